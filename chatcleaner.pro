@@ -19,6 +19,7 @@ DEPENDPATH += src/ \
 	src/net/
 SOURCES += src/chatcleaner/chatcleaner.cpp \
 	src/chatcleaner/cleanerserver.cpp \
+	src/chatcleaner/cleanerconnection.cpp \
 	src/chatcleaner/messagefilter.cpp \
 	src/chatcleaner/badwordcheck.cpp \
 	src/chatcleaner/textfloodcheck.cpp \
@@ -27,6 +28,7 @@ SOURCES += src/chatcleaner/chatcleaner.cpp \
 	src/chatcleaner/letterrepeatingcheck.cpp \
 	src/chatcleaner/urlcheck.cpp
 HEADERS += src/chatcleaner/cleanerserver.h \
+	src/chatcleaner/cleanerconnection.h \
 	src/chatcleaner/messagefilter.h \
 	src/chatcleaner/badwordcheck.h \
 	src/chatcleaner/textfloodcheck.h \
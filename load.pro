@@ -17,20 +17,28 @@ DEFINES += PREFIX=\"$${PREFIX}\"
 QT -= core gui
 #PRECOMPILED_HEADER = src/pch_lib.h
 
+DEFINES += ENABLE_IPV6
+
 INCLUDEPATH += . \
 		src \
-		src/third_party/asn1
+		src/engine \
+		src/net
 
 DEPENDPATH += . \
 		src \
-		src/third_party/asn1
+		src/engine \
+		src/net
 
 # Input
 HEADERS += \
-		src/game_defs.h
+		src/game_defs.h \
+		src/tests/loadclient.h \
+		src/tests/loadstatistics.h
 
 SOURCES += \
-		src/load.cpp
+		src/load.cpp \
+		src/tests/loadclient.cpp \
+		src/tests/loadstatistics.cpp
 
 LIBS += -lpokerth_protocol
 
@@ -46,6 +54,7 @@ unix : !mac {
 	BOOST_THREAD = boost_thread boost_thread-mt
 	BOOST_PROGRAM_OPTIONS = boost_program_options boost_program_options-mt
 	BOOST_SYS = boost_system boost_system-mt
+	BOOST_CHRONO = boost_chrono boost_chrono-mt
 
 
 	#
@@ -79,10 +88,18 @@ unix : !mac {
 				message("Found $$lib")
 				BOOST_SYS = -l$$lib
 			}
+			for(lib, BOOST_CHRONO):exists($${dir}/lib$${lib}.so*) {
+				message("Found $$lib")
+				BOOST_CHRONO = -l$$lib
+			}
+			for(lib, BOOST_CHRONO):exists($${dir}/lib$${lib}.a) {
+				message("Found $$lib")
+				BOOST_CHRONO = -l$$lib
+			}
 		}
 	}
-	BOOST_LIBS = $$BOOST_PROGRAM_OPTIONS $$BOOST_SYS $$BOOST_THREAD
-	!count(BOOST_LIBS, 3){
+	BOOST_LIBS = $$BOOST_PROGRAM_OPTIONS $$BOOST_SYS $$BOOST_THREAD $$BOOST_CHRONO
+	!count(BOOST_LIBS, 4){
 		error("Unable to find boost libraries in PREFIX=$${PREFIX}")
 	}
 
@@ -91,7 +108,7 @@ unix : !mac {
 	kFreeBSD = $$find(UNAME, "kFreeBSD")
 
 	LIBS += $$BOOST_LIBS
-	LIBS += -lgsasl
+	LIBS += -lprotobuf -lgsasl
 
 	POST_TARGETDEPS += ./lib/libpokerth_protocol.a
 
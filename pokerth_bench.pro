@@ -0,0 +1,101 @@
+# QMake pro-file for the PokerTH micro benchmarks
+
+isEmpty( PREFIX ){
+	PREFIX =/usr
+}
+
+TEMPLATE = app
+CODECFORSRC = UTF-8
+
+CONFIG += thread console embed_manifest_exe exceptions rtti stl warn_on release
+
+UI_DIR = uics
+TARGET = bin/pokerth_bench
+MOC_DIR = mocs
+OBJECTS_DIR = obj
+DEFINES += PREFIX=\"$${PREFIX}\"
+DEFINES += ENABLE_IPV6 TIXML_USE_STL BOOST_FILESYSTEM_DEPRECATED
+QT -= core gui
+
+INCLUDEPATH += . \
+		src \
+		src/engine \
+		src/engine/local_engine \
+		src/net \
+		src/config \
+		src/core
+
+DEPENDPATH += . \
+		src \
+		src/tests
+
+# Input
+HEADERS += \
+		src/tests/benchmark.h
+
+SOURCES += \
+		src/tests/pokerth_bench.cpp \
+		src/tests/bench_patternmatcher.cpp \
+		src/tests/bench_handstart.cpp \
+		src/tests/bench_tablestate.cpp \
+		src/tests/bench_avatardownload.cpp
+
+LIBS += -lpokerth_lib \
+	-lpokerth_protocol
+
+unix : !mac {
+
+	QMAKE_LIBDIR += lib $${PREFIX}/lib
+	INCLUDEPATH += $${PREFIX}/include
+	LIB_DIRS = $${PREFIX}/lib $${PREFIX}/lib64 $$system(qmake -query QT_INSTALL_LIBS)
+	BOOST_CHRONO = boost_chrono boost_chrono-mt
+	BOOST_SYS = boost_system boost_system-mt
+	BOOST_THREAD = boost_thread boost_thread-mt
+
+	for(dir, LIB_DIRS){
+		exists($$dir){
+			for(lib, BOOST_CHRONO):exists($${dir}/lib$${lib}.so*) {
+				message("Found $$lib")
+				BOOST_CHRONO = -l$$lib
+			}
+			for(lib, BOOST_CHRONO):exists($${dir}/lib$${lib}.a) {
+				message("Found $$lib")
+				BOOST_CHRONO = -l$$lib
+			}
+			for(lib, BOOST_SYS):exists($${dir}/lib$${lib}.so*) {
+				message("Found $$lib")
+				BOOST_SYS = -l$$lib
+			}
+			for(lib, BOOST_SYS):exists($${dir}/lib$${lib}.a) {
+				message("Found $$lib")
+				BOOST_SYS = -l$$lib
+			}
+			for(lib, BOOST_THREAD):exists($${dir}/lib$${lib}.so*) {
+				message("Found $$lib")
+				BOOST_THREAD = -l$$lib
+			}
+			for(lib, BOOST_THREAD):exists($${dir}/lib$${lib}.a) {
+				message("Found $$lib")
+				BOOST_THREAD = -l$$lib
+			}
+		}
+	}
+	BOOST_LIBS = $$BOOST_CHRONO $$BOOST_SYS $$BOOST_THREAD
+	!count(BOOST_LIBS, 3){
+		error("Unable to find boost libraries in PREFIX=$${PREFIX}")
+	}
+
+	LIBS += $$BOOST_LIBS
+	LIBS += -lcurl
+
+	UNAME = $$system(uname -s)
+	BSD = $$find(UNAME, "BSD")
+	kFreeBSD = $$find(UNAME, "kFreeBSD")
+	!isEmpty( BSD ): isEmpty( kFreeBSD ){
+		LIBS += -lcrypto
+	} else {
+		LIBS += -lgcrypt
+	}
+
+	POST_TARGETDEPS += ./lib/libpokerth_lib.a
+}
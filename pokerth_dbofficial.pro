@@ -90,3 +90,7 @@ mac {
     INCLUDEPATH += /opt/local/include/mysql++ \
         /opt/local/include/mysql5/mysql
 }
+
+trace{
+	DEFINES += POKERTH_TRACE
+}
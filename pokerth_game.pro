@@ -125,6 +125,7 @@ HEADERS += src/engine/game.h \
 	src/core/loghelper.h \
 	src/engine/boardinterface.h \
 	src/engine/enginefactory.h \
+	src/engine/engineevent.h \
 	src/engine/handinterface.h \
 	src/engine/playerinterface.h \
 	src/engine/berointerface.h \
@@ -148,6 +149,7 @@ HEADERS += src/engine/game.h \
 	src/engine/local_engine/localenginefactory.h \
 	src/engine/local_engine/localhand.h \
 	src/engine/local_engine/localplayer.h \
+	src/engine/local_engine/localtablestate.h \
 	src/engine/local_engine/localberopreflop.h \
 	src/engine/local_engine/localberoflop.h \
 	src/engine/local_engine/localberoturn.h \
@@ -188,6 +190,7 @@ HEADERS += src/engine/game.h \
 	src/gui/qt/startwindow/startwindowimpl.h \
 	src/gui/qt/styles/gametablestylereader.h \
 	src/gui/qt/styles/carddeckstylereader.h \
+	src/gui/qt/styles/gametablestylecache.h \
 	src/gui/qt/changecontentdialog/changecontentdialogimpl.h \
 	src/gui/qt/changecompleteblindsdialog/changecompleteblindsdialogimpl.h \
 	src/gui/qt/gamelobbydialog/gamelobbydialogimpl.h \
@@ -207,6 +210,8 @@ HEADERS += src/engine/game.h \
 	src/gui/qt/internetgamelogindialog/internetgamelogindialogimpl.h \
 	src/engine/local_engine/replay.h \
 	src/gui/qt/gamelobbydialog/mynicklistsortfilterproxymodel.h \
+	src/gui/qt/gamelobbydialog/lobbygamelistmodel.h \
+	src/gui/qt/gamelobbydialog/lobbynicklistmodel.h \
 	src/gui/qt/gametable/myslider.h \
 	src/gui/qt/gametable/mycashlabel.h \
 	src/gui/qt/sound/soundevents.h \
@@ -266,6 +271,7 @@ SOURCES += src/pokerth.cpp \
 	src/gui/qt/startwindow/startwindowimpl.cpp \
 	src/gui/qt/styles/gametablestylereader.cpp \
 	src/gui/qt/styles/carddeckstylereader.cpp \
+	src/gui/qt/styles/gametablestylecache.cpp \
 	src/gui/qt/changecontentdialog/changecontentdialogimpl.cpp \
 	src/gui/qt/changecompleteblindsdialog/changecompleteblindsdialogimpl.cpp \
 	src/gui/qt/mymessagedialog/mymessagedialogimpl.cpp \
@@ -283,6 +289,8 @@ SOURCES += src/pokerth.cpp \
 	src/gui/qt/internetgamelogindialog/internetgamelogindialogimpl.cpp \
 	src/engine/local_engine/replay.cpp \
 	src/gui/qt/gamelobbydialog/mynicklistsortfilterproxymodel.cpp \
+	src/gui/qt/gamelobbydialog/lobbygamelistmodel.cpp \
+	src/gui/qt/gamelobbydialog/lobbynicklistmodel.cpp \
 	src/net/common/servermanagerfactoryclient.cpp \
 	src/gui/qt/gametable/mycashlabel.cpp \
 	src/gui/qt/sound/soundevents.cpp \
@@ -508,7 +516,8 @@ unix:!mac {
 		kFreeBSD = $$find(UNAME, "kFreeBSD")
 		LIBS += -lsqlite3 \
 				-ltinyxml \
-				-lprotobuf
+				-lprotobuf \
+				-lz
 		LIBS += $$BOOST_LIBS
 		LIBS += -lSDL \
 				-lSDL_mixer \
@@ -55,8 +55,11 @@ HEADERS += \
 		src/core/crypthelper.h \
 		src/core/avatarmanager.h \
 		src/core/pokerthexception.h \
+		src/core/multipatternmatcher.h \
+		src/core/tracehelper.h \
 		src/engine/boardinterface.h \
 		src/engine/enginefactory.h \
+		src/engine/engineevent.h \
 		src/engine/handinterface.h \
 		src/engine/playerinterface.h \
 		src/engine/berointerface.h \
@@ -79,8 +82,10 @@ HEADERS += \
 		src/net/serveracceptwebhelper.h \
 		src/net/servergame.h \
 		src/net/servergamestate.h \
+		src/net/spectatorstream.h \
 		src/net/serverlobbythread.h \
 		src/net/serverbanmanager.h \
+		src/net/ipprefixtrie.h \
 		src/net/servercallback.h \
 		src/net/serveradminbot.h \
 		src/net/serverlobbybot.h \
@@ -106,6 +111,7 @@ HEADERS += \
 		src/engine/local_engine/localenginefactory.h \
 		src/engine/local_engine/localhand.h \
 		src/engine/local_engine/localplayer.h \
+		src/engine/local_engine/localtablestate.h \
 		src/engine/local_engine/localberopreflop.h \
 		src/engine/local_engine/localberoflop.h \
 		src/engine/local_engine/localberoturn.h \
@@ -138,6 +144,10 @@ HEADERS += \
 		src/net/uploadcallback.h \
 		src/net/websocket_defs.h \
 		src/net/websocketdata.h \
+		src/net/websocketdeflate.h \
+		src/net/servermetrics.h \
+		src/net/servermetricshelper.h \
+		src/net/serveraischeduler.h \
     src/net/validation/lobbymessagevalidator.h \
     src/net/validation/authmessagevalidator.h \
     src/net/validation/gamemessagevalidator.h \
@@ -161,6 +171,8 @@ SOURCES += \
 		src/core/common/crypthelper.cpp \
 		src/core/common/avatarmanager.cpp \
 		src/core/common/pokerthexception.cpp \
+		src/core/common/multipatternmatcher.cpp \
+		src/core/common/tracehelper.cpp \
 		src/engine/local_engine/cardsvalue.cpp \
 		src/engine/local_engine/localboard.cpp \
 		src/engine/local_engine/localenginefactory.cpp \
@@ -196,9 +208,11 @@ SOURCES += \
 		src/net/common/serveracceptwebhelper.cpp \
 		src/net/common/servergame.cpp \
 		src/net/common/servergamestate.cpp \
+		src/net/common/spectatorstream.cpp \
 		src/net/common/serverlobbythread.cpp \
 		src/net/common/serverdelaytime.cpp \
 		src/net/common/serverbanmanager.cpp \
+		src/net/common/ipprefixtrie.cpp \
 		src/net/common/servercallback.cpp \
 		src/net/common/serveradminbot.cpp \
 		src/net/common/serverlobbybot.cpp \
@@ -220,6 +234,10 @@ SOURCES += \
 		src/net/common/sendbuffer.cpp \
 		src/net/common/asiosendbuffer.cpp \
 		src/net/common/websendbuffer.cpp \
+		src/net/common/websocketdeflate.cpp \
+		src/net/common/servermetrics.cpp \
+		src/net/common/servermetricshelper.cpp \
+		src/net/common/serveraischeduler.cpp \
 		src/net/common/receivebuffer.cpp \
 		src/net/common/asioreceivebuffer.cpp \
 		src/net/common/webreceivebuffer.cpp \
@@ -241,6 +259,13 @@ android|android_test{
 official_server{
 	INCLUDEPATH += pkth_stat/daemon_lib/src
 	DEFINES += POKERTH_OFFICIAL_SERVER
+	HEADERS += src/core/avatarpackstore.h
+	SOURCES += src/core/common/avatarpackstore.cpp
+}
+
+# Compile in trace points, enable with "qmake CONFIG+=trace".
+trace{
+	DEFINES += POKERTH_TRACE
 }
 
 win32{
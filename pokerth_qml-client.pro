@@ -187,7 +187,8 @@ unix:!mac {
             kFreeBSD = $$find(UNAME, "kFreeBSD")
             LIBS += -lsqlite3 \
                             -ltinyxml \
-                            -lprotobuf
+                            -lprotobuf \
+                            -lz
             LIBS += $$BOOST_LIBS
             LIBS += -lSDL \
                             -lSDL_mixer \
@@ -56,6 +56,7 @@ HEADERS += \
 		src/core/thread.h \
 		src/engine/boardinterface.h \
 		src/engine/enginefactory.h \
+		src/engine/engineevent.h \
 		src/engine/handinterface.h \
 		src/engine/playerinterface.h \
 		src/engine/berointerface.h \
@@ -83,6 +84,7 @@ HEADERS += \
 		src/engine/local_engine/localenginefactory.h \
 		src/engine/local_engine/localhand.h \
 		src/engine/local_engine/localplayer.h \
+		src/engine/local_engine/localtablestate.h \
 		src/engine/local_engine/localberopreflop.h \
 		src/engine/local_engine/localberoflop.h \
 		src/engine/local_engine/localberoturn.h \
@@ -274,7 +276,8 @@ unix : !mac {
 	LIBS += $$BOOST_LIBS
 	LIBS += -lsqlite3 \
 			-ltinyxml \
-			-lprotobuf
+			-lprotobuf \
+			-lz
 	LIBS += -lgsasl
 	!isEmpty( BSD ): isEmpty( kFreeBSD ){
 		LIBS += -lcrypto -liconv
@@ -341,3 +344,7 @@ official_server {
 android_test{
 	DEFINES += ANDROID
 }
+
+trace{
+	DEFINES += POKERTH_TRACE
+}
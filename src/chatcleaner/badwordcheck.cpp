@@ -31,32 +31,55 @@
 #include "badwordcheck.h"
 
 #include <QtCore>
+#include <core/multipatternmatcher.h>
 
-BadWordCheck::BadWordCheck()
+BadWordCheck::BadWordCheck(): firstBadWordId(0), firstExceptionId(0)
 {
 }
 
-bool BadWordCheck::run(QString msg)
+void BadWordCheck::addPatterns(MultiPatternMatcher &matcher)
 {
-	msg = msg.toLower();
-	bool badMessage(false);
-
+	firstBadWordId = matcher.GetNumPatterns();
 	QStringListIterator it(badWords);
 	while (it.hasNext()) {
-		QString bw=it.next();
-		if(msg.contains(bw)) {
-			badMessage=true;
+		matcher.AddPattern(it.next().toUtf8().constData());
+	}
+
+	firstExceptionId = matcher.GetNumPatterns();
+	QStringListIterator it2(badWordsException);
+	while (it2.hasNext()) {
+		matcher.AddPattern(it2.next().toUtf8().constData());
+	}
+
+	// An exception only applies to the bad words it contains.
+	exceptionIds.clear();
+	exceptionIds.resize(badWords.size());
+	for(int i = 0; i < badWords.size(); i++) {
+		for(int j = 0; j < badWordsException.size(); j++) {
+			if(badWordsException.at(j).contains(badWords.at(i))) {
+				exceptionIds[i].append(firstExceptionId + j);
+			}
+		}
+	}
+}
+
+bool BadWordCheck::run(const std::vector<char> &patternHits) const
+{
+	for(int i = 0; i < badWords.size(); i++) {
+		if(patternHits[firstBadWordId + i]) {
 			//exception check
-			QStringListIterator it2(badWordsException);
-			while (it2.hasNext()) {
-				QString bwe=it2.next();
-				if(bwe.contains(bw) && msg.contains(bwe)) {
-					badMessage=false;
+			bool exception = false;
+			QListIterator<unsigned> it(exceptionIds.at(i));
+			while (it.hasNext()) {
+				if(patternHits[it.next()]) {
+					exception = true;
+					break;
 				}
 			}
+			if(!exception) {
+				return true;
+			}
 		}
 	}
-
-	if(badMessage) return true;
-	else return false;
+	return false;
 }
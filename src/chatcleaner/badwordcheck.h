@@ -32,6 +32,9 @@
 #define BADWORDCHECK_H
 
 #include <QtCore>
+#include <vector>
+
+class MultiPatternMatcher;
 
 class BadWordCheck: public QObject
 {
@@ -47,12 +50,20 @@ public:
 		badWordsException = bwe;
 	}
 
-	bool run(QString);
+	// Adds bad words and exceptions to the (not yet built) matcher.
+	void addPatterns(MultiPatternMatcher &matcher);
+	// Evaluates the pattern hits of a lowercase message.
+	bool run(const std::vector<char> &patternHits) const;
 
 private:
 
 	QStringList badWords;
 	QStringList badWordsException;
+
+	unsigned firstBadWordId;
+	unsigned firstExceptionId;
+	// For each bad word: ids of the exceptions which contain it.
+	QVector<QList<unsigned> > exceptionIds;
 };
 
 #endif // BADWORDCHECK_H
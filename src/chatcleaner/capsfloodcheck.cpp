@@ -37,7 +37,7 @@ CapsFloodCheck::CapsFloodCheck()
 {
 }
 
-bool CapsFloodCheck::run(QString msg)
+bool CapsFloodCheck::run(QString msg) const
 {
 	msg = msg.simplified().remove(" ");
 	QRegExp e(QString("[A-Z]{%1,}").arg(capsNumberToTrigger));
@@ -42,7 +42,7 @@ public:
 	void setCapsNumberToTrigger(int n) {
 		capsNumberToTrigger = n;
 	}
-	bool run(QString);
+	bool run(QString) const;
 
 private:
 
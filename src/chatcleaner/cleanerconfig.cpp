@@ -54,7 +54,7 @@ using namespace std;
 CleanerConfig::CleanerConfig()
 {
 	// !!!! Revisionsnummer der Configdefaults !!!!!
-	configRev = 10;
+	configRev = 11;
 
 	// Pfad und Dateinamen setzen
 #ifdef _WIN32
@@ -123,6 +123,8 @@ CleanerConfig::CleanerConfig()
 	configList.push_back(ConfigInfo("DefaultListenPort", CONFIG_TYPE_STRING, "4327"));
 	configList.push_back(ConfigInfo("ClientAuthString", CONFIG_TYPE_STRING, ""));
 	configList.push_back(ConfigInfo("ServerAuthString", CONFIG_TYPE_STRING, ""));
+	configList.push_back(ConfigInfo("MaxConnections", CONFIG_TYPE_INT, "16"));
+	configList.push_back(ConfigInfo("WorkerThreads", CONFIG_TYPE_INT, "0"));
 
 	configList.push_back(ConfigInfo("WarnLevelToKick", CONFIG_TYPE_INT, "2"));
 	configList.push_back(ConfigInfo("TextFloodLevelToTrigger", CONFIG_TYPE_INT, "3"));
@@ -0,0 +1,157 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+#include "cleanerconnection.h"
+
+#include <QtNetwork>
+#include <QtCore>
+#include <QtEndian>
+#include <cstdlib>
+#include <string>
+#include <third_party/protobuf/chatcleaner.pb.h>
+
+using namespace std;
+
+CleanerConnection::CleanerConnection(unsigned id, QTcpSocket *socket, CleanerServer *server)
+	: connectionId(id), tcpSocket(socket), myServer(server), authenticated(false), m_recvBufUsed(0)
+{
+	tcpSocket->setParent(this);
+	connect(tcpSocket, SIGNAL(readyRead()), this, SLOT(onRead()));
+	connect(tcpSocket, SIGNAL(stateChanged(QAbstractSocket::SocketState)), this, SLOT(socketStateChanged(QAbstractSocket::SocketState)));
+}
+
+CleanerConnection::~CleanerConnection()
+{
+}
+
+void CleanerConnection::onRead()
+{
+	qint64 bytesRead = tcpSocket->read((char *)m_recvBuf + m_recvBufUsed, sizeof(m_recvBuf) - m_recvBufUsed);
+	bool error = bytesRead < 1;
+	if (!error) {
+		m_recvBufUsed += bytesRead;
+		bool valid;
+		do {
+			valid = false;
+			if (m_recvBufUsed >= CLEANER_NET_HEADER_SIZE) {
+				// Read the size of the packet (first 4 bytes in network byte order).
+				uint32_t nativeVal;
+				memcpy(&nativeVal, &m_recvBuf[0], sizeof(uint32_t));
+				size_t packetSize = qFromBigEndian(nativeVal);
+				if (packetSize > MAX_CLEANER_PACKET_SIZE) {
+					m_recvBufUsed = 0;
+					qDebug() << "Invalid packet size: " << packetSize;
+				} else if (m_recvBufUsed >= packetSize + CLEANER_NET_HEADER_SIZE) {
+					try {
+						// Try to decode the packet.
+						boost::shared_ptr<ChatCleanerMessage> recvMsg(ChatCleanerMessage::default_instance().New());
+						if (recvMsg->ParseFromArray(&m_recvBuf[CLEANER_NET_HEADER_SIZE], static_cast<int>(packetSize))) {
+							m_recvBufUsed -= (packetSize + CLEANER_NET_HEADER_SIZE);
+							if (m_recvBufUsed) {
+								memmove(m_recvBuf, m_recvBuf + packetSize + CLEANER_NET_HEADER_SIZE, m_recvBufUsed);
+							}
+						}
+						// Handle the packet.
+						error = handleMessage(*recvMsg);
+						valid = true;
+					} catch (const exception &e) {
+						// Reset buffer on error.
+						m_recvBufUsed = 0;
+						qDebug() << "Exception while decoding packet: " << e.what();
+					}
+				}
+			}
+		} while (valid && !error);
+	}
+
+	if (error) {
+		qDebug() << "Error handling packets from client" << connectionId;
+		tcpSocket->close();
+	}
+}
+
+bool CleanerConnection::handleMessage(ChatCleanerMessage &msg)
+{
+	bool error = true;
+	if (msg.messagetype() == ChatCleanerMessage::Type_CleanerInitMessage) {
+		const CleanerInitMessage &netInit = msg.cleanerinitmessage();
+		if (netInit.requestedversion() == CLEANER_PROTOCOL_VERSION) {
+			if (myServer->getClientSecret() == QString::fromStdString(netInit.clientsecret())) {
+				error = false;
+				authenticated = true;
+
+				boost::shared_ptr<ChatCleanerMessage> tmpAck(ChatCleanerMessage::default_instance().New());
+				tmpAck->set_messagetype(ChatCleanerMessage::Type_CleanerInitAckMessage);
+				CleanerInitAckMessage *netAck = tmpAck->mutable_cleanerinitackmessage();
+				netAck->set_serverversion(CLEANER_PROTOCOL_VERSION);
+				netAck->set_serversecret(myServer->getServerSecret().toStdString());
+				sendMessageToClient(*tmpAck);
+			} else
+				qDebug() << "Invalid client secret.";
+		} else
+			qDebug() << "Invalid client version: " << netInit.requestedversion();
+	} else if (msg.messagetype() == ChatCleanerMessage::Type_CleanerChatRequestMessage && authenticated) {
+		error = false;
+		const CleanerChatRequestMessage &netRequest = msg.cleanerchatrequestmessage();
+
+		// Requests are answered as soon as they are checked, possibly out of
+		// order. The client matches replies by request id.
+		CleanerChatRequest request;
+		request.connectionId = connectionId;
+		request.requestId = netRequest.requestid();
+		request.chatType = netRequest.cleanerchattype();
+		request.gameId = netRequest.gameid();
+		request.playerId = netRequest.playerid();
+		request.nick = QString::fromUtf8(netRequest.playername().c_str());
+		request.message = QString::fromUtf8(netRequest.chatmessage().c_str());
+		request.textFlood = false;
+		request.offence = 0;
+		myServer->queueChatRequest(request);
+	}
+	return error;
+}
+
+void CleanerConnection::socketStateChanged(QAbstractSocket::SocketState state)
+{
+	qDebug() << "Socket" << connectionId << "state changed to: " << state;
+	if (state == QAbstractSocket::UnconnectedState) {
+		emit closed(connectionId);
+	}
+}
+
+void CleanerConnection::sendMessageToClient(const ChatCleanerMessage &msg)
+{
+	uint32_t packetSize = msg.ByteSize();
+	google::protobuf::uint8 *buf = new google::protobuf::uint8[packetSize + CLEANER_NET_HEADER_SIZE];
+	*((uint32_t *)buf) = qToBigEndian(packetSize);
+	msg.SerializeWithCachedSizesToArray(&buf[CLEANER_NET_HEADER_SIZE]);
+	tcpSocket->write((const char *)buf, packetSize + CLEANER_NET_HEADER_SIZE);
+	delete[] buf;
+}
@@ -32,34 +32,58 @@
 
 #include <QtNetwork>
 #include <QtCore>
-#include <QtEndian>
 #include <cstdlib>
 #include <string>
 #include <third_party/protobuf/chatcleaner.pb.h>
 
+#include "cleanerconnection.h"
 #include "messagefilter.h"
 #include "cleanerconfig.h"
 
 using namespace std;
 
-CleanerServer::CleanerServer(): config(0), blockConnection(false), m_recvBufUsed(0), secondsSinceLastConfigChange(0)
+// Runs the content checks of one chat line on the worker pool.
+class ChatCheckTask: public QRunnable
 {
+public:
+	ChatCheckTask(CleanerServer *s, const MessageFilter *f, const CleanerChatRequest &r)
+		: server(s), filter(f), request(r) {}
+
+	virtual void run() {
+		request.offence = filter->checkContent(request.message);
+		QMetaObject::invokeMethod(server, "chatRequestChecked", Qt::QueuedConnection, Q_ARG(CleanerChatRequest, request));
+	}
+
+private:
+	CleanerServer *server;
+	const MessageFilter *filter;
+	CleanerChatRequest request;
+};
+
+CleanerServer::CleanerServer(): config(0), lastConnectionId(0), maxConnections(0), secondsSinceLastConfigChange(0)
+{
+	qRegisterMetaType<CleanerChatRequest>("CleanerChatRequest");
+
 	config = new CleanerConfig;
 
 	clientSecret = QString::fromUtf8(config->readConfigString("ClientAuthString").c_str());
 	serverSecret = QString::fromUtf8(config->readConfigString("ServerAuthString").c_str());
+	maxConnections = config->readConfigInt("MaxConnections");
 
 	myMessageFilter = new MessageFilter(config);
+	workerPool = new QThreadPool();
+	int numWorkers = config->readConfigInt("WorkerThreads");
+	if (numWorkers > 0) {
+		workerPool->setMaxThreadCount(numWorkers);
+	}
 	tcpServer = new QTcpServer();
-	tcpServer->setMaxPendingConnections(1);
+	configRefreshTimer = new QTimer();
 
 	if (!tcpServer->listen(QHostAddress(QString::fromUtf8(config->readConfigString("HostAddress").c_str())), config->readConfigInt("DefaultListenPort")) ) {
 		qDebug() << QString("Unable to start the server: %1.").arg(tcpServer->errorString());
 		return;
 	}
-	qDebug() << QString("The server is running on port %1.").arg(tcpServer->serverPort());
-
-	configRefreshTimer = new QTimer();
+	qDebug() << QString("The server is running on port %1 with %2 worker threads.").arg(tcpServer->serverPort()).arg(workerPool->maxThreadCount());
 
 	connect(configRefreshTimer, SIGNAL(timeout()), this, SLOT(refreshConfig()));
 	connect(tcpServer, SIGNAL(newConnection()), this, SLOT(newCon()));
@@ -70,6 +94,10 @@ CleanerServer::CleanerServer(): config(0), blockConnection(false), m_recvBufUsed
 
 CleanerServer::~CleanerServer()
 {
+	// Finish pending checks before the filter is deleted.
+	workerPool->waitForDone();
+	qDeleteAll(connections);
+	delete workerPool;
 	delete config;
 	delete myMessageFilter;
 	delete tcpServer;
@@ -78,140 +106,74 @@ CleanerServer::~CleanerServer()
 
 void CleanerServer::newCon()
 {
-	if(!blockConnection) {
-		tcpSocket = tcpServer->nextPendingConnection();
-		connect(tcpSocket, SIGNAL(readyRead()), this, SLOT(onRead()));
-		connect(tcpSocket, SIGNAL(stateChanged(QAbstractSocket::SocketState)), this, SLOT(socketStateChanged(QAbstractSocket::SocketState)));
-		blockConnection = true;
-#if QT_VERSION >= 0x050100
-		tcpServer->pauseAccepting();
-#endif
+	while (tcpServer->hasPendingConnections()) {
+		QTcpSocket *tcpSocket = tcpServer->nextPendingConnection();
+		if (maxConnections > 0 && connections.size() >= maxConnections) {
+			qDebug() << "Connection limit reached, rejecting client.";
+			tcpSocket->abort();
+			tcpSocket->deleteLater();
+			continue;
+		}
+		lastConnectionId++;
+		if (lastConnectionId == 0) // 0 is an invalid id.
+			lastConnectionId++;
+		CleanerConnection *newConnection = new CleanerConnection(lastConnectionId, tcpSocket, this);
+		connect(newConnection, SIGNAL(closed(unsigned)), this, SLOT(connectionClosed(unsigned)));
+		connections.insert(lastConnectionId, newConnection);
 	}
 }
 
-void CleanerServer::onRead()
+void CleanerServer::connectionClosed(unsigned connectionId)
 {
-	qint64 bytesRead = tcpSocket->read((char *)m_recvBuf + m_recvBufUsed, sizeof(m_recvBuf) - m_recvBufUsed);
-	bool error = bytesRead < 1;
-	if (!error) {
-		m_recvBufUsed += bytesRead;
-		bool valid;
-		do {
-			valid = false;
-			if (m_recvBufUsed >= CLEANER_NET_HEADER_SIZE) {
-				// Read the size of the packet (first 4 bytes in network byte order).
-				uint32_t nativeVal;
-				memcpy(&nativeVal, &m_recvBuf[0], sizeof(uint32_t));
-				size_t packetSize = qFromBigEndian(nativeVal);
-				if (packetSize > MAX_CLEANER_PACKET_SIZE) {
-					m_recvBufUsed = 0;
-					qDebug() << "Invalid packet size: " << packetSize;
-				} else if (m_recvBufUsed >= packetSize + CLEANER_NET_HEADER_SIZE) {
-					try {
-						// Try to decode the packet.
-						boost::shared_ptr<ChatCleanerMessage> recvMsg(ChatCleanerMessage::default_instance().New());
-						if (recvMsg->ParseFromArray(&m_recvBuf[CLEANER_NET_HEADER_SIZE], static_cast<int>(packetSize))) {
-							m_recvBufUsed -= (packetSize + CLEANER_NET_HEADER_SIZE);
-							if (m_recvBufUsed) {
-								memmove(m_recvBuf, m_recvBuf + packetSize + CLEANER_NET_HEADER_SIZE, m_recvBufUsed);
-							}
-						}
-						// Handle the packet.
-						error = handleMessage(*recvMsg);
-						valid = true;
-					} catch (const exception &e) {
-						// Reset buffer on error.
-						m_recvBufUsed = 0;
-						qDebug() << "Exception while decoding packet: " << e.what();
-					}
-				}
-			}
-		} while (valid && !error);
+	CleanerConnection *tmpConnection = connections.take(connectionId);
+	if (tmpConnection) {
+		tmpConnection->deleteLater();
 	}
-
-	if (error) {
-		qDebug() << "Error handling packets from client.";
-		tcpSocket->close();
-	}
-
-	/*	char buf[1024];
-	tcpSocket->readLine(buf, sizeof(buf));
-	QString message = QString::fromUtf8("%1").arg(buf);
-
-	// TESTING DEFAULT VALUES
-	QString nick = "PlayerNick";
-	unsigned playerId = 1;
-	// TESTING DEFAULT VALUES
-
-	QString checkMessage = myMessageFilter->check(playerId, nick, message);
-	tcpSocket->write(checkMessage.toAscii().data(), checkMessage.length());*/
 }
 
-bool CleanerServer::handleMessage(ChatCleanerMessage &msg)
+void CleanerServer::queueChatRequest(CleanerChatRequest request)
 {
-	bool error = true;
-	if (msg.messagetype() == ChatCleanerMessage::Type_CleanerInitMessage) {
-		const CleanerInitMessage &netInit = msg.cleanerinitmessage();
-		if (netInit.requestedversion() == CLEANER_PROTOCOL_VERSION) {
-			if (clientSecret == QString::fromStdString(netInit.clientsecret())) {
-				error = false;
-
-				boost::shared_ptr<ChatCleanerMessage> tmpAck(ChatCleanerMessage::default_instance().New());
-				tmpAck->set_messagetype(ChatCleanerMessage::Type_CleanerInitAckMessage);
-				CleanerInitAckMessage *netAck = tmpAck->mutable_cleanerinitackmessage();
-				netAck->set_serverversion(CLEANER_PROTOCOL_VERSION);
-				netAck->set_serversecret(serverSecret.toStdString());
-				sendMessageToClient(*tmpAck);
-			} else
-				qDebug() << "Invalid client secret.";
-		} else
-			qDebug() << "Invalid client version: " << netInit.requestedversion();
-	} else if (msg.messagetype() == ChatCleanerMessage::Type_CleanerChatRequestMessage) {
-		error = false;
-		const CleanerChatRequestMessage &netRequest = msg.cleanerchatrequestmessage();
-		unsigned playerId = netRequest.playerid();
-		QString nick(QString::fromUtf8(netRequest.playername().c_str()));
-		QString message(QString::fromUtf8(netRequest.chatmessage().c_str()));
-		unsigned gameId = netRequest.gameid();
-
-		QStringList checkreturn = myMessageFilter->check(gameId, playerId, nick, message);
-		QString checkAction = checkreturn.at(0);
-		QString checkMessage = checkreturn.at(1);
-
-		if (!checkAction.isEmpty()) {
-			boost::shared_ptr<ChatCleanerMessage> tmpReply(ChatCleanerMessage::default_instance().New());
-			tmpReply->set_messagetype(ChatCleanerMessage::Type_CleanerChatReplyMessage);
-			CleanerChatReplyMessage *netReply = tmpReply->mutable_cleanerchatreplymessage();
-			netReply->set_requestid(netRequest.requestid());
-			netReply->set_gameid(netRequest.gameid());
-			netReply->set_cleanerchattype(netRequest.cleanerchattype());
-			netReply->set_playerid(netRequest.playerid());
-
-			if(checkAction == "warn") {
-				netReply->set_cleaneractiontype(CleanerChatReplyMessage_CleanerActionType_cleanerActionWarning);
-			} else if (checkAction == "kick") {
-				netReply->set_cleaneractiontype(CleanerChatReplyMessage_CleanerActionType_cleanerActionKick);
-			} else if (checkAction == "kickban") {
-				netReply->set_cleaneractiontype(CleanerChatReplyMessage_CleanerActionType_cleanerActionBan);
-			} else if (checkAction == "mute") {
-				netReply->set_cleaneractiontype(CleanerChatReplyMessage_CleanerActionType_cleanerActionMute);
-			}
-
-			netReply->set_cleanertext(checkMessage.toUtf8());
-			sendMessageToClient(*tmpReply);
-		}
-	}
-	return error;
+	// Flood state depends on the order of messages, so it is checked here.
+	quint64 clientId = (static_cast<quint64>(request.connectionId) << 32) | request.playerId;
+	request.textFlood = myMessageFilter->checkTextFlood(clientId);
+	workerPool->start(new ChatCheckTask(this, myMessageFilter, request));
 }
 
-void CleanerServer::socketStateChanged(QAbstractSocket::SocketState state)
+void CleanerServer::chatRequestChecked(CleanerChatRequest request)
 {
-	qDebug() << "Socket state changed to: " << state;
-	if (state == QAbstractSocket::UnconnectedState) {
-		blockConnection = false;
-#if QT_VERSION >= 0x050100
-		tcpServer->resumeAccepting();
-#endif
+	CleanerConnection *tmpConnection = connections.value(request.connectionId);
+	if (!tmpConnection) {
+		// Client has disconnected in the meantime.
+		return;
+	}
+
+	OffenceType offence = request.textFlood ? TEXT_FLOOD_LINES : static_cast<OffenceType>(request.offence);
+	quint64 clientId = (static_cast<quint64>(request.connectionId) << 32) | request.playerId;
+	QStringList checkreturn = myMessageFilter->handleOffence(request.gameId, clientId, request.nick, offence);
+	QString checkAction = checkreturn.at(0);
+	QString checkMessage = checkreturn.at(1);
+
+	if (!checkAction.isEmpty()) {
+		boost::shared_ptr<ChatCleanerMessage> tmpReply(ChatCleanerMessage::default_instance().New());
+		tmpReply->set_messagetype(ChatCleanerMessage::Type_CleanerChatReplyMessage);
+		CleanerChatReplyMessage *netReply = tmpReply->mutable_cleanerchatreplymessage();
+		netReply->set_requestid(request.requestId);
+		netReply->set_gameid(request.gameId);
+		netReply->set_cleanerchattype(static_cast<CleanerChatType>(request.chatType));
+		netReply->set_playerid(request.playerId);
+
+		if(checkAction == "warn") {
+			netReply->set_cleaneractiontype(CleanerChatReplyMessage_CleanerActionType_cleanerActionWarning);
+		} else if (checkAction == "kick") {
+			netReply->set_cleaneractiontype(CleanerChatReplyMessage_CleanerActionType_cleanerActionKick);
+		} else if (checkAction == "kickban") {
+			netReply->set_cleaneractiontype(CleanerChatReplyMessage_CleanerActionType_cleanerActionBan);
+		} else if (checkAction == "mute") {
+			netReply->set_cleaneractiontype(CleanerChatReplyMessage_CleanerActionType_cleanerActionMute);
+		}
+
+		netReply->set_cleanertext(checkMessage.toUtf8());
+		tmpConnection->sendMessageToClient(*tmpReply);
 	}
 }
 
@@ -226,14 +188,3 @@ void CleanerServer::refreshConfig()
 
 	myMessageFilter->refreshConfig();
 }
-
-void CleanerServer::sendMessageToClient(ChatCleanerMessage &msg)
-{
-	uint32_t packetSize = msg.ByteSize();
-	google::protobuf::uint8 *buf = new google::protobuf::uint8[packetSize + CLEANER_NET_HEADER_SIZE];
-	*((uint32_t *)buf) = qToBigEndian(packetSize);
-	msg.SerializeWithCachedSizesToArray(&buf[CLEANER_NET_HEADER_SIZE]);
-	tcpSocket->write((const char *)buf, packetSize + CLEANER_NET_HEADER_SIZE);
-	delete[] buf;
-}
-
@@ -40,8 +40,23 @@
 
 class MessageFilter;
 class CleanerConfig;
+class CleanerConnection;
 class ChatCleanerMessage;
 
+// A chat line on its way through the worker pool.
+struct CleanerChatRequest {
+	unsigned connectionId;
+	unsigned requestId;
+	int chatType;
+	unsigned gameId;
+	unsigned playerId;
+	QString nick;
+	QString message;
+	bool textFlood;
+	int offence;
+};
+Q_DECLARE_METATYPE(CleanerChatRequest)
+
 class CleanerServer: public QObject
 {
 	Q_OBJECT
@@ -50,27 +65,36 @@ public:
 	CleanerServer();
 	~CleanerServer();
 
+	const QString &getClientSecret() const {
+		return clientSecret;
+	}
+	const QString &getServerSecret() const {
+		return serverSecret;
+	}
+
+	void queueChatRequest(CleanerChatRequest request);
+
+public slots:
+	void chatRequestChecked(CleanerChatRequest request);
+
 private slots:
 	void newCon();
-	void onRead();
-	bool handleMessage(ChatCleanerMessage &msg);
-	void socketStateChanged(QAbstractSocket::SocketState);
+	void connectionClosed(unsigned connectionId);
 	void refreshConfig();
-	void sendMessageToClient(ChatCleanerMessage &msg);
 
 private:
 	QTcpServer *tcpServer;
-	QTcpSocket *tcpSocket;
 	QTimer *configRefreshTimer;
 	MessageFilter *myMessageFilter;
+	QThreadPool *workerPool;
 
 	CleanerConfig *config;
-	bool blockConnection;
 	QString clientSecret;
 	QString serverSecret;
 
-	unsigned char m_recvBuf[2*MAX_CLEANER_PACKET_SIZE];
-	size_t m_recvBufUsed;
+	QHash<unsigned, CleanerConnection *> connections;
+	unsigned lastConnectionId;
+	int maxConnections;
 
 	int secondsSinceLastConfigChange;
 };
@@ -37,7 +37,7 @@ LetterRepeatingCheck::LetterRepeatingCheck()
 {
 }
 
-bool LetterRepeatingCheck::run(QString msg)
+bool LetterRepeatingCheck::run(QString msg) const
 {
 	msg = msg.simplified().remove(" ");
 	QRegExp e(QString(".*(.)\\1{%1,}.*").arg(letterNumberToTrigger-1));
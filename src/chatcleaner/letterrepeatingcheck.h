@@ -42,7 +42,7 @@ public:
 	void setLetterNumberToTrigger(int n) {
 		letterNumberToTrigger = n;
 	}
-	bool run(QString);
+	bool run(QString) const;
 
 private:
 
@@ -37,6 +37,7 @@
 #include "capsfloodcheck.h"
 #include "letterrepeatingcheck.h"
 #include "urlcheck.h"
+#include <core/multipatternmatcher.h>
 
 enum ActionType {
 	NOTHING,
@@ -46,15 +47,6 @@ enum ActionType {
 	MUTE
 };
 
-enum OffenceType {
-	NONE,
-	BAD_WORD,
-	TEXT_FLOOD_LINES,
-	CAPS_FLOOD,
-	LETTER_REPEATING,
-	URL
-};
-
 MessageFilter::MessageFilter(CleanerConfig *c): config(c)
 {
 	myBadWordCheck = new BadWordCheck;
@@ -62,6 +54,7 @@ MessageFilter::MessageFilter(CleanerConfig *c): config(c)
 	myCapsFloodCheck = new CapsFloodCheck;
 	myLetterRepeatingCheck = new LetterRepeatingCheck;
 	myUrlCheck = new UrlCheck;
+	myPatternMatcher = new MultiPatternMatcher;
 
 	cleanTimer = new QTimer();
 	connect(cleanTimer, SIGNAL(timeout()), this, SLOT(cleanKickCounterList()));
@@ -76,34 +69,49 @@ MessageFilter::~MessageFilter()
 	delete myCapsFloodCheck;
 	delete myLetterRepeatingCheck;
 	delete myUrlCheck;
+	delete myPatternMatcher;
 	delete cleanTimer;
 }
 
-QStringList MessageFilter::check(unsigned gameId, unsigned playerId, QString nick, QString msg)
+OffenceType MessageFilter::checkContent(const QString &msg) const
 {
-	QStringList returnList;
-	QString returnMessage;
-	QString returnAction;
-
 	OffenceType offence = NONE;
+	QReadLocker lock(&myConfigLock);
+
+	// Find all bad words, url strings and their exceptions in one pass.
+	std::vector<char> patternHits;
+	myPatternMatcher->FindAll(msg.toLower().toUtf8().constData(), patternHits);
 
-	if(myBadWordCheck->run(msg)) offence = BAD_WORD;
+	if(myBadWordCheck->run(patternHits)) offence = BAD_WORD;
 	if(myCapsFloodCheck->run(msg)) offence = CAPS_FLOOD;
 	if(myLetterRepeatingCheck->run(msg)) offence = LETTER_REPEATING;
-	if(myUrlCheck->run(msg)) offence = URL;
-	if(myTextFloodCheck->run(playerId)) offence = TEXT_FLOOD_LINES;
+	if(myUrlCheck->run(patternHits)) offence = URL;
+
+	return offence;
+}
+
+bool MessageFilter::checkTextFlood(quint64 clientId)
+{
+	return myTextFloodCheck->run(clientId);
+}
+
+QStringList MessageFilter::handleOffence(unsigned gameId, quint64 clientId, QString nick, OffenceType offence)
+{
+	QStringList returnList;
+	QString returnMessage;
+	QString returnAction;
 
 	if(offence) {
 
 		ActionType action = NOTHING;
-		QMap<unsigned, ClientWarnInfos>::const_iterator i = myClientWarnLevelList.find(playerId);
+		QHash<quint64, ClientWarnInfos>::const_iterator i = myClientWarnLevelList.find(clientId);
 
 		if(i == myClientWarnLevelList.end()) {
 			ClientWarnInfos tmpInfos;
 			tmpInfos.warnLevel = 1;
 			tmpInfos.lastWarnType = offence;
 			tmpInfos.nick = nick;
-			myClientWarnLevelList.insert(playerId, tmpInfos);
+			myClientWarnLevelList.insert(clientId, tmpInfos);
 			action = WARN;
 		} else {
 			if(i.value().warnLevel == warnLevelToKick || i.value().lastWarnType == offence) {
@@ -111,14 +119,14 @@ QStringList MessageFilter::check(unsigned gameId, unsigned playerId, QString nic
 					//check for ingame to do not kick but mute
 					action = MUTE;
 					//remove playerId from all lists and as LAST from myClientWarnLevelList
-					myTextFloodCheck->removeNickFromList(i.key());
-					myClientWarnLevelList.remove(i.key());
+					myTextFloodCheck->removeNickFromList(clientId);
+					myClientWarnLevelList.remove(clientId);
 				} else {
 					//				Kick Command
 					action = KICK;
 					//remove playerId from all lists and as LAST from myClientWarnLevelList
-					myTextFloodCheck->removeNickFromList(i.key());
-					myClientWarnLevelList.remove(i.key());
+					myTextFloodCheck->removeNickFromList(clientId);
+					myClientWarnLevelList.remove(clientId);
 					//check if player is already on kickCounterList
 					QMap<QString, ClientKickInfos>::const_iterator j = myClientKickCounterList.find(nick);
 					if(j == myClientKickCounterList.end()) {
@@ -146,7 +154,7 @@ QStringList MessageFilter::check(unsigned gameId, unsigned playerId, QString nic
 				tmpInfos.warnLevel = i.value().warnLevel+1;
 				tmpInfos.lastWarnType = offence;
 				tmpInfos.nick = nick;
-				myClientWarnLevelList.insert(playerId, tmpInfos);
+				myClientWarnLevelList.insert(clientId, tmpInfos);
 				action = WARN;
 			}
 		}
@@ -199,6 +207,7 @@ QStringList MessageFilter::check(unsigned gameId, unsigned playerId, QString nic
 
 void MessageFilter::refreshConfig()
 {
+	QWriteLocker lock(&myConfigLock);
 
 	//	global settings
 	warnLevelToKick = config->readConfigInt("WarnLevelToKick");
@@ -238,6 +247,20 @@ void MessageFilter::refreshConfig()
 	}
 	myUrlCheck->setUrlExceptionStrings(urlExceptionList);
 
+	// Rebuild the pattern matcher only if the word lists have changed.
+	QList<QStringList> patternConfig;
+	patternConfig.append(bwList);
+	patternConfig.append(bweList);
+	patternConfig.append(urlList);
+	patternConfig.append(urlExceptionList);
+	if(patternConfig != myPatternConfig) {
+		myPatternMatcher->Clear();
+		myBadWordCheck->addPatterns(*myPatternMatcher);
+		myUrlCheck->addPatterns(*myPatternMatcher);
+		myPatternMatcher->Build();
+		myPatternConfig = patternConfig;
+	}
+
 	myTextFloodCheck->setTextFloodLevelToTrigger(config->readConfigInt("TextFloodLevelToTrigger"));
 	myCapsFloodCheck->setCapsNumberToTrigger(config->readConfigInt("CapsFloodCapsNumberToTrigger"));
 	myLetterRepeatingCheck->setLetterNumberToTrigger(config->readConfigInt("LetterRepeatingNumberToTrigger"));
@@ -43,6 +43,16 @@ class CleanerConfig;
 class CapsFloodCheck;
 class LetterRepeatingCheck;
 class UrlCheck;
+class MultiPatternMatcher;
+
+enum OffenceType {
+	NONE,
+	BAD_WORD,
+	TEXT_FLOOD_LINES,
+	CAPS_FLOOD,
+	LETTER_REPEATING,
+	URL
+};
 
 class MessageFilter: public QObject
 {
@@ -51,7 +61,12 @@ public:
 	MessageFilter(CleanerConfig*);
 	~MessageFilter();
 
-	QStringList check(unsigned, unsigned, QString, QString);
+	// Content checks, these may run concurrently on worker threads.
+	OffenceType checkContent(const QString &msg) const;
+	// Flood check and warn level handling, these need to run on the main thread.
+	bool checkTextFlood(quint64 clientId);
+	QStringList handleOffence(unsigned gameId, quint64 clientId, QString nick, OffenceType offence);
+
 	void refreshConfig();
 
 public slots:
@@ -63,6 +78,9 @@ private:
 	CapsFloodCheck *myCapsFloodCheck;
 	LetterRepeatingCheck *myLetterRepeatingCheck;
 	UrlCheck *myUrlCheck;
+	MultiPatternMatcher *myPatternMatcher;
+	QList<QStringList> myPatternConfig;
+	mutable QReadWriteLock myConfigLock;
 
 	struct ClientWarnInfos {
 		QString nick;
@@ -75,7 +93,7 @@ private:
 		int kickNumber;
 	};
 
-	QMap<unsigned, ClientWarnInfos> myClientWarnLevelList;
+	QHash<quint64, ClientWarnInfos> myClientWarnLevelList;
 	QMap<QString, ClientKickInfos> myClientKickCounterList;
 
 	int warnLevelToKick;
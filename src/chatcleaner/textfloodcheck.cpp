@@ -32,6 +32,7 @@
 #include <QtCore>
 
 TextFloodCheck::TextFloodCheck()
+	: textFloodLevelToTrigger(0)
 {
 	timer.reset();
 	timer.start();
@@ -40,7 +41,7 @@ TextFloodCheck::TextFloodCheck()
 
 	connect(cleanTimer, SIGNAL(timeout()), this, SLOT(cleanMsgTimesList()));
 
-	cleanTimer->start(4000);
+	cleanTimer->start(30000);
 
 }
 
@@ -49,74 +50,50 @@ TextFloodCheck::~TextFloodCheck()
 	delete cleanTimer;
 }
 
-bool TextFloodCheck::run(unsigned playerId)
+bool TextFloodCheck::run(quint64 clientId)
 {
+	size_t now = timer.elapsed().total_seconds();
+	QHash<quint64, TextFloodInfos>::iterator i = msgTimesList.find(clientId);
 
-	QMapIterator<unsigned, TextFloodInfos> it(msgTimesList);
-	while (it.hasNext()) {
-		it.next();
-//		 qDebug() << "counter: " << msgTimesList.count() << " playerid: " << it.key() << " floodlevel: " << it.value().floodLevel << " timestamp: " <<  it.value().timeStamp;
+	if(i == msgTimesList.end()) {
+		TextFloodInfos tmpInfos;
+		tmpInfos.floodLevel = 0;
+		tmpInfos.timeStamp = now;
+		msgTimesList.insert(clientId, tmpInfos);
+		return false;
 	}
 
-	QMap<unsigned, TextFloodInfos>::const_iterator i = msgTimesList.find(playerId);
-
-	if(i == msgTimesList.end()) {
-		TextFloodInfos tmpInfos1;
-		tmpInfos1.floodLevel = 0;
-		tmpInfos1.timeStamp = timer.elapsed().total_seconds();
-		msgTimesList.insert(playerId, tmpInfos1);
-		qDebug () << "Add Player: set player floodlevel to " << tmpInfos1.floodLevel;
-	} else {
-		TextFloodInfos tmpInfos2;
-		if(timer.elapsed().total_seconds()-i.value().timeStamp <= 1) {
-			if(i.value().floodLevel == textFloodLevelToTrigger) {
-				TextFloodInfos tmpInfos3;
-				tmpInfos3.floodLevel = i.value().floodLevel-1;
-				tmpInfos3.timeStamp = timer.elapsed().total_seconds();
-				qDebug () << "Trigger: set player floodlevel to " << tmpInfos3.floodLevel;
-				msgTimesList.insert(playerId, tmpInfos3);
-				return true;
-			} else {
-				tmpInfos2.floodLevel = i.value().floodLevel+1;
-				qDebug () << "Raise: set player floodlevel to " << tmpInfos2.floodLevel << " from " << i.value().floodLevel;
-			}
+	bool retVal = false;
+	TextFloodInfos &infos = i.value();
+	size_t idleSeconds = now - infos.timeStamp;
+	// The flood level drops by one for every decay interval without messages.
+	infos.floodLevel = qMax(0, infos.floodLevel - static_cast<int>(idleSeconds / TEXT_FLOOD_DECAY_SECONDS));
+	if(idleSeconds <= 1) {
+		if(infos.floodLevel >= textFloodLevelToTrigger) {
+			infos.floodLevel = textFloodLevelToTrigger-1;
+			retVal = true;
 		} else {
-			tmpInfos2.floodLevel = i.value().floodLevel;
-			qDebug () << "Keep: player floodlevel is " << tmpInfos2.floodLevel << " from " << i.value().floodLevel;
+			infos.floodLevel++;
 		}
-
-		tmpInfos2.timeStamp = timer.elapsed().total_seconds();
-		msgTimesList.insert(playerId, tmpInfos2);
 	}
-	return false;
+	infos.timeStamp = now;
+	return retVal;
 }
 
 void TextFloodCheck::cleanMsgTimesList()
 {
-
-	QMapIterator<unsigned, TextFloodInfos> it(msgTimesList);
+	// Remove all players whose flood level has decayed to zero.
+	size_t now = timer.elapsed().total_seconds();
+	QMutableHashIterator<quint64, TextFloodInfos> it(msgTimesList);
 	while (it.hasNext()) {
 		it.next();
-		if(timer.elapsed().total_seconds()-it.value().timeStamp > 3) {
-
-			if(it.value().floodLevel == 0) {
-				msgTimesList.remove(it.key());
-				qDebug () << "Refresh: player removed from List";
-			} else {
-				TextFloodInfos tmpInfos;
-				tmpInfos.floodLevel = it.value().floodLevel-1;
-				tmpInfos.timeStamp = it.value().timeStamp;
-				qDebug () << "Refresh: player floodlevel to " << tmpInfos.floodLevel;
-				msgTimesList.insert(it.key(), tmpInfos);
-			}
+		if(now-it.value().timeStamp >= static_cast<size_t>(TEXT_FLOOD_DECAY_SECONDS * (it.value().floodLevel+1))) {
+			it.remove();
 		}
-//		qDebug() << msgTimesList.count() << it.key() << ": " << it.value().floodLevel << it.value().timeStamp << endl;
 	}
 }
 
-void TextFloodCheck::removeNickFromList(unsigned playerId)
+void TextFloodCheck::removeNickFromList(quint64 clientId)
 {
-
-//	qDebug() << "id " << playerId << "removed from textfloodcheck list" << endl;
-	msgTimesList.remove(playerId);
+	msgTimesList.remove(clientId);
 }
@@ -37,6 +37,7 @@
 #endif
 #include <stdlib.h>
 
+#define TEXT_FLOOD_DECAY_SECONDS	4
 
 class TextFloodCheck: public QObject
 {
@@ -49,11 +50,11 @@ public:
 		textFloodLevelToTrigger = level;
 	}
 
-	bool run(unsigned);
+	bool run(quint64);
 
 public slots:
 	void cleanMsgTimesList();
-	void removeNickFromList(unsigned);
+	void removeNickFromList(quint64);
 
 private:
 	QTimer *cleanTimer;
@@ -62,7 +63,7 @@ private:
 		int floodLevel;
 		size_t timeStamp;
 	};
-	QMap<unsigned, TextFloodInfos> msgTimesList;
+	QHash<quint64, TextFloodInfos> msgTimesList;
 
 	int textFloodLevelToTrigger;
 };
@@ -31,31 +31,42 @@
 #include "urlcheck.h"
 
 #include <QtCore>
+#include <core/multipatternmatcher.h>
 
-UrlCheck::UrlCheck()
+UrlCheck::UrlCheck(): firstUrlId(0), firstExceptionId(0)
 {
 }
 
-bool UrlCheck::run(QString msg)
+void UrlCheck::addPatterns(MultiPatternMatcher &matcher)
 {
-	msg = msg.toLower();
-
+	firstUrlId = matcher.GetNumPatterns();
 	QStringListIterator it1(urlStrings);
-
 	while (it1.hasNext()) {
-		if(msg.contains(it1.next())) {
-			QStringListIterator it2(urlExceptionStrings);
-			bool exception = false;
-			while (it2.hasNext()) {
-				if(msg.contains(it2.next())) {
-					exception = true;
-					break;
-				}
-			}
-			if(!exception) {
-				return true;
+		matcher.AddPattern(it1.next().toUtf8().constData());
+	}
+
+	firstExceptionId = matcher.GetNumPatterns();
+	QStringListIterator it2(urlExceptionStrings);
+	while (it2.hasNext()) {
+		matcher.AddPattern(it2.next().toUtf8().constData());
+	}
+}
+
+bool UrlCheck::run(const std::vector<char> &patternHits) const
+{
+	bool url = false;
+	for(int i = 0; i < urlStrings.size(); i++) {
+		if(patternHits[firstUrlId + i]) {
+			url = true;
+			break;
+		}
+	}
+	if(url) {
+		for(int i = 0; i < urlExceptionStrings.size(); i++) {
+			if(patternHits[firstExceptionId + i]) {
+				return false;
 			}
 		}
 	}
-	return false;
+	return url;
 }
@@ -32,6 +32,9 @@
 #define URLCHECK_H
 
 #include <QtCore>
+#include <vector>
+
+class MultiPatternMatcher;
 
 class UrlCheck: public QObject
 {
@@ -45,12 +48,19 @@ public:
 	void setUrlExceptionStrings(QStringList ues) {
 		urlExceptionStrings = ues;
 	}
-	bool run(QString);
+
+	// Adds url strings and exceptions to the (not yet built) matcher.
+	void addPatterns(MultiPatternMatcher &matcher);
+	// Evaluates the pattern hits of a lowercase message.
+	bool run(const std::vector<char> &patternHits) const;
 
 private:
 
 	QStringList urlStrings;
 	QStringList urlExceptionStrings;
+
+	unsigned firstUrlId;
+	unsigned firstExceptionId;
 };
 
 #endif // URLCHECK_H
@@ -51,10 +51,16 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include <boost/bind.hpp>
+
+// Delay before a requested write is done, further requests restart the delay.
+#define CONFIG_WRITE_DELAY_MSEC		500
+
 using namespace std;
 
 
-ConfigFile::ConfigFile(char *argv0, bool readonly) : noWriteAccess(readonly)
+ConfigFile::ConfigFile(char *argv0, bool readonly)
+	: m_writeRequestCounter(0), m_writePending(false), m_writeQuit(false), m_fileDeleted(false), noWriteAccess(readonly)
 {
 
 	myArgv0 = argv0;
@@ -64,7 +70,7 @@ ConfigFile::ConfigFile(char *argv0, bool readonly) : noWriteAccess(readonly)
 	myConfigState = OK;
 
 	// !!!! Revisionsnummer der Configdefaults !!!!!
-	configRev = 104;
+	configRev = 108;
 
 	//standard defaults
 	logOnOffDefault = "1";
@@ -163,6 +169,7 @@ ConfigFile::ConfigFile(char *argv0, bool readonly) : noWriteAccess(readonly)
 	configList.push_back(ConfigInfo("AccidentallyCallBlocker", CONFIG_TYPE_INT, "1"));
 	configList.push_back(ConfigInfo("DontHideAvatarsOfIgnored", CONFIG_TYPE_INT, "0"));
 	configList.push_back(ConfigInfo("DisableChatEmoticons", CONFIG_TYPE_INT, "0"));
+	configList.push_back(ConfigInfo("ChatScrollbackLines", CONFIG_TYPE_INT, "1000"));
 	configList.push_back(ConfigInfo("AntiPeekMode", CONFIG_TYPE_INT, "0"));
 	configList.push_back(ConfigInfo("AlternateFKeysUserActionMode", CONFIG_TYPE_INT, "0"));
 	configList.push_back(ConfigInfo("EnableBetInputFocusSwitch", CONFIG_TYPE_INT, "0"));
@@ -225,6 +232,13 @@ ConfigFile::ConfigFile(char *argv0, bool readonly) : noWriteAccess(readonly)
 	configList.push_back(ConfigInfo("ServerWebSocketPort", CONFIG_TYPE_INT, "7233"));
 	configList.push_back(ConfigInfo("ServerWebSocketResource", CONFIG_TYPE_STRING, ""));
 	configList.push_back(ConfigInfo("ServerWebSocketOrigin", CONFIG_TYPE_STRING, ""));
+	configList.push_back(ConfigInfo("ServerWebSocketCompression", CONFIG_TYPE_INT, "1"));
+	configList.push_back(ConfigInfo("ServerWebSocketDeflateWindowBits", CONFIG_TYPE_INT, "12"));
+	configList.push_back(ConfigInfo("ServerWebSocketDeflateMemLevel", CONFIG_TYPE_INT, "5"));
+	configList.push_back(ConfigInfo("ServerWebSocketDeflateMinSize", CONFIG_TYPE_INT, "64"));
+	configList.push_back(ConfigInfo("ServerMetricsPort", CONFIG_TYPE_INT, "0"));
+	configList.push_back(ConfigInfo("ServerMetricsAddress", CONFIG_TYPE_STRING, "127.0.0.1"));
+	configList.push_back(ConfigInfo("ServerAiWorkerThreads", CONFIG_TYPE_INT, "2"));
 	configList.push_back(ConfigInfo("ServerUsePutAvatars", CONFIG_TYPE_INT, "0"));
 	configList.push_back(ConfigInfo("ServerPutAvatarsAddress", CONFIG_TYPE_STRING, ""));
 	configList.push_back(ConfigInfo("ServerPutAvatarsUser", CONFIG_TYPE_STRING, ""));
@@ -314,6 +328,7 @@ ConfigFile::ConfigFile(char *argv0, bool readonly) : noWriteAccess(readonly)
 
 	//fill tempList firstTime
 	configBufferList = configList;
+	buildIndex();
 
 	// 	cout << configTempList[3].name << " " << configTempList[10].defaultValue << endl;
 
@@ -364,16 +379,71 @@ ConfigFile::ConfigFile(char *argv0, bool readonly) : noWriteAccess(readonly)
 
 ConfigFile::~ConfigFile()
 {
+	{
+		boost::mutex::scoped_lock lock(m_writeMutex);
+		m_writeQuit = true;
+	}
+	m_writeCond.notify_all();
+	if (m_writeThread.joinable()) {
+		m_writeThread.join();
+	}
+	flushBuffer();
+
 	delete myQtToolsInterface;
 	myQtToolsInterface = 0;
 
 }
 
 
+void ConfigFile::ConfigInfo::updateIntValues()
+{
+	istringstream isst;
+	isst.str(defaultValue);
+	intValue = 0;
+	isst >> intValue;
+
+	intListValue.clear();
+	list<string>::const_iterator it;
+	for(it = defaultListValue.begin(); it != defaultListValue.end(); ++it) {
+		int tempInt = 0;
+		isst.str(*it);
+		isst.clear();
+		isst >> tempInt;
+		intListValue.push_back(tempInt);
+	}
+}
+
+void ConfigFile::buildIndex()
+{
+	configIndex.clear();
+	for (size_t i=0; i<configBufferList.size(); i++) {
+		configIndex[configBufferList[i].name] = i;
+		configBufferList[i].updateIntValues();
+	}
+}
+
+const ConfigFile::ConfigInfo *ConfigFile::findConfig(const string &varName) const
+{
+	ConfigIndexMap::const_iterator pos = configIndex.find(varName);
+	if (pos != configIndex.end()) {
+		return &configBufferList[pos->second];
+	}
+	return NULL;
+}
+
+ConfigFile::ConfigInfo *ConfigFile::findConfig(const string &varName)
+{
+	ConfigIndexMap::const_iterator pos = configIndex.find(varName);
+	if (pos != configIndex.end()) {
+		return &configBufferList[pos->second];
+	}
+	return NULL;
+}
+
 void ConfigFile::fillBuffer()
 {
 
-	boost::recursive_mutex::scoped_lock lock(m_configMutex);
+	boost::unique_lock<boost::shared_mutex> lock(m_configMutex);
 
 	string tempString1("");
 	string tempString2("");
@@ -414,6 +484,7 @@ void ConfigFile::fillBuffer()
 			} else {
 				LOG_ERROR("Could not find the root element in the config file!");
 			}
+			configBufferList[i].updateIntValues();
 
 			// 			cout << configBufferList[i].name << " " << configBufferList[i].defaultValue << endl;
 		}
@@ -422,7 +493,6 @@ void ConfigFile::fillBuffer()
 
 void ConfigFile::checkAndCorrectBuffer()
 {
-	boost::recursive_mutex::scoped_lock lock(m_configMutex);
 	// For now, only the player names are checked.
 	checkAndCorrectPlayerNames();
 }
@@ -453,22 +523,75 @@ void ConfigFile::checkAndCorrectPlayerNames()
 
 void ConfigFile::writeBuffer() const
 {
+	if(noWriteAccess) {
+		return;
+	}
 
-	boost::recursive_mutex::scoped_lock lock(m_configMutex);
+	boost::mutex::scoped_lock lock(m_writeMutex);
+	if (m_writeQuit) {
+		return;
+	}
+	m_writePending = true;
+	m_writeRequestCounter++;
+	if (!m_writeThread.joinable()) {
+		m_writeThread = boost::thread(boost::bind(&ConfigFile::writerThreadProc, this));
+	}
+	m_writeCond.notify_one();
+}
 
-	//write buffer to disc if enabled
-	if(!noWriteAccess) {
-		TiXmlDocument doc;
-		TiXmlDeclaration * decl = new TiXmlDeclaration( "1.0", "UTF-8", "");
-		doc.LinkEndChild( decl );
+void ConfigFile::flushBuffer() const
+{
+	{
+		boost::mutex::scoped_lock lock(m_writeMutex);
+		if (!m_writePending) {
+			return;
+		}
+		m_writePending = false;
+	}
+	saveBuffer();
+}
 
-		TiXmlElement * root = new TiXmlElement( "PokerTH" );
-		doc.LinkEndChild( root );
+void ConfigFile::writerThreadProc() const
+{
+	boost::mutex::scoped_lock lock(m_writeMutex);
+	while (!m_writeQuit) {
+		if (!m_writePending) {
+			m_writeCond.wait(lock);
+			continue;
+		}
+		// Wait until no further writes are requested for a short time.
+		unsigned requestCounter = m_writeRequestCounter;
+		m_writeCond.timed_wait(lock, boost::posix_time::milliseconds(CONFIG_WRITE_DELAY_MSEC));
+		if (m_writeQuit || requestCounter != m_writeRequestCounter || !m_writePending) {
+			continue;
+		}
+		m_writePending = false;
+		lock.unlock();
+		saveBuffer();
+		lock.lock();
+	}
+}
 
-		TiXmlElement * config;
-		config = new TiXmlElement( "Configuration" );
-		root->LinkEndChild( config );
+void ConfigFile::saveBuffer() const
+{
+	boost::mutex::scoped_lock saveLock(m_saveMutex);
+	if (m_fileDeleted) {
+		return;
+	}
 
+	TiXmlDocument doc;
+	TiXmlDeclaration * decl = new TiXmlDeclaration( "1.0", "UTF-8", "");
+	doc.LinkEndChild( decl );
+
+	TiXmlElement * root = new TiXmlElement( "PokerTH" );
+	doc.LinkEndChild( root );
+
+	TiXmlElement * config;
+	config = new TiXmlElement( "Configuration" );
+	root->LinkEndChild( config );
+
+	{
+		boost::shared_lock<boost::shared_mutex> lock(m_configMutex);
 		size_t i;
 
 		for (i=0; i<configBufferList.size(); i++) {
@@ -490,15 +613,29 @@ void ConfigFile::writeBuffer() const
 
 			}
 		}
+	}
 
-		doc.SaveFile( configFileName );
+	// Write to a temporary file and replace the config file afterwards, so that
+	// the config file is never left half written.
+	string tmpFileName(configFileName + ".tmp");
+	if (doc.SaveFile( tmpFileName )) {
+#ifdef _WIN32
+		if (!MoveFileExA(tmpFileName.c_str(), configFileName.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+#else
+		if (rename(tmpFileName.c_str(), configFileName.c_str()) != 0) {
+#endif
+			LOG_ERROR("Cannot write config file: Unable to replace " << configFileName);
+			remove(tmpFileName.c_str());
+		}
+	} else {
+		LOG_ERROR("Cannot write config file: " << tmpFileName);
 	}
 }
 
 void ConfigFile::updateConfig(ConfigState myConfigState)
 {
 
-	boost::recursive_mutex::scoped_lock lock(m_configMutex);
+	boost::unique_lock<boost::shared_mutex> lock(m_configMutex);
 
 	size_t i;
 
@@ -666,164 +803,123 @@ void ConfigFile::updateConfig(ConfigState myConfigState)
 
 ConfigState ConfigFile::getConfigState() const
 {
-	boost::recursive_mutex::scoped_lock lock(m_configMutex);
+	boost::shared_lock<boost::shared_mutex> lock(m_configMutex);
 	return myConfigState;
 }
 
 string ConfigFile::readConfigString(string varName) const
 {
-	boost::recursive_mutex::scoped_lock lock(m_configMutex);
+	boost::shared_lock<boost::shared_mutex> lock(m_configMutex);
 
-	size_t i;
 	string tempString("");
-
-	for (i=0; i<configBufferList.size(); i++) {
-
-		if (configBufferList[i].name == varName) {
-			tempString = configBufferList[i].defaultValue;
-		}
+	const ConfigInfo *info = findConfig(varName);
+	if (info) {
+		tempString = info->defaultValue;
 	}
-
 	return tempString;
 }
 
 int ConfigFile::readConfigInt(string varName) const
 {
-	boost::recursive_mutex::scoped_lock lock(m_configMutex);
+	boost::shared_lock<boost::shared_mutex> lock(m_configMutex);
 
-	size_t i;
-	string tempString("");
 	int tempInt=0;
-
-	for (i=0; i<configBufferList.size(); i++) {
-
-		if (configBufferList[i].name == varName) {
-			tempString = configBufferList[i].defaultValue;
-		}
+	const ConfigInfo *info = findConfig(varName);
+	if (info) {
+		tempInt = info->intValue;
 	}
-
-	istringstream isst;
-	isst.str (tempString);
-	isst >> tempInt;
-
 	return tempInt;
 }
 
 list<int> ConfigFile::readConfigIntList(string varName) const
 {
-	boost::recursive_mutex::scoped_lock lock(m_configMutex);
+	boost::shared_lock<boost::shared_mutex> lock(m_configMutex);
 
-	size_t i;
-	list<string> tempStringList;
 	list<int> tempIntList;
-
-	for (i=0; i<configBufferList.size(); i++) {
-
-		if (configBufferList[i].name == varName) {
-			tempStringList = configBufferList[i].defaultListValue;
-		}
+	const ConfigInfo *info = findConfig(varName);
+	if (info) {
+		tempIntList = info->intListValue;
 	}
-
-	istringstream isst;
-	int tempInt;
-	list<string>::iterator it;
-	for(it = tempStringList.begin(); it != tempStringList.end(); ++it) {
-
-		isst.str(*it);
-		isst >> tempInt;
-		tempIntList.push_back(tempInt);
-		isst.str("");
-		isst.clear();
-	}
-
 	return tempIntList;
 }
 
 list<string> ConfigFile::readConfigStringList(string varName) const
 {
-	boost::recursive_mutex::scoped_lock lock(m_configMutex);
+	boost::shared_lock<boost::shared_mutex> lock(m_configMutex);
 
-	size_t i;
 	list<string> tempStringList;
-
-	for (i=0; i<configBufferList.size(); i++) {
-
-		if (configBufferList[i].name == varName) {
-			tempStringList = configBufferList[i].defaultListValue;
-		}
+	const ConfigInfo *info = findConfig(varName);
+	if (info) {
+		tempStringList = info->defaultListValue;
 	}
-
 	return tempStringList;
 }
 
 void ConfigFile::writeConfigInt(string varName, int varCont)
 {
-	boost::recursive_mutex::scoped_lock lock(m_configMutex);
-
-	size_t i;
-	ostringstream intToString;
-
-	for (i=0; i<configBufferList.size(); i++) {
-
-		if (configBufferList[i].name == varName) {
-			intToString << varCont;
-			configBufferList[i].defaultValue = intToString.str();
-		}
+	boost::unique_lock<boost::shared_mutex> lock(m_configMutex);
+
+	ConfigInfo *info = findConfig(varName);
+	if (info) {
+		ostringstream intToString;
+		intToString << varCont;
+		info->defaultValue = intToString.str();
+		info->intValue = varCont;
 	}
 }
 
 void ConfigFile::writeConfigIntList(string varName, list<int> varCont)
 {
-	boost::recursive_mutex::scoped_lock lock(m_configMutex);
-
-	size_t i;
-	ostringstream intToString;
-	list<string> stringList;
-
-	for (i=0; i<configBufferList.size(); i++) {
-
-		if (configBufferList[i].name == varName) {
-			list<int>::iterator it;
-			for(it = varCont.begin(); it != varCont.end(); ++it) {
-
-				intToString << (*it);
-				stringList.push_back(intToString.str());
-				intToString.str("");
-				intToString.clear();
-			}
-
-			configBufferList[i].defaultListValue = stringList;
+	boost::unique_lock<boost::shared_mutex> lock(m_configMutex);
+
+	ConfigInfo *info = findConfig(varName);
+	if (info) {
+		ostringstream intToString;
+		list<string> stringList;
+		list<int>::iterator it;
+		for(it = varCont.begin(); it != varCont.end(); ++it) {
+
+			intToString << (*it);
+			stringList.push_back(intToString.str());
+			intToString.str("");
+			intToString.clear();
 		}
+
+		info->defaultListValue = stringList;
+		info->intListValue = varCont;
 	}
 }
 
 void ConfigFile::writeConfigString(string varName, string varCont)
 {
-	boost::recursive_mutex::scoped_lock lock(m_configMutex);
+	boost::unique_lock<boost::shared_mutex> lock(m_configMutex);
 
-	size_t i;
-	for (i=0; i<configBufferList.size(); i++) {
-		if (configBufferList[i].name == varName) {
-			configBufferList[i].defaultValue = varCont;
-		}
+	ConfigInfo *info = findConfig(varName);
+	if (info) {
+		info->defaultValue = varCont;
+		info->updateIntValues();
 	}
-
 }
 
 void ConfigFile::writeConfigStringList(string varName, list<string> varCont)
 {
-	boost::recursive_mutex::scoped_lock lock(m_configMutex);
-
-	size_t i;
-	for (i=0; i<configBufferList.size(); i++) {
+	boost::unique_lock<boost::shared_mutex> lock(m_configMutex);
 
-		if (configBufferList[i].name == varName) {
-			configBufferList[i].defaultListValue = varCont;
-		}
+	ConfigInfo *info = findConfig(varName);
+	if (info) {
+		info->defaultListValue = varCont;
+		info->updateIntValues();
 	}
 }
 
 void ConfigFile::deleteConfigFile()
 {
+	// Drop pending writes, they would create the file again.
+	{
+		boost::mutex::scoped_lock lock(m_writeMutex);
+		m_writePending = false;
+	}
+	boost::mutex::scoped_lock saveLock(m_saveMutex);
+	m_fileDeleted = true;
 	remove(configFileName.c_str());
 }
@@ -34,9 +34,11 @@
 
 #include <vector>
 #include <string>
+#include <list>
 
 #ifndef Q_MOC_RUN
 #include <boost/thread.hpp>
+#include <boost/unordered_map.hpp>
 #endif
 
 enum ConfigState { NONEXISTING, OLD, OK };
@@ -53,7 +55,10 @@ public:
 
 	void fillBuffer();
 	void checkAndCorrectBuffer();
+	// Schedule writing the buffer to disk. Writes are delayed and done in the background.
 	void writeBuffer() const;
+	// Write pending changes now.
+	void flushBuffer() const;
 
 	void updateConfig(ConfigState);
 	ConfigState getConfigState() const;
@@ -71,21 +76,44 @@ public:
 protected:
 	void checkAndCorrectPlayerNames();
 
+	void buildIndex();
+	void writerThreadProc() const;
+	void saveBuffer() const;
+
 private:
 
-	mutable boost::recursive_mutex m_configMutex;
+	mutable boost::shared_mutex m_configMutex;
 
 	struct ConfigInfo {
-		ConfigInfo(const std::string &n, ConfigType t, const std::string &d, const std::list<std::string> &l =std::list<std::string>()) : name(n), type(t), defaultValue(d), defaultListValue(l) {}
+		ConfigInfo(const std::string &n, ConfigType t, const std::string &d, const std::list<std::string> &l =std::list<std::string>()) : name(n), type(t), defaultValue(d), defaultListValue(l), intValue(0) {}
+		void updateIntValues();
 		std::string name;
 		ConfigType type;
 		std::string defaultValue;
 		std::list<std::string> defaultListValue;
-
+		// parsed values, updated whenever the strings change
+		int intValue;
+		std::list<int> intListValue;
 	};
 
+	typedef boost::unordered_map<std::string, size_t> ConfigIndexMap;
+
+	const ConfigInfo *findConfig(const std::string &varName) const;
+	ConfigInfo *findConfig(const std::string &varName);
+
 	std::vector<ConfigInfo> configList;
 	std::vector<ConfigInfo> configBufferList;
+	ConfigIndexMap configIndex;
+
+	// background writer for writeBuffer()
+	mutable boost::mutex m_writeMutex;
+	mutable boost::mutex m_saveMutex;
+	mutable boost::condition_variable m_writeCond;
+	mutable boost::thread m_writeThread;
+	mutable unsigned m_writeRequestCounter;
+	mutable bool m_writePending;
+	bool m_writeQuit;
+	bool m_fileDeleted;
 
 	std::string configFileName;
 	std::string logDir;
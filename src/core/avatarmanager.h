@@ -36,8 +36,12 @@
 #include <boost/thread.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <boost/unordered_map.hpp>
+
 #include <map>
 #include <list>
+#include <vector>
+#include <ctime>
 
 #include <playerdata.h>
 #include <core/crypthelper.h>
@@ -48,6 +52,9 @@
 
 struct AvatarFileState;
 class UploaderThread;
+#ifdef POKERTH_OFFICIAL_SERVER
+class AvatarPackStore;
+#endif
 
 class AvatarManager
 {
@@ -65,6 +72,8 @@ public:
 	static unsigned ChunkReadAvatarFile(boost::shared_ptr<AvatarFileState> fileState, unsigned char *data, unsigned chunkSize);
 
 	static int AvatarFileToNetPackets(const std::string &fileName, unsigned requestId, NetPacketList &packets);
+	static int AvatarDataToNetPackets(const unsigned char *data, size_t size, AvatarFileType fileType, unsigned requestId, NetPacketList &packets);
+	int AvatarToNetPackets(const MD5Buf &md5buf, unsigned requestId, NetPacketList &packets) const;
 	static AvatarFileType GetAvatarFileType(const std::string &fileName);
 	static std::string GetAvatarFileExtension(AvatarFileType fileType);
 
@@ -76,20 +85,61 @@ public:
 	static bool IsValidAvatarFileType(AvatarFileType avatarFileType, const unsigned char *fileHeader, size_t fileHeaderSize);
 
 	void RemoveOldAvatarCacheEntries();
+	// Runs RemoveOldAvatarCacheEntries in the background, unless the
+	// cache thread is still busy.
+	void StartCacheCleanup();
 
 protected:
 	typedef std::map<MD5Buf, std::string> AvatarMap;
 	typedef std::list<MD5Buf> AvatarList;
-	typedef std::map<std::time_t, MD5Buf> TimeAvatarMap;
+
+	// The LRU list holds the fields of the cache index, so that the index
+	// is copied without lookups.
+	struct CacheLruEntry {
+		MD5Buf md5buf;
+		AvatarFileType fileType;
+		unsigned fileSize;
+		std::time_t lastUse;
+	};
+	typedef std::list<CacheLruEntry> CacheLruList;
+
+	struct CachedAvatar {
+		std::string fileName;
+		// Stored in the avatar pack store instead of a file.
+		bool packed;
+		CacheLruList::iterator lruPos;
+	};
+	typedef boost::unordered_map<MD5Buf, CachedAvatar, MD5BufHash> CachedAvatarMap;
 
 	bool InternalReadDirectory(const std::string &dir, AvatarMap &avatars);
 
+	// These methods are not thread safe. Only call after locking the cache.
+	CachedAvatar &InternalAddCachedAvatar(const MD5Buf &md5buf, const std::string &fileName, AvatarFileType fileType,
+									unsigned fileSize, std::time_t lastUse, bool mostRecent);
+	void InternalTouchCachedAvatar(CachedAvatar &avatar) const;
+	void InternalRemoveCachedAvatar(CachedAvatarMap::iterator pos, bool deleteFile);
+	bool InternalReadCacheIndex(const std::string &cacheDir);
+
+	void WriteCacheIndex();
+	void ReconcileCacheDirectory(const std::string &cacheDir);
+#ifdef POKERTH_OFFICIAL_SERVER
+	void ReconcilePackStore(const std::string &cacheDir, AvatarMap &dirAvatars);
+#endif
+
 private:
 	mutable boost::mutex	m_avatarsMutex;
 	AvatarMap				m_avatars;
 
 	mutable boost::mutex	m_cachedAvatarsMutex;
-	AvatarMap				m_cachedAvatars;
+	// Lookups update the LRU order, most recently used first.
+	mutable CachedAvatarMap	m_cachedAvatars;
+	mutable CacheLruList	m_cacheLru;
+	mutable bool			m_cacheIndexDirty;
+
+	boost::mutex			m_cacheIndexFileMutex;
+	// Reconciles the cache directory and cleans up the cache.
+	boost::mutex			m_cacheThreadMutex;
+	boost::thread			m_cacheThread;
 
 	mutable boost::mutex	m_cacheDirMutex;
 	std::string				m_cacheDir;
@@ -100,6 +150,9 @@ private:
 	const std::string		m_externalServerPassword;
 
 	boost::shared_ptr<UploaderThread> m_uploader;
+#ifdef POKERTH_OFFICIAL_SERVER
+	boost::shared_ptr<AvatarPackStore> m_packStore;
+#endif
 };
 
 #endif
@@ -0,0 +1,87 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+/* An append-only store which packs avatars into segment files. */
+
+#ifndef _AVATARPACKSTORE_H_
+#define _AVATARPACKSTORE_H_
+
+#include <boost/thread.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <string>
+#include <vector>
+
+#include <playerdata.h>
+#include <core/crypthelper.h>
+
+#define AVATAR_PACK_NUM_SHARDS			16
+#define AVATAR_PACK_MAX_SEGMENT_SIZE	(16 * 1024 * 1024)
+
+struct AvatarPackShard;
+
+// Avatars are appended to segment files, the store never writes one file
+// per avatar. The avatars are distributed to shards by MD5 sum, every
+// shard has its own directory, lock and MD5 keyed index of the record
+// offsets. Avatars are never removed, the official server keeps all of
+// them. The index is rebuilt on Open() by reading only the record headers.
+class AvatarPackStore
+{
+public:
+	struct Entry {
+		unsigned segmentId;
+		unsigned offset;
+		unsigned size;
+		AvatarFileType fileType;
+	};
+	typedef boost::unordered_map<MD5Buf, Entry, MD5BufHash> EntryMap;
+
+	AvatarPackStore();
+	~AvatarPackStore();
+
+	bool Open(const std::string &storeDir);
+	void Close();
+
+	bool Has(const MD5Buf &md5buf) const;
+	bool Read(const MD5Buf &md5buf, AvatarFileType &outFileType, std::vector<unsigned char> &outData) const;
+	// Storing an avatar which is already present does nothing.
+	bool Store(const MD5Buf &md5buf, AvatarFileType fileType, const unsigned char *data, size_t size);
+
+	void GetEntries(EntryMap &outEntries) const;
+
+protected:
+	AvatarPackShard &GetShard(const MD5Buf &md5buf) const;
+
+private:
+	std::vector<boost::shared_ptr<AvatarPackShard> > m_shards;
+};
+
+#endif
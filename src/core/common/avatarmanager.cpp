@@ -33,15 +33,23 @@
 #include <net/net_helper.h>
 #include <net/socket_msg.h>
 #include <net/uploaderthread.h>
+#ifdef POKERTH_OFFICIAL_SERVER
+#include <core/avatarpackstore.h>
+#endif
 #include <core/loghelper.h>
 #include <core/crypthelper.h>
 
 #include <boost/filesystem.hpp>
 #include <boost/lambda/lambda.hpp>
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/cstdint.hpp>
 #include <core/openssl_wrapper.h>
 
 #include <fstream>
+#include <iterator>
+#include <algorithm>
 #include <cstring>
 
 #define MAX_NUMBER_OF_FILES			NetHelper::GetMaxNumberOfAvatarFiles()
@@ -56,6 +64,14 @@
 #define GIF_HEADER_SIZE (sizeof(GIF_HEADER_1) - 1)
 #define MAX_HEADER_SIZE PNG_HEADER_SIZE
 
+#define AVATAR_CACHE_INDEX_FILENAME		"avatarcache.idx"
+#define AVATAR_CACHE_INDEX_MAGIC		"PTHAVIDX"
+#define AVATAR_CACHE_INDEX_VERSION		1
+
+#define AVATAR_PACK_DIRNAME				"avatarpack"
+#define AVATAR_UPLOAD_DIRNAME			"upload"
+#define AVATAR_UPLOAD_KEEP_SEC			3600
+
 
 using namespace std;
 using namespace boost::filesystem;
@@ -64,9 +80,45 @@ struct AvatarFileState {
 	std::ifstream		inputStream;
 };
 
+// Layout of the cache index file. The entries are stored in LRU order,
+// most recently used first.
+struct AvatarCacheIndexHeader {
+	char				magic[8];
+	boost::uint32_t		version;
+	boost::uint32_t		numEntries;
+};
+
+struct AvatarCacheIndexEntry {
+	unsigned char		md5[MD5_DATA_SIZE];
+	boost::uint32_t		fileType;
+	boost::uint32_t		fileSize;
+	boost::int64_t		lastUse;
+};
+
+static bool
+WriteAvatarFile(const string &fileName, const unsigned char *data, size_t size)
+{
+	std::ofstream o(fileName.c_str(), ios_base::out | ios_base::binary | ios_base::trunc);
+	if (!o.fail()) {
+		o.write((const char *)data, size);
+		o.close();
+	}
+	return !o.fail();
+}
+
+static bool
+ReadAvatarFile(const string &fileName, vector<unsigned char> &data)
+{
+	std::ifstream i(fileName.c_str(), ios_base::in | ios_base::binary);
+	if (!i.fail()) {
+		data.assign(std::istreambuf_iterator<char>(i), std::istreambuf_iterator<char>());
+	}
+	return !i.bad() && !data.empty();
+}
+
 AvatarManager::AvatarManager(bool useExternalServer, const std::string &externalServerAddress,
 							 const string &externalServerUser, const string &externalServerPassword)
-	: m_useExternalServer(useExternalServer), m_externalServerAddress(externalServerAddress),
+	: m_cacheIndexDirty(false), m_useExternalServer(useExternalServer), m_externalServerAddress(externalServerAddress),
 	  m_externalServerUser(externalServerUser), m_externalServerPassword(externalServerPassword)
 {
 	m_uploader.reset(new UploaderThread());
@@ -74,6 +126,15 @@ AvatarManager::AvatarManager(bool useExternalServer, const std::string &external
 
 AvatarManager::~AvatarManager()
 {
+	{
+		boost::mutex::scoped_lock lock(m_cacheThreadMutex);
+		if (m_cacheThread.joinable()) {
+			m_cacheThread.interrupt();
+			m_cacheThread.join();
+		}
+	}
+	WriteCacheIndex();
+
 	m_uploader->SignalTermination();
 	m_uploader->Join(UPLOADER_THREAD_TERMINATE_TIMEOUT);
 }
@@ -98,10 +159,26 @@ AvatarManager::Init(const string &dataDir, const string &cacheDir)
 	}
 	if (cacheDir.empty() || tmpCachePath.empty())
 		LOG_ERROR("Cache directory was not set!");
-	else {
-		boost::mutex::scoped_lock lock(m_cachedAvatarsMutex);
-		tmpRet = InternalReadDirectory(tmpCachePath.directory_string(), m_cachedAvatars);
-		retVal = retVal && tmpRet;
+	else if (!exists(tmpCachePath) || !is_directory(tmpCachePath)) {
+		LOG_ERROR("Avatar directory does not exist.");
+		retVal = false;
+	} else {
+#ifdef POKERTH_OFFICIAL_SERVER
+		// The server keeps avatars in a few large segment files.
+		m_packStore.reset(new AvatarPackStore);
+		if (!m_packStore->Open((tmpCachePath / AVATAR_PACK_DIRNAME).directory_string())) {
+			LOG_ERROR("Failed to open avatar pack store, storing avatars as single files.");
+			m_packStore.reset();
+		}
+#endif
+		{
+			boost::mutex::scoped_lock lock(m_cachedAvatarsMutex);
+			InternalReadCacheIndex(tmpCachePath.directory_string());
+		}
+		// Files which were added or removed while the index was not
+		// written are found in the background, lookups are not blocked.
+		boost::mutex::scoped_lock lock(m_cacheThreadMutex);
+		m_cacheThread = boost::thread(boost::bind(&AvatarManager::ReconcileCacheDirectory, this, tmpCachePath.directory_string()));
 	}
 
 	m_uploader->Run();
@@ -242,6 +319,78 @@ AvatarManager::AvatarFileToNetPackets(const string &fileName, unsigned requestId
 	return retVal;
 }
 
+int
+AvatarManager::AvatarDataToNetPackets(const unsigned char *data, size_t size, AvatarFileType fileType, unsigned requestId, NetPacketList &packets)
+{
+	int retVal = ERR_NET_INVALID_AVATAR_FILE;
+	if (size >= MIN_AVATAR_FILE_SIZE && size <= MAX_AVATAR_FILE_SIZE && IsValidAvatarFileType(fileType, data, size)) {
+		{
+			boost::shared_ptr<NetPacket> avatarHeader(new NetPacket);
+			avatarHeader->GetMsg()->set_messagetype(PokerTHMessage::Type_LobbyMessage);
+			LobbyMessage *netLobby = avatarHeader->GetMsg()->mutable_lobbymessage();
+			netLobby->set_messagetype(LobbyMessage::Type_AvatarHeaderMessage);
+			AvatarHeaderMessage *netHeader = netLobby->mutable_avatarheadermessage();
+			netHeader->set_requestid(requestId);
+			netHeader->set_avatartype(static_cast<NetAvatarType>(fileType));
+			netHeader->set_avatarsize(static_cast<unsigned>(size));
+			packets.push_back(avatarHeader);
+		}
+
+		size_t offset = 0;
+		while (offset < size) {
+			size_t numBytes = min(size - offset, static_cast<size_t>(MAX_FILE_DATA_SIZE));
+			boost::shared_ptr<NetPacket> avatarFile(new NetPacket);
+			avatarFile->GetMsg()->set_messagetype(PokerTHMessage::Type_LobbyMessage);
+			LobbyMessage *netLobby = avatarFile->GetMsg()->mutable_lobbymessage();
+			netLobby->set_messagetype(LobbyMessage::Type_AvatarDataMessage);
+			AvatarDataMessage *netFile = netLobby->mutable_avatardatamessage();
+			netFile->set_requestid(requestId);
+			netFile->set_avatarblock((const char *)data + offset, numBytes);
+			packets.push_back(avatarFile);
+			offset += numBytes;
+		}
+
+		boost::shared_ptr<NetPacket> avatarEnd(new NetPacket);
+		avatarEnd->GetMsg()->set_messagetype(PokerTHMessage::Type_LobbyMessage);
+		LobbyMessage *netLobby = avatarEnd->GetMsg()->mutable_lobbymessage();
+		netLobby->set_messagetype(LobbyMessage::Type_AvatarEndMessage);
+		AvatarEndMessage *netEnd = netLobby->mutable_avatarendmessage();
+		netEnd->set_requestid(requestId);
+		packets.push_back(avatarEnd);
+		retVal = 0;
+	}
+	return retVal;
+}
+
+int
+AvatarManager::AvatarToNetPackets(const MD5Buf &md5buf, unsigned requestId, NetPacketList &packets) const
+{
+	int retVal = ERR_NET_INVALID_AVATAR_FILE;
+	bool packed = false;
+#ifdef POKERTH_OFFICIAL_SERVER
+	{
+		boost::mutex::scoped_lock lock(m_cachedAvatarsMutex);
+		CachedAvatarMap::iterator pos = m_cachedAvatars.find(md5buf);
+		if (pos != m_cachedAvatars.end() && pos->second.packed) {
+			InternalTouchCachedAvatar(pos->second);
+			packed = true;
+		}
+	}
+	if (packed) {
+		AvatarFileType fileType;
+		vector<unsigned char> data;
+		if (m_packStore && m_packStore->Read(md5buf, fileType, data) && !data.empty())
+			retVal = AvatarDataToNetPackets(&data[0], data.size(), fileType, requestId, packets);
+	}
+#endif
+	if (!packed) {
+		string fileName;
+		if (GetAvatarFileName(md5buf, fileName))
+			retVal = AvatarFileToNetPackets(fileName, requestId, packets);
+	}
+	return retVal;
+}
+
 AvatarFileType
 AvatarManager::GetAvatarFileType(const string &fileName)
 {
@@ -303,10 +452,10 @@ AvatarManager::GetHashForAvatar(const std::string &fileName, MD5Buf &md5buf) con
 		// Check cached avatars next.
 		if (!found) {
 			boost::mutex::scoped_lock lock(m_cachedAvatarsMutex);
-			AvatarMap::const_iterator i = m_cachedAvatars.begin();
-			AvatarMap::const_iterator end = m_cachedAvatars.end();
+			CachedAvatarMap::const_iterator i = m_cachedAvatars.begin();
+			CachedAvatarMap::const_iterator end = m_cachedAvatars.end();
 			while (i != end) {
-				if (i->second == fileName) {
+				if (i->second.fileName == fileName) {
 					md5buf = i->first;
 					found = true;
 					break;
@@ -338,9 +487,10 @@ AvatarManager::GetAvatarFileName(const MD5Buf &md5buf, std::string &fileName) co
 	}
 	if (!retVal) {
 		boost::mutex::scoped_lock lock(m_cachedAvatarsMutex);
-		AvatarMap::const_iterator pos = m_cachedAvatars.find(md5buf);
+		CachedAvatarMap::iterator pos = m_cachedAvatars.find(md5buf);
 		if (pos != m_cachedAvatars.end()) {
-			fileName = pos->second;
+			fileName = pos->second.fileName;
+			InternalTouchCachedAvatar(pos->second);
 			retVal = true;
 		}
 	}
@@ -368,20 +518,43 @@ AvatarManager::StoreAvatarInCache(const MD5Buf &md5buf, AvatarFileType avatarFil
 		if (!ext.empty() && !cacheDir.empty()) {
 			// Check header before storing file.
 			if (IsValidAvatarFileType(avatarFileType, data, size)) {
+				string avatarName(md5buf.ToString() + ext);
 				path tmpPath(cacheDir);
-				tmpPath /= (md5buf.ToString() + ext);
+				tmpPath /= avatarName;
+				// Packed avatars keep this name to report their type.
 				string fileName(tmpPath.file_string());
-				std::ofstream o(fileName.c_str(), ios_base::out | ios_base::binary | ios_base::trunc);
-				if (!o.fail()) {
-					o.write((const char *)data, size);
-					o.close();
+				bool packed = false;
+#ifdef POKERTH_OFFICIAL_SERVER
+				packed = m_packStore && m_packStore->Store(md5buf, avatarFileType, data, size);
+#endif
+				if (packed || WriteAvatarFile(fileName, data, size)) {
 					if (upload && m_useExternalServer) {
-						m_uploader->QueueUpload(m_externalServerAddress, m_externalServerUser, m_externalServerPassword, fileName, size);
+						string uploadFileName(fileName);
+						bool uploadFileWritten = true;
+#ifdef POKERTH_OFFICIAL_SERVER
+						if (packed) {
+							// The uploader needs a file, it is deleted by the cache cleanup.
+							path uploadPath(path(cacheDir) / AVATAR_UPLOAD_DIRNAME);
+							create_directories(uploadPath);
+							uploadFileName = (uploadPath / avatarName).file_string();
+							uploadFileWritten = WriteAvatarFile(uploadFileName, data, size);
+						}
+#endif
+						if (uploadFileWritten)
+							m_uploader->QueueUpload(m_externalServerAddress, m_externalServerUser, m_externalServerPassword, uploadFileName, size);
+						else
+							LOG_ERROR("Failed to write avatar file for upload: " << uploadFileName);
 					}
 
 					{
 						boost::mutex::scoped_lock lock(m_cachedAvatarsMutex);
-						m_cachedAvatars.insert(AvatarMap::value_type(md5buf, fileName));
+						CachedAvatar &avatar = InternalAddCachedAvatar(md5buf, fileName, avatarFileType, static_cast<unsigned>(size), time(NULL), true);
+						avatar.packed = packed;
+#ifndef POKERTH_OFFICIAL_SERVER
+						// Evict one avatar at a time instead of scanning the cache.
+						while (m_cachedAvatars.size() > MAX_NUMBER_OF_FILES && m_cacheLru.size() > 1)
+							InternalRemoveCachedAvatar(m_cachedAvatars.find(m_cacheLru.back().md5buf), true);
+#endif
 					}
 					retVal = true;
 				}
@@ -427,92 +600,64 @@ AvatarManager::IsValidAvatarFileType(AvatarFileType avatarFileType, const unsign
 void
 AvatarManager::RemoveOldAvatarCacheEntries()
 {
-	string cacheDir;
-	{
-		boost::mutex::scoped_lock lock(m_cacheDirMutex);
-		cacheDir = m_cacheDir;
-	}
+#ifndef POKERTH_OFFICIAL_SERVER
+	// The official server never deletes avatars.
 	try {
-		path cachePath(cacheDir);
-		cacheDir = cachePath.directory_string();
-		// Never delete anything if we do not have a special cache dir set.
-		if (!cacheDir.empty()) {
-			boost::mutex::scoped_lock lock(m_cachedAvatarsMutex);
-
-			// First pass: Remove files which no longer exist.
-			// Count files and record age.
-			AvatarList removeList;
-			TimeAvatarMap timeMap;
-			{
-				AvatarMap::const_iterator i = m_cachedAvatars.begin();
-				AvatarMap::const_iterator end = m_cachedAvatars.end();
-				while (i != end) {
-					bool keepFile = false;
-					path filePath(i->second);
-					string fileString(filePath.file_string());
-					// Only consider files which are definitely in the cache dir.
-					if (fileString.size() > cacheDir.size() && fileString.substr(0, cacheDir.size()) == cacheDir) {
-						// Only consider files with MD5 as file name.
-						MD5Buf tmpBuf;
-						if (exists(filePath) && tmpBuf.FromString(basename(filePath))) {
-							timeMap.insert(TimeAvatarMap::value_type(last_write_time(filePath), i->first));
-							keepFile = true;
-						}
-					}
-					if (!keepFile)
-						removeList.push_back(i->first);
-
-					++i;
-				}
-			}
+		boost::mutex::scoped_lock lock(m_cachedAvatarsMutex);
 
-			{
-				AvatarList::const_iterator i = removeList.begin();
-				AvatarList::const_iterator end = removeList.end();
+		// Remove and physically delete the least recently used files
+		// in one of the following cases:
+		// 1. More than MAX_NUMBER_OF_FILES files are present.
+		// 2. Files were not used for MAX_AVATAR_CACHE_AGE.
+		// The list is in LRU order, stop at the first file to keep.
+		time_t curTime = time(NULL);
+		while (!m_cacheLru.empty()) {
+			const CacheLruEntry &oldest = m_cacheLru.back();
+			if (m_cachedAvatars.size() <= MAX_NUMBER_OF_FILES && curTime - oldest.lastUse < (int)MAX_AVATAR_CACHE_AGE)
+				break;
+			InternalRemoveCachedAvatar(m_cachedAvatars.find(oldest.md5buf), true);
+		}
+	} catch (...) {
+		LOG_ERROR("Exception caught while cleaning up cache.");
+	}
+#else
+	if (m_packStore) {
+		string cacheDir;
+		{
+			boost::mutex::scoped_lock lock(m_cacheDirMutex);
+			cacheDir = m_cacheDir;
+		}
+		try {
+			// Delete files which were written for the uploader.
+			path uploadPath(path(cacheDir) / AVATAR_UPLOAD_DIRNAME);
+			if (exists(uploadPath)) {
+				time_t curTime = time(NULL);
+				directory_iterator i(uploadPath);
+				directory_iterator end;
 				while (i != end) {
-					m_cachedAvatars.erase(*i);
+					path filePath(i->path());
 					++i;
+					if (is_regular(filePath) && curTime - last_write_time(filePath) >= AVATAR_UPLOAD_KEEP_SEC)
+						remove(filePath);
 				}
-				removeList.clear();
-			}
-
-			// Remove and physically delete files in one of the
-			// following cases:
-			// 1. More than MAX_NUMBER_OF_FILES files are present
-			//    - delete until only MAX_NUMBER_OF_FILES/2 are left.
-			// 2. Files are older than 30 days.
-
-			if (m_cachedAvatars.size() > MAX_NUMBER_OF_FILES) {
-				while (!timeMap.empty() && m_cachedAvatars.size() > MAX_NUMBER_OF_FILES / 2) {
-					TimeAvatarMap::iterator i = timeMap.begin();
-					AvatarMap::iterator pos = m_cachedAvatars.find(i->second);
-					if (pos != m_cachedAvatars.end()) {
-						path tmpPath(pos->second);
-						remove(tmpPath);
-						m_cachedAvatars.erase(pos);
-					}
-					timeMap.erase(i);
-				}
-			}
-
-			// Get reference time.
-			time_t curTime = time(NULL);
-			while (!timeMap.empty() && !m_cachedAvatars.empty()) {
-				TimeAvatarMap::iterator i = timeMap.begin();
-				if (curTime - i->first < (int)MAX_AVATAR_CACHE_AGE)
-					break;
-				AvatarMap::iterator pos = m_cachedAvatars.find(i->second);
-				if (pos != m_cachedAvatars.end()) {
-					path tmpPath(pos->second);
-					remove(tmpPath);
-					m_cachedAvatars.erase(pos);
-				}
-				timeMap.erase(i);
 			}
+		} catch (...) {
+			LOG_ERROR("Exception caught while cleaning up avatar uploads.");
 		}
-	} catch (...) {
-		LOG_ERROR("Exception caught while cleaning up cache.");
 	}
+#endif
+	WriteCacheIndex();
+}
+
+void
+AvatarManager::StartCacheCleanup()
+{
+	boost::mutex::scoped_lock lock(m_cacheThreadMutex);
+	if (m_cacheThread.joinable()) {
+		if (!m_cacheThread.timed_join(boost::posix_time::milliseconds(0)))
+			return;
+	}
+	m_cacheThread = boost::thread(boost::bind(&AvatarManager::RemoveOldAvatarCacheEntries, this));
 }
 
 bool
@@ -550,3 +695,275 @@ AvatarManager::InternalReadDirectory(const std::string &dir, AvatarMap &avatars)
 	return retVal;
 }
 
+AvatarManager::CachedAvatar &
+AvatarManager::InternalAddCachedAvatar(const MD5Buf &md5buf, const std::string &fileName, AvatarFileType fileType,
+									   unsigned fileSize, std::time_t lastUse, bool mostRecent)
+{
+	m_cacheIndexDirty = true;
+	CachedAvatarMap::iterator pos = m_cachedAvatars.find(md5buf);
+	if (pos != m_cachedAvatars.end()) {
+		pos->second.fileName = fileName;
+		pos->second.lruPos->fileType = fileType;
+		pos->second.lruPos->fileSize = fileSize;
+		if (mostRecent)
+			InternalTouchCachedAvatar(pos->second);
+		return pos->second;
+	}
+	CacheLruEntry lruEntry;
+	lruEntry.md5buf = md5buf;
+	lruEntry.fileType = fileType;
+	lruEntry.fileSize = fileSize;
+	lruEntry.lastUse = lastUse;
+	CachedAvatar &avatar = m_cachedAvatars[md5buf];
+	avatar.fileName = fileName;
+	avatar.packed = false;
+	avatar.lruPos = m_cacheLru.insert(mostRecent ? m_cacheLru.begin() : m_cacheLru.end(), lruEntry);
+	return avatar;
+}
+
+void
+AvatarManager::InternalTouchCachedAvatar(CachedAvatar &avatar) const
+{
+	m_cacheLru.splice(m_cacheLru.begin(), m_cacheLru, avatar.lruPos);
+	avatar.lruPos->lastUse = time(NULL);
+	m_cacheIndexDirty = true;
+}
+
+void
+AvatarManager::InternalRemoveCachedAvatar(CachedAvatarMap::iterator pos, bool deleteFile)
+{
+	// Packed avatars are only used by the official server, which never deletes avatars.
+	if (deleteFile && !pos->second.packed) {
+		boost::system::error_code ec;
+		remove(path(pos->second.fileName), ec);
+	}
+	m_cacheLru.erase(pos->second.lruPos);
+	m_cachedAvatars.erase(pos);
+	m_cacheIndexDirty = true;
+}
+
+bool
+AvatarManager::InternalReadCacheIndex(const std::string &cacheDir)
+{
+	bool retVal = false;
+	path indexPath(path(cacheDir) / AVATAR_CACHE_INDEX_FILENAME);
+	try {
+		if (exists(indexPath) && file_size(indexPath) >= sizeof(AvatarCacheIndexHeader)) {
+			using namespace boost::interprocess;
+			file_mapping indexMapping(indexPath.file_string().c_str(), read_only);
+			mapped_region indexRegion(indexMapping, read_only);
+			const unsigned char *indexData = static_cast<const unsigned char *>(indexRegion.get_address());
+			size_t indexSize = indexRegion.get_size();
+
+			AvatarCacheIndexHeader header;
+			memcpy(&header, indexData, sizeof(header));
+			if (memcmp(header.magic, AVATAR_CACHE_INDEX_MAGIC, sizeof(header.magic)) == 0
+					&& header.version == AVATAR_CACHE_INDEX_VERSION
+					&& indexSize == sizeof(header) + header.numEntries * sizeof(AvatarCacheIndexEntry)) {
+				const unsigned char *entryData = indexData + sizeof(header);
+				for (unsigned i = 0; i < header.numEntries; i++) {
+					AvatarCacheIndexEntry entry;
+					memcpy(&entry, entryData, sizeof(entry));
+					entryData += sizeof(entry);
+
+					MD5Buf md5buf;
+					memcpy(md5buf.GetData(), entry.md5, MD5_DATA_SIZE);
+					AvatarFileType fileType = static_cast<AvatarFileType>(entry.fileType);
+					string ext(GetAvatarFileExtension(fileType));
+					if (!ext.empty()) {
+						path filePath(path(cacheDir) / (md5buf.ToString() + ext));
+						// Entries are in LRU order, append them.
+						CachedAvatar &avatar = InternalAddCachedAvatar(md5buf, filePath.file_string(), fileType, entry.fileSize,
+																	   static_cast<time_t>(entry.lastUse), false);
+#ifdef POKERTH_OFFICIAL_SERVER
+						avatar.packed = m_packStore && m_packStore->Has(md5buf);
+#endif
+					}
+				}
+				m_cacheIndexDirty = false;
+				retVal = true;
+			} else {
+				LOG_ERROR("Avatar cache index is invalid, rebuilding.");
+			}
+		}
+	} catch (...) {
+		LOG_ERROR("Exception caught when trying to read avatar cache index.");
+	}
+	return retVal;
+}
+
+void
+AvatarManager::WriteCacheIndex()
+{
+	string cacheDir;
+	{
+		boost::mutex::scoped_lock lock(m_cacheDirMutex);
+		cacheDir = m_cacheDir;
+	}
+	if (cacheDir.empty())
+		return;
+
+	boost::mutex::scoped_lock fileLock(m_cacheIndexFileMutex);
+	vector<AvatarCacheIndexEntry> entries;
+	{
+		boost::mutex::scoped_lock lock(m_cachedAvatarsMutex);
+		if (!m_cacheIndexDirty)
+			return;
+		entries.reserve(m_cacheLru.size());
+		CacheLruList::const_iterator i = m_cacheLru.begin();
+		CacheLruList::const_iterator end = m_cacheLru.end();
+		while (i != end) {
+			AvatarCacheIndexEntry entry;
+			memcpy(entry.md5, i->md5buf.GetData(), MD5_DATA_SIZE);
+			entry.fileType = static_cast<boost::uint32_t>(i->fileType);
+			entry.fileSize = i->fileSize;
+			entry.lastUse = static_cast<boost::int64_t>(i->lastUse);
+			entries.push_back(entry);
+			++i;
+		}
+		m_cacheIndexDirty = false;
+	}
+
+	AvatarCacheIndexHeader header;
+	memcpy(header.magic, AVATAR_CACHE_INDEX_MAGIC, sizeof(header.magic));
+	header.version = AVATAR_CACHE_INDEX_VERSION;
+	header.numEntries = static_cast<boost::uint32_t>(entries.size());
+
+	try {
+		// Replace the index at once, so that it is never read half written.
+		path indexPath(path(cacheDir) / AVATAR_CACHE_INDEX_FILENAME);
+		path tmpIndexPath(path(cacheDir) / (AVATAR_CACHE_INDEX_FILENAME ".tmp"));
+		{
+			std::ofstream o(tmpIndexPath.file_string().c_str(), ios_base::out | ios_base::binary | ios_base::trunc);
+			o.write((const char *)&header, sizeof(header));
+			if (!entries.empty())
+				o.write((const char *)&entries[0], entries.size() * sizeof(AvatarCacheIndexEntry));
+			o.close();
+			if (o.fail())
+				throw runtime_error("write failed");
+		}
+		if (exists(indexPath))
+			remove(indexPath);
+		rename(tmpIndexPath, indexPath);
+	} catch (...) {
+		LOG_ERROR("Exception caught when trying to write avatar cache index.");
+		boost::mutex::scoped_lock lock(m_cachedAvatarsMutex);
+		m_cacheIndexDirty = true;
+	}
+}
+
+void
+AvatarManager::ReconcileCacheDirectory(const std::string &cacheDir)
+{
+	try {
+		// Collect the avatar files without blocking lookups.
+		AvatarMap dirAvatars;
+		InternalReadDirectory(cacheDir, dirAvatars);
+		boost::this_thread::interruption_point();
+#ifdef POKERTH_OFFICIAL_SERVER
+		if (m_packStore)
+			ReconcilePackStore(cacheDir, dirAvatars);
+#endif
+
+		AvatarList newAvatars;
+		{
+			boost::mutex::scoped_lock lock(m_cachedAvatarsMutex);
+			AvatarMap::const_iterator i = dirAvatars.begin();
+			AvatarMap::const_iterator end = dirAvatars.end();
+			while (i != end) {
+				CachedAvatarMap::const_iterator pos = m_cachedAvatars.find(i->first);
+				if (pos == m_cachedAvatars.end() || pos->second.fileName != i->second)
+					newAvatars.push_back(i->first);
+				++i;
+			}
+		}
+
+		// Files which are not in the index are added as least recently used.
+		AvatarList::const_iterator i = newAvatars.begin();
+		AvatarList::const_iterator end = newAvatars.end();
+		while (i != end) {
+			boost::this_thread::interruption_point();
+			const string &fileName = dirAvatars[*i];
+			AvatarFileType fileType = GetAvatarFileType(fileName);
+			if (fileType != AVATAR_FILE_TYPE_UNKNOWN) {
+				path filePath(fileName);
+				unsigned fileSize = static_cast<unsigned>(file_size(filePath));
+				time_t lastUse = last_write_time(filePath);
+				boost::mutex::scoped_lock lock(m_cachedAvatarsMutex);
+				if (m_cachedAvatars.find(*i) == m_cachedAvatars.end())
+					InternalAddCachedAvatar(*i, fileName, fileType, fileSize, lastUse, false);
+			}
+			++i;
+		}
+
+		// Index entries without a file are dropped. Check again, the
+		// file may have been stored during the scan.
+		{
+			boost::mutex::scoped_lock lock(m_cachedAvatarsMutex);
+			CachedAvatarMap::iterator i = m_cachedAvatars.begin();
+			while (i != m_cachedAvatars.end()) {
+				CachedAvatarMap::iterator cur = i++;
+				bool found;
+#ifdef POKERTH_OFFICIAL_SERVER
+				if (cur->second.packed)
+					found = m_packStore && m_packStore->Has(cur->first);
+				else
+#endif
+					found = dirAvatars.find(cur->first) != dirAvatars.end() || exists(path(cur->second.fileName));
+				if (!found)
+					InternalRemoveCachedAvatar(cur, false);
+			}
+		}
+		WriteCacheIndex();
+	} catch (const boost::thread_interrupted &) {
+		throw;
+	} catch (...) {
+		LOG_ERROR("Exception caught when trying to scan avatar cache.");
+	}
+}
+
+#ifdef POKERTH_OFFICIAL_SERVER
+void
+AvatarManager::ReconcilePackStore(const std::string &cacheDir, AvatarMap &dirAvatars)
+{
+	// Move single files into the pack store, e.g. after an upgrade.
+	AvatarMap::iterator i = dirAvatars.begin();
+	while (i != dirAvatars.end()) {
+		boost::this_thread::interruption_point();
+		AvatarMap::iterator cur = i++;
+		AvatarFileType fileType = GetAvatarFileType(cur->second);
+		vector<unsigned char> data;
+		if (fileType != AVATAR_FILE_TYPE_UNKNOWN && ReadAvatarFile(cur->second, data)
+				&& m_packStore->Store(cur->first, fileType, &data[0], data.size())) {
+			{
+				boost::mutex::scoped_lock lock(m_cachedAvatarsMutex);
+				CachedAvatarMap::iterator pos = m_cachedAvatars.find(cur->first);
+				if (pos != m_cachedAvatars.end())
+					pos->second.packed = true;
+			}
+			boost::system::error_code ec;
+			remove(path(cur->second), ec);
+			dirAvatars.erase(cur);
+		}
+	}
+
+	// Avatars which are not in the index are added as least recently used.
+	AvatarPackStore::EntryMap packEntries;
+	m_packStore->GetEntries(packEntries);
+	time_t curTime = time(NULL);
+	boost::mutex::scoped_lock lock(m_cachedAvatarsMutex);
+	AvatarPackStore::EntryMap::const_iterator entry = packEntries.begin();
+	AvatarPackStore::EntryMap::const_iterator end = packEntries.end();
+	while (entry != end) {
+		CachedAvatarMap::iterator pos = m_cachedAvatars.find(entry->first);
+		if (pos == m_cachedAvatars.end()) {
+			path filePath(path(cacheDir) / (entry->first.ToString() + GetAvatarFileExtension(entry->second.fileType)));
+			CachedAvatar &avatar = InternalAddCachedAvatar(entry->first, filePath.file_string(), entry->second.fileType,
+														   entry->second.size, curTime, false);
+			avatar.packed = true;
+		} else
+			pos->second.packed = true;
+		++entry;
+	}
+}
+#endif
@@ -0,0 +1,385 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+
+#include <core/avatarpackstore.h>
+#include <core/loghelper.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/cstdint.hpp>
+
+#include <set>
+#include <map>
+#include <sstream>
+#include <iomanip>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define AVATAR_PACK_RECORD_MAGIC		0x56415450 // "PTAV"
+#define AVATAR_PACK_SEGMENT_EXTENSION	".pak"
+
+#define RECORD_SIZE(_dataSize)			(sizeof(AvatarPackRecordHeader) + (_dataSize))
+
+using namespace std;
+using namespace boost::filesystem;
+
+// Every avatar is stored with this header.
+struct AvatarPackRecordHeader {
+	boost::uint32_t		magic;
+	// Reserved, always 0.
+	boost::uint32_t		flags;
+	unsigned char		md5[MD5_DATA_SIZE];
+	boost::uint32_t		fileType;
+	boost::uint32_t		dataSize;
+};
+
+struct AvatarPackSegment {
+	AvatarPackSegment() : id(0), fd(-1), size(0) {}
+
+	unsigned			id;
+	int					fd;
+	string				fileName;
+	unsigned			size;
+};
+
+// Ordered by id, new records are appended to the last segment.
+typedef map<unsigned, AvatarPackSegment> AvatarPackSegmentMap;
+
+struct AvatarPackShard {
+	AvatarPackShard() : nextSegmentId(1) {}
+
+	mutable boost::mutex		mutex;
+	string						dir;
+	AvatarPackStore::EntryMap	entries;
+	AvatarPackSegmentMap		segments;
+	unsigned					nextSegmentId;
+};
+
+static bool
+ReadAll(int fd, void *buf, size_t size, off_t offset)
+{
+	unsigned char *pos = static_cast<unsigned char *>(buf);
+	while (size) {
+		ssize_t bytesRead = pread(fd, pos, size, offset);
+		if (bytesRead < 0 && errno == EINTR)
+			continue;
+		if (bytesRead <= 0)
+			return false;
+		pos += bytesRead;
+		offset += bytesRead;
+		size -= bytesRead;
+	}
+	return true;
+}
+
+static bool
+WriteAll(int fd, const void *buf, size_t size, off_t offset)
+{
+	const unsigned char *pos = static_cast<const unsigned char *>(buf);
+	while (size) {
+		ssize_t bytesWritten = pwrite(fd, pos, size, offset);
+		if (bytesWritten < 0 && errno == EINTR)
+			continue;
+		if (bytesWritten <= 0)
+			return false;
+		pos += bytesWritten;
+		offset += bytesWritten;
+		size -= bytesWritten;
+	}
+	return true;
+}
+
+static string
+SegmentFileName(const AvatarPackShard &shard, unsigned segmentId)
+{
+	ostringstream name;
+	name << setw(8) << setfill('0') << segmentId << AVATAR_PACK_SEGMENT_EXTENSION;
+	return (path(shard.dir) / name.str()).file_string();
+}
+
+static AvatarPackSegment *
+OpenSegment(AvatarPackShard &shard, unsigned segmentId)
+{
+	AvatarPackSegment *retVal = NULL;
+	string fileName(SegmentFileName(shard, segmentId));
+	int fd = open(fileName.c_str(), O_RDWR | O_CREAT, 0644);
+	if (fd != -1) {
+		struct stat fileStat;
+		if (fstat(fd, &fileStat) == 0) {
+			AvatarPackSegment &segment = shard.segments[segmentId];
+			segment.id = segmentId;
+			segment.fd = fd;
+			segment.fileName = fileName;
+			segment.size = static_cast<unsigned>(fileStat.st_size);
+			if (segmentId >= shard.nextSegmentId)
+				shard.nextSegmentId = segmentId + 1;
+			retVal = &segment;
+		} else
+			close(fd);
+	}
+	if (!retVal)
+		LOG_ERROR("Failed to open avatar pack segment " << fileName << ": " << strerror(errno));
+	return retVal;
+}
+
+// Rebuild the index from the record headers. A partly written record
+// at the end of the segment is cut off.
+static void
+ScanSegment(AvatarPackShard &shard, AvatarPackSegment &segment)
+{
+	unsigned offset = 0;
+	AvatarPackRecordHeader header;
+	while (offset + sizeof(header) <= segment.size
+			&& ReadAll(segment.fd, &header, sizeof(header), offset)
+			&& header.magic == AVATAR_PACK_RECORD_MAGIC
+			&& offset + RECORD_SIZE(header.dataSize) <= segment.size) {
+		MD5Buf md5buf;
+		memcpy(md5buf.GetData(), header.md5, MD5_DATA_SIZE);
+		AvatarPackStore::Entry &entry = shard.entries[md5buf];
+		entry.segmentId = segment.id;
+		entry.offset = offset;
+		entry.size = header.dataSize;
+		entry.fileType = static_cast<AvatarFileType>(header.fileType);
+		offset += RECORD_SIZE(header.dataSize);
+	}
+	if (offset < segment.size) {
+		LOG_ERROR("Avatar pack segment " << segment.fileName << " is damaged, truncating at " << offset << ".");
+		if (ftruncate(segment.fd, offset) == 0)
+			segment.size = offset;
+	}
+}
+
+static bool
+AppendRecord(AvatarPackShard &shard, const MD5Buf &md5buf, AvatarFileType fileType,
+			 const unsigned char *data, size_t size, AvatarPackStore::Entry &outEntry)
+{
+	AvatarPackSegment *segment = NULL;
+	if (!shard.segments.empty()) {
+		segment = &shard.segments.rbegin()->second;
+		if (segment->size && segment->size + RECORD_SIZE(size) > AVATAR_PACK_MAX_SEGMENT_SIZE)
+			segment = NULL;
+	}
+	if (!segment)
+		segment = OpenSegment(shard, shard.nextSegmentId);
+	if (!segment)
+		return false;
+
+	// Write header and data at once.
+	vector<unsigned char> record(RECORD_SIZE(size));
+	AvatarPackRecordHeader header;
+	header.magic = AVATAR_PACK_RECORD_MAGIC;
+	header.flags = 0;
+	memcpy(header.md5, md5buf.GetData(), MD5_DATA_SIZE);
+	header.fileType = static_cast<boost::uint32_t>(fileType);
+	header.dataSize = static_cast<boost::uint32_t>(size);
+	memcpy(&record[0], &header, sizeof(header));
+	if (size)
+		memcpy(&record[sizeof(header)], data, size);
+
+	if (!WriteAll(segment->fd, &record[0], record.size(), segment->size)) {
+		LOG_ERROR("Failed to write avatar pack segment " << segment->fileName << ": " << strerror(errno));
+		// Do not leave a partial record behind.
+		if (ftruncate(segment->fd, segment->size) != 0)
+			LOG_ERROR("Failed to truncate avatar pack segment " << segment->fileName << ".");
+		return false;
+	}
+	outEntry.segmentId = segment->id;
+	outEntry.offset = segment->size;
+	outEntry.size = static_cast<unsigned>(size);
+	outEntry.fileType = fileType;
+	segment->size += static_cast<unsigned>(record.size());
+	return true;
+}
+
+static bool
+ReadRecord(const AvatarPackShard &shard, const MD5Buf &md5buf, const AvatarPackStore::Entry &entry, vector<unsigned char> &outData)
+{
+	AvatarPackSegmentMap::const_iterator segment = shard.segments.find(entry.segmentId);
+	if (segment == shard.segments.end())
+		return false;
+
+	vector<unsigned char> record(RECORD_SIZE(entry.size));
+	if (!ReadAll(segment->second.fd, &record[0], record.size(), entry.offset))
+		return false;
+	AvatarPackRecordHeader header;
+	memcpy(&header, &record[0], sizeof(header));
+	if (header.magic != AVATAR_PACK_RECORD_MAGIC || header.dataSize != entry.size
+			|| memcmp(header.md5, md5buf.GetData(), MD5_DATA_SIZE) != 0)
+		return false;
+	outData.assign(record.begin() + sizeof(header), record.end());
+	return true;
+}
+
+
+AvatarPackStore::AvatarPackStore()
+{
+}
+
+AvatarPackStore::~AvatarPackStore()
+{
+	Close();
+}
+
+bool
+AvatarPackStore::Open(const std::string &storeDir)
+{
+	Close();
+	bool retVal = true;
+	try {
+		for (unsigned i = 0; i < AVATAR_PACK_NUM_SHARDS; i++) {
+			boost::shared_ptr<AvatarPackShard> shard(new AvatarPackShard);
+			ostringstream shardName;
+			shardName << hex << i;
+			path shardPath(path(storeDir) / shardName.str());
+			create_directories(shardPath);
+			shard->dir = shardPath.directory_string();
+
+			// Segments need to be scanned in the order they were written.
+			set<unsigned> segmentIds;
+			directory_iterator dirIter(shardPath);
+			directory_iterator end;
+			while (dirIter != end) {
+				unsigned segmentId = 0;
+				if (is_regular(dirIter->status()) && extension(dirIter->path()) == AVATAR_PACK_SEGMENT_EXTENSION) {
+					istringstream idStream(basename(dirIter->path()));
+					if (idStream >> segmentId)
+						segmentIds.insert(segmentId);
+				}
+				++dirIter;
+			}
+			set<unsigned>::const_iterator idIter = segmentIds.begin();
+			set<unsigned>::const_iterator idEnd = segmentIds.end();
+			while (idIter != idEnd) {
+				AvatarPackSegment *segment = OpenSegment(*shard, *idIter);
+				if (segment)
+					ScanSegment(*shard, *segment);
+				else
+					retVal = false;
+				++idIter;
+			}
+			m_shards.push_back(shard);
+		}
+	} catch (...) {
+		LOG_ERROR("Exception caught when trying to open avatar pack store.");
+		retVal = false;
+	}
+	if (!retVal)
+		Close();
+	return retVal;
+}
+
+void
+AvatarPackStore::Close()
+{
+	vector<boost::shared_ptr<AvatarPackShard> >::iterator i = m_shards.begin();
+	vector<boost::shared_ptr<AvatarPackShard> >::iterator end = m_shards.end();
+	while (i != end) {
+		boost::mutex::scoped_lock lock((*i)->mutex);
+		AvatarPackSegmentMap::iterator segment = (*i)->segments.begin();
+		while (segment != (*i)->segments.end()) {
+			close(segment->second.fd);
+			++segment;
+		}
+		(*i)->segments.clear();
+		(*i)->entries.clear();
+		++i;
+	}
+	m_shards.clear();
+}
+
+bool
+AvatarPackStore::Has(const MD5Buf &md5buf) const
+{
+	if (m_shards.empty())
+		return false;
+	AvatarPackShard &shard = GetShard(md5buf);
+	boost::mutex::scoped_lock lock(shard.mutex);
+	return shard.entries.find(md5buf) != shard.entries.end();
+}
+
+bool
+AvatarPackStore::Read(const MD5Buf &md5buf, AvatarFileType &outFileType, std::vector<unsigned char> &outData) const
+{
+	bool retVal = false;
+	if (!m_shards.empty()) {
+		AvatarPackShard &shard = GetShard(md5buf);
+		boost::mutex::scoped_lock lock(shard.mutex);
+		EntryMap::const_iterator pos = shard.entries.find(md5buf);
+		if (pos != shard.entries.end()) {
+			if (ReadRecord(shard, md5buf, pos->second, outData)) {
+				outFileType = pos->second.fileType;
+				retVal = true;
+			} else
+				LOG_ERROR("Failed to read avatar " << md5buf.ToString() << " from pack store.");
+		}
+	}
+	return retVal;
+}
+
+bool
+AvatarPackStore::Store(const MD5Buf &md5buf, AvatarFileType fileType, const unsigned char *data, size_t size)
+{
+	bool retVal = false;
+	if (!m_shards.empty()) {
+		AvatarPackShard &shard = GetShard(md5buf);
+		boost::mutex::scoped_lock lock(shard.mutex);
+		if (shard.entries.find(md5buf) != shard.entries.end())
+			retVal = true;
+		else {
+			Entry entry;
+			if (AppendRecord(shard, md5buf, fileType, data, size, entry)) {
+				shard.entries[md5buf] = entry;
+				retVal = true;
+			}
+		}
+	}
+	return retVal;
+}
+
+void
+AvatarPackStore::GetEntries(EntryMap &outEntries) const
+{
+	vector<boost::shared_ptr<AvatarPackShard> >::const_iterator i = m_shards.begin();
+	vector<boost::shared_ptr<AvatarPackShard> >::const_iterator end = m_shards.end();
+	while (i != end) {
+		boost::mutex::scoped_lock lock((*i)->mutex);
+		outEntries.insert((*i)->entries.begin(), (*i)->entries.end());
+		++i;
+	}
+}
+
+AvatarPackShard &
+AvatarPackStore::GetShard(const MD5Buf &md5buf) const
+{
+	return *m_shards[md5buf.GetData()[0] % AVATAR_PACK_NUM_SHARDS];
+}
@@ -273,57 +273,117 @@ CryptHelper::BytesToKey(const unsigned char *keyData, unsigned keySize, unsigned
 	memcpy(iv + tmpivBytes, keyBuf2.GetData(), AES_BLOCK_SIZE - tmpivBytes);
 }
 
+struct AES128CipherData {
+#ifdef HAVE_OPENSSL
+	EVP_CIPHER_CTX ctx;
+#else
+	gcry_cipher_hd_t hd;
+#endif
+	unsigned char iv[AES_BLOCK_SIZE];
+};
+
+AES128Context::AES128Context()
+	: m_data(NULL)
+{
+}
+
+AES128Context::~AES128Context()
+{
+	Clear();
+}
+
 bool
-CryptHelper::AES128Encrypt(const unsigned char *keyData, unsigned keySize, const string &plainStr, std::vector<unsigned char> &outCipher)
+AES128Context::Init(const unsigned char *keyData, unsigned keySize)
 {
+	Clear();
 	bool retVal = false;
-	unsigned plainSize = static_cast<unsigned>(plainStr.size());
-	if (keySize && plainSize) {
+	if (keySize) {
 		unsigned char key[AES_BLOCK_SIZE];
-		unsigned char iv[AES_BLOCK_SIZE];
-		BytesToKey(keyData, keySize, key, iv);
-		// Add padding to plain data.
-		unsigned paddedPlainSize = ADD_PADDING(plainSize);
-		unsigned char *paddedPlainStr = (unsigned char *)calloc(paddedPlainSize, 1);
-		memcpy(paddedPlainStr, plainStr.c_str(), plainSize);
-		// Perform the encryption.
-		int cipherSize = paddedPlainSize;
-		outCipher.resize(cipherSize);
-
+		AES128CipherData *tmpData = new AES128CipherData;
+		CryptHelper::BytesToKey(keyData, keySize, key, tmpData->iv);
 #ifdef HAVE_OPENSSL
-		EVP_CIPHER_CTX encryptCtx;
-		EVP_CIPHER_CTX_init(&encryptCtx);
-		int outCipherSize = cipherSize;
-
-		int success = EVP_EncryptInit(&encryptCtx, EVP_aes_128_cbc(), key, iv);
-		EVP_CIPHER_CTX_set_padding(&encryptCtx, 0);
-		if (success) {
-			success = EVP_EncryptUpdate(&encryptCtx, &outCipher[0], &outCipherSize, paddedPlainStr, paddedPlainSize);
-
-			if (success && outCipherSize) {
-				// Since padding is off, this will not modify the cipher. However, parameters need to be set.
-				EVP_EncryptFinal(&encryptCtx, &outCipher[0], &outCipherSize);
-				retVal = true;
-			}
+		EVP_CIPHER_CTX_init(&tmpData->ctx);
+		if (EVP_EncryptInit_ex(&tmpData->ctx, EVP_aes_128_cbc(), NULL, key, tmpData->iv)) {
+			EVP_CIPHER_CTX_set_padding(&tmpData->ctx, 0);
+			retVal = true;
 		} else
-			outCipher.clear();
+			EVP_CIPHER_CTX_cleanup(&tmpData->ctx);
 #else
-		gcry_cipher_hd_t hd;
-		gcry_error_t err = gcry_cipher_open(&hd, GCRY_CIPHER_AES128, GCRY_CIPHER_MODE_CBC, 0);
+		gcry_error_t err = gcry_cipher_open(&tmpData->hd, GCRY_CIPHER_AES128, GCRY_CIPHER_MODE_CBC, 0);
 		if (!err) {
-			gcry_cipher_setkey(hd, key, sizeof(key));
-			gcry_cipher_setiv(hd, iv, sizeof(iv));
-			err = gcry_cipher_encrypt(hd, &outCipher[0], cipherSize, paddedPlainStr, paddedPlainSize);
+			err = gcry_cipher_setkey(tmpData->hd, key, sizeof(key));
 			if (!err)
 				retVal = true;
 			else
-				outCipher.clear();
-		} else
-			outCipher.clear();
+				gcry_cipher_close(tmpData->hd);
+		}
+#endif
+		memset(key, 0, sizeof(key));
+		if (retVal)
+			m_data = tmpData;
+		else
+			delete tmpData;
+	}
+	return retVal;
+}
 
-		gcry_cipher_close(hd);
+void
+AES128Context::Clear()
+{
+	if (m_data) {
+#ifdef HAVE_OPENSSL
+		EVP_CIPHER_CTX_cleanup(&m_data->ctx);
+#else
+		gcry_cipher_close(m_data->hd);
+#endif
+		delete m_data;
+		m_data = NULL;
+	}
+}
+
+bool
+AES128Context::IsValid() const
+{
+	return m_data != NULL;
+}
+
+bool
+AES128Context::Encrypt(const unsigned char *plainData, unsigned plainSize, unsigned char *outCipher, unsigned cipherBufSize)
+{
+	bool retVal = false;
+	unsigned paddedPlainSize = ADD_PADDING(plainSize);
+	if (m_data && plainSize && cipherBufSize >= paddedPlainSize) {
+		// Pad in the output buffer and encrypt in place.
+		memcpy(outCipher, plainData, plainSize);
+		memset(outCipher + plainSize, 0, paddedPlainSize - plainSize);
+#ifdef HAVE_OPENSSL
+		int outCipherSize = paddedPlainSize;
+		// Only reset the iv, the key schedule is kept.
+		if (EVP_EncryptInit_ex(&m_data->ctx, NULL, NULL, NULL, m_data->iv)
+				&& EVP_EncryptUpdate(&m_data->ctx, outCipher, &outCipherSize, outCipher, paddedPlainSize)) {
+			retVal = outCipherSize == (int)paddedPlainSize;
+		}
+#else
+		if (!gcry_cipher_setiv(m_data->hd, m_data->iv, AES_BLOCK_SIZE))
+			retVal = !gcry_cipher_encrypt(m_data->hd, outCipher, paddedPlainSize, NULL, 0);
 #endif
-		free(paddedPlainStr);
+	}
+	return retVal;
+}
+
+bool
+CryptHelper::AES128Encrypt(const unsigned char *keyData, unsigned keySize, const string &plainStr, std::vector<unsigned char> &outCipher)
+{
+	bool retVal = false;
+	unsigned plainSize = static_cast<unsigned>(plainStr.size());
+	if (keySize && plainSize) {
+		AES128Context context;
+		if (context.Init(keyData, keySize)) {
+			outCipher.resize(ADD_PADDING(plainSize));
+			retVal = context.Encrypt((const unsigned char *)plainStr.c_str(), plainSize, &outCipher[0], (unsigned)outCipher.size());
+		}
+		if (!retVal)
+			outCipher.clear();
 	}
 	return retVal;
 }
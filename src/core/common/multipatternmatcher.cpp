@@ -0,0 +1,230 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+
+#include <core/multipatternmatcher.h>
+
+#include <algorithm>
+#include <deque>
+
+using namespace std;
+
+#define MATCHER_ROOT_STATE	0
+#define MATCHER_NO_STATE	0xFFFFFFFF
+
+MultiPatternMatcher::MultiPatternMatcher()
+	: m_numPatterns(0), m_built(false)
+{
+	Clear();
+}
+
+void
+MultiPatternMatcher::Clear()
+{
+	m_buildTrie.clear();
+	m_buildOutput.clear();
+	m_buildTrie.push_back(TransitionMap());
+	m_buildOutput.push_back(IndexList());
+
+	fill(m_rootTransition, m_rootTransition + 256, MATCHER_ROOT_STATE);
+	m_edgeStart.assign(2, 0);
+	m_edgeLabel.clear();
+	m_edgeTarget.clear();
+	m_failLink.assign(1, MATCHER_ROOT_STATE);
+	m_outputLink.assign(1, MATCHER_ROOT_STATE);
+	m_outputStart.assign(2, 0);
+	m_outputIds.clear();
+
+	m_numPatterns = 0;
+	m_built = false;
+}
+
+unsigned
+MultiPatternMatcher::AddPattern(const std::string &pattern)
+{
+	unsigned patternId = m_numPatterns++;
+	if (!pattern.empty()) {
+		unsigned state = MATCHER_ROOT_STATE;
+		string::const_iterator i = pattern.begin();
+		string::const_iterator end = pattern.end();
+		while (i != end) {
+			unsigned char c = static_cast<unsigned char>(*i);
+			TransitionMap::const_iterator pos = m_buildTrie[state].find(c);
+			if (pos == m_buildTrie[state].end()) {
+				unsigned newState = static_cast<unsigned>(m_buildTrie.size());
+				m_buildTrie[state][c] = newState;
+				m_buildTrie.push_back(TransitionMap());
+				m_buildOutput.push_back(IndexList());
+				state = newState;
+			} else {
+				state = pos->second;
+			}
+			++i;
+		}
+		m_buildOutput[state].push_back(patternId);
+	}
+	m_built = false;
+	return patternId;
+}
+
+void
+MultiPatternMatcher::Build()
+{
+	unsigned numStates = static_cast<unsigned>(m_buildTrie.size());
+
+	// Flatten the trie. States are numbered in insertion order, so the
+	// transitions can be stored per state in ascending label order.
+	m_edgeStart.assign(numStates + 1, 0);
+	m_edgeLabel.clear();
+	m_edgeTarget.clear();
+	m_outputStart.assign(numStates + 1, 0);
+	m_outputIds.clear();
+	for (unsigned state = 0; state < numStates; state++) {
+		m_edgeStart[state] = static_cast<unsigned>(m_edgeTarget.size());
+		TransitionMap::const_iterator i = m_buildTrie[state].begin();
+		TransitionMap::const_iterator end = m_buildTrie[state].end();
+		while (i != end) {
+			m_edgeLabel.push_back(i->first);
+			m_edgeTarget.push_back(i->second);
+			++i;
+		}
+		m_outputStart[state] = static_cast<unsigned>(m_outputIds.size());
+		m_outputIds.insert(m_outputIds.end(), m_buildOutput[state].begin(), m_buildOutput[state].end());
+	}
+	m_edgeStart[numStates] = static_cast<unsigned>(m_edgeTarget.size());
+	m_outputStart[numStates] = static_cast<unsigned>(m_outputIds.size());
+
+	// The root has a full transition table, missing transitions loop back.
+	fill(m_rootTransition, m_rootTransition + 256, MATCHER_ROOT_STATE);
+	for (unsigned e = m_edgeStart[MATCHER_ROOT_STATE]; e < m_edgeStart[MATCHER_ROOT_STATE + 1]; e++)
+		m_rootTransition[m_edgeLabel[e]] = m_edgeTarget[e];
+
+	// Compute failure links and output links breadth first.
+	m_failLink.assign(numStates, MATCHER_ROOT_STATE);
+	m_outputLink.assign(numStates, MATCHER_ROOT_STATE);
+	deque<unsigned> stateQueue;
+	for (unsigned e = m_edgeStart[MATCHER_ROOT_STATE]; e < m_edgeStart[MATCHER_ROOT_STATE + 1]; e++)
+		stateQueue.push_back(m_edgeTarget[e]);
+
+	while (!stateQueue.empty()) {
+		unsigned state = stateQueue.front();
+		stateQueue.pop_front();
+		for (unsigned e = m_edgeStart[state]; e < m_edgeStart[state + 1]; e++) {
+			unsigned child = m_edgeTarget[e];
+			unsigned fail = NextState(m_failLink[state], m_edgeLabel[e]);
+			m_failLink[child] = fail;
+			m_outputLink[child] = (m_outputStart[fail] != m_outputStart[fail + 1]) ? fail : m_outputLink[fail];
+			stateQueue.push_back(child);
+		}
+	}
+
+	m_buildTrie.clear();
+	m_buildOutput.clear();
+	m_built = true;
+}
+
+unsigned
+MultiPatternMatcher::GetNumPatterns() const
+{
+	return m_numPatterns;
+}
+
+bool
+MultiPatternMatcher::IsEmpty() const
+{
+	return m_outputIds.empty();
+}
+
+void
+MultiPatternMatcher::FindAll(const std::string &text, std::vector<char> &hits) const
+{
+	hits.assign(m_numPatterns, 0);
+	if (!m_built || IsEmpty())
+		return;
+
+	unsigned state = MATCHER_ROOT_STATE;
+	string::const_iterator i = text.begin();
+	string::const_iterator end = text.end();
+	while (i != end) {
+		state = NextState(state, static_cast<unsigned char>(*i));
+		unsigned out = (m_outputStart[state] != m_outputStart[state + 1]) ? state : m_outputLink[state];
+		while (out != MATCHER_ROOT_STATE) {
+			unsigned o = m_outputStart[out];
+			// If this state was reported before, its whole output chain was too.
+			if (hits[m_outputIds[o]])
+				break;
+			for (; o < m_outputStart[out + 1]; o++)
+				hits[m_outputIds[o]] = 1;
+			out = m_outputLink[out];
+		}
+		++i;
+	}
+}
+
+bool
+MultiPatternMatcher::FindAny(const std::string &text) const
+{
+	if (!m_built || IsEmpty())
+		return false;
+
+	unsigned state = MATCHER_ROOT_STATE;
+	string::const_iterator i = text.begin();
+	string::const_iterator end = text.end();
+	while (i != end) {
+		state = NextState(state, static_cast<unsigned char>(*i));
+		if (m_outputStart[state] != m_outputStart[state + 1] || m_outputLink[state] != MATCHER_ROOT_STATE)
+			return true;
+		++i;
+	}
+	return false;
+}
+
+unsigned
+MultiPatternMatcher::NextState(unsigned state, unsigned char c) const
+{
+	unsigned next;
+	while (state != MATCHER_ROOT_STATE && (next = FindTransition(state, c)) == MATCHER_NO_STATE)
+		state = m_failLink[state];
+	if (state == MATCHER_ROOT_STATE)
+		next = m_rootTransition[c];
+	return next;
+}
+
+unsigned
+MultiPatternMatcher::FindTransition(unsigned state, unsigned char c) const
+{
+	unsigned retVal = MATCHER_NO_STATE;
+	const unsigned char *first = &m_edgeLabel[0] + m_edgeStart[state];
+	const unsigned char *last = &m_edgeLabel[0] + m_edgeStart[state + 1];
+	const unsigned char *pos = lower_bound(first, last, c);
+	if (pos != last && *pos == c)
+		retVal = m_edgeTarget[pos - &m_edgeLabel[0]];
+	return retVal;
+}
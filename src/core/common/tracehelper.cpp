@@ -0,0 +1,217 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+
+#include <core/tracehelper.h>
+#include <boost/atomic.hpp>
+#include <boost/chrono.hpp>
+#include <boost/thread.hpp>
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+using namespace std;
+
+struct TraceEvent {
+	boost::atomic<const char *> name;
+	boost::atomic<boost::uint64_t> startUsec;
+	boost::atomic<boost::uint64_t> endUsec;
+};
+
+struct TraceEventData {
+	const char *name;
+	boost::uint64_t startUsec;
+	boost::uint64_t endUsec;
+	unsigned threadId;
+
+	bool operator<(const TraceEventData &other) const
+	{
+		return startUsec < other.startUsec;
+	}
+};
+
+// Ring buffer with a single writer, the owning thread. Readers detect
+// events which were overwritten while reading through the write position.
+struct TraceBuffer {
+	TraceBuffer(unsigned id) : threadId(id), inUse(false), writePos(0) {}
+
+	const unsigned threadId;
+	// Protected by the registry mutex.
+	bool inUse;
+	boost::atomic<boost::uint64_t> writePos;
+	TraceEvent events[TRACE_BUFFER_NUM_EVENTS];
+};
+
+static const boost::chrono::steady_clock::time_point s_traceStartTime = boost::chrono::steady_clock::now();
+
+// Buffers are never freed, the buffer of a terminated thread is reused.
+static boost::mutex s_traceBufferMutex;
+static vector<TraceBuffer *> s_traceBufferList;
+
+static void
+ReleaseTraceBuffer(TraceBuffer *buffer)
+{
+	boost::mutex::scoped_lock lock(s_traceBufferMutex);
+	buffer->inUse = false;
+}
+
+static boost::thread_specific_ptr<TraceBuffer> s_threadTraceBuffer(&ReleaseTraceBuffer);
+
+static TraceBuffer &
+GetThreadTraceBuffer()
+{
+	TraceBuffer *buffer = s_threadTraceBuffer.get();
+	if (!buffer) {
+		boost::mutex::scoped_lock lock(s_traceBufferMutex);
+		vector<TraceBuffer *>::iterator i = s_traceBufferList.begin();
+		vector<TraceBuffer *>::iterator end = s_traceBufferList.end();
+		while (i != end && (*i)->inUse)
+			++i;
+		if (i != end) {
+			buffer = *i;
+		} else {
+			buffer = new TraceBuffer((unsigned)s_traceBufferList.size() + 1);
+			s_traceBufferList.push_back(buffer);
+		}
+		buffer->inUse = true;
+		s_threadTraceBuffer.reset(buffer);
+	}
+	return *buffer;
+}
+
+static void
+ReadTraceBuffer(const TraceBuffer &buffer, boost::uint64_t minStartUsec, vector<TraceEventData> &outEvents)
+{
+	boost::uint64_t endPos = buffer.writePos.load(boost::memory_order_acquire);
+	boost::uint64_t startPos = endPos > TRACE_BUFFER_NUM_EVENTS ? endPos - TRACE_BUFFER_NUM_EVENTS : 0;
+	vector<TraceEventData> tmpEvents;
+	tmpEvents.reserve((size_t)(endPos - startPos));
+	for (boost::uint64_t pos = startPos; pos < endPos; pos++) {
+		const TraceEvent &event = buffer.events[pos % TRACE_BUFFER_NUM_EVENTS];
+		TraceEventData data;
+		data.name = event.name.load(boost::memory_order_relaxed);
+		data.startUsec = event.startUsec.load(boost::memory_order_relaxed);
+		data.endUsec = event.endUsec.load(boost::memory_order_relaxed);
+		data.threadId = buffer.threadId;
+		tmpEvents.push_back(data);
+	}
+	boost::atomic_thread_fence(boost::memory_order_acquire);
+	// The writer may meanwhile have overwritten the oldest events,
+	// including the one it is currently writing.
+	boost::uint64_t newEndPos = buffer.writePos.load(boost::memory_order_relaxed);
+	boost::uint64_t validStartPos = newEndPos >= TRACE_BUFFER_NUM_EVENTS ? newEndPos - TRACE_BUFFER_NUM_EVENTS + 1 : 0;
+	for (boost::uint64_t pos = max(startPos, validStartPos); pos < endPos; pos++) {
+		const TraceEventData &data = tmpEvents[(size_t)(pos - startPos)];
+		if (data.startUsec >= minStartUsec)
+			outEvents.push_back(data);
+	}
+}
+
+static void
+WriteJsonString(ostream &o, const char *str)
+{
+	o << '"';
+	while (str && *str) {
+		if (*str == '"' || *str == '\\')
+			o << '\\';
+		if ((unsigned char)*str >= 0x20)
+			o << *str;
+		++str;
+	}
+	o << '"';
+}
+
+boost::uint64_t
+tracehelper_now_usec()
+{
+	return boost::chrono::duration_cast<boost::chrono::microseconds>(boost::chrono::steady_clock::now() - s_traceStartTime).count();
+}
+
+void
+tracehelper_add_event(const char *name, boost::uint64_t startUsec, boost::uint64_t endUsec)
+{
+	TraceBuffer &buffer = GetThreadTraceBuffer();
+	boost::uint64_t pos = buffer.writePos.load(boost::memory_order_relaxed);
+	TraceEvent &event = buffer.events[pos % TRACE_BUFFER_NUM_EVENTS];
+	event.name.store(name, boost::memory_order_relaxed);
+	event.startUsec.store(startUsec, boost::memory_order_relaxed);
+	event.endUsec.store(endUsec, boost::memory_order_relaxed);
+	buffer.writePos.store(pos + 1, boost::memory_order_release);
+}
+
+bool
+tracehelper_dump(const string &fileName, unsigned lastSeconds)
+{
+	if (!tracehelper_enabled())
+		return false;
+
+	boost::uint64_t now = tracehelper_now_usec();
+	boost::uint64_t minStartUsec = now > (boost::uint64_t)lastSeconds * 1000000 ? now - (boost::uint64_t)lastSeconds * 1000000 : 0;
+	vector<TraceEventData> events;
+	{
+		boost::mutex::scoped_lock lock(s_traceBufferMutex);
+		vector<TraceBuffer *>::const_iterator i = s_traceBufferList.begin();
+		vector<TraceBuffer *>::const_iterator end = s_traceBufferList.end();
+		while (i != end) {
+			ReadTraceBuffer(**i, minStartUsec, events);
+			++i;
+		}
+	}
+	sort(events.begin(), events.end());
+
+	ofstream o(fileName.c_str(), ios_base::out | ios_base::trunc);
+	if (o.fail())
+		return false;
+	o << "{\"traceEvents\":[";
+	vector<TraceEventData>::const_iterator i = events.begin();
+	vector<TraceEventData>::const_iterator end = events.end();
+	while (i != end) {
+		if (i != events.begin())
+			o << ",";
+		o << "\n{\"name\":";
+		WriteJsonString(o, i->name);
+		o << ",\"cat\":\"pokerth\",\"ph\":\"X\",\"ts\":" << i->startUsec
+		  << ",\"dur\":" << (i->endUsec >= i->startUsec ? i->endUsec - i->startUsec : 0)
+		  << ",\"pid\":1,\"tid\":" << i->threadId << "}";
+		++i;
+	}
+	o << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return !o.fail();
+}
+
+bool
+tracehelper_enabled()
+{
+#ifdef POKERTH_TRACE
+	return true;
+#else
+	return false;
+#endif
+}
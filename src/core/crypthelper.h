@@ -35,6 +35,7 @@
 
 #include <string>
 #include <vector>
+#include <cstring>
 
 #define MD5_DATA_SIZE		16
 #define SHA1_DATA_SIZE		20
@@ -72,6 +73,16 @@ private:
 	unsigned char m_data[MD5_DATA_SIZE];
 };
 
+// Hash function for unordered containers. The MD5 sum is already well
+// distributed, so its first bytes are used.
+struct MD5BufHash {
+	size_t operator()(const MD5Buf &md5buf) const {
+		size_t hash;
+		memcpy(&hash, md5buf.GetData(), sizeof(hash));
+		return hash;
+	}
+};
+
 class SHA1Buf : public HashBuf
 {
 public:
@@ -84,8 +95,34 @@ public:
 	unsigned char m_data[SHA1_DATA_SIZE];
 };
 
+struct AES128CipherData;
+
+// AES-128-CBC cipher with the key and iv derived once from a password.
+// The cipher context is kept open so that repeated encryption does not
+// run the key derivation or allocate memory.
+class AES128Context
+{
+public:
+	AES128Context();
+	~AES128Context();
+
+	bool Init(const unsigned char *keyData, unsigned keySize);
+	void Clear();
+	bool IsValid() const;
+
+	// Plain data is padded with zeroes, outCipher needs ADD_PADDING(plainSize) bytes.
+	bool Encrypt(const unsigned char *plainData, unsigned plainSize, unsigned char *outCipher, unsigned cipherBufSize);
+
+private:
+	AES128Context(const AES128Context &other);
+	AES128Context &operator=(const AES128Context &other);
+
+	AES128CipherData *m_data;
+};
+
 class CryptHelper
 {
+	friend class AES128Context;
 public:
 
 	static bool MD5Sum(const std::string &fileName, MD5Buf &buf);
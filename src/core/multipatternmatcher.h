@@ -0,0 +1,89 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+/* Aho-Corasick automaton for matching many literal patterns at once. */
+
+#ifndef _MULTIPATTERNMATCHER_H_
+#define _MULTIPATTERNMATCHER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+class MultiPatternMatcher
+{
+public:
+	MultiPatternMatcher();
+
+	// Remove all patterns. The matcher needs to be rebuilt afterwards.
+	void Clear();
+	// Add a literal pattern and return its id (ids are assigned sequentially,
+	// starting at 0). Empty patterns are accepted but never match.
+	unsigned AddPattern(const std::string &pattern);
+	// Compile the automaton. Needs to be called after adding patterns and
+	// before matching.
+	void Build();
+
+	unsigned GetNumPatterns() const;
+	bool IsEmpty() const;
+
+	// Scan the text once, setting hits[id] to 1 for every pattern which
+	// occurs in the text. The vector is resized to GetNumPatterns().
+	void FindAll(const std::string &text, std::vector<char> &hits) const;
+	// Returns true if any pattern occurs in the text.
+	bool FindAny(const std::string &text) const;
+
+protected:
+	typedef std::map<unsigned char, unsigned> TransitionMap;
+	typedef std::vector<unsigned> IndexList;
+
+	unsigned NextState(unsigned state, unsigned char c) const;
+	unsigned FindTransition(unsigned state, unsigned char c) const;
+
+private:
+	// Trie which is used while adding patterns.
+	std::vector<TransitionMap> m_buildTrie;
+	std::vector<IndexList> m_buildOutput;
+
+	// Compiled automaton, transitions in compressed sparse row format.
+	unsigned m_rootTransition[256];
+	IndexList m_edgeStart;
+	std::vector<unsigned char> m_edgeLabel;
+	IndexList m_edgeTarget;
+	IndexList m_failLink;
+	IndexList m_outputLink;
+	IndexList m_outputStart;
+	IndexList m_outputIds;
+
+	unsigned m_numPatterns;
+	bool m_built;
+};
+
+#endif
@@ -0,0 +1,76 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+/* Helper for tracing handler run times. */
+
+#ifndef _TRACEHELPER_H_
+#define _TRACEHELPER_H_
+
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <string>
+
+// Events per thread, older events are overwritten.
+#define TRACE_BUFFER_NUM_EVENTS		32768
+
+boost::uint64_t tracehelper_now_usec();
+// The name needs to be a string literal, only the pointer is stored.
+void tracehelper_add_event(const char *name, boost::uint64_t startUsec, boost::uint64_t endUsec);
+// Writes the events of the last seconds in the Chrome trace event format.
+// Returns false if tracing was not compiled in or the file cannot be written.
+bool tracehelper_dump(const std::string &fileName, unsigned lastSeconds);
+bool tracehelper_enabled();
+
+class TraceScope : private boost::noncopyable
+{
+public:
+	TraceScope(const char *name)
+		: m_name(name), m_startUsec(tracehelper_now_usec()) {}
+
+	~TraceScope()
+	{
+		tracehelper_add_event(m_name, m_startUsec, tracehelper_now_usec());
+	}
+
+private:
+	const char *m_name;
+	boost::uint64_t m_startUsec;
+};
+
+// Trace points are only compiled in if POKERTH_TRACE is defined.
+#ifdef POKERTH_TRACE
+#define TRACE_SCOPE_CONCAT2(_a, _b) _a##_b
+#define TRACE_SCOPE_CONCAT(_a, _b) TRACE_SCOPE_CONCAT2(_a, _b)
+#define TRACE_SCOPE(_name) TraceScope TRACE_SCOPE_CONCAT(traceScope, __LINE__)(_name)
+#else
+#define TRACE_SCOPE(_name) do {} while(false)
+#endif
+
+#endif
@@ -43,6 +43,8 @@
 #include <dbofficial/asyncdbblockplayer.h>
 #include <dbofficial/compositeasyncdbquery.h>
 #include <dbofficial/db_table_defs.h>
+#include <net/servermetrics.h>
+#include <core/tracehelper.h>
 #include <ctime>
 #include <sstream>
 #include <mysql++.h>
@@ -498,6 +500,8 @@ ServerDBThread::HandleNextQuery()
 	}
 	if (nextQuery) {
 		do {
+			TRACE_SCOPE("ServerDBThread::Query");
+			ServerMetricsTimer queryTimer(METRIC_DB_QUERY_USEC);
 			nextQuery->Init(m_dbIdManager);
 			mysqlpp::Query executeQuery = m_connData->conn.query();
 			executeQuery << "EXECUTE " << nextQuery->GetPreparedName();
@@ -527,6 +531,7 @@ ServerDBThread::HandleNextQuery()
 					++i;
 				}
 				if (!paramQuery.exec()) {
+					ServerMetrics::AddCounter(METRIC_DB_ERRORS);
 					m_connData->conn.disconnect();
 					m_ioService->post(boost::bind(&ServerDBCallback::QueryError, &m_callback, paramQuery.error()));
 					break;
@@ -534,15 +539,19 @@ ServerDBThread::HandleNextQuery()
 			}
 			if (nextQuery->RequiresResultSet()) {
 				mysqlpp::StoreQueryResult res = executeQuery.store();
-				if (res)
+				if (res) {
 					nextQuery->HandleResult(executeQuery, m_dbIdManager, res, *m_ioService, m_callback);
-				else
+				} else {
+					ServerMetrics::AddCounter(METRIC_DB_ERRORS);
 					nextQuery->HandleError(*m_ioService, m_callback);
+				}
 			} else {
-				if (executeQuery.exec())
+				if (executeQuery.exec()) {
 					nextQuery->HandleNoResult(executeQuery, m_dbIdManager, *m_ioService, m_callback);
-				else
+				} else {
+					ServerMetrics::AddCounter(METRIC_DB_ERRORS);
 					nextQuery->HandleError(*m_ioService, m_callback);
+				}
 			}
 		} while (nextQuery->Next()); // Consider composite queries.
 	}
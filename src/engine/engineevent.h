@@ -0,0 +1,130 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+
+#ifndef ENGINEEVENT_H
+#define ENGINEEVENT_H
+
+#include <game_defs.h>
+
+enum EngineEventType {
+	ENGINE_EVENT_HAND_START = 0, // playerId: dealer, amount: small blind
+	ENGINE_EVENT_HOLE_CARDS, // cards 0-1
+	ENGINE_EVENT_BLIND, // amount: blind set
+	ENGINE_EVENT_PLAYERS_TURN,
+	ENGINE_EVENT_PLAYER_ACTION, // amount: last relative set
+	ENGINE_EVENT_ROUND_CHANGE,
+	ENGINE_EVENT_BOARD_CARDS, // all board cards of the round, others are -1
+	ENGINE_EVENT_POT_AWARD // amount: money won
+};
+
+// One step of a hand. The engine does not format strings or call the gui
+// for events, consumers read the state they need from the event.
+struct EngineEvent {
+	unsigned char type; // EngineEventType
+	unsigned char round; // GameState
+	unsigned char action; // PlayerAction
+	signed char cards[5];
+	unsigned playerId;
+	int amount;
+};
+
+// Append only event stream in storage which is supplied by the caller.
+// Events which do not fit are dropped and flagged as overflow.
+class EngineEventBuffer
+{
+public:
+	EngineEventBuffer(EngineEvent *events, unsigned capacity)
+		: myEvents(events), myCapacity(capacity), mySize(0), myOverflow(false) {}
+
+	void clear() {
+		mySize = 0;
+		myOverflow = false;
+	}
+
+	unsigned size() const {
+		return mySize;
+	}
+	bool empty() const {
+		return mySize == 0;
+	}
+	bool getOverflow() const {
+		return myOverflow;
+	}
+	const EngineEvent &at(unsigned i) const {
+		return myEvents[i];
+	}
+
+	void add(EngineEventType type, GameState round, unsigned playerId = 0, int amount = 0, PlayerAction action = PLAYER_ACTION_NONE) {
+		next(type, round, playerId, amount, action);
+	}
+
+	void addHoleCards(GameState round, unsigned playerId, const int *holeCards) {
+		EngineEvent *e = next(ENGINE_EVENT_HOLE_CARDS, round, playerId, 0, PLAYER_ACTION_NONE);
+		if (e) {
+			e->cards[0] = static_cast<signed char>(holeCards[0]);
+			e->cards[1] = static_cast<signed char>(holeCards[1]);
+		}
+	}
+
+	// Adds the board cards which are open in the given round.
+	void addBoardCards(GameState round, const int *boardCards) {
+		int numCards = round == GAME_STATE_FLOP ? 3 : round == GAME_STATE_TURN ? 4 : round >= GAME_STATE_RIVER ? 5 : 0;
+		EngineEvent *e = next(ENGINE_EVENT_BOARD_CARDS, round, 0, 0, PLAYER_ACTION_NONE);
+		if (e) {
+			for (int i = 0; i < numCards; i++)
+				e->cards[i] = static_cast<signed char>(boardCards[i]);
+		}
+	}
+
+private:
+	EngineEvent *next(EngineEventType type, GameState round, unsigned playerId, int amount, PlayerAction action) {
+		if (mySize >= myCapacity) {
+			myOverflow = true;
+			return 0;
+		}
+		EngineEvent *e = &myEvents[mySize++];
+		e->type = static_cast<unsigned char>(type);
+		e->round = static_cast<unsigned char>(round);
+		e->action = static_cast<unsigned char>(action);
+		for (int i = 0; i < 5; i++)
+			e->cards[i] = -1;
+		e->playerId = playerId;
+		e->amount = amount;
+		return e;
+	}
+
+	EngineEvent *myEvents;
+	unsigned myCapacity;
+	unsigned mySize;
+	bool myOverflow;
+};
+
+#endif
@@ -38,6 +38,8 @@
 #include "berointerface.h"
 #include "log.h"
 
+class EngineEventBuffer;
+
 class EngineFactory
 {
 public:
@@ -48,6 +50,9 @@ public:
 	virtual boost::shared_ptr<BoardInterface> createBoard() =0;
 	virtual boost::shared_ptr<PlayerInterface> createPlayer(int id, unsigned uniqueId, PlayerType type, std::string name, std::string avatar, int sC, bool aS, bool sotS, int mB) =0;
 	virtual std::vector<boost::shared_ptr<BeRoInterface> > createBeRo(HandInterface *hi, unsigned dP, int sB) =0;
+
+	// Engines which support it report the hand as events instead of gui callbacks.
+	virtual void setEventBuffer(EngineEventBuffer * /*events*/) {}
 };
 
 #endif
@@ -179,10 +179,7 @@ void Game::initHand()
 		}
 	}
 
-	runningPlayerList->clear();
-	(*runningPlayerList) = (*activePlayerList);
-
-	// create Hand
+	// create Hand, it resets the running player list
 	currentHand = myFactory->createHand(myFactory, myGui, currentBoard, myLog, seatsList, activePlayerList, runningPlayerList, currentHandID, startQuantityPlayers, dealerPosition, currentSmallBlind, startCash);
 
 	// shifting dealer button -> TODO exception-rule !!!
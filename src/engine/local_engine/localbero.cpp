@@ -37,47 +37,83 @@
 
 using namespace std;
 
-LocalBeRo::LocalBeRo(HandInterface* hi, unsigned dP, int sB, GameState gS)
-	: BeRoInterface(), myHand(hi), myBeRoID(gS), dealerPosition(dP), smallBlindPosition(0), smallBlindPositionId(0), bigBlindPositionId(0), smallBlind(sB), highestSet(0), minimumRaise(2*sB), fullBetRule(false), firstRun(true), firstRunGui(true), firstRound(true), firstHeadsUpRound(true), currentPlayersTurnId(0), firstRoundLastPlayersTurnId(0), logBoardCardsDone(false)
+LocalBeRo::LocalBeRo(HandInterface* hi, boost::shared_ptr<LocalTableState> tS, unsigned dP, int sB, GameState gS)
+	: BeRoInterface(), myHand(hi), myTableState(tS), myBeRoID(gS), dealerPosition(dP), smallBlindPosition(0), smallBlindPositionId(0), bigBlindPositionId(0), smallBlind(sB), highestSet(0), minimumRaise(2*sB), fullBetRule(false), firstRun(true), firstRunGui(true), firstRound(true), firstHeadsUpRound(true), currentPlayersTurnId(0), firstRoundLastPlayersTurnId(0), logBoardCardsDone(false)
 {
+	LocalBeRo::reset(dP, sB);
+}
+
+
+LocalBeRo::~LocalBeRo()
+{
+}
+
+void LocalBeRo::reset(unsigned dP, int sB)
+{
+	dealerPosition = dP;
+	smallBlindPosition = 0;
+	smallBlind = sB;
+	highestSet = 0;
+	minimumRaise = 2*sB;
+	fullBetRule = false;
+	firstRun = true;
+	firstRunGui = true;
+	firstRound = true;
+	firstHeadsUpRound = true;
+	currentPlayersTurnId = 0;
+	firstRoundLastPlayersTurnId = 0;
+	logBoardCardsDone = false;
+
 	currentPlayersTurnIt = myHand->getRunningPlayerList()->begin();
 	lastPlayersTurnIt = myHand->getRunningPlayerList()->begin();
 
-	PlayerListConstIterator it_c;
-
-	// determine bigBlindPosition
-	for(it_c=myHand->getActivePlayerList()->begin(); it_c!=myHand->getActivePlayerList()->end(); ++it_c) {
-		if((*it_c)->getMyButton() == BUTTON_BIG_BLIND) {
-			bigBlindPositionId = (*it_c)->getMyUniqueID();
-			break;
+	// determine bigBlindPosition and smallBlindPosition
+	const LocalTableState &table = *myTableState;
+	int bigBlindSeat = -1;
+	int smallBlindSeat = -1;
+	for(int seat=0; seat<MAX_NUMBER_OF_PLAYERS; seat++) {
+		if(table.activeMask & LocalTableState::seatBit(seat)) {
+			if(bigBlindSeat < 0 && table.button[seat] == BUTTON_BIG_BLIND) {
+				bigBlindSeat = seat;
+			}
+			if(smallBlindSeat < 0 && table.button[seat] == BUTTON_SMALL_BLIND) {
+				smallBlindSeat = seat;
+			}
 		}
 	}
-	if(it_c == myHand->getActivePlayerList()->end()) {
+	if(bigBlindSeat < 0 || smallBlindSeat < 0) {
 		throw LocalException(__FILE__, __LINE__, ERR_ACTIVE_PLAYER_NOT_FOUND);
 	}
+	bigBlindPositionId = table.uniqueId[bigBlindSeat];
+	smallBlindPositionId = table.uniqueId[smallBlindSeat];
+}
 
-	// determine smallBlindPosition
-	for(it_c=myHand->getActivePlayerList()->begin(); it_c!=myHand->getActivePlayerList()->end(); ++it_c) {
-		if((*it_c)->getMyButton() == BUTTON_SMALL_BLIND) {
-			smallBlindPositionId = (*it_c)->getMyUniqueID();
-			break;
-		}
-	}
-	if(it_c == myHand->getActivePlayerList()->end()) {
-		throw LocalException(__FILE__, __LINE__, ERR_ACTIVE_PLAYER_NOT_FOUND);
-	}
 
+int LocalBeRo::getHighestCardsValue() const
+{
+	LOG_ERROR(__FILE__ << " (" << __LINE__ << "): getHighestCardsValue() in wrong BeRo");
+	return 0;
 }
 
-
-LocalBeRo::~LocalBeRo()
+bool LocalBeRo::allRunningPlayersHaveHighestSet() const
 {
+	const LocalTableState &table = *myTableState;
+	for(int seat=0; seat<MAX_NUMBER_OF_PLAYERS; seat++) {
+		if((table.runningMask & LocalTableState::seatBit(seat)) && table.set[seat] != highestSet) {
+			return false;
+		}
+	}
+	return true;
 }
 
-int LocalBeRo::getHighestCardsValue() const
+void LocalBeRo::resetRunningPlayersAction()
 {
-	LOG_ERROR(__FILE__ << " (" << __LINE__ << "): getHighestCardsValue() in wrong BeRo");
-	return 0;
+	LocalTableState &table = *myTableState;
+	for(int seat=0; seat<MAX_NUMBER_OF_PLAYERS; seat++) {
+		if(table.runningMask & LocalTableState::seatBit(seat)) {
+			table.action[seat] = PLAYER_ACTION_NONE;
+		}
+	}
 }
 
 void LocalBeRo::nextPlayer()
@@ -94,8 +130,10 @@ void LocalBeRo::nextPlayer()
 
 void LocalBeRo::run()
 {
+	EngineEventBuffer *events = myTableState->events;
 
-	if(firstRunGui) {
+	// event driven hands do not wait for a gui deal animation
+	if(firstRunGui && !events) {
 		firstRunGui = false;
 		myHand->setPreviousPlayerID(-1);
 		myHand->getGuiInterface()->dealBeRoCards(myBeRoID);
@@ -151,38 +189,30 @@ void LocalBeRo::run()
 
 			myHand->getBoard()->getMyCards(boardCards);
 
-			switch(myBeRoID) {
-			case GAME_STATE_FLOP:
-				myHand->getGuiInterface()->logDealBoardCardsMsg(myBeRoID, boardCards[0], boardCards[1], boardCards[2]);
-				break;
-			case GAME_STATE_TURN:
-				myHand->getGuiInterface()->logDealBoardCardsMsg(myBeRoID, boardCards[0], boardCards[1], boardCards[2], boardCards[3]);
-				break;
-			case GAME_STATE_RIVER:
-				myHand->getGuiInterface()->logDealBoardCardsMsg(myBeRoID, boardCards[0], boardCards[1], boardCards[2], boardCards[3], boardCards[4]);
-
-				break;
-			default: {
-				LOG_ERROR(__FILE__ << " (" << __LINE__ << "): ERROR - wrong myBeRoID");
-			}
+			if(!events) {
+				switch(myBeRoID) {
+				case GAME_STATE_FLOP:
+					myHand->getGuiInterface()->logDealBoardCardsMsg(myBeRoID, boardCards[0], boardCards[1], boardCards[2]);
+					break;
+				case GAME_STATE_TURN:
+					myHand->getGuiInterface()->logDealBoardCardsMsg(myBeRoID, boardCards[0], boardCards[1], boardCards[2], boardCards[3]);
+					break;
+				case GAME_STATE_RIVER:
+					myHand->getGuiInterface()->logDealBoardCardsMsg(myBeRoID, boardCards[0], boardCards[1], boardCards[2], boardCards[3], boardCards[4]);
+
+					break;
+				default: {
+					LOG_ERROR(__FILE__ << " (" << __LINE__ << "): ERROR - wrong myBeRoID");
+				}
+				}
 			}
 			if(myHand->getLog()) myHand->getLog()->logBoardCards(boardCards);
 			logBoardCardsDone = true;
 
 		}
 
-		bool allHighestSet = true;
-
-		PlayerListIterator it_c;
-
-
 		// check if all running players have same sets (else allHighestSet = false)
-		for( it_c = myHand->getRunningPlayerList()->begin(); it_c != myHand->getRunningPlayerList()->end(); ++it_c) {
-			if(highestSet != (*it_c)->getMySet()) {
-				allHighestSet = false;
-				break;
-			}
-		}
+		bool allHighestSet = allRunningPlayersHaveHighestSet();
 
 		// prfen, ob aktuelle bero wirklich dran ist
 		if(!firstRound && allHighestSet) {
@@ -192,19 +222,19 @@ void LocalBeRo::run()
 			myHand->setCurrentRound(GameState(myBeRoID+1));
 
 			//Action loeschen und ActionButtons refresh
-			for(it_c=myHand->getRunningPlayerList()->begin(); it_c!=myHand->getRunningPlayerList()->end(); ++it_c) {
-				(*it_c)->setMyAction(PLAYER_ACTION_NONE);
-			}
+			resetRunningPlayersAction();
 
 			//Sets in den Pot verschieben und Sets = 0 und Pot-refresh
 			myHand->getBoard()->collectSets();
 			myHand->getBoard()->collectPot();
-			myHand->getGuiInterface()->refreshPot();
+			if(!events) {
+				myHand->getGuiInterface()->refreshPot();
 
-			myHand->getGuiInterface()->refreshSet();
-			myHand->getGuiInterface()->refreshCash();
-			for(int i=0; i<MAX_NUMBER_OF_PLAYERS; i++) {
-				myHand->getGuiInterface()->refreshAction(i,PLAYER_ACTION_NONE);
+				myHand->getGuiInterface()->refreshSet();
+				myHand->getGuiInterface()->refreshCash();
+				for(int i=0; i<MAX_NUMBER_OF_PLAYERS; i++) {
+					myHand->getGuiInterface()->refreshAction(i,PLAYER_ACTION_NONE);
+				}
 			}
 
 			myHand->switchRounds();
@@ -223,8 +253,10 @@ void LocalBeRo::run()
 			currentPlayersTurnId = (*currentPlayersTurnIt)->getMyUniqueID();
 
 			//highlight active players groupbox and clear action
-			myHand->getGuiInterface()->refreshGroupbox(currentPlayersTurnId,2);
-			myHand->getGuiInterface()->refreshAction(currentPlayersTurnId,0);
+			if(!events) {
+				myHand->getGuiInterface()->refreshGroupbox(currentPlayersTurnId,2);
+				myHand->getGuiInterface()->refreshAction(currentPlayersTurnId,0);
+			}
 
 			currentPlayersTurnIt = myHand->getRunningPlayerIt( currentPlayersTurnId );
 			if(currentPlayersTurnIt == myHand->getRunningPlayerList()->end()) {
@@ -238,7 +270,9 @@ void LocalBeRo::run()
 				firstRound = false;
 			}
 
-			if( currentPlayersTurnId == 0) {
+			if(events) {
+				events->add(ENGINE_EVENT_PLAYERS_TURN, myBeRoID, currentPlayersTurnId);
+			} else if( currentPlayersTurnId == 0) {
 				// Wir sind dran
 				myHand->getGuiInterface()->meInAction();
 			} else {
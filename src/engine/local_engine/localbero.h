@@ -37,13 +37,19 @@
 
 #include "berointerface.h"
 #include "handinterface.h"
+#include "localtablestate.h"
+
+#include <boost/shared_ptr.hpp>
 
 class LocalBeRo : public BeRoInterface
 {
 public:
-	LocalBeRo(HandInterface* hi, unsigned dP, int sB, GameState gS);
+	LocalBeRo(HandInterface* hi, boost::shared_ptr<LocalTableState> tS, unsigned dP, int sB, GameState gS);
 	~LocalBeRo();
 
+	// Prepare a recycled betting round for the next hand.
+	virtual void reset(unsigned dP, int sB);
+
 	GameState getMyBeRoID() const {
 		return myBeRoID;
 	}
@@ -81,6 +87,14 @@ protected:
 		return myHand;
 	}
 
+	// set if the hand is reported as events instead of gui callbacks
+	EngineEventBuffer *getEvents() const {
+		return myTableState->events;
+	}
+
+	bool allRunningPlayersHaveHighestSet() const;
+	void resetRunningPlayersAction();
+
 	unsigned getDealerPosition() const {
 		return dealerPosition;
 	}
@@ -169,6 +183,7 @@ protected:
 private:
 
 	HandInterface* myHand;
+	boost::shared_ptr<LocalTableState> myTableState;
 
 	const GameState myBeRoID;
 	unsigned dealerPosition;
@@ -36,7 +36,7 @@
 
 using namespace std;
 
-LocalBeRoFlop::LocalBeRoFlop(HandInterface* hi, unsigned dP, int sB) : LocalBeRo(hi, dP, sB, GAME_STATE_FLOP)
+LocalBeRoFlop::LocalBeRoFlop(HandInterface* hi, boost::shared_ptr<LocalTableState> tS, unsigned dP, int sB) : LocalBeRo(hi, tS, dP, sB, GAME_STATE_FLOP)
 {
 }
 
@@ -41,7 +41,7 @@ class LocalBeRoFlop : public LocalBeRo
 {
 
 public:
-	LocalBeRoFlop(HandInterface*, unsigned, int);
+	LocalBeRoFlop(HandInterface*, boost::shared_ptr<LocalTableState>, unsigned, int);
 	~LocalBeRoFlop();
 
 };
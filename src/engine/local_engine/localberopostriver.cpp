@@ -37,7 +37,7 @@
 
 using namespace std;
 
-LocalBeRoPostRiver::LocalBeRoPostRiver(HandInterface* hi, int dP, int sB) : LocalBeRo(hi, dP, sB, GAME_STATE_POST_RIVER), highestCardsValue(0)
+LocalBeRoPostRiver::LocalBeRoPostRiver(HandInterface* hi, boost::shared_ptr<LocalTableState> tS, int dP, int sB) : LocalBeRo(hi, tS, dP, sB, GAME_STATE_POST_RIVER), highestCardsValue(0)
 {
 }
 
@@ -45,6 +45,12 @@ LocalBeRoPostRiver::~LocalBeRoPostRiver()
 {
 }
 
+void LocalBeRoPostRiver::reset(unsigned dP, int sB)
+{
+	LocalBeRo::reset(dP, sB);
+	highestCardsValue = 0;
+}
+
 void LocalBeRoPostRiver::run()
 {
 }
@@ -112,5 +118,5 @@ void LocalBeRoPostRiver::postRiverRun()
 	}
 
 	//starte die Animaionsreihe
-	getMyHand()->getGuiInterface()->postRiverRunAnimation1();
+	if(!getEvents()) getMyHand()->getGuiInterface()->postRiverRunAnimation1();
 }
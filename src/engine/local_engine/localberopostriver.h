@@ -41,9 +41,11 @@ class HandInterface;
 class LocalBeRoPostRiver : public LocalBeRo
 {
 public:
-	LocalBeRoPostRiver(HandInterface*, int, int);
+	LocalBeRoPostRiver(HandInterface*, boost::shared_ptr<LocalTableState>, int, int);
 	~LocalBeRoPostRiver();
 
+	void reset(unsigned, int);
+
 	void setHighestCardsValue(int theValue) {
 		highestCardsValue = theValue;
 	}
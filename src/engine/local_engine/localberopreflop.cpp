@@ -39,7 +39,7 @@
 
 using namespace std;
 
-LocalBeRoPreflop::LocalBeRoPreflop(HandInterface* hi, unsigned dP, int sB) : LocalBeRo(hi, dP, sB, GAME_STATE_PREFLOP)
+LocalBeRoPreflop::LocalBeRoPreflop(HandInterface* hi, boost::shared_ptr<LocalTableState> tS, unsigned dP, int sB) : LocalBeRo(hi, tS, dP, sB, GAME_STATE_PREFLOP)
 {
 	setHighestSet(2*getSmallBlind());
 }
@@ -50,6 +50,12 @@ LocalBeRoPreflop::~LocalBeRoPreflop()
 {
 }
 
+void LocalBeRoPreflop::reset(unsigned dP, int sB)
+{
+	LocalBeRo::reset(dP, sB);
+	setHighestSet(2*getSmallBlind());
+}
+
 void LocalBeRoPreflop::run()
 {
 
@@ -123,16 +129,8 @@ void LocalBeRoPreflop::run()
 
 	}
 
-	bool allHighestSet = true;
-	PlayerListConstIterator it_c;
-
 	// check if all running players have same sets (else allHighestSet = false)
-	for(it_c=getMyHand()->getRunningPlayerList()->begin(); it_c!=getMyHand()->getRunningPlayerList()->end(); ++it_c) {
-		if(getHighestSet() != (*it_c)->getMySet()) {
-			allHighestSet = false;
-			break;
-		}
-	}
+	bool allHighestSet = allRunningPlayersHaveHighestSet();
 
 	// determine next player
 	PlayerListConstIterator currentPlayersTurnIt = getMyHand()->getRunningPlayerIt( getCurrentPlayersTurnId() );
@@ -153,19 +151,19 @@ void LocalBeRoPreflop::run()
 		getMyHand()->setCurrentRound(GAME_STATE_FLOP);
 
 		//Action loeschen und ActionButtons refresh
-		for(it_c=getMyHand()->getRunningPlayerList()->begin(); it_c!=getMyHand()->getRunningPlayerList()->end(); ++it_c) {
-			(*it_c)->setMyAction(PLAYER_ACTION_NONE);
-		}
+		resetRunningPlayersAction();
 
 		//Sets in den Pot verschieben und Sets = 0 und Pot-refresh
 		getMyHand()->getBoard()->collectSets();
 		getMyHand()->getBoard()->collectPot();
-		getMyHand()->getGuiInterface()->refreshPot();
+		if(!getEvents()) {
+			getMyHand()->getGuiInterface()->refreshPot();
 
-		getMyHand()->getGuiInterface()->refreshSet();
-		getMyHand()->getGuiInterface()->refreshCash();
-		for(int i=0; i<MAX_NUMBER_OF_PLAYERS; i++) {
-			getMyHand()->getGuiInterface()->refreshAction(i,PLAYER_ACTION_NONE);
+			getMyHand()->getGuiInterface()->refreshSet();
+			getMyHand()->getGuiInterface()->refreshCash();
+			for(int i=0; i<MAX_NUMBER_OF_PLAYERS; i++) {
+				getMyHand()->getGuiInterface()->refreshAction(i,PLAYER_ACTION_NONE);
+			}
 		}
 
 		getMyHand()->switchRounds();
@@ -181,6 +179,11 @@ void LocalBeRoPreflop::run()
 		}
 		(*currentPlayersTurnIt)->setMyTurn(true);
 
+		if(getEvents()) {
+			getEvents()->add(ENGINE_EVENT_PLAYERS_TURN, getMyBeRoID(), getCurrentPlayersTurnId());
+			return;
+		}
+
 		//highlight active players groupbox and clear action
 		getMyHand()->getGuiInterface()->refreshGroupbox( getCurrentPlayersTurnId() , 2 );
 		getMyHand()->getGuiInterface()->refreshAction( getCurrentPlayersTurnId() , PLAYER_ACTION_NONE );
@@ -41,9 +41,11 @@ class LocalBeRoPreflop : public LocalBeRo
 {
 
 public:
-	LocalBeRoPreflop(HandInterface*, unsigned, int);
+	LocalBeRoPreflop(HandInterface*, boost::shared_ptr<LocalTableState>, unsigned, int);
 	~LocalBeRoPreflop();
 
+	void reset(unsigned, int);
+
 	void run();
 
 private:
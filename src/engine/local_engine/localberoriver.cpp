@@ -37,7 +37,7 @@
 
 using namespace std;
 
-LocalBeRoRiver::LocalBeRoRiver(HandInterface* hi, unsigned dP, int sB) : LocalBeRo(hi, dP, sB, GAME_STATE_RIVER)
+LocalBeRoRiver::LocalBeRoRiver(HandInterface* hi, boost::shared_ptr<LocalTableState> tS, unsigned dP, int sB) : LocalBeRo(hi, tS, dP, sB, GAME_STATE_RIVER)
 {
 }
 
@@ -41,7 +41,7 @@ class HandInterface;
 class LocalBeRoRiver : public LocalBeRo
 {
 public:
-	LocalBeRoRiver(HandInterface*, unsigned, int);
+	LocalBeRoRiver(HandInterface*, boost::shared_ptr<LocalTableState>, unsigned, int);
 	~LocalBeRoRiver();
 };
 
@@ -36,7 +36,7 @@
 
 using namespace std;
 
-LocalBeRoTurn::LocalBeRoTurn(HandInterface* hi, unsigned dP, int sB) : LocalBeRo(hi, dP, sB, GAME_STATE_TURN)
+LocalBeRoTurn::LocalBeRoTurn(HandInterface* hi, boost::shared_ptr<LocalTableState> tS, unsigned dP, int sB) : LocalBeRo(hi, tS, dP, sB, GAME_STATE_TURN)
 {
 }
 
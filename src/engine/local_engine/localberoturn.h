@@ -40,7 +40,7 @@ class HandInterface;
 class LocalBeRoTurn : public LocalBeRo
 {
 public:
-	LocalBeRoTurn(HandInterface*, unsigned, int);
+	LocalBeRoTurn(HandInterface*, boost::shared_ptr<LocalTableState>, unsigned, int);
 	~LocalBeRoTurn();
 
 };
@@ -37,7 +37,9 @@
 #include "localexception.h"
 #include "engine_msg.h"
 
-LocalBoard::LocalBoard() : BoardInterface(), pot(0), sets(0), allInCondition(false), lastActionPlayerID(0)
+#include <algorithm>
+
+LocalBoard::LocalBoard(boost::shared_ptr<LocalTableState> tS) : BoardInterface(), myTableState(tS), pot(0), sets(0), allInCondition(false), lastActionPlayerID(0)
 {
 	myCards[0] = myCards[1] = myCards[2] = myCards[3] = myCards[4] = 0;
 }
@@ -58,9 +60,8 @@ void LocalBoard::collectSets()
 
 	sets = 0;
 
-	PlayerListConstIterator it_c;
-	for(it_c=seatsList->begin(); it_c!=seatsList->end(); ++it_c) {
-		sets += (*it_c)->getMySet();
+	for(int seat=0; seat<MAX_NUMBER_OF_PLAYERS; seat++) {
+		sets += myTableState->set[seat];
 	}
 
 }
@@ -71,9 +72,9 @@ void LocalBoard::collectPot()
 	pot += sets;
 	sets = 0;
 
-	PlayerListIterator it;
-	for(it=seatsList->begin(); it!=seatsList->end(); ++it) {
-		(*it)->setMySetNull();
+	for(int seat=0; seat<MAX_NUMBER_OF_PLAYERS; seat++) {
+		myTableState->set[seat] = 0;
+		myTableState->lastRelativeSet[seat] = 0;
 	}
 
 }
@@ -83,29 +84,30 @@ void LocalBoard::distributePot(unsigned dealerPosition)
 
 	winners.clear();
 
-	size_t i,j,k,l;
-	PlayerListIterator it;
-	PlayerListConstIterator it_c;
+	LocalTableState &table = *myTableState;
+	int seat;
+	size_t i,j,k;
 
-	// filling player sets vector
-	std::vector<unsigned> playerSets;
-	for(it=seatsList->begin(); it!=seatsList->end(); ++it) {
-		if((*it)->getMyActiveStatus()) {
-			playerSets.push_back( ( ((*it)->getMyRoundStartCash()) - ((*it)->getMyCash()) ) );
+	// filling player sets
+	unsigned playerSets[MAX_NUMBER_OF_PLAYERS];
+	for(seat=0; seat<MAX_NUMBER_OF_PLAYERS; seat++) {
+		if(table.activeMask & LocalTableState::seatBit(seat)) {
+			playerSets[seat] = table.roundStartCash[seat] - table.cash[seat];
 		} else {
-			playerSets.push_back(0);
+			playerSets[seat] = 0;
 		}
-		(*it)->setLastMoneyWon(0);
+		table.lastMoneyWon[seat] = 0;
 	}
 
 	// sort player sets asc
-	std::vector<unsigned> playerSetsSort = playerSets;
-	sort(playerSetsSort.begin(), playerSetsSort.end());
-
-	// potLevel[0] = amount, potLevel[1] = sum, potLevel[2..n] = winner
-	std::vector<unsigned> potLevel;
+	unsigned playerSetsSort[MAX_NUMBER_OF_PLAYERS];
+	std::copy(playerSets, playerSets + MAX_NUMBER_OF_PLAYERS, playerSetsSort);
+	std::sort(playerSetsSort, playerSetsSort + MAX_NUMBER_OF_PLAYERS);
 
 	// temp var
+	unsigned levelAmount;
+	unsigned levelSum;
+	SeatMask levelWinners;
 	int highestCardsValue;
 	size_t winnerCount;
 	bool finalPot;
@@ -114,7 +116,7 @@ void LocalBoard::distributePot(unsigned dealerPosition)
 	bool winnerHit;
 
 	// level loop
-	for(i=0; i<playerSetsSort.size(); i++) {
+	for(i=0; i<MAX_NUMBER_OF_PLAYERS; i++) {
 
 		// restart levelHighestCardsValue
 		highestCardsValue = 0;
@@ -123,64 +125,53 @@ void LocalBoard::distributePot(unsigned dealerPosition)
 		if(playerSetsSort[i] > 0) {
 
 			// level amount
-			potLevel.push_back(playerSetsSort[i]);
+			levelAmount = playerSetsSort[i];
 
 			// level sum
-			potLevel.push_back((playerSetsSort.size()-i)*potLevel[0] + potCarryOver);
+			levelSum = (MAX_NUMBER_OF_PLAYERS-i)*levelAmount + potCarryOver;
 
 			// determine level highestCardsValue
-			for(it_c=seatsList->begin(), j=0; it_c!=seatsList->end(); ++it_c,j++) {
-				if((*it_c)->getMyActiveStatus() && (*it_c)->getMyCardsValueInt() > highestCardsValue && (*it_c)->getMyAction() != PLAYER_ACTION_FOLD && playerSets[j] >= potLevel[0]) {
-					highestCardsValue = (*it_c)->getMyCardsValueInt();
+			for(seat=0; seat<MAX_NUMBER_OF_PLAYERS; seat++) {
+				if((table.activeMask & LocalTableState::seatBit(seat)) && table.cardsValueInt[seat] > highestCardsValue && table.action[seat] != PLAYER_ACTION_FOLD && playerSets[seat] >= levelAmount) {
+					highestCardsValue = table.cardsValueInt[seat];
 				}
 			}
 
 			// level winners
-			for(it_c=seatsList->begin(), j=0; it_c!=seatsList->end(); ++it_c,j++) {
-				if((*it_c)->getMyActiveStatus() && highestCardsValue == (*it_c)->getMyCardsValueInt() && (*it_c)->getMyAction() != PLAYER_ACTION_FOLD && playerSets[j] >= potLevel[0]) {
-					potLevel.push_back((*it_c)->getMyUniqueID());
+			levelWinners = 0;
+			for(seat=0; seat<MAX_NUMBER_OF_PLAYERS; seat++) {
+				if((table.activeMask & LocalTableState::seatBit(seat)) && highestCardsValue == table.cardsValueInt[seat] && table.action[seat] != PLAYER_ACTION_FOLD && playerSets[seat] >= levelAmount) {
+					levelWinners |= LocalTableState::seatBit(seat);
 				}
 			}
 
 			// determine the number of level winners
-			winnerCount = potLevel.size()-2;
+			winnerCount = LocalTableState::countSeats(levelWinners);
 			if (!winnerCount) {
 				LOG_ERROR(__FILE__ << " (" << __LINE__ << "): distributePot-ERROR: no winner found");
 			}
 
 			// check if this is the final pot level for at least one winner
 			finalPot = false;
-			for(j=2; j<potLevel.size(); j++) {
-				// find seat with potLevel[j]-ID
-				for(it=seatsList->begin(), k=0; it!=seatsList->end(); ++it, k++) {
-					if((*it)->getMyUniqueID() == potLevel[j] && potLevel[0] == playerSets[k]) {
-						finalPot = true;
-						break;
-					}
+			for(seat=0; seat<MAX_NUMBER_OF_PLAYERS; seat++) {
+				if((levelWinners & LocalTableState::seatBit(seat)) && levelAmount == playerSets[seat]) {
+					finalPot = true;
+					break;
 				}
-				if(finalPot) break;
 			}
 
 			if(finalPot && winnerCount>0) {
 				// distribute the pot level sum to level winners
-				mod = (potLevel[1])%winnerCount;
+				mod = levelSum%winnerCount;
 				// pot level sum divisible by winnerCount
 				if(mod == 0) {
 
-					for(j=2; j<potLevel.size(); j++) {
-						// find seat with potLevel[j]-ID
-						for(it=seatsList->begin(); it!=seatsList->end(); ++it) {
-							if((*it)->getMyUniqueID() == potLevel[j]) {
-								break;
-							}
-						}
-						if(it == seatsList->end()) {
-							LOG_ERROR(__FILE__ << " (" << __LINE__ << "): distributePot-ERROR: seat not found");
-						} else {
-							(*it)->setMyCash( (*it)->getMyCash() + ((potLevel[1])/winnerCount));
+					for(seat=0; seat<MAX_NUMBER_OF_PLAYERS; seat++) {
+						if(levelWinners & LocalTableState::seatBit(seat)) {
+							table.cash[seat] += levelSum/winnerCount;
 							// filling winners vector
-							winners.push_back((*it)->getMyUniqueID());
-							(*it)->setLastMoneyWon( (*it)->getLastMoneyWon() + (potLevel[1])/winnerCount );
+							winners.push_back(table.uniqueId[seat]);
+							table.lastMoneyWon[seat] += levelSum/winnerCount;
 						}
 					}
 
@@ -190,13 +181,9 @@ void LocalBoard::distributePot(unsigned dealerPosition)
 				else {
 
 					// find Seat with dealerPosition
-					for(it=seatsList->begin(); it!=seatsList->end(); ++it) {
-						if((*it)->getMyUniqueID() == dealerPosition) {
-							break;
-						}
-					}
-					if(it == seatsList->end()) {
-						it = seatsList->begin();
+					seat = table.findSeat(dealerPosition);
+					if(seat < 0) {
+						seat = 0;
 						LOG_ERROR(__FILE__ << " (" << __LINE__ << "): distributePot-ERROR: dealer position not found");
 					}
 
@@ -206,54 +193,44 @@ void LocalBoard::distributePot(unsigned dealerPosition)
 
 						for(k=0; k<MAX_NUMBER_OF_PLAYERS && !winnerHit; k++) {
 
-							++it;
-							if(it == seatsList->end())
-								it = seatsList->begin();
+							seat = (seat + 1) % MAX_NUMBER_OF_PLAYERS;
 
-							for(l=2; l<potLevel.size(); l++) {
-								if((*it)->getMyActiveStatus() && (*it)->getMyUniqueID() == potLevel[l])
-									winnerHit = true;
-							}
+							if(levelWinners & LocalTableState::seatBit(seat))
+								winnerHit = true;
 
 						}
 
 						if(winnerHit) {
+							unsigned share = levelSum/winnerCount;
 							if(j<mod) {
-								(*it)->setMyCash( (*it)->getMyCash() + (int)((potLevel[1])/winnerCount) + 1);
-								// filling winners vector
-								winners.push_back((*it)->getMyUniqueID());
-								(*it)->setLastMoneyWon( (*it)->getLastMoneyWon() + ((potLevel[1])/winnerCount) + 1 );
-							} else {
-								(*it)->setMyCash( (*it)->getMyCash() + (int)((potLevel[1])/winnerCount));
-								// filling winners vector
-								winners.push_back((*it)->getMyUniqueID());
-								(*it)->setLastMoneyWon( (*it)->getLastMoneyWon() + (potLevel[1])/winnerCount );
+								share++;
 							}
+							table.cash[seat] += share;
+							// filling winners vector
+							winners.push_back(table.uniqueId[seat]);
+							table.lastMoneyWon[seat] += share;
 						}
 					}
 				}
 				potCarryOver = 0;
 
 				// pot refresh
-				pot -= potLevel[1];
+				pot -= levelSum;
 
 			} else {
-				potCarryOver = potLevel[1];
+				potCarryOver = levelSum;
 			}
 
 			// reevaluate the player sets
-			for(j=0; j<playerSets.size(); j++) {
-				if(playerSets[j]>0) {
-					playerSets[j] -= potLevel[0];
+			for(seat=0; seat<MAX_NUMBER_OF_PLAYERS; seat++) {
+				if(playerSets[seat]>0) {
+					playerSets[seat] -= levelAmount;
 				}
 			}
 
 			// sort player sets asc
-			playerSetsSort = playerSets;
-			sort(playerSetsSort.begin(), playerSetsSort.end());
-
-			// clear potLevel
-			potLevel.clear();
+			std::copy(playerSets, playerSets + MAX_NUMBER_OF_PLAYERS, playerSetsSort);
+			std::sort(playerSetsSort, playerSetsSort + MAX_NUMBER_OF_PLAYERS);
 
 		}
 	}
@@ -262,16 +239,18 @@ void LocalBoard::distributePot(unsigned dealerPosition)
 	winners.sort();
 	winners.unique();
 
+	if(table.events) {
+		for(seat=0; seat<MAX_NUMBER_OF_PLAYERS; seat++) {
+			if(table.lastMoneyWon[seat] > 0) {
+				table.events->add(ENGINE_EVENT_POT_AWARD, GAME_STATE_POST_RIVER, table.uniqueId[seat], table.lastMoneyWon[seat]);
+			}
+		}
+	}
+
 
 	// ERROR-Outputs
 
 	if(pot!=0) LOG_ERROR(__FILE__ << " (" << __LINE__ << "): distributePot-ERROR: Pot = " << pot);
-
-	/*int sum = 0;
-
-	for(it_c=activePlayerList->begin(); it_c!=activePlayerList->end(); ++it_c) {
-		sum += (*it_c)->getMyCash();
-	}*/
 }
 
 void LocalBoard::determinePlayerNeedToShowCards()
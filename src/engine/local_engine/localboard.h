@@ -37,6 +37,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include <boardinterface.h>
+#include "localtablestate.h"
 
 class PlayerInterface;
 class HandInterface;
@@ -45,7 +46,7 @@ class HandInterface;
 class LocalBoard : public BoardInterface
 {
 public:
-	LocalBoard();
+	LocalBoard(boost::shared_ptr<LocalTableState> tS);
 	~LocalBoard();
 
 	void setPlayerLists(PlayerList, PlayerList, PlayerList);
@@ -101,6 +102,8 @@ public:
 
 
 private:
+	boost::shared_ptr<LocalTableState> myTableState;
+
 	PlayerList seatsList;
 	PlayerList activePlayerList;
 	PlayerList runningPlayerList;
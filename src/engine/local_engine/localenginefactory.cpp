@@ -44,7 +44,7 @@
 
 
 LocalEngineFactory::LocalEngineFactory(ConfigFile *c)
-	: myConfig(c)
+	: myConfig(c), myTableState(new LocalTableState)
 {
 }
 
@@ -57,19 +57,32 @@ LocalEngineFactory::~LocalEngineFactory()
 boost::shared_ptr<HandInterface>
 LocalEngineFactory::createHand(boost::shared_ptr<EngineFactory> f, GuiInterface *g, boost::shared_ptr<BoardInterface> b, Log *l, PlayerList sl, PlayerList apl, PlayerList rpl, int id, int sP, int dP, int sB,int sC)
 {
-	return boost::shared_ptr<HandInterface>(new LocalHand(f, g, b, l, sl, apl, rpl, id, sP, dP, sB, sC));
+	// Recycle a hand which is no longer referenced outside of the pool.
+	// The game still holds the previous hand, so the pool keeps two hands.
+	std::vector<boost::shared_ptr<LocalHand> >::iterator i = myHandPool.begin();
+	std::vector<boost::shared_ptr<LocalHand> >::iterator end = myHandPool.end();
+	while (i != end) {
+		if (i->unique()) {
+			(*i)->reset(g, b, l, sl, apl, rpl, id, sP, dP, sB, sC);
+			return *i;
+		}
+		++i;
+	}
+	boost::shared_ptr<LocalHand> newHand(new LocalHand(f, myTableState, g, b, l, sl, apl, rpl, id, sP, dP, sB, sC));
+	myHandPool.push_back(newHand);
+	return newHand;
 }
 
 boost::shared_ptr<BoardInterface>
 LocalEngineFactory::createBoard()
 {
-	return boost::shared_ptr<BoardInterface>(new LocalBoard());
+	return boost::shared_ptr<BoardInterface>(new LocalBoard(myTableState));
 }
 
 boost::shared_ptr<PlayerInterface>
 LocalEngineFactory::createPlayer(int id, unsigned uniqueId, PlayerType type, std::string name, std::string avatar, int sC, bool aS, bool sotS, int mB)
 {
-	return boost::shared_ptr<PlayerInterface> (new LocalPlayer(myConfig, id, uniqueId, type, name, avatar, sC, aS, sotS, mB));
+	return boost::shared_ptr<PlayerInterface> (new LocalPlayer(myConfig, myTableState, id, uniqueId, type, name, avatar, sC, aS, sotS, mB));
 }
 
 std::vector<boost::shared_ptr<BeRoInterface> >
@@ -77,15 +90,15 @@ LocalEngineFactory::createBeRo(HandInterface *hi, unsigned dP, int sB)
 {
 	std::vector<boost::shared_ptr<BeRoInterface> > myBeRo;
 
-	myBeRo.push_back(boost::shared_ptr<BeRoInterface>(new LocalBeRoPreflop(hi, dP, sB)));
+	myBeRo.push_back(boost::shared_ptr<BeRoInterface>(new LocalBeRoPreflop(hi, myTableState, dP, sB)));
 
-	myBeRo.push_back(boost::shared_ptr<BeRoInterface>(new LocalBeRoFlop(hi, dP, sB)));
+	myBeRo.push_back(boost::shared_ptr<BeRoInterface>(new LocalBeRoFlop(hi, myTableState, dP, sB)));
 
-	myBeRo.push_back(boost::shared_ptr<BeRoInterface>(new LocalBeRoTurn(hi, dP, sB)));
+	myBeRo.push_back(boost::shared_ptr<BeRoInterface>(new LocalBeRoTurn(hi, myTableState, dP, sB)));
 
-	myBeRo.push_back(boost::shared_ptr<BeRoInterface>(new LocalBeRoRiver(hi, dP, sB)));
+	myBeRo.push_back(boost::shared_ptr<BeRoInterface>(new LocalBeRoRiver(hi, myTableState, dP, sB)));
 
-	myBeRo.push_back(boost::shared_ptr<BeRoInterface>(new LocalBeRoPostRiver(hi, dP, sB)));
+	myBeRo.push_back(boost::shared_ptr<BeRoInterface>(new LocalBeRoPostRiver(hi, myTableState, dP, sB)));
 
 	return myBeRo;
 
@@ -37,6 +37,9 @@
 #include <handinterface.h>
 #include <boardinterface.h>
 #include <playerinterface.h>
+#include "localtablestate.h"
+
+class LocalHand;
 
 #include <boost/shared_ptr.hpp>
 #include <vector>
@@ -54,8 +57,14 @@ public:
 	virtual boost::shared_ptr<PlayerInterface> createPlayer(int id, unsigned uniqueId, PlayerType type, std::string name, std::string avatar, int sC, bool aS, bool sotS, int mB);
 	virtual std::vector<boost::shared_ptr<BeRoInterface> > createBeRo(HandInterface *hi, unsigned dP, int sB);
 
+	virtual void setEventBuffer(EngineEventBuffer *events) {
+		myTableState->events = events;
+	}
+
 private:
 	ConfigFile *myConfig;
+	boost::shared_ptr<LocalTableState> myTableState; // one factory per game
+	std::vector<boost::shared_ptr<LocalHand> > myHandPool;
 };
 
 #endif
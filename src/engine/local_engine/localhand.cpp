@@ -35,6 +35,7 @@
 #include <game_defs.h>
 #include <core/loghelper.h>
 
+#include "localbero.h"
 #include "localexception.h"
 #include "engine_msg.h"
 
@@ -42,14 +43,60 @@
 
 using namespace std;
 
-LocalHand::LocalHand(boost::shared_ptr<EngineFactory> f, GuiInterface *g, boost::shared_ptr<BoardInterface> b, Log *l, PlayerList sl, PlayerList apl, PlayerList rpl, int id, int sP, unsigned dP, int sB,int sC)
-	: myFactory(f), myGui(g),  myBoard(b), myLog(l), seatsList(sl), activePlayerList(apl), runningPlayerList(rpl), myBeRo(0), myID(id), startQuantityPlayers(sP), dealerPosition(dP), smallBlindPosition(dP), bigBlindPosition(dP), currentRound(GAME_STATE_PREFLOP), roundBeforePostRiver(GAME_STATE_PREFLOP), smallBlind(sB), startCash(sC), previousPlayerID(-1), lastActionPlayerID(0), allInCondition(false),
+LocalHand::LocalHand(boost::shared_ptr<EngineFactory> f, boost::shared_ptr<LocalTableState> tS, GuiInterface *g, boost::shared_ptr<BoardInterface> b, Log *l, PlayerList sl, PlayerList apl, PlayerList rpl, int id, int sP, unsigned dP, int sB,int sC)
+	: myTableState(tS), myGui(g),  myBoard(b), myLog(l), seatsList(sl), activePlayerList(apl), runningPlayerList(rpl), myBeRo(0), myID(id), startQuantityPlayers(sP), dealerPosition(dP), smallBlindPosition(dP), bigBlindPosition(dP), currentRound(GAME_STATE_PREFLOP), roundBeforePostRiver(GAME_STATE_PREFLOP), smallBlind(sB), startCash(sC), previousPlayerID(-1), lastActionPlayerID(0), allInCondition(false),
 	  cardsShown(false)
+{
+	dealHand();
+
+	// the betting rounds are created once and recycled with the hand
+	myBeRo = f->createBeRo(this, dealerPosition, smallBlind);
+}
+
+
+
+LocalHand::~LocalHand()
+{
+}
+
+void LocalHand::reset(GuiInterface *g, boost::shared_ptr<BoardInterface> b, Log *l, PlayerList sl, PlayerList apl, PlayerList rpl, int id, int sP, unsigned dP, int sB,int sC)
+{
+	myGui = g;
+	myBoard = b;
+	myLog = l;
+	seatsList = sl;
+	activePlayerList = apl;
+	runningPlayerList = rpl;
+	myID = id;
+	startQuantityPlayers = sP;
+	dealerPosition = smallBlindPosition = bigBlindPosition = dP;
+	currentRound = roundBeforePostRiver = GAME_STATE_PREFLOP;
+	smallBlind = sB;
+	startCash = sC;
+	previousPlayerID = -1;
+	lastActionPlayerID = 0;
+	allInCondition = false;
+	cardsShown = false;
+
+	dealHand();
+
+	for(size_t i=0; i<myBeRo.size(); i++) {
+		static_cast<LocalBeRo *>(myBeRo[i].get())->reset(dealerPosition, smallBlind);
+	}
+}
+
+void LocalHand::dealHand()
 {
 
 	int i, j, k;
 	PlayerListIterator it;
 
+	// reset the running player list to the active players, reusing the
+	// list nodes of the players who were removed during the last hand
+	runningPlayerList->splice(runningPlayerList->end(), removedRunningPlayers);
+	*runningPlayerList = *activePlayerList;
+	myTableState->runningMask = myTableState->activeMask;
+
 	for(it=seatsList->begin(); it!=seatsList->end(); ++it) {
 		(*it)->setHand(this);
 		// set myFlipCards 0
@@ -81,6 +128,9 @@ LocalHand::LocalHand(boost::shared_ptr<EngineFactory> f, GuiInterface *g, boost:
 	// prepare whole player hand
 	for(i=0; i<5; i++) playerCards[i+2] = boardCards[i];
 
+	EngineEventBuffer *events = myTableState->events;
+	if(events) events->add(ENGINE_EVENT_HAND_START, GAME_STATE_PREFLOP, dealerPosition, smallBlind);
+
 	k = 0;
 	myBoard->setMyCards(boardCards);
 	for(it=activePlayerList->begin(); it!=activePlayerList->end(); ++it, k++) {
@@ -89,6 +139,7 @@ LocalHand::LocalHand(boost::shared_ptr<EngineFactory> f, GuiInterface *g, boost:
 		for(j=0; j<2; j++) playerHoleCards[j] = cards[2*k+j+5];
 		(*it)->setMyHoleCards(playerHoleCards);
 		if(myLog) myLog->debugMode_getPlayerCards(playerHoleCards,myID,k); // debug mode
+		if(events) events->addHoleCards(GAME_STATE_PREFLOP, (*it)->getMyUniqueID(), playerHoleCards);
 
 		// complete whole player hand
 		for(j=0; j<2; j++) playerCards[j] = playerHoleCards[j];
@@ -122,15 +173,16 @@ LocalHand::LocalHand(boost::shared_ptr<EngineFactory> f, GuiInterface *g, boost:
 	assignButtons();
 	setBlinds();
 
-	if(myLog) myLog->logNewHandMsg(myID, dealerPosition+1, smallBlind, smallBlindPosition+1, 2*smallBlind, bigBlindPosition+1, seatsList);
-
-	myBeRo = myFactory->createBeRo(this, dealerPosition, smallBlind);
-}
-
-
+	if(events) {
+		const LocalTableState &table = *myTableState;
+		for(int seat=0; seat<MAX_NUMBER_OF_PLAYERS; seat++) {
+			if((table.activeMask & LocalTableState::seatBit(seat)) && (table.button[seat] == BUTTON_SMALL_BLIND || table.button[seat] == BUTTON_BIG_BLIND)) {
+				events->add(ENGINE_EVENT_BLIND, GAME_STATE_PREFLOP, table.uniqueId[seat], table.set[seat], table.action[seat]);
+			}
+		}
+	}
 
-LocalHand::~LocalHand()
-{
+	if(myLog) myLog->logNewHandMsg(myID, dealerPosition+1, smallBlind, smallBlindPosition+1, 2*smallBlind, bigBlindPosition+1, seatsList);
 }
 
 void LocalHand::start()
@@ -277,12 +329,19 @@ void LocalHand::setBlinds()
 
 void LocalHand::switchRounds()
 {
+	EngineEventBuffer *events = myTableState->events;
 
 	// logging last player action
 	PlayerListConstIterator previousPlayerIt = getRunningPlayerIt(previousPlayerID);
 	if(previousPlayerIt != runningPlayerList->end()) {
 		if(myLog) myLog->logPlayerAction((*previousPlayerIt)->getMyName(),myLog->transformPlayerActionLog((*previousPlayerIt)->getMyAction()),(*previousPlayerIt)->getMyLastRelativeSet());
 	}
+	// the previous player id is the seat, the action is reported only once
+	if(events && previousPlayerID >= 0 && previousPlayerID < MAX_NUMBER_OF_PLAYERS) {
+		const LocalTableState &table = *myTableState;
+		events->add(ENGINE_EVENT_PLAYER_ACTION, currentRound, table.uniqueId[previousPlayerID], table.lastRelativeSet[previousPlayerID], table.action[previousPlayerID]);
+		previousPlayerID = -1;
+	}
 
 	PlayerListIterator it, it_1;
 	PlayerListConstIterator it_c;
@@ -291,7 +350,9 @@ void LocalHand::switchRounds()
 	for(it=runningPlayerList->begin(); it!=runningPlayerList->end(); ) {
 		if((*it)->getMyAction() == PLAYER_ACTION_FOLD || (*it)->getMyAction() == PLAYER_ACTION_ALLIN) {
 
-			it = runningPlayerList->erase(it);
+			myTableState->runningMask &= ~LocalTableState::seatBit((*it)->getMyID());
+			PlayerListIterator removedIt = it++;
+			removedRunningPlayers.splice(removedRunningPlayers.end(), *runningPlayerList, removedIt);
 			if(!(runningPlayerList->empty())) {
 
 				it_1 = it;
@@ -305,25 +366,24 @@ void LocalHand::switchRounds()
 		}
 	}
 
-	// determine number of all in players
+	// determine number of all in and non-fold players
 	int allInPlayersCounter = 0;
-	for (it_c=activePlayerList->begin(); it_c!=activePlayerList->end(); ++it_c) {
-		if ((*it_c)->getMyAction() == PLAYER_ACTION_ALLIN) allInPlayersCounter++;
-	}
-
-	// determine number of non-fold players
 	int nonFoldPlayerCounter = 0;
-	for (it_c=activePlayerList->begin(); it_c!=activePlayerList->end(); ++it_c) {
-		if ((*it_c)->getMyAction() != PLAYER_ACTION_FOLD) nonFoldPlayerCounter++;
+	for (int seat=0; seat<MAX_NUMBER_OF_PLAYERS; seat++) {
+		if (myTableState->activeMask & LocalTableState::seatBit(seat)) {
+			if (myTableState->action[seat] == PLAYER_ACTION_ALLIN) allInPlayersCounter++;
+			if (myTableState->action[seat] != PLAYER_ACTION_FOLD) nonFoldPlayerCounter++;
+		}
 	}
 
 	// if only one player non-fold -> distribute pot
 	if(nonFoldPlayerCounter==1) {
 		myBoard->collectPot();
-		myGui->refreshPot();
-		myGui->refreshSet();
-		currentRound = GAME_STATE_POST_RIVER;
-		if(myLog) myLog->setCurrentRound(currentRound);
+		if(!events) {
+			myGui->refreshPot();
+			myGui->refreshSet();
+		}
+		setCurrentRound(GAME_STATE_POST_RIVER);
 	}
 
 	// check for all in condition
@@ -380,17 +440,18 @@ void LocalHand::switchRounds()
 	// special routine
 	if(allInCondition) {
 		myBoard->collectPot();
-		myGui->refreshPot();
-		myGui->refreshSet();
-		myGui->flipHolecardsAllIn();
+		if(!events) {
+			myGui->refreshPot();
+			myGui->refreshSet();
+			myGui->flipHolecardsAllIn();
+		}
 		// Logging HoleCards
 		if(currentRound<GAME_STATE_RIVER) {
 			if(myLog) myLog->logHoleCardsHandName(activePlayerList);
 		}
 
 		if (currentRound < GAME_STATE_POST_RIVER) { // do not increment past 4
-			currentRound = GameState(currentRound + 1);
-			if(myLog) myLog->setCurrentRound(currentRound);
+			setCurrentRound(GameState(currentRound + 1));
 		}
 
 		//log board cards for allin
@@ -398,12 +459,21 @@ void LocalHand::switchRounds()
 			int boardCards[5];
 
 			myBoard->getMyCards(boardCards);
-			myGui->logDealBoardCardsMsg(currentRound, boardCards[0], boardCards[1], boardCards[2], boardCards[3], boardCards[4]);
+			if(!events) myGui->logDealBoardCardsMsg(currentRound, boardCards[0], boardCards[1], boardCards[2], boardCards[3], boardCards[4]);
 			if(myLog) myLog->logBoardCards(boardCards);
 		}
 
 	}
 
+	if(currentRound < GAME_STATE_POST_RIVER) {
+		roundBeforePostRiver = currentRound;
+	}
+
+	// the caller drives the next step of an event driven hand
+	if(events) {
+		return;
+	}
+
 	//unhighlight current players groupbox
 	it_c = getActivePlayerIt(previousPlayerID);
 	if( it_c != activePlayerList->end() ) {
@@ -413,10 +483,6 @@ void LocalHand::switchRounds()
 
 	myGui->refreshGameLabels((GameState)getCurrentRound());
 
-	if(currentRound < GAME_STATE_POST_RIVER) {
-		roundBeforePostRiver = currentRound;
-	}
-
 	switch(currentRound) {
 	case GAME_STATE_PREFLOP: {
 		myGui->preflopAnimation1();
@@ -465,6 +531,11 @@ PlayerListIterator LocalHand::getActivePlayerIt(unsigned uniqueId) const
 
 	PlayerListIterator it;
 
+	// the list holds exactly the active seats
+	if(myTableState->findSeat(uniqueId, myTableState->activeMask) < 0) {
+		return activePlayerList->end();
+	}
+
 	for(it=activePlayerList->begin(); it!=activePlayerList->end(); ++it) {
 		if((*it)->getMyUniqueID() == uniqueId) {
 			break;
@@ -480,6 +551,11 @@ PlayerListIterator LocalHand::getRunningPlayerIt(unsigned uniqueId) const
 
 	PlayerListIterator it;
 
+	// the list holds exactly the running seats
+	if(myTableState->findSeat(uniqueId, myTableState->runningMask) < 0) {
+		return runningPlayerList->end();
+	}
+
 	for(it=runningPlayerList->begin(); it!=runningPlayerList->end(); ++it) {
 
 		if((*it)->getMyUniqueID() == uniqueId) {
@@ -491,6 +567,23 @@ PlayerListIterator LocalHand::getRunningPlayerIt(unsigned uniqueId) const
 
 }
 
+void LocalHand::setCurrentRound(GameState theValue)
+{
+	currentRound = theValue;
+	if(myLog) myLog->setCurrentRound(currentRound);
+
+	// report the board cards together with the new round
+	EngineEventBuffer *events = myTableState->events;
+	if(events) {
+		events->add(ENGINE_EVENT_ROUND_CHANGE, currentRound);
+		if(currentRound >= GAME_STATE_FLOP && currentRound <= GAME_STATE_RIVER) {
+			int boardCards[5];
+			myBoard->getMyCards(boardCards);
+			events->addBoardCards(currentRound, boardCards);
+		}
+	}
+}
+
 void LocalHand::setLastActionPlayerID(unsigned theValue)
 {
 	lastActionPlayerID = theValue;
@@ -38,6 +38,7 @@
 #include <playerinterface.h>
 #include <handinterface.h>
 #include <berointerface.h>
+#include "localtablestate.h"
 
 #include <vector>
 
@@ -46,9 +47,12 @@ class Log;
 class LocalHand : public HandInterface
 {
 public:
-	LocalHand(boost::shared_ptr<EngineFactory> f, GuiInterface*, boost::shared_ptr<BoardInterface>, Log*, PlayerList, PlayerList, PlayerList, int, int, unsigned, int, int);
+	LocalHand(boost::shared_ptr<EngineFactory> f, boost::shared_ptr<LocalTableState>, GuiInterface*, boost::shared_ptr<BoardInterface>, Log*, PlayerList, PlayerList, PlayerList, int, int, unsigned, int, int);
 	~LocalHand();
 
+	// Prepare a recycled hand for the next deal.
+	void reset(GuiInterface*, boost::shared_ptr<BoardInterface>, Log*, PlayerList, PlayerList, PlayerList, int, int, unsigned, int, int);
+
 	void start();
 
 	PlayerList getSeatsList() const {
@@ -101,10 +105,7 @@ public:
 		return startQuantityPlayers;
 	}
 
-	void setCurrentRound(GameState theValue) {
-		currentRound = theValue;
-		if(myLog) myLog->setCurrentRound(currentRound);
-	}
+	void setCurrentRound(GameState theValue);
 	GameState getCurrentRound() const {
 		return currentRound;
 	}
@@ -170,8 +171,9 @@ protected:
 	PlayerListIterator getRunningPlayerIt(unsigned) const;
 
 private:
+	void dealHand();
 
-	boost::shared_ptr<EngineFactory> myFactory;
+	boost::shared_ptr<LocalTableState> myTableState;
 	GuiInterface *myGui;
 	boost::shared_ptr<BoardInterface> myBoard;
 	Log *myLog;
@@ -179,6 +181,7 @@ private:
 	PlayerList seatsList; // all player
 	PlayerList activePlayerList; // all player who are not out
 	PlayerList runningPlayerList; // all player who are not folded, not all in and not out
+	std::list<boost::shared_ptr<PlayerInterface> > removedRunningPlayers; // spare nodes of runningPlayerList
 
 	std::vector<boost::shared_ptr<BeRoInterface> > myBeRo;
 
@@ -858,14 +858,26 @@ static const RoundData FlopValues[] = {
 #define NUM_PREFLOP_VALUES (sizeof(PreflopValues)/sizeof(RoundData))
 #define NUM_FLOP_VALUES (sizeof(FlopValues)/sizeof(RoundData))
 
-LocalPlayer::LocalPlayer(ConfigFile *c, int id, unsigned uniqueId, PlayerType type, std::string name, std::string avatar, int sC, bool aS, bool sotS, int mB)
-	: PlayerInterface(), myConfig(c), currentHand(0), myID(id), myUniqueID(uniqueId), myType(type), myName(name), myAvatar(avatar),
-	  myDude(0), myDude4(0), myCardsValueInt(0), myOdds(-1.0), logHoleCardsDone(false), myCash(sC), mySet(0), myLastRelativeSet(0), myAction(PLAYER_ACTION_NONE),
-	  myButton(mB), myActiveStatus(aS), myStayOnTableStatus(sotS), myTurn(0), myHoleCardsFlip(0), myRoundStartCash(0), lastMoneyWon(0),
+LocalPlayer::LocalPlayer(ConfigFile *c, boost::shared_ptr<LocalTableState> table, int id, unsigned uniqueId, PlayerType type, std::string name, std::string avatar, int sC, bool aS, bool sotS, int mB)
+	: PlayerInterface(), myConfig(c), currentHand(0), myTableState(table), myID(id), myUniqueID(table->uniqueId[id]), myType(type), myName(name), myAvatar(avatar),
+	  myDude(0), myDude4(0), myCardsValueInt(table->cardsValueInt[id]), myOdds(-1.0), myPrecomputedOdds(-1.0), logHoleCardsDone(false), myCash(table->cash[id]), mySet(table->set[id]), myLastRelativeSet(table->lastRelativeSet[id]), myAction(table->action[id]),
+	  myButton(table->button[id]), myStayOnTableStatus(sotS), myTurn(0), myHoleCardsFlip(0), myRoundStartCash(table->roundStartCash[id]), lastMoneyWon(table->lastMoneyWon[id]),
 	  sBluff(0), sBluffStatus(false), m_actionTimeoutCounter(0), m_isSessionActive(false), m_isKicked(false), m_isMuted(false)
 {
 
 	int i;
+
+	// initialize the seat
+	myUniqueID = uniqueId;
+	myCardsValueInt = 0;
+	myCash = sC;
+	mySet = 0;
+	myLastRelativeSet = 0;
+	myAction = PLAYER_ACTION_NONE;
+	myButton = mB;
+	myRoundStartCash = 0;
+	lastMoneyWon = 0;
+	setMyActiveStatus(aS);
 	for(i=0; i<3; i++) {
 		myNiveau[i] = 0;
 	}
@@ -890,7 +902,7 @@ LocalPlayer::LocalPlayer(ConfigFile *c, int id, unsigned uniqueId, PlayerType ty
 
 	// Dude zuweisen
 	Tools::GetRand(3, 5, 1, &myDude);
-	// 	cout << "Spieler: " << myID << " Dude: " << myDude << " Cash: " << myCash << " ActiveStatus: " << myActiveStatus << " Button: " << myButton << endl;
+	// 	cout << "Spieler: " << myID << " Dude: " << myDude << " Cash: " << myCash << " ActiveStatus: " << getMyActiveStatus() << " Button: " << myButton << endl;
 
 	// Dude4 zuweisen
 	const int interval = 7;
@@ -924,7 +936,7 @@ void LocalPlayer::action()
 		else */preflopEngine();
 
 		currentHand->getBoard()->collectSets();
-		currentHand->getGuiInterface()->refreshPot();
+		if(!myTableState->events) currentHand->getGuiInterface()->refreshPot();
 
 	}
 	break;
@@ -934,7 +946,7 @@ void LocalPlayer::action()
 		else */flopEngine();
 
 		currentHand->getBoard()->collectSets();
-		currentHand->getGuiInterface()->refreshPot();
+		if(!myTableState->events) currentHand->getGuiInterface()->refreshPot();
 
 	}
 	break;
@@ -944,7 +956,7 @@ void LocalPlayer::action()
 		else */turnEngine();
 
 		currentHand->getBoard()->collectSets();
-		currentHand->getGuiInterface()->refreshPot();
+		if(!myTableState->events) currentHand->getGuiInterface()->refreshPot();
 
 	}
 	break;
@@ -954,7 +966,7 @@ void LocalPlayer::action()
 		else */riverEngine();
 
 		currentHand->getBoard()->collectSets();
-		currentHand->getGuiInterface()->refreshPot();
+		if(!myTableState->events) currentHand->getGuiInterface()->refreshPot();
 
 	}
 	break;
@@ -973,8 +985,11 @@ void LocalPlayer::action()
 	//set that i was the last active player. need this for unhighlighting groupbox
 	currentHand->setPreviousPlayerID(myID);
 
-	currentHand->getGuiInterface()->logPlayerActionMsg(myName, myAction, myLastRelativeSet);
-	currentHand->getGuiInterface()->nextPlayerAnimation();
+	// event driven hands report the action in switchRounds
+	if(!myTableState->events) {
+		currentHand->getGuiInterface()->logPlayerActionMsg(myName, myAction, myLastRelativeSet);
+		currentHand->getGuiInterface()->nextPlayerAnimation();
+	}
 
 	// 	cout << "playerID in action(): " << (*(currentHand->getCurrentBeRo()->getCurrentPlayersTurnIt()))->getMyID() << endl;
 }
@@ -2815,81 +2830,86 @@ int LocalPlayer::flopCardsValue(int* cards)
 }
 
 void LocalPlayer::calcMyOdds()
+{
+	if(myPrecomputedOdds >= 0) {
+		myOdds = myPrecomputedOdds;
+		myPrecomputedOdds = -1.0;
+		return;
+	}
+
+	int boardCards[5];
+	currentHand->getBoard()->getMyCards(boardCards);
+
+	double odds = calcOdds(currentHand->getCurrentRound(), myHoleCards, boardCards, currentHand->getActivePlayerList()->size());
+	if(odds >= 0) myOdds = odds;
+}
+
+double LocalPlayer::calcOdds(int round, const int *holeCards, const int *boardCards, int players)
 {
 
 	int handCode;
+	double odds = -1.0;
 
-	switch(currentHand->getCurrentRound()) {
+	// übergang solange preflopValue und flopValue noch nicht bereinigt
+	if(players > 5) players = 5;
+	// paranoia
+	if(players < 2) players = 2;
 
-	case GAME_STATE_PREFLOP: {
+	switch(round) {
 
-		handCode = CardsValue::holeCardsToIntCode(myHoleCards);
+	case GAME_STATE_PREFLOP: {
 
-		// übergang solange preflopValue und flopValue noch nicht bereinigt
-		int players = currentHand->getActivePlayerList()->size();
-		if(players > 5) players = 5;
-		// paranoia
-		if(players < 2) players = 2;
+		int tempHoleCards[2] = { holeCards[0], holeCards[1] };
+		handCode = CardsValue::holeCardsToIntCode(tempHoleCards);
 
 		for (unsigned val = 0; val < NUM_PREFLOP_VALUES; val++) {
 			if(handCode == PreflopValues[val].hand) {
-				myOdds = 100.0*PreflopValues[val].data[players - 2];
+				odds = 100.0*PreflopValues[val].data[players - 2];
 				break;
 			}
 		}
-		if (myOdds == -1) LOG_ERROR(__FILE__ << " (" << __LINE__ << "): ERROR myOdds - " << handCode);
+		if (odds == -1) LOG_ERROR(__FILE__ << " (" << __LINE__ << "): ERROR myOdds - " << handCode);
 
 	}
 	break;
 	case GAME_STATE_FLOP: {
 
 		int tempArray[5];
-		int boardCards[5];
 
 		int i;
 
-		for(i=0; i<2; i++) tempArray[i] = myHoleCards[i];
-		currentHand->getBoard()->getMyCards(boardCards);
+		for(i=0; i<2; i++) tempArray[i] = holeCards[i];
 		for(i=0; i<3; i++) tempArray[2+i] = boardCards[i];
 
 		handCode = flopCardsValue(tempArray);
 
-		// übergang solange preflopValue und flopValue noch nicht bereinigt
-		int players = currentHand->getActivePlayerList()->size();
-		if(players > 5) players = 5;
-		// paranoia
-		if(players < 2) players = 2;
-
 		if(handCode != 80000) {
 			for (unsigned val = 0; val < NUM_FLOP_VALUES; val++) {
 				if(handCode == FlopValues[val].hand) {
-					myOdds = 100.0*FlopValues[val].data[players - 2];
+					odds = 100.0*FlopValues[val].data[players - 2];
 					break;
 				}
 			}
-			if(myOdds == -1) {
+			if(odds == -1) {
 				ostringstream logger;
 				logger << "ERROR myOdds is -1: ";
 				for(i=0; i<5; i++) logger << tempArray[i] << " ";
 				LOG_ERROR(__FILE__ << " (" << __LINE__ << "): " << logger.str());
 			}
 		} else {
-			myOdds = 100;
+			odds = 100;
 		}
 
 	}
 	break;
 	case GAME_STATE_TURN: {
 
-		int boardCards[5];
-		currentHand->getBoard()->getMyCards(boardCards);
-
 		int card_idx_1;
 		int myCards[4] = { 0,0,0,0 };
 		int opponentCards[4] = { 0,0,0,0 };
 		for(card_idx_1=0; card_idx_1<4; card_idx_1++) myCards[boardCards[card_idx_1]/13] |= (1 << (boardCards[card_idx_1]%13));
 		std::copy(myCards,myCards+4,opponentCards);
-		for(card_idx_1=0; card_idx_1<2; card_idx_1++) myCards[myHoleCards[card_idx_1]/13] |= (1 << (myHoleCards[card_idx_1]%13));
+		for(card_idx_1=0; card_idx_1<2; card_idx_1++) myCards[holeCards[card_idx_1]/13] |= (1 << (holeCards[card_idx_1]%13));
 
 		int countAll = 0;
 		int countMy = 0;
@@ -2919,21 +2939,18 @@ void LocalPlayer::calcMyOdds()
 			}
 		}
 
-		myOdds = 100.0*(countMy*1.0)/(countAll*1.0);
+		odds = 100.0*(countMy*1.0)/(countAll*1.0);
 
 	}
 	break;
 	case GAME_STATE_RIVER: {
 
-		int boardCards[5];
-		currentHand->getBoard()->getMyCards(boardCards);
-
 		int card_idx_1;
 		int myCards[4] = { 0,0,0,0 };
 		int opponentCards[4] = { 0,0,0,0 };
 		for(card_idx_1=0; card_idx_1<5; card_idx_1++) myCards[boardCards[card_idx_1]/13] |= (1 << (boardCards[card_idx_1]%13));
 		std::copy(myCards,myCards+4,opponentCards);
-		for(card_idx_1=0; card_idx_1<2; card_idx_1++) myCards[myHoleCards[card_idx_1]/13] |= (1 << (myHoleCards[card_idx_1]%13));
+		for(card_idx_1=0; card_idx_1<2; card_idx_1++) myCards[holeCards[card_idx_1]/13] |= (1 << (holeCards[card_idx_1]%13));
 
 		int countAll = 0;
 		int countMy = 0;
@@ -2955,7 +2972,7 @@ void LocalPlayer::calcMyOdds()
 			}
 		}
 
-		myOdds = 100.0*(countMy*1.0)/(countAll*1.0);
+		odds = 100.0*(countMy*1.0)/(countAll*1.0);
 
 	}
 	break;
@@ -2964,6 +2981,8 @@ void LocalPlayer::calcMyOdds()
 
 
 	}
+
+	return odds;
 }
 
 
@@ -33,6 +33,7 @@
 #define LOCALPLAYER_H
 
 #include <playerinterface.h>
+#include "localtablestate.h"
 
 #include <boost/shared_ptr.hpp>
 #include <string>
@@ -44,7 +45,7 @@ class HandInterface;
 class LocalPlayer : public PlayerInterface
 {
 public:
-	LocalPlayer(ConfigFile*, int id, unsigned uniqueId, PlayerType type, std::string name, std::string avatar, int sC, bool aS, bool sotS, int mB);
+	LocalPlayer(ConfigFile*, boost::shared_ptr<LocalTableState> table, int id, unsigned uniqueId, PlayerType type, std::string name, std::string avatar, int sC, bool aS, bool sotS, int mB);
 
 	~LocalPlayer();
 
@@ -144,10 +145,13 @@ public:
 	}
 
 	void setMyActiveStatus(bool theValue) {
-		myActiveStatus = theValue;
+		if (theValue)
+			myTableState->activeMask |= LocalTableState::seatBit(myID);
+		else
+			myTableState->activeMask &= ~LocalTableState::seatBit(myID);
 	}
 	bool getMyActiveStatus() const {
-		return myActiveStatus;
+		return (myTableState->activeMask & LocalTableState::seatBit(myID)) != 0;
 	}
 
 	void setMyStayOnTableStatus(bool theValue) {
@@ -287,10 +291,16 @@ public:
 //	void turnEngine3();
 //	void riverEngine3();
 
-	int flopCardsValue(int*);
+	static int flopCardsValue(int*);
 	int turnCardsValue(int*);
 
 	void calcMyOdds();
+	// Does not touch the table, so the server may run it on another thread.
+	static double calcOdds(int round, const int *holeCards, const int *boardCards, int players);
+
+	void setPrecomputedOdds(double odds) {
+		myPrecomputedOdds = odds;
+	}
 
 	void evaluation(int, int);
 
@@ -310,10 +320,11 @@ private:
 
 	ConfigFile *myConfig;
 	HandInterface *currentHand;
+	boost::shared_ptr<LocalTableState> myTableState;
 
 	// Konstanten
 	int myID;
-	unsigned myUniqueID;
+	unsigned &myUniqueID; // seat state is stored in the table
 	std::string myGuid;
 	PlayerType myType;
 	std::string myName;
@@ -323,24 +334,24 @@ private:
 
 
 	// Laufvariablen
-	int myCardsValueInt;
+	int &myCardsValueInt;
 	int myBestHandPosition[5];
 	double myOdds;
+	double myPrecomputedOdds; // used once by the next calcMyOdds
 	int myNiveau[3];
 	bool logHoleCardsDone;
 
 	int myHoleCards[2];
-	int myCash;
-	int mySet;
-	int myLastRelativeSet;
-	PlayerAction myAction;
-	int myButton; // 0 = none, 1 = dealer, 2 =small, 3 = big
-	bool myActiveStatus; // 0 = inactive, 1 = active
+	int &myCash;
+	int &mySet;
+	int &myLastRelativeSet;
+	PlayerAction &myAction;
+	int &myButton; // 0 = none, 1 = dealer, 2 =small, 3 = big
 	bool myStayOnTableStatus; // 0 = left, 1 = stay
 	bool myTurn; // 0 = no, 1 = yes
 	bool myHoleCardsFlip; // 0 = cards are not fliped, 1 = cards are already flipped,
-	int myRoundStartCash;
-	int lastMoneyWon;
+	int &myRoundStartCash;
+	int &lastMoneyWon;
 
 	int myAverageSets[4];
 	bool myAggressive[7];
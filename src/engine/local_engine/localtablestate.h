@@ -0,0 +1,98 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+
+#ifndef LOCALTABLESTATE_H
+#define LOCALTABLESTATE_H
+
+#include <game_defs.h>
+#include <engineevent.h>
+
+// Bit n is set for seat n.
+typedef unsigned SeatMask;
+
+// State of all seats of a local table, stored in flat arrays indexed by the
+// seat number (the player id). The LocalPlayer objects are views on their
+// seat, which allows betting round and pot code to work on the arrays
+// instead of walking the player lists.
+struct LocalTableState {
+	LocalTableState() : activeMask(0), runningMask(0), events(0) {
+		for (int i = 0; i < MAX_NUMBER_OF_PLAYERS; i++) {
+			uniqueId[i] = 0;
+			cash[i] = 0;
+			set[i] = 0;
+			lastRelativeSet[i] = 0;
+			roundStartCash[i] = 0;
+			lastMoneyWon[i] = 0;
+			cardsValueInt[i] = 0;
+			button[i] = 0;
+			action[i] = PLAYER_ACTION_NONE;
+		}
+	}
+
+	static SeatMask seatBit(int seat) {
+		return 1u << seat;
+	}
+
+	static int countSeats(SeatMask mask) {
+		int count = 0;
+		while (mask) {
+			mask &= mask - 1;
+			count++;
+		}
+		return count;
+	}
+
+	// Returns the first seat within the mask which has the id, or -1.
+	int findSeat(unsigned id, SeatMask mask = ~0u) const {
+		for (int i = 0; i < MAX_NUMBER_OF_PLAYERS; i++) {
+			if ((mask & seatBit(i)) && uniqueId[i] == id)
+				return i;
+		}
+		return -1;
+	}
+
+	unsigned uniqueId[MAX_NUMBER_OF_PLAYERS];
+	int cash[MAX_NUMBER_OF_PLAYERS];
+	int set[MAX_NUMBER_OF_PLAYERS];
+	int lastRelativeSet[MAX_NUMBER_OF_PLAYERS];
+	int roundStartCash[MAX_NUMBER_OF_PLAYERS];
+	int lastMoneyWon[MAX_NUMBER_OF_PLAYERS];
+	int cardsValueInt[MAX_NUMBER_OF_PLAYERS];
+	int button[MAX_NUMBER_OF_PLAYERS];
+	PlayerAction action[MAX_NUMBER_OF_PLAYERS];
+
+	SeatMask activeMask; // all seats which are not out
+	SeatMask runningMask; // all seats which are not folded, not all in and not out
+
+	EngineEventBuffer *events; // if set, the engine emits events and skips the gui
+};
+
+#endif
@@ -41,6 +41,8 @@ ClientHand::ClientHand(boost::shared_ptr<EngineFactory> f, GuiInterface *g, boos
 {
 	PlayerListIterator it;
 
+	(*runningPlayerList) = (*activePlayerList);
+
 	for(it=seatsList->begin(); it!=seatsList->end(); ++it) {
 		(*it)->setHand(this);
 		// myFlipCards auf 0 setzen
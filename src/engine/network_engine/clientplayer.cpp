@@ -466,6 +466,11 @@ ClientPlayer::action()
 {
 }
 
+void
+ClientPlayer::setPrecomputedOdds(double /*odds*/)
+{
+}
+
 int
 ClientPlayer::checkMyAction(int /*targetAction*/, int /*targetBet*/, int /*highestSet*/, int /*minimumRaise*/, int /*smallBlind*/)
 {
@@ -126,6 +126,7 @@ public:
 	bool getSBluffStatus() const;
 
 	void action();
+	void setPrecomputedOdds(double odds);
 	int checkMyAction(int targetAction, int targetBet, int highestSet, int minimumRaise, int smallBlind);
 
 	void preflopEngine();
@@ -124,6 +124,8 @@ public:
 	virtual bool getSBluffStatus() const =0;
 
 	virtual void action() =0;
+	// Odds for the next action, calculated outside of the engine.
+	virtual void setPrecomputedOdds(double odds) =0;
 	virtual int checkMyAction(int targetAction, int targetBet, int highestSet, int minimumRaise, int smallBlind) = 0;
 
 	virtual void preflopEngine() =0;
@@ -33,6 +33,7 @@
 #include "configfile.h"
 #include "gametablestylereader.h"
 #include "gamelobbydialogimpl.h"
+#include "lobbynicklistmodel.h"
 #include "soundevents.h"
 #include <iostream>
 
@@ -40,10 +41,15 @@
 using namespace std;
 
 
-ChatTools::ChatTools(QLineEdit* l, ConfigFile *c, ChatType ct, QTextBrowser *b, QStandardItemModel *m, gameLobbyDialogImpl *lo) : nickAutoCompletitionCounter(0), myLineEdit(l), myNickListModel(m), myNickStringList(NULL), myTextBrowser(b), myChatType(ct), myConfig(c), myNick(""), myLobby(lo)
+ChatTools::ChatTools(QLineEdit* l, ConfigFile *c, ChatType ct, QTextBrowser *b, LobbyNickListModel *m, gameLobbyDialogImpl *lo) : nickAutoCompletitionCounter(0), myLineEdit(l), myNickListModel(m), myNickStringList(NULL), myTextBrowser(b), myChatType(ct), myConfig(c), myNick(""), myLobby(lo)
 {
 	myNick = QString::fromUtf8(myConfig->readConfigString("MyName").c_str());
 	ignoreList = myConfig->readConfigStringList("PlayerIgnoreList");
+
+	if(myTextBrowser) {
+		// every chat line is one block, the oldest ones are dropped from the top (0 = unlimited)
+		myTextBrowser->document()->setMaximumBlockCount(qMax(myConfig->readConfigInt("ChatScrollbackLines"), 0));
+	}
 }
 
 ChatTools::~ChatTools()
@@ -84,7 +90,8 @@ void ChatTools::receiveMessage(QString playerName, QString message, bool pm)
 		message = message.replace("<","&lt;");
 		message = message.replace(">","&gt;");
 		//doing the links
-		message = message.replace(QRegExp("((?:https?)://\\S+)"), "<a href=\"\\1\">\\1</a>");
+		static const QRegExp linkRegExp("((?:https?)://\\S+)");
+		message = message.replace(linkRegExp, "<a href=\"\\1\">\\1</a>");
 
 		//refresh myNick if it was changed during runtime
 		myNick = QString::fromUtf8(myConfig->readConfigString("MyName").c_str());
@@ -232,13 +239,12 @@ void ChatTools::nickAutoCompletition()
 	if(nickAutoCompletitionCounter == 0) {
 
 		if(myNickListModel) {
-			int it = 0;
-			while (myNickListModel->item(it)) {
-				QString text = myNickListModel->item(it, 0)->data(Qt::DisplayRole).toString();
+			QStringListIterator it(myNickListModel->getPlayerNames());
+			while (it.hasNext()) {
+				QString text = it.next();
 				if(text.startsWith(myChatStringList.last(), Qt::CaseInsensitive) && myChatStringList.last() != "") {
 					matchStringList << text;
 				}
-				++it;
 			}
 		}
 
@@ -314,15 +320,7 @@ unsigned ChatTools::parsePrivateMessageTarget(QString &chatText)
 	unsigned playerId = 0;
 	if (!playerName.isEmpty() && !chatText.isEmpty()) {
 		if(myNickListModel) {
-			int it = 0;
-			while (myNickListModel->item(it)) {
-				QString text = myNickListModel->item(it, 0)->data(Qt::DisplayRole).toString();
-				if(text == playerName) {
-					playerId = myNickListModel->item(it, 0)->data(Qt::UserRole).toUInt();
-					break;
-				}
-				++it;
-			}
+			myNickListModel->getPlayerIdFromName(playerName, playerId);
 		}
 	}
 	return playerId;
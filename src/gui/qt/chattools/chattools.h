@@ -45,13 +45,14 @@ class Session;
 class ConfigFile;
 class GameTableStyleReader;
 class gameLobbyDialogImpl;
+class LobbyNickListModel;
 
 class ChatTools : public QObject
 {
 	Q_OBJECT
 
 public:
-	ChatTools(QLineEdit*, ConfigFile*, ChatType, QTextBrowser *b = NULL, QStandardItemModel *m = NULL, gameLobbyDialogImpl *lo = NULL);
+	ChatTools(QLineEdit*, ConfigFile*, ChatType, QTextBrowser *b = NULL, LobbyNickListModel *m = NULL, gameLobbyDialogImpl *lo = NULL);
 
 	~ChatTools();
 
@@ -104,7 +105,7 @@ private:
 	int nickAutoCompletitionCounter;
 
 	QLineEdit *myLineEdit;
-	QStandardItemModel *myNickListModel;
+	LobbyNickListModel *myNickListModel;
 	QStringList myNickStringList;
 	QTextBrowser *myTextBrowser;
 	boost::shared_ptr<Session> mySession;
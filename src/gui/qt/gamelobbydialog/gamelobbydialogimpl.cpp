@@ -31,6 +31,8 @@
 #include "gamelobbydialogimpl.h"
 #include "mygamelistsortfilterproxymodel.h"
 #include "mynicklistsortfilterproxymodel.h"
+#include "lobbygamelistmodel.h"
+#include "lobbynicklistmodel.h"
 #include "startwindowimpl.h"
 #include "chattools.h"
 #include "changecompleteblindsdialogimpl.h"
@@ -126,7 +128,7 @@ gameLobbyDialogImpl::gameLobbyDialogImpl(startWindowImpl *parent, ConfigFile *c)
 	autoStartTimerOverlay->setPalette(p);
 
 
-	myGameListModel = new QStandardItemModel(this);
+	myGameListModel = new LobbyGameListModel(this);
 	myGameListSortFilterProxyModel = new MyGameListSortFilterProxyModel(this);
 	myGameListSortFilterProxyModel->setSourceModel(myGameListModel);
 	myGameListSortFilterProxyModel->setDynamicSortFilter(true);
@@ -135,7 +137,7 @@ gameLobbyDialogImpl::gameLobbyDialogImpl(startWindowImpl *parent, ConfigFile *c)
 
 	QStringList headerList;
 	headerList << tr("Game") << tr("Players") << tr("State") << tr("T") << tr("P") << tr("Time");
-	myGameListModel->setHorizontalHeaderLabels(headerList);
+	myGameListModel->setHeaderLabels(headerList);
 
 #ifdef GUI_800x480
 	treeView_GameList->setColumnWidth(0,200); //484px alltogether
@@ -178,7 +180,7 @@ gameLobbyDialogImpl::gameLobbyDialogImpl(startWindowImpl *parent, ConfigFile *c)
 #endif
 	treeView_GameList->setAutoFillBackground(true);
 
-	myNickListModel = new QStandardItemModel(this);
+	myNickListModel = new LobbyNickListModel(this);
 	myNickListSortFilterProxyModel = new MyNickListSortFilterProxyModel(this);
 	myNickListSortFilterProxyModel->setSourceModel(myNickListModel);
 	myNickListSortFilterProxyModel->setDynamicSortFilter(true);
@@ -189,7 +191,7 @@ gameLobbyDialogImpl::gameLobbyDialogImpl(startWindowImpl *parent, ConfigFile *c)
 
 	QStringList headerList2;
 	headerList2 << tr("Available Players");
-	myNickListModel->setHorizontalHeaderLabels(headerList2);
+	myNickListModel->setHeaderLabels(headerList2);
 	treeView_NickList->sortByColumn(0, Qt::AscendingOrder);
 
 	myChat = new ChatTools(lineEdit_ChatInput, myConfig, INET_LOBBY_CHAT, textBrowser_ChatDisplay, myNickListModel, this);
@@ -429,7 +431,7 @@ void gameLobbyDialogImpl::refresh(int actionID)
 
 		QStringList headerList;
 		headerList << tr("Game") << tr("Players") << tr("State") << tr("T") << tr("P") << tr("Time");;
-		myGameListModel->setHorizontalHeaderLabels(headerList);
+		myGameListModel->setHeaderLabels(headerList);
 
 #ifdef GUI_800x480
 		treeView_GameList->setColumnWidth(0,200); //484px alltogether
@@ -449,7 +451,7 @@ void gameLobbyDialogImpl::refresh(int actionID)
 
 		QStringList headerList2;
 		headerList2 << tr("Available Players");
-		myNickListModel->setHorizontalHeaderLabels(headerList2);
+		myNickListModel->setHeaderLabels(headerList2);
 
 		//stop waitStartGameMsgBoxes
 		waitStartGameMsgBoxTimer->stop();
@@ -485,13 +487,14 @@ void gameLobbyDialogImpl::gameSelected(const QModelIndex &index)
 	if (!inGame && index.isValid() ) {
 		pushButton_JoinGame->setEnabled(true);
 
-		currentGameName = myGameListModel->item(myGameListSortFilterProxyModel->mapToSource(index).row(), 0)->text();
+		QModelIndex sourceIndex = myGameListSortFilterProxyModel->mapToSource(index);
+		currentGameName = myGameListModel->index(sourceIndex.row(), 0).data(Qt::DisplayRole).toString();
 
 		groupBox_GameInfo->setEnabled(true);
 		groupBox_GameInfo->setTitle(tr("Game Info") + " - " + currentGameName);
 
 		assert(mySession);
-		GameInfo info(mySession->getClientGameInfo(myGameListModel->item(myGameListSortFilterProxyModel->mapToSource(index).row(), 0)->data(Qt::UserRole).toUInt()));
+		GameInfo info(mySession->getClientGameInfo(sourceIndex.data(Qt::UserRole).toUInt()));
 
 		switch (info.data.gameType) {
 		case GAME_TYPE_NORMAL: {
@@ -551,162 +554,62 @@ void gameLobbyDialogImpl::gameSelected(const QModelIndex &index)
 	}
 }
 
-void gameLobbyDialogImpl::updateGameItem(QList <QStandardItem*> itemList, unsigned gameId)
+void gameLobbyDialogImpl::updateGameItem(unsigned gameId)
 {
 	assert(mySession);
 	GameInfo info(mySession->getClientGameInfo(gameId));
 
-	itemList.at(0)->setData(gameId, Qt::UserRole);
-	itemList.at(0)->setData(QString::fromUtf8(info.name.c_str()), Qt::DisplayRole);
+	LobbyGameListEntry entry;
+	entry.gameId = gameId;
+	entry.name = QString::fromUtf8(info.name.c_str());
 
 	PlayerIdList::const_iterator i = info.players.begin();
 	PlayerIdList::const_iterator end = info.players.end();
-
 	while (i != end) {
 		if(myPlayerId == *i) {
-			itemList.at(0)->setData( "MeInThisGame", 16);
-			itemList.at(0)->setBackground(QBrush(QColor(0, 255, 0, 127)));
-			itemList.at(1)->setBackground(QBrush(QColor(0, 255, 0, 127)));
-			itemList.at(2)->setBackground(QBrush(QColor(0, 255, 0, 127)));
-			itemList.at(3)->setBackground(QBrush(QColor(0, 255, 0, 127)));
-			itemList.at(4)->setBackground(QBrush(QColor(0, 255, 0, 127)));
-			itemList.at(5)->setBackground(QBrush(QColor(0, 255, 0, 127)));
-			break;
-		} else {
-			itemList.at(0)->setData( "", 16);
-			itemList.at(0)->setBackground(QBrush());
-			itemList.at(1)->setBackground(QBrush());
-			itemList.at(2)->setBackground(QBrush());
-			itemList.at(3)->setBackground(QBrush());
-			itemList.at(4)->setBackground(QBrush());
-			itemList.at(5)->setBackground(QBrush());
+			entry.meInThisGame = true;
 		}
-		++i;
-	}
-
-	//reset players iterator
-	i = info.players.begin();
-	end = info.players.end();
-	while (i != end) {
 		//mark players as active
-		int it1 = 0;
-		while (myNickListModel->item(it1)) {
-			if (myNickListModel->item(it1, 0)->data(Qt::UserRole) == *i) {
-				myNickListModel->item(it1, 0)->setData("active", 34);
-				break;
-			}
-			++it1;
-		}
+		myNickListModel->setPlayerActive(*i, true);
 		++i;
 	}
 
-	QString playerStr;
-	playerStr.sprintf("%u/%u", (unsigned)info.players.size(), (unsigned)info.data.maxNumberOfPlayers);
-	itemList.at(1)->setData(playerStr, Qt::DisplayRole);
-	if((unsigned)info.players.size() == (unsigned)info.data.maxNumberOfPlayers) {
-		itemList.at(1)->setData("totalfull", 16);
-	} else {
-		itemList.at(1)->setData("nonfull", 16);
-	}\
-
-	if (info.mode == GAME_MODE_STARTED) {
-		itemList.at(2)->setData(tr("running"), Qt::DisplayRole);
-		itemList.at(2)->setData("running", 16);
-	} else {
-		itemList.at(2)->setData(tr("open"), Qt::DisplayRole);
-		itemList.at(2)->setData("open", 16);
-	}
-
-	switch (info.data.gameType) {
-	case GAME_TYPE_NORMAL: {
-		itemList.at(3)->setIcon(QIcon(":/gfx/player_play.png"));
-		itemList.at(3)->setData("", Qt::DisplayRole);
-		itemList.at(3)->setData("standard", 16);
-	}
-	break;
-	case GAME_TYPE_REGISTERED_ONLY: {
-		itemList.at(3)->setIcon(QIcon(":/gfx/registered.png"));
-		itemList.at(3)->setData(" ", Qt::DisplayRole);
-		itemList.at(3)->setData("registered", 16);
-	}
-	break;
-	case GAME_TYPE_INVITE_ONLY: {
-		itemList.at(3)->setIcon(QIcon(":/gfx/list_add_user.png"));
-		itemList.at(3)->setData("  ", Qt::DisplayRole);
-		itemList.at(3)->setData("invited", 16);
-	}
-	break;
-	case GAME_TYPE_RANKING: {
-		itemList.at(3)->setIcon(QIcon(":/gfx/cup.png"));
-		itemList.at(3)->setData("   ", Qt::DisplayRole);
-		itemList.at(3)->setData("ranking", 16);
-	}
-	break;
-	}
+	entry.playersText.sprintf("%u/%u", (unsigned)info.players.size(), (unsigned)info.data.maxNumberOfPlayers);
+	entry.isFull = (unsigned)info.players.size() == (unsigned)info.data.maxNumberOfPlayers;
 
-	if (info.isPasswordProtected) {
-		itemList.at(4)->setIcon(QIcon(":/gfx/lock.png"));
-		itemList.at(4)->setData(" ", Qt::DisplayRole);
-		itemList.at(4)->setData("private", 16);
-	} else {
-		itemList.at(4)->setData("", Qt::DisplayRole);
-		itemList.at(4)->setData("nonpriv", 16);
-	}
+	entry.isRunning = info.mode == GAME_MODE_STARTED;
+	entry.stateText = entry.isRunning ? tr("running") : tr("open");
+	entry.gameType = info.data.gameType;
+	entry.isPrivate = info.isPasswordProtected;
 
-	itemList.at(5)->setData(QString::number(info.data.playerActionTimeoutSec)+"s/"+QString::number(info.data.delayBetweenHandsSec)+"s", Qt::DisplayRole);
+	entry.timingText = QString::number(info.data.playerActionTimeoutSec)+"s/"+QString::number(info.data.delayBetweenHandsSec)+"s";
 	QString actionTimeOutString = QString::number(info.data.playerActionTimeoutSec);
 	if(info.data.playerActionTimeoutSec < 10) {
 		actionTimeOutString = "0"+actionTimeOutString;
 	}
-	itemList.at(5)->setData(actionTimeOutString, 16);
+	entry.timingSortKey = actionTimeOutString;
 
-	treeView_GameList->sortByColumn(myConfig->readConfigInt("DlgGameLobbyGameListSortingSection"), (Qt::SortOrder)myConfig->readConfigInt("DlgGameLobbyGameListSortingOrder") );
+	myGameListModel->setGame(entry);
 	refreshGameStats();
 
 	//mark spactators as active
 	PlayerIdList::const_iterator s = info.spectators.begin();
 	PlayerIdList::const_iterator s_end = info.spectators.end();
-
 	while (s != s_end) {
-		int it2 = 0;
-		while (myNickListModel->item(it2)) {
-			if (myNickListModel->item(it2, 0)->data(Qt::UserRole) == *s) {
-				myNickListModel->item(it2, 0)->setData("active", 34);
-				break;
-			}
-			++it2;
-		}
+		myNickListModel->setPlayerActive(*s, true);
 		++s;
 	}
 }
 
 void gameLobbyDialogImpl::addGame(unsigned gameId)
 {
-	QList <QStandardItem*> itemList;
-	QStandardItem *item1 = new QStandardItem();
-	QStandardItem *item2 = new QStandardItem();
-	QStandardItem *item3 = new QStandardItem();
-	QStandardItem *item4 = new QStandardItem();
-	QStandardItem *item5 = new QStandardItem();
-	QStandardItem *item6 = new QStandardItem();
-	itemList << item1 << item2 << item3 << item4 << item5 << item6;
-
-	myGameListModel->appendRow(itemList);
-
-	updateGameItem(itemList, gameId);
+	updateGameItem(gameId);
 }
 
 void gameLobbyDialogImpl::updateGameMode(unsigned gameId, int /*newMode*/)
 {
-	int it = 0;
-	while (myGameListModel->item(it)) {
-		if (myGameListModel->item(it, 0)->data(Qt::UserRole) == gameId) {
-			QList <QStandardItem*> itemList;
-			itemList << myGameListModel->item(it, 0) << myGameListModel->item(it, 1) << myGameListModel->item(it, 2) << myGameListModel->item(it, 3) << myGameListModel->item(it, 4) << myGameListModel->item(it, 5);
-			updateGameItem(itemList, gameId);
-			break;
-		}
-		it++;
+	if (myGameListModel->hasGame(gameId)) {
+		updateGameItem(gameId);
 	}
 }
 
@@ -717,44 +620,21 @@ void gameLobbyDialogImpl::updateGameAdmin(unsigned /*gameId*/, unsigned adminPla
 
 void gameLobbyDialogImpl::removeGame(unsigned gameId)
 {
-	int it = 0;
-	while (myGameListModel->item(it)) {
-		if (myGameListModel->item(it, 0)->data(Qt::UserRole) == gameId) {
-			myGameListModel->removeRow(it);
-			break;
-		}
-		it++;
-	}
+	myGameListModel->removeGame(gameId);
 
 	refreshGameStats();
 }
 
 void gameLobbyDialogImpl::refreshGameStats()
 {
-
-	int runningGamesCounter = 0;
-	int openGamesCounter = 0;
-
-	int it = 0;
-	while (myGameListModel->item(it)) {
-		if (myGameListModel->item(it, 2)->data(16) == "running") {
-			runningGamesCounter++;
-		}
-		if (myGameListModel->item(it, 2)->data(16) == "open") {
-			openGamesCounter++;
-		}
-		++it;
-	}
-
-	label_openGamesCounter->setText(" | "+tr("running games: %1").arg(runningGamesCounter));
-	label_runningGamesCounter->setText(" | "+tr("open games: %1").arg(openGamesCounter));
-
+	label_openGamesCounter->setText(" | "+tr("running games: %1").arg(myGameListModel->getNumRunningGames()));
+	label_runningGamesCounter->setText(" | "+tr("open games: %1").arg(myGameListModel->getNumOpenGames()));
 }
 
 void gameLobbyDialogImpl::refreshPlayerStats()
 {
 	//ServerStats stats = mySession->getClientStats();
-	label_connectedPlayersCounter->setText(tr("connected players: %1").arg(myNickListModel->rowCount()));
+	label_connectedPlayersCounter->setText(tr("connected players: %1").arg(myNickListModel->getNumPlayers()));
 }
 
 void gameLobbyDialogImpl::gameAddPlayer(unsigned gameId, unsigned playerId)
@@ -773,28 +653,14 @@ void gameLobbyDialogImpl::gameAddPlayer(unsigned gameId, unsigned playerId)
 		}
 	}
 
-	int it = 0;
-	while (myGameListModel->item(it)) {
-		if (myGameListModel->item(it, 0)->data(Qt::UserRole) == gameId) {
-			QList <QStandardItem*> itemList;
-			itemList << myGameListModel->item(it, 0) << myGameListModel->item(it, 1) << myGameListModel->item(it, 2) << myGameListModel->item(it, 3) << myGameListModel->item(it, 4)  << myGameListModel->item(it, 5);
-			updateGameItem(itemList, gameId);
-			break;
-		}
-		it++;
+	if (myGameListModel->hasGame(gameId)) {
+		updateGameItem(gameId);
 	}
 }
 
 void gameLobbyDialogImpl::gameAddSpectator(unsigned /*gameId*/, unsigned playerId)
 {
-	int it1 = 0;
-	while (myNickListModel->item(it1)) {
-		if (myNickListModel->item(it1, 0)->data(Qt::UserRole) == playerId) {
-			myNickListModel->item(it1, 0)->setData("active", 34);
-			break;
-		}
-		++it1;
-	}
+	myNickListModel->setPlayerActive(playerId, true);
 }
 
 void gameLobbyDialogImpl::gameRemovePlayer(unsigned gameId, unsigned playerId)
@@ -810,40 +676,18 @@ void gameLobbyDialogImpl::gameRemovePlayer(unsigned gameId, unsigned playerId)
 		}
 	}
 
-	int it = 0;
-	while (myGameListModel->item(it)) {
-		if (myGameListModel->item(it, 0)->data(Qt::UserRole) == gameId) {
-			QList <QStandardItem*> itemList;
-			itemList << myGameListModel->item(it, 0) << myGameListModel->item(it, 1) << myGameListModel->item(it, 2) << myGameListModel->item(it, 3) << myGameListModel->item(it, 4) << myGameListModel->item(it, 5);
-
-			updateGameItem(itemList, gameId);
-			break;
-		}
-		++it;
+	if (myGameListModel->hasGame(gameId)) {
+		updateGameItem(gameId);
 	}
 
 	//mark player as idle again
-	int it1 = 0;
-	while (myNickListModel->item(it1)) {
-		if (myNickListModel->item(it1, 0)->data(Qt::UserRole) == playerId) {
-			myNickListModel->item(it1, 0)->setData("idle", 34);
-			break;
-		}
-		++it1;
-	}
+	myNickListModel->setPlayerActive(playerId, false);
 }
 
 void gameLobbyDialogImpl::gameRemoveSpectator(unsigned, unsigned playerId)
 {
 	//mark spectator as idle again
-	int it1 = 0;
-	while (myNickListModel->item(it1)) {
-		if (myNickListModel->item(it1, 0)->data(Qt::UserRole) == playerId) {
-			myNickListModel->item(it1, 0)->setData("idle", 34);
-			break;
-		}
-		++it1;
-	}
+	myNickListModel->setPlayerActive(playerId, false);
 }
 
 void gameLobbyDialogImpl::updateStats(ServerStats /*stats*/)
@@ -886,7 +730,7 @@ void gameLobbyDialogImpl::clearDialog()
 
 	QStringList headerList;
 	headerList << tr("Game") << tr("Players") << tr("State") << tr("T") << tr("P") << tr("Time");
-	myGameListModel->setHorizontalHeaderLabels(headerList);
+	myGameListModel->setHeaderLabels(headerList);
 
 #ifdef GUI_800x480
 	treeView_GameList->setColumnWidth(0,200); //484px alltogether
@@ -913,8 +757,8 @@ void gameLobbyDialogImpl::clearDialog()
 	myNickListSelectionModel->clearSelection();;
 	QStringList headerList2;
 	headerList2 << tr("Available Players");
-	myNickListModel->setHorizontalHeaderLabels(headerList2);
-	myNickListModel->sort(0, treeView_NickList->header()->sortIndicatorOrder());
+	myNickListModel->setHeaderLabels(headerList2);
+	myNickListSortFilterProxyModel->sort(0, treeView_NickList->header()->sortIndicatorOrder());
 
 	inGame = false;
 	isGameAdministrator = false;
@@ -1076,26 +920,16 @@ void gameLobbyDialogImpl::updatePlayer(unsigned playerId, QString newPlayerName)
 
 	//also rename player in nick-list
 	QString oldNick;
-	int it1 = 0;
-	while (myNickListModel->item(it1)) {
-		if (myNickListModel->item(it1, 0)->data(Qt::UserRole) == playerId) {
-			oldNick = myNickListModel->item(it1, 0)->text();
-			myNickListModel->item(it1, 0)->setText(newPlayerName);
-
-			PlayerInfo playerInfo(mySession->getClientPlayerInfo(playerId));
-			QString countryString = QString::fromUtf8(playerInfo.countryCode.c_str()).toLower();
-			myNickListModel->item(it1, 0)->setData(countryString, 33);
-			if(playerInfo.isGuest || countryString.isEmpty()) {
-				myNickListModel->item(it1, 0)->setIcon(QIcon(":/cflags/cflags/undefined.png"));
-				myNickListModel->item(it1, 0)->setToolTip("");
-			} else {
-				myNickListModel->item(it1, 0)->setIcon(QIcon(QString(":/cflags/cflags/%1.png").arg(countryString)));
-				myNickListModel->item(it1, 0)->setToolTip(getFullCountryString(countryString.toUpper()));
-			}
-			break;
+	if (myNickListModel->hasPlayer(playerId)) {
+		oldNick = myNickListModel->getPlayerName(playerId);
+
+		PlayerInfo playerInfo(mySession->getClientPlayerInfo(playerId));
+		QString countryString = QString::fromUtf8(playerInfo.countryCode.c_str()).toLower();
+		QString toolTip;
+		if(!playerInfo.isGuest && !countryString.isEmpty()) {
+			toolTip = getFullCountryString(countryString.toUpper());
 		}
-
-		++it1;
+		myNickListModel->updatePlayer(playerId, newPlayerName, countryString, toolTip, playerInfo.isGuest);
 	}
 
 	if (myChat->getMyNick() == oldNick) {
@@ -1132,14 +966,7 @@ void gameLobbyDialogImpl::removeSpectator(unsigned spectatorId, QString)
 
 void gameLobbyDialogImpl::playerLeftLobby(unsigned playerId)
 {
-	int it1 = 0;
-	while (myNickListModel->item(it1)) {
-		if (myNickListModel->item(it1, 0)->data(Qt::UserRole) == playerId) {
-			myNickListModel->removeRow(it1);;
-			break;
-		}
-		++it1;
-	}
+	myNickListModel->removePlayer(playerId);
 
 	refreshPlayerStats();
 }
@@ -1149,18 +976,16 @@ void gameLobbyDialogImpl::playerJoinedLobby(unsigned playerId, QString /*playerN
 	PlayerInfo playerInfo(mySession->getClientPlayerInfo(playerId));
 	QString countryString = QString::fromUtf8(playerInfo.countryCode.c_str()).toLower();
 
-	QStandardItem *item = new QStandardItem;
-	item->setText(QString::fromUtf8(playerInfo.playerName.c_str()));
-	item->setData(playerId, Qt::UserRole);
-	item->setData(countryString, 33);
-	if(playerInfo.isGuest || countryString.isEmpty()) {
-		item->setIcon(QIcon(":/cflags/cflags/undefined.png"));
-	} else {
-		item->setIcon(QIcon(QString(":/cflags/cflags/%1.png").arg(countryString)));
-		item->setToolTip(getFullCountryString(countryString.toUpper()));
+	LobbyNickListEntry entry;
+	entry.playerId = playerId;
+	entry.name = QString::fromUtf8(playerInfo.playerName.c_str());
+	entry.countryCode = countryString;
+	entry.isGuest = playerInfo.isGuest;
+	if(!playerInfo.isGuest && !countryString.isEmpty()) {
+		entry.toolTip = getFullCountryString(countryString.toUpper());
 	}
-	item->setData("idle", 34);
-	myNickListModel->appendRow(item);
+	// Rows are inserted in one batch when control returns to the event loop.
+	myNickListModel->addPlayer(entry);
 
 	refreshPlayerStats();
 }
@@ -1609,7 +1434,7 @@ void gameLobbyDialogImpl::changeNickListFilter(int state)
 	}
 
 	myNickListSortFilterProxyModel->setFilterState(state);
-	myNickListModel->sort(0, Qt::DescendingOrder);
+	myNickListSortFilterProxyModel->invalidate();
 
 	myNickListSortFilterProxyModel->setFilterRegExp(QString());
 	myNickListSortFilterProxyModel->setFilterKeyColumn(0);
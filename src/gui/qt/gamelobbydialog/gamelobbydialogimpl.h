@@ -51,6 +51,8 @@ class ChatTools;
 class startWindowImpl;
 class MyGameListSortFilterProxyModel;
 class MyNickListSortFilterProxyModel;
+class LobbyGameListModel;
+class LobbyNickListModel;
 
 /**
 	@author FThauer FHammer <webmaster@pokerth.net>
@@ -85,7 +87,7 @@ public slots:
 	void createGame();
 	void joinGame();
 	void gameSelected(const QModelIndex &);
-	void updateGameItem(QList <QStandardItem*>, unsigned gameId);
+	void updateGameItem(unsigned gameId);
 	void addGame(unsigned gameId);
 	void updateGameMode(unsigned gameId, int newMode);
 	void updateGameAdmin(unsigned gameId, unsigned adminPlayerId);
@@ -196,7 +198,7 @@ private:
 	QColor disabledStartButtonTextColor;
 	ChatTools *myChat;
 	int keyUpCounter;
-	QStandardItemModel *myGameListModel;
+	LobbyGameListModel *myGameListModel;
 	QItemSelectionModel *myGameListSelectionModel;
 	MyGameListSortFilterProxyModel *myGameListSortFilterProxyModel;
 	QMenu *gameListContextMenu;
@@ -219,7 +221,7 @@ private:
 	int currentInvitationGameId;
 	bool inviteDialogIsCurrentlyShown;
 
-	QStandardItemModel *myNickListModel;
+	LobbyNickListModel *myNickListModel;
 	QItemSelectionModel *myNickListSelectionModel;
 	MyNickListSortFilterProxyModel *myNickListSortFilterProxyModel;
 
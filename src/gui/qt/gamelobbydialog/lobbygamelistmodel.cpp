@@ -0,0 +1,233 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+#include "lobbygamelistmodel.h"
+#include <QtGui>
+#include <QtCore>
+
+LobbyGameListModel::LobbyGameListModel(QObject *parent)
+	: QAbstractTableModel(parent), numVisibleRows(0), firstDirtyRow(-1), lastDirtyRow(-1), numRunningGames(0), flushScheduled(false)
+{
+	typeIcons[GAME_TYPE_NORMAL] = QIcon(":/gfx/player_play.png");
+	typeIcons[GAME_TYPE_REGISTERED_ONLY] = QIcon(":/gfx/registered.png");
+	typeIcons[GAME_TYPE_INVITE_ONLY] = QIcon(":/gfx/list_add_user.png");
+	typeIcons[GAME_TYPE_RANKING] = QIcon(":/gfx/cup.png");
+	lockIcon = QIcon(":/gfx/lock.png");
+}
+
+int LobbyGameListModel::rowCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : numVisibleRows;
+}
+
+int LobbyGameListModel::columnCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : GAME_LIST_NUM_COLUMNS;
+}
+
+QVariant LobbyGameListModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid() || index.row() >= numVisibleRows) {
+		return QVariant();
+	}
+	const LobbyGameListEntry &entry = entries.at(index.row());
+
+	if (role == Qt::UserRole) {
+		return entry.gameId;
+	}
+	if (role == Qt::BackgroundRole) {
+		if (entry.meInThisGame) {
+			return QBrush(QColor(0, 255, 0, 127));
+		}
+		return QVariant();
+	}
+
+	switch (index.column()) {
+	case 0:
+		if (role == Qt::DisplayRole) {
+			return entry.name;
+		} else if (role == GAME_LIST_FILTER_ROLE) {
+			return entry.meInThisGame ? QString("MeInThisGame") : QString("");
+		}
+		break;
+	case 1:
+		if (role == Qt::DisplayRole) {
+			return entry.playersText;
+		} else if (role == GAME_LIST_FILTER_ROLE) {
+			return entry.isFull ? QString("totalfull") : QString("nonfull");
+		}
+		break;
+	case 2:
+		if (role == Qt::DisplayRole) {
+			return entry.stateText;
+		} else if (role == GAME_LIST_FILTER_ROLE) {
+			return entry.isRunning ? QString("running") : QString("open");
+		}
+		break;
+	case 3:
+		// The display text is only used for sorting by type.
+		switch (entry.gameType) {
+		case GAME_TYPE_NORMAL:
+			if (role == Qt::DisplayRole) return QString("");
+			if (role == GAME_LIST_FILTER_ROLE) return QString("standard");
+			break;
+		case GAME_TYPE_REGISTERED_ONLY:
+			if (role == Qt::DisplayRole) return QString(" ");
+			if (role == GAME_LIST_FILTER_ROLE) return QString("registered");
+			break;
+		case GAME_TYPE_INVITE_ONLY:
+			if (role == Qt::DisplayRole) return QString("  ");
+			if (role == GAME_LIST_FILTER_ROLE) return QString("invited");
+			break;
+		case GAME_TYPE_RANKING:
+			if (role == Qt::DisplayRole) return QString("   ");
+			if (role == GAME_LIST_FILTER_ROLE) return QString("ranking");
+			break;
+		}
+		if (role == Qt::DecorationRole && entry.gameType >= GAME_TYPE_NORMAL && entry.gameType <= GAME_TYPE_RANKING) {
+			return typeIcons[entry.gameType];
+		}
+		break;
+	case 4:
+		if (role == Qt::DisplayRole) {
+			return entry.isPrivate ? QString(" ") : QString("");
+		} else if (role == GAME_LIST_FILTER_ROLE) {
+			return entry.isPrivate ? QString("private") : QString("nonpriv");
+		} else if (role == Qt::DecorationRole && entry.isPrivate) {
+			return lockIcon;
+		}
+		break;
+	case 5:
+		if (role == Qt::DisplayRole) {
+			return entry.timingText;
+		} else if (role == GAME_LIST_FILTER_ROLE) {
+			return entry.timingSortKey;
+		}
+		break;
+	}
+	return QVariant();
+}
+
+QVariant LobbyGameListModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section >= 0 && section < headerLabels.size()) {
+		return headerLabels.at(section);
+	}
+	return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+void LobbyGameListModel::setHeaderLabels(const QStringList &labels)
+{
+	headerLabels = labels;
+	emit headerDataChanged(Qt::Horizontal, 0, GAME_LIST_NUM_COLUMNS - 1);
+}
+
+void LobbyGameListModel::setGame(const LobbyGameListEntry &entry)
+{
+	QHash<unsigned, int>::const_iterator pos = rowIndex.find(entry.gameId);
+	if (pos != rowIndex.end()) {
+		int row = pos.value();
+		if (entries.at(row).isRunning != entry.isRunning) {
+			numRunningGames += entry.isRunning ? 1 : -1;
+		}
+		entries[row] = entry;
+		// Rows which are not yet visible will be inserted with their current data.
+		if (row < numVisibleRows) {
+			if (firstDirtyRow < 0 || row < firstDirtyRow) {
+				firstDirtyRow = row;
+			}
+			if (row > lastDirtyRow) {
+				lastDirtyRow = row;
+			}
+		}
+	} else {
+		rowIndex.insert(entry.gameId, entries.size());
+		entries.append(entry);
+		if (entry.isRunning) {
+			numRunningGames++;
+		}
+	}
+	scheduleFlush();
+}
+
+void LobbyGameListModel::removeGame(unsigned gameId)
+{
+	flushPending();
+	QHash<unsigned, int>::iterator pos = rowIndex.find(gameId);
+	if (pos != rowIndex.end()) {
+		int row = pos.value();
+		beginRemoveRows(QModelIndex(), row, row);
+		if (entries.at(row).isRunning) {
+			numRunningGames--;
+		}
+		rowIndex.erase(pos);
+		entries.remove(row);
+		for (int i = row; i < entries.size(); i++) {
+			rowIndex[entries.at(i).gameId] = i;
+		}
+		numVisibleRows--;
+		endRemoveRows();
+	}
+}
+
+void LobbyGameListModel::clear()
+{
+	beginResetModel();
+	entries.clear();
+	rowIndex.clear();
+	numVisibleRows = 0;
+	firstDirtyRow = lastDirtyRow = -1;
+	numRunningGames = 0;
+	endResetModel();
+}
+
+void LobbyGameListModel::flushPending()
+{
+	flushScheduled = false;
+	if (firstDirtyRow >= 0) {
+		int first = firstDirtyRow;
+		int last = lastDirtyRow;
+		firstDirtyRow = lastDirtyRow = -1;
+		emit dataChanged(index(first, 0), index(last, GAME_LIST_NUM_COLUMNS - 1));
+	}
+	if (entries.size() > numVisibleRows) {
+		beginInsertRows(QModelIndex(), numVisibleRows, entries.size() - 1);
+		numVisibleRows = entries.size();
+		endInsertRows();
+	}
+}
+
+void LobbyGameListModel::scheduleFlush()
+{
+	if (!flushScheduled) {
+		flushScheduled = true;
+		QTimer::singleShot(0, this, SLOT(flushPending()));
+	}
+}
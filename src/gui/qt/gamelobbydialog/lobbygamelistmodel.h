@@ -0,0 +1,108 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+#ifndef LOBBYGAMELISTMODEL_H
+#define LOBBYGAMELISTMODEL_H
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+#include <QIcon>
+
+#include <gamedata.h>
+
+// Role of the filter/sort keys used by MyGameListSortFilterProxyModel.
+#define GAME_LIST_FILTER_ROLE		16
+#define GAME_LIST_NUM_COLUMNS		6
+
+struct LobbyGameListEntry {
+	LobbyGameListEntry() : gameId(0), gameType(GAME_TYPE_NORMAL), isFull(false), isRunning(false), isPrivate(false), meInThisGame(false) {}
+	unsigned gameId;
+	QString name;
+	QString playersText;
+	QString stateText;
+	QString timingText;
+	QString timingSortKey;
+	GameType gameType;
+	bool isFull;
+	bool isRunning;
+	bool isPrivate;
+	bool meInThisGame;
+};
+
+// Game list of the lobby, indexed by game id.
+// New rows and changes are collected and passed to the views once per event loop run.
+class LobbyGameListModel : public QAbstractTableModel
+{
+	Q_OBJECT
+
+public:
+	LobbyGameListModel(QObject *parent = 0);
+
+	int rowCount(const QModelIndex &parent = QModelIndex()) const;
+	int columnCount(const QModelIndex &parent = QModelIndex()) const;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+	void setHeaderLabels(const QStringList &labels);
+	void setGame(const LobbyGameListEntry &entry);
+	void removeGame(unsigned gameId);
+	void clear();
+
+	bool hasGame(unsigned gameId) const {
+		return rowIndex.contains(gameId);
+	}
+	int getNumRunningGames() const {
+		return numRunningGames;
+	}
+	int getNumOpenGames() const {
+		return entries.size() - numRunningGames;
+	}
+
+public slots:
+	void flushPending();
+
+private:
+	void scheduleFlush();
+
+	QVector<LobbyGameListEntry> entries;
+	QHash<unsigned, int> rowIndex;
+	QStringList headerLabels;
+	QIcon typeIcons[GAME_TYPE_RANKING + 1];
+	QIcon lockIcon;
+	int numVisibleRows;
+	int firstDirtyRow;
+	int lastDirtyRow;
+	int numRunningGames;
+	bool flushScheduled;
+};
+
+#endif // LOBBYGAMELISTMODEL_H
@@ -0,0 +1,222 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+#include "lobbynicklistmodel.h"
+#include <QtGui>
+#include <QtCore>
+
+LobbyNickListModel::LobbyNickListModel(QObject *parent)
+	: QAbstractListModel(parent), numVisibleRows(0), firstDirtyRow(-1), lastDirtyRow(-1), flushScheduled(false)
+{
+}
+
+int LobbyNickListModel::rowCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : numVisibleRows;
+}
+
+QVariant LobbyNickListModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid() || index.row() >= numVisibleRows || index.column() != 0) {
+		return QVariant();
+	}
+	const LobbyNickListEntry &entry = entries.at(index.row());
+
+	switch (role) {
+	case Qt::DisplayRole:
+		return entry.name;
+	case Qt::UserRole:
+		return entry.playerId;
+	case Qt::DecorationRole:
+		return getFlagIcon(entry.countryCode, entry.isGuest);
+	case Qt::ToolTipRole:
+		return entry.toolTip;
+	case NICK_LIST_COUNTRY_ROLE:
+		return entry.countryCode;
+	case NICK_LIST_STATE_ROLE:
+		return entry.isActive ? QString("active") : QString("idle");
+	}
+	return QVariant();
+}
+
+QVariant LobbyNickListModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section >= 0 && section < headerLabels.size()) {
+		return headerLabels.at(section);
+	}
+	return QAbstractListModel::headerData(section, orientation, role);
+}
+
+void LobbyNickListModel::setHeaderLabels(const QStringList &labels)
+{
+	headerLabels = labels;
+	emit headerDataChanged(Qt::Horizontal, 0, 0);
+}
+
+void LobbyNickListModel::addPlayer(const LobbyNickListEntry &entry)
+{
+	QHash<unsigned, int>::const_iterator pos = rowIndex.find(entry.playerId);
+	if (pos != rowIndex.end()) {
+		entries[pos.value()] = entry;
+		markDirty(pos.value());
+	} else {
+		rowIndex.insert(entry.playerId, entries.size());
+		entries.append(entry);
+		scheduleFlush();
+	}
+}
+
+void LobbyNickListModel::updatePlayer(unsigned playerId, const QString &name, const QString &countryCode, const QString &toolTip, bool isGuest)
+{
+	QHash<unsigned, int>::const_iterator pos = rowIndex.find(playerId);
+	if (pos != rowIndex.end()) {
+		LobbyNickListEntry &entry = entries[pos.value()];
+		entry.name = name;
+		entry.countryCode = countryCode;
+		entry.toolTip = toolTip;
+		entry.isGuest = isGuest;
+		markDirty(pos.value());
+	}
+}
+
+void LobbyNickListModel::setPlayerActive(unsigned playerId, bool active)
+{
+	QHash<unsigned, int>::const_iterator pos = rowIndex.find(playerId);
+	if (pos != rowIndex.end() && entries.at(pos.value()).isActive != active) {
+		entries[pos.value()].isActive = active;
+		markDirty(pos.value());
+	}
+}
+
+void LobbyNickListModel::removePlayer(unsigned playerId)
+{
+	flushPending();
+	QHash<unsigned, int>::iterator pos = rowIndex.find(playerId);
+	if (pos != rowIndex.end()) {
+		int row = pos.value();
+		beginRemoveRows(QModelIndex(), row, row);
+		rowIndex.erase(pos);
+		entries.remove(row);
+		for (int i = row; i < entries.size(); i++) {
+			rowIndex[entries.at(i).playerId] = i;
+		}
+		numVisibleRows--;
+		endRemoveRows();
+	}
+}
+
+void LobbyNickListModel::clear()
+{
+	beginResetModel();
+	entries.clear();
+	rowIndex.clear();
+	numVisibleRows = 0;
+	firstDirtyRow = lastDirtyRow = -1;
+	endResetModel();
+}
+
+QString LobbyNickListModel::getPlayerName(unsigned playerId) const
+{
+	QHash<unsigned, int>::const_iterator pos = rowIndex.find(playerId);
+	if (pos != rowIndex.end()) {
+		return entries.at(pos.value()).name;
+	}
+	return QString();
+}
+
+bool LobbyNickListModel::getPlayerIdFromName(const QString &name, unsigned &playerId) const
+{
+	for (int i = 0; i < entries.size(); i++) {
+		if (entries.at(i).name == name) {
+			playerId = entries.at(i).playerId;
+			return true;
+		}
+	}
+	return false;
+}
+
+QStringList LobbyNickListModel::getPlayerNames() const
+{
+	QStringList names;
+	names.reserve(entries.size());
+	for (int i = 0; i < entries.size(); i++) {
+		names << entries.at(i).name;
+	}
+	return names;
+}
+
+void LobbyNickListModel::flushPending()
+{
+	flushScheduled = false;
+	if (firstDirtyRow >= 0) {
+		int first = firstDirtyRow;
+		int last = lastDirtyRow;
+		firstDirtyRow = lastDirtyRow = -1;
+		emit dataChanged(index(first, 0), index(last, 0));
+	}
+	if (entries.size() > numVisibleRows) {
+		beginInsertRows(QModelIndex(), numVisibleRows, entries.size() - 1);
+		numVisibleRows = entries.size();
+		endInsertRows();
+	}
+}
+
+void LobbyNickListModel::markDirty(int row)
+{
+	// Rows which are not yet visible will be inserted with their current data.
+	if (row < numVisibleRows) {
+		if (firstDirtyRow < 0 || row < firstDirtyRow) {
+			firstDirtyRow = row;
+		}
+		if (row > lastDirtyRow) {
+			lastDirtyRow = row;
+		}
+		scheduleFlush();
+	}
+}
+
+void LobbyNickListModel::scheduleFlush()
+{
+	if (!flushScheduled) {
+		flushScheduled = true;
+		QTimer::singleShot(0, this, SLOT(flushPending()));
+	}
+}
+
+const QIcon &LobbyNickListModel::getFlagIcon(const QString &countryCode, bool isGuest) const
+{
+	// Flag icons are shared by many players, load each of them only once.
+	QString key(isGuest || countryCode.isEmpty() ? QString("undefined") : countryCode);
+	QHash<QString, QIcon>::iterator pos = flagIcons.find(key);
+	if (pos == flagIcons.end()) {
+		pos = flagIcons.insert(key, QIcon(QString(":/cflags/cflags/%1.png").arg(key)));
+	}
+	return pos.value();
+}
@@ -0,0 +1,103 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+#ifndef LOBBYNICKLISTMODEL_H
+#define LOBBYNICKLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+#include <QIcon>
+
+// Roles used by MyNickListSortFilterProxyModel.
+#define NICK_LIST_COUNTRY_ROLE		33
+#define NICK_LIST_STATE_ROLE		34
+
+struct LobbyNickListEntry {
+	LobbyNickListEntry() : playerId(0), isGuest(false), isActive(false) {}
+	unsigned playerId;
+	QString name;
+	QString countryCode;
+	QString toolTip;
+	bool isGuest;
+	bool isActive;
+};
+
+// Player list of the lobby, indexed by player id.
+// New rows and changes are collected and passed to the views once per event loop run.
+class LobbyNickListModel : public QAbstractListModel
+{
+	Q_OBJECT
+
+public:
+	LobbyNickListModel(QObject *parent = 0);
+
+	int rowCount(const QModelIndex &parent = QModelIndex()) const;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+	void setHeaderLabels(const QStringList &labels);
+	void addPlayer(const LobbyNickListEntry &entry);
+	void updatePlayer(unsigned playerId, const QString &name, const QString &countryCode, const QString &toolTip, bool isGuest);
+	void setPlayerActive(unsigned playerId, bool active);
+	void removePlayer(unsigned playerId);
+	void clear();
+
+	bool hasPlayer(unsigned playerId) const {
+		return rowIndex.contains(playerId);
+	}
+	QString getPlayerName(unsigned playerId) const;
+	bool getPlayerIdFromName(const QString &name, unsigned &playerId) const;
+	// All players, including those not yet passed to the views.
+	int getNumPlayers() const {
+		return entries.size();
+	}
+	QStringList getPlayerNames() const;
+
+public slots:
+	void flushPending();
+
+private:
+	void markDirty(int row);
+	void scheduleFlush();
+	const QIcon &getFlagIcon(const QString &countryCode, bool isGuest) const;
+
+	QVector<LobbyNickListEntry> entries;
+	QHash<unsigned, int> rowIndex;
+	QStringList headerLabels;
+	mutable QHash<QString, QIcon> flagIcons;
+	int numVisibleRows;
+	int firstDirtyRow;
+	int lastDirtyRow;
+	bool flushScheduled;
+};
+
+#endif // LOBBYNICKLISTMODEL_H
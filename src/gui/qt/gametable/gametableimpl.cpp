@@ -76,8 +76,19 @@
 
 using namespace std;
 
+static int getRefreshFrameMsec()
+{
+#if QT_VERSION >= 0x050000
+	QScreen *screen = QGuiApplication::primaryScreen();
+	if(screen && screen->refreshRate() > 0) {
+		return qMax(1, qRound(1000.0 / screen->refreshRate()));
+	}
+#endif
+	return 16;
+}
+
 gameTableImpl::gameTableImpl(ConfigFile *c, QMainWindow *parent)
-	: QMainWindow(parent), myChat(NULL), myConfig(c), gameSpeed(0), myActionIsBet(0), myActionIsRaise(0), pushButtonBetRaiseIsChecked(false), pushButtonCallCheckIsChecked(false), pushButtonFoldIsChecked(false), pushButtonAllInIsChecked(false), myButtonsAreCheckable(false), breakAfterCurrentHand(false), currentGameOver(false), betSliderChangedByInput(false), guestMode(false), myLastPreActionBetValue(0)
+	: QMainWindow(parent), myChat(NULL), myConfig(c), pendingRefreshFlags(0), fastForward(false), animationSpeed(c->readConfigInt("GameSpeed")), gameSpeed(0), myActionIsBet(0), myActionIsRaise(0), pushButtonBetRaiseIsChecked(false), pushButtonCallCheckIsChecked(false), pushButtonFoldIsChecked(false), pushButtonAllInIsChecked(false), myButtonsAreCheckable(false), breakAfterCurrentHand(false), currentGameOver(false), betSliderChangedByInput(false), guestMode(false), myLastPreActionBetValue(0)
 {
 	int i;
 
@@ -99,10 +110,12 @@ gameTableImpl::gameTableImpl(ConfigFile *c, QMainWindow *parent)
 	// 	Init game table style
 	myGameTableStyle = new GameTableStyleReader(myConfig, this);
 	myGameTableStyle->readStyleFile(QString::fromUtf8(myConfig->readConfigString("CurrentGameTableStyle").c_str()));
+	myGameTableStyle->loadPixmaps();
 
 	// 	Init card deck style
 	myCardDeckStyle = new CardDeckStyleReader(myConfig, this);
 	myCardDeckStyle->readStyleFile(QString::fromUtf8(myConfig->readConfigString("CurrentCardDeckStyle").c_str()));
+	myCardDeckStyle->loadPixmaps();
 
 	//Player0 pixmapCardsLabel needs Myw
 	pixmapLabel_card0b->setMyW(this);
@@ -128,7 +141,7 @@ gameTableImpl::gameTableImpl(ConfigFile *c, QMainWindow *parent)
 	if (myConfig->readConfigInt("FlipsideOwn") && myConfig->readConfigString("FlipsideOwnFile") != "") {
 		flipside = QPixmap::fromImage(QImage(QString::fromUtf8(myConfig->readConfigString("FlipsideOwnFile").c_str())));
 	} else {
-		flipside = QPixmap::fromImage(QImage(myCardDeckStyle->getCurrentDir()+"flipside.png"));
+		flipside = myCardDeckStyle->getFlipsidePixmap();
 	}
 
 	//Flipside Animation noch nicht erledigt
@@ -235,6 +248,10 @@ gameTableImpl::gameTableImpl(ConfigFile *c, QMainWindow *parent)
 
 	enableCallCheckPushButtonTimer->setSingleShot(true);
 
+	refreshFrameTimer = new QTimer(this);
+	refreshFrameTimer->setSingleShot(true);
+	refreshFrameTimer->setInterval(getRefreshFrameMsec());
+
 	playerStarsArray[1][0]=label_Star10;
 	playerStarsArray[2][0]=label_Star20;
 	playerStarsArray[3][0]=label_Star30;
@@ -641,15 +658,16 @@ gameTableImpl::gameTableImpl(ConfigFile *c, QMainWindow *parent)
 	}
 	//Nachrichten Thread-Save
 	connect(this, SIGNAL(signalInitGui(int)), this, SLOT(initGui(int)));
-	connect(this, SIGNAL(signalRefreshSet()), this, SLOT(refreshSet()));
-	connect(this, SIGNAL(signalRefreshCash()), this, SLOT(refreshCash()));
+	connect(refreshFrameTimer, SIGNAL(timeout()), this, SLOT(flushRefresh()));
+	connect(this, SIGNAL(signalRefreshSet()), this, SLOT(scheduleRefreshSet()));
+	connect(this, SIGNAL(signalRefreshCash()), this, SLOT(scheduleRefreshCash()));
 	connect(this, SIGNAL(signalRefreshAction(int, int)), this, SLOT(refreshAction(int, int)));
-	connect(this, SIGNAL(signalRefreshChangePlayer()), this, SLOT(refreshChangePlayer()));
-	connect(this, SIGNAL(signalRefreshPot()), this, SLOT(refreshPot()));
+	connect(this, SIGNAL(signalRefreshChangePlayer()), this, SLOT(scheduleRefreshChangePlayer()));
+	connect(this, SIGNAL(signalRefreshPot()), this, SLOT(scheduleRefreshPot()));
 	connect(this, SIGNAL(signalRefreshGroupbox(int, int)), this, SLOT(refreshGroupbox(int, int)));
-	connect(this, SIGNAL(signalRefreshAll()), this, SLOT(refreshAll()));
-	connect(this, SIGNAL(signalRefreshPlayerName()), this, SLOT(refreshPlayerName()));
-	connect(this, SIGNAL(signalRefreshButton()), this, SLOT(refreshButton()));
+	connect(this, SIGNAL(signalRefreshAll()), this, SLOT(scheduleRefreshAll()));
+	connect(this, SIGNAL(signalRefreshPlayerName()), this, SLOT(scheduleRefreshPlayerName()));
+	connect(this, SIGNAL(signalRefreshButton()), this, SLOT(scheduleRefreshButton()));
 	connect(this, SIGNAL(signalRefreshGameLabels(int)), this, SLOT(refreshGameLabels(int)));
 	connect(this, SIGNAL(signalRefreshSpectatorsDisplay()), this, SLOT(refreshSpectatorsDisplay()));
 	connect(this, SIGNAL(signalSetPlayerAvatar(int, QString)), this, SLOT(setPlayerAvatar(int, QString)));
@@ -709,9 +727,11 @@ void gameTableImpl::applySettings(settingsDialogImpl* mySettingsDialog)
 #ifndef GUI_800x480 //currently not for mobile guis because we just use the default style here
 	//apply card deck style
 	myCardDeckStyle->readStyleFile(QString::fromUtf8(myConfig->readConfigString("CurrentCardDeckStyle").c_str()));
+	myCardDeckStyle->loadPixmaps();
 	checkActionLabelPosition();
 	//apply game table style
 	myGameTableStyle->readStyleFile(QString::fromUtf8(myConfig->readConfigString("CurrentGameTableStyle").c_str()));
+	myGameTableStyle->loadPixmaps();
 #endif
 
 #ifdef GUI_800x480
@@ -797,15 +817,15 @@ void gameTableImpl::applySettings(settingsDialogImpl* mySettingsDialog)
 		GameState currentState = myStartWindow->getSession()->getCurrentGame()->getCurrentHand()->getCurrentBeRo()->getMyBeRoID();
 		if(currentState >= GAME_STATE_FLOP && currentState <= GAME_STATE_POST_RIVER)
 			for(int i=0; i<3; i++) {
-				QPixmap card = QPixmap::fromImage(QImage(myCardDeckStyle->getCurrentDir()+QString::number(boardCards[i], 10)+".png"));
+				QPixmap card = myCardDeckStyle->getCardPixmap(boardCards[i]);
 				boardCardsArray[i]->setPixmap(card, false);
 			}
 		if(currentState >= GAME_STATE_TURN && currentState <= GAME_STATE_POST_RIVER) {
-			QPixmap card = QPixmap::fromImage(QImage(myCardDeckStyle->getCurrentDir()+QString::number(boardCards[3], 10)+".png"));
+			QPixmap card = myCardDeckStyle->getCardPixmap(boardCards[3]);
 			boardCardsArray[3]->setPixmap(card, false);
 		}
 		if(currentState == GAME_STATE_RIVER || currentState == GAME_STATE_POST_RIVER) {
-			QPixmap card = QPixmap::fromImage(QImage(myCardDeckStyle->getCurrentDir()+QString::number(boardCards[4], 10)+".png"));
+			QPixmap card = myCardDeckStyle->getCardPixmap(boardCards[4]);
 			boardCardsArray[4]->setPixmap(card, false);
 		}
 	}
@@ -814,7 +834,7 @@ void gameTableImpl::applySettings(settingsDialogImpl* mySettingsDialog)
 	if (myConfig->readConfigInt("FlipsideOwn") && myConfig->readConfigString("FlipsideOwnFile") != "") {
 		flipside = QPixmap::fromImage(QImage(QString::fromUtf8(myConfig->readConfigString("FlipsideOwnFile").c_str())));
 	} else {
-		flipside = QPixmap::fromImage(QImage(myCardDeckStyle->getCurrentDir()+"flipside.png"));
+		flipside = myCardDeckStyle->getFlipsidePixmap();
 	}
 	int j,k;
 	for (j=1; j<MAX_NUMBER_OF_PLAYERS; j++ ) {
@@ -837,15 +857,15 @@ void gameTableImpl::applySettings(settingsDialogImpl* mySettingsDialog)
 			humanPlayer->getMyHoleCards(tempCardsIntArray);
 			if(myConfig->readConfigInt("AntiPeekMode")) {
 				holeCardsArray[0][0]->setPixmap(flipside, true);
-				tempCardsPixmapArray[0] = QPixmap::fromImage(QImage(myCardDeckStyle->getCurrentDir()+QString::number(tempCardsIntArray[0], 10)+".png"));
+				tempCardsPixmapArray[0] = myCardDeckStyle->getCardPixmap(tempCardsIntArray[0]);
 				holeCardsArray[0][0]->setHiddenFrontPixmap(tempCardsPixmapArray[0]);
 				holeCardsArray[0][1]->setPixmap(flipside, true);
-				tempCardsPixmapArray[1]= QPixmap::fromImage(QImage(myCardDeckStyle->getCurrentDir()+QString::number(tempCardsIntArray[1], 10)+".png"));
+				tempCardsPixmapArray[1]= myCardDeckStyle->getCardPixmap(tempCardsIntArray[1]);
 				holeCardsArray[0][1]->setHiddenFrontPixmap(tempCardsPixmapArray[1]);
 			} else {
-				tempCardsPixmapArray[0]= QPixmap::fromImage(QImage(myCardDeckStyle->getCurrentDir()+QString::number(tempCardsIntArray[0], 10)+".png"));
+				tempCardsPixmapArray[0]= myCardDeckStyle->getCardPixmap(tempCardsIntArray[0]);
 				holeCardsArray[0][0]->setPixmap(tempCardsPixmapArray[0],false);
-				tempCardsPixmapArray[1]= QPixmap::fromImage(QImage(myCardDeckStyle->getCurrentDir()+QString::number(tempCardsIntArray[1], 10)+".png"));
+				tempCardsPixmapArray[1]= myCardDeckStyle->getCardPixmap(tempCardsIntArray[1]);
 				holeCardsArray[0][1]->setPixmap(tempCardsPixmapArray[1],false);
 			}
 		}
@@ -885,6 +905,11 @@ void gameTableImpl::initGui(int speed)
 		userWidgetsArray[i]->show();
 	}
 
+	//fast forward is only available in local games
+	if(myStartWindow->getSession()->isNetworkClientRunning() && fastForward) {
+		toggleFastForward();
+	}
+
 	//set speeds for local game and for first network game
 	if( !myStartWindow->getSession()->isNetworkClientRunning() || (myStartWindow->getSession()->isNetworkClientRunning() && !myStartWindow->getSession()->getCurrentGame()) ) {
 		guiGameSpeed = speed;
@@ -959,10 +984,10 @@ void gameTableImpl::refreshSet()
 void gameTableImpl::refreshButton()
 {
 
-	QPixmap dealerButton = QPixmap::fromImage(QImage(myGameTableStyle->getDealerPuck()));
-	QPixmap smallblindButton = QPixmap::fromImage(QImage(myGameTableStyle->getSmallBlindPuck()));
-	QPixmap bigblindButton = QPixmap::fromImage(QImage(myGameTableStyle->getBigBlindPuck()));
-	QPixmap onePix = QPixmap::fromImage(QImage(myAppDataPath +"gfx/gui/misc/1px.png"));
+	QPixmap dealerButton = myGameTableStyle->getPixmap(myGameTableStyle->getDealerPuck());
+	QPixmap smallblindButton = myGameTableStyle->getPixmap(myGameTableStyle->getSmallBlindPuck());
+	QPixmap bigblindButton = myGameTableStyle->getPixmap(myGameTableStyle->getBigBlindPuck());
+	QPixmap onePix = myGameTableStyle->getOnePixPixmap();
 
 	boost::shared_ptr<Game> currentGame = myStartWindow->getSession()->getCurrentGame();
 
@@ -1072,7 +1097,7 @@ void gameTableImpl::refreshPlayerAvatar()
 
 	if(myStartWindow->getSession()->getCurrentGame()) {
 
-		QPixmap onePix = QPixmap::fromImage(QImage(myAppDataPath +"gfx/gui/misc/1px.png"));
+		QPixmap onePix = myGameTableStyle->getOnePixPixmap();
 
 		boost::shared_ptr<Game> currentGame = myStartWindow->getSession()->getCurrentGame();
 		int seatPlace;
@@ -1091,7 +1116,7 @@ void gameTableImpl::refreshPlayerAvatar()
 			QFile myAvatarFile(QString::fromUtf8((*it_c)->getMyAvatar().c_str()));
 			QPixmap avatarPic;
 			if((*it_c)->getMyAvatar() == "" || !myAvatarFile.exists()) {
-				avatarPic = QPixmap::fromImage(QImage(myGameTableStyle->getDefaultAvatar()));
+				avatarPic = myGameTableStyle->getPixmap(myGameTableStyle->getDefaultAvatar());
 			} else {
 				avatarPic = QPixmap::fromImage(QImage(QString::fromUtf8((*it_c)->getMyAvatar().c_str())));
 			}
@@ -1138,7 +1163,7 @@ void gameTableImpl::setPlayerAvatar(int myID, QString myAvatar)
 				playerAvatarLabelArray[tmpPlayer->getMyID()]->setPixmap(myAvatar);
 				tmpPlayer->setMyAvatar(myAvatar.toUtf8().constData());
 			} else {
-				playerAvatarLabelArray[tmpPlayer->getMyID()]->setPixmap(QPixmap::fromImage(QImage(myGameTableStyle->getDefaultAvatar())));
+				playerAvatarLabelArray[tmpPlayer->getMyID()]->setPixmap(myGameTableStyle->getPixmap(myGameTableStyle->getDefaultAvatar()));
 				tmpPlayer->setMyAvatar("");
 			}
 		}
@@ -1148,7 +1173,7 @@ void gameTableImpl::setPlayerAvatar(int myID, QString myAvatar)
 void gameTableImpl::refreshAction(int playerID, int playerAction)
 {
 
-	QPixmap onePix = QPixmap::fromImage(QImage(myAppDataPath +"gfx/gui/misc/1px.png"));
+	QPixmap onePix = myGameTableStyle->getOnePixPixmap();
 	QPixmap action;
 
 	QStringList actionArray;
@@ -1167,7 +1192,7 @@ void gameTableImpl::refreshAction(int playerID, int playerAction)
 				actionLabelArray[(*it_c)->getMyID()]->setPixmap(onePix);
 			} else {
 				//paint action pixmap
-				actionLabelArray[(*it_c)->getMyID()]->setPixmap(QPixmap::fromImage(QImage(myGameTableStyle->getActionPic((*it_c)->getMyAction()))));
+				actionLabelArray[(*it_c)->getMyID()]->setPixmap(myGameTableStyle->getPixmap(myGameTableStyle->getActionPic((*it_c)->getMyAction())));
 			}
 
 			if ((*it_c)->getMyAction()==1) {
@@ -1185,7 +1210,7 @@ void gameTableImpl::refreshAction(int playerID, int playerAction)
 		} else {
 
 			// 		paint action pixmap and raise
-			actionLabelArray[playerID]->setPixmap(QPixmap::fromImage(QImage(myGameTableStyle->getActionPic(playerAction))));
+			actionLabelArray[playerID]->setPixmap(myGameTableStyle->getPixmap(myGameTableStyle->getActionPic(playerAction)));
 
 			//play sounds if exist
 			if(myConfig->readConfigInt("PlayGameActions"))
@@ -1381,6 +1406,39 @@ void gameTableImpl::refreshAll()
 	refreshPlayerAvatar();
 }
 
+void gameTableImpl::scheduleRefresh(int flags)
+{
+	pendingRefreshFlags |= flags;
+	if(!refreshFrameTimer->isActive()) {
+		refreshFrameTimer->start();
+	}
+}
+
+void gameTableImpl::flushRefresh()
+{
+	int flags = pendingRefreshFlags;
+	pendingRefreshFlags = 0;
+
+	if(!myStartWindow->getSession()->getCurrentGame()) {
+		return;
+	}
+
+	// skip what a bigger refresh already covers
+	if(flags & REFRESH_ALL) {
+		refreshAll();
+		flags &= ~(REFRESH_SET | REFRESH_CASH | REFRESH_CHANGE_PLAYER | REFRESH_PLAYER_NAME | REFRESH_BUTTON);
+	}
+	if(flags & REFRESH_CHANGE_PLAYER) {
+		refreshChangePlayer();
+		flags &= ~(REFRESH_SET | REFRESH_CASH);
+	}
+	if(flags & REFRESH_SET) refreshSet();
+	if(flags & REFRESH_CASH) refreshCash();
+	if(flags & REFRESH_POT) refreshPot();
+	if(flags & REFRESH_PLAYER_NAME) refreshPlayerName();
+	if(flags & REFRESH_BUTTON) refreshButton();
+}
+
 void gameTableImpl::refreshChangePlayer()
 {
 
@@ -1425,7 +1483,7 @@ void gameTableImpl::dealHoleCards()
 		}
 	}
 
-	QPixmap onePix = QPixmap::fromImage(QImage(myAppDataPath +"gfx/gui/misc/1px.png"));
+	QPixmap onePix = myGameTableStyle->getOnePixPixmap();
 
 	//TempArrays
 	QPixmap tempCardsPixmapArray[2];
@@ -1442,7 +1500,7 @@ void gameTableImpl::dealHoleCards()
 		for(j=0; j<2; j++) {
 			if((*it_c)->getMyActiveStatus()) {
 				if (( (*it_c)->getMyID() == 0) || (currentGame->getCurrentHand()->getLog() && currentGame->getCurrentHand()->getLog()->getDebugMode()) ) {
-					tempCardsPixmapArray[j].load(myCardDeckStyle->getCurrentDir()+QString::number(tempCardsIntArray[j], 10)+".png");
+					tempCardsPixmapArray[j] = myCardDeckStyle->getCardPixmap(tempCardsIntArray[j]);
 					if(myConfig->readConfigInt("AntiPeekMode")) {
 						holeCardsArray[(*it_c)->getMyID()][j]->setPixmap(flipside, true);
 						holeCardsArray[(*it_c)->getMyID()][j]->setFront(flipside);
@@ -1533,12 +1591,12 @@ void gameTableImpl::dealFlopCards4()
 	int boardCards[5];
 
 	myStartWindow->getSession()->getCurrentGame()->getCurrentHand()->getBoard()->getMyCards(boardCards);
-	QPixmap card = QPixmap::fromImage(QImage(myCardDeckStyle->getCurrentDir()+QString::number(boardCards[0], 10)+".png"));
+	QPixmap card = myCardDeckStyle->getCardPixmap(boardCards[0]);
 
 	//Config? mit oder ohne Eye-Candy?
 	if(myConfig->readConfigInt("ShowFlipCardsAnimation")) {
 		//with Eye-Candy
-		boardCardsArray[0]->startFlipCards(guiGameSpeed, card, flipside);
+		boardCardsArray[0]->startFlipCards(animationSpeed, card, flipside);
 	} else {
 		//without Eye-Candy
 		boardCardsArray[0]->setFront(card);
@@ -1552,12 +1610,12 @@ void gameTableImpl::dealFlopCards5()
 
 	int boardCards[5];
 	myStartWindow->getSession()->getCurrentGame()->getCurrentHand()->getBoard()->getMyCards(boardCards);
-	QPixmap card = QPixmap::fromImage(QImage(myCardDeckStyle->getCurrentDir()+QString::number(boardCards[1], 10)+".png"));
+	QPixmap card = myCardDeckStyle->getCardPixmap(boardCards[1]);
 
 	//Config? mit oder ohne Eye-Candy?
 	if(myConfig->readConfigInt("ShowFlipCardsAnimation")) {
 		//with Eye-Candy
-		boardCardsArray[1]->startFlipCards(guiGameSpeed, card, flipside);
+		boardCardsArray[1]->startFlipCards(animationSpeed, card, flipside);
 	} else {
 		//without Eye-Candy
 		boardCardsArray[1]->setFront(card);
@@ -1571,12 +1629,12 @@ void gameTableImpl::dealFlopCards6()
 
 	int boardCards[5];
 	myStartWindow->getSession()->getCurrentGame()->getCurrentHand()->getBoard()->getMyCards(boardCards);
-	QPixmap card = QPixmap::fromImage(QImage(myCardDeckStyle->getCurrentDir()+QString::number(boardCards[2], 10)+".png"));
+	QPixmap card = myCardDeckStyle->getCardPixmap(boardCards[2]);
 
 	//Config? mit oder ohne Eye-Candy?
 	if(myConfig->readConfigInt("ShowFlipCardsAnimation")) {
 		//with Eye-Candy
-		boardCardsArray[2]->startFlipCards(guiGameSpeed, card, flipside);
+		boardCardsArray[2]->startFlipCards(animationSpeed, card, flipside);
 	} else {
 		//without Eye-Candy
 		boardCardsArray[2]->setFront(card);
@@ -1615,12 +1673,12 @@ void gameTableImpl::dealTurnCards2()
 
 	int boardCards[5];
 	myStartWindow->getSession()->getCurrentGame()->getCurrentHand()->getBoard()->getMyCards(boardCards);
-	QPixmap card = QPixmap::fromImage(QImage(myCardDeckStyle->getCurrentDir()+QString::number(boardCards[3], 10)+".png"));
+	QPixmap card = myCardDeckStyle->getCardPixmap(boardCards[3]);
 
 	//Config? mit oder ohne Eye-Candy?
 	if(myConfig->readConfigInt("ShowFlipCardsAnimation")) {
 		//with Eye-Candy
-		boardCardsArray[3]->startFlipCards(guiGameSpeed, card, flipside);
+		boardCardsArray[3]->startFlipCards(animationSpeed, card, flipside);
 	} else {
 		//without Eye-Candy
 		boardCardsArray[3]->setFront(card);
@@ -1660,12 +1718,12 @@ void gameTableImpl::dealRiverCards2()
 
 	int boardCards[5];
 	myStartWindow->getSession()->getCurrentGame()->getCurrentHand()->getBoard()->getMyCards(boardCards);
-	QPixmap card = QPixmap::fromImage(QImage(myCardDeckStyle->getCurrentDir()+QString::number(boardCards[4], 10)+".png"));
+	QPixmap card = myCardDeckStyle->getCardPixmap(boardCards[4]);
 
 	//Config? mit oder ohne Eye-Candy?
 	if(myConfig->readConfigInt("ShowFlipCardsAnimation")) {
 		//with Eye-Candy
-		boardCardsArray[4]->startFlipCards(guiGameSpeed, card, flipside);
+		boardCardsArray[4]->startFlipCards(animationSpeed, card, flipside);
 	} else {
 		//without Eye-Candy
 		boardCardsArray[4]->setFront(card);
@@ -2366,8 +2424,6 @@ void gameTableImpl::nextPlayerAnimation()
 	boost::shared_ptr<HandInterface> currentHand = myStartWindow->getSession()->getCurrentGame()->getCurrentHand();
 
 	//refresh Change Player
-	refreshSet();
-
 	PlayerListConstIterator it_c;
 	PlayerList seatsList = currentHand->getSeatsList();
 	for (it_c=seatsList->begin(); it_c!=seatsList->end(); ++it_c) {
@@ -2377,7 +2433,7 @@ void gameTableImpl::nextPlayerAnimation()
 	if(currentHand->getPreviousPlayerID() != -1) {
 		refreshAction(currentHand->getPreviousPlayerID(), (*it_c)->getMyAction());
 	}
-	refreshCash();
+	scheduleRefresh(REFRESH_SET | REFRESH_CASH);
 
 	//refresh actions for human player
 	updateMyButtonsState();
@@ -2585,7 +2641,7 @@ void gameTableImpl::postRiverRunAnimation3()
 		if((*it_c)->getMyAction() != PLAYER_ACTION_FOLD && (*it_c)->getMyCardsValueInt() == currentHand->getCurrentBeRo()->getHighestCardsValue() ) {
 
 			//Show "Winner" label
-			actionLabelArray[(*it_c)->getMyID()]->setPixmap(QPixmap::fromImage(QImage(myGameTableStyle->getActionPic(7))));
+			actionLabelArray[(*it_c)->getMyID()]->setPixmap(myGameTableStyle->getPixmap(myGameTableStyle->getActionPic(7)));
 
 			//show winnercards if more than one player is active TODO
 			if ( nonfoldPlayerCounter != 1 && myConfig->readConfigInt("ShowFadeOutCardsAnimation")) {
@@ -2601,7 +2657,7 @@ void gameTableImpl::postRiverRunAnimation3()
 					}
 				}
 				if (index0) {
-					holeCardsArray[(*it_c)->getMyID()][0]->startFadeOut(guiGameSpeed); /*cout << "Fade Out index0" << endl;*/
+					holeCardsArray[(*it_c)->getMyID()][0]->startFadeOut(animationSpeed); /*cout << "Fade Out index0" << endl;*/
 				}
 				//index 1 testen
 				bool index1 = true;
@@ -2611,7 +2667,7 @@ void gameTableImpl::postRiverRunAnimation3()
 					}
 				}
 				if (index1) {
-					holeCardsArray[(*it_c)->getMyID()][1]->startFadeOut(guiGameSpeed); /*cout << "Fade Out index1" << endl;*/
+					holeCardsArray[(*it_c)->getMyID()][1]->startFadeOut(animationSpeed); /*cout << "Fade Out index1" << endl;*/
 				}
 				//index 2 testen
 				bool index2 = true;
@@ -2621,7 +2677,7 @@ void gameTableImpl::postRiverRunAnimation3()
 					}
 				}
 				if (index2) {
-					boardCardsArray[0]->startFadeOut(guiGameSpeed); /*cout << "Fade Out index2" << endl;*/
+					boardCardsArray[0]->startFadeOut(animationSpeed); /*cout << "Fade Out index2" << endl;*/
 				}
 				//index 3 testen
 				bool index3 = true;
@@ -2631,7 +2687,7 @@ void gameTableImpl::postRiverRunAnimation3()
 					}
 				}
 				if (index3) {
-					boardCardsArray[1]->startFadeOut(guiGameSpeed); /*cout << "Fade Out index3" << endl;*/
+					boardCardsArray[1]->startFadeOut(animationSpeed); /*cout << "Fade Out index3" << endl;*/
 				}
 				//index 4 testen
 				bool index4 = true;
@@ -2641,7 +2697,7 @@ void gameTableImpl::postRiverRunAnimation3()
 					}
 				}
 				if (index4) {
-					boardCardsArray[2]->startFadeOut(guiGameSpeed); /*cout << "Fade Out index4" << endl;*/
+					boardCardsArray[2]->startFadeOut(animationSpeed); /*cout << "Fade Out index4" << endl;*/
 				}
 				//index 5 testen
 				bool index5 = true;
@@ -2651,7 +2707,7 @@ void gameTableImpl::postRiverRunAnimation3()
 					}
 				}
 				if (index5) {
-					boardCardsArray[3]->startFadeOut(guiGameSpeed); /*cout << "Fade Out index5" << endl;*/
+					boardCardsArray[3]->startFadeOut(animationSpeed); /*cout << "Fade Out index5" << endl;*/
 				}
 				//index 6 testen
 				bool index6 = true;
@@ -2661,7 +2717,7 @@ void gameTableImpl::postRiverRunAnimation3()
 					}
 				}
 				if (index6) {
-					boardCardsArray[4]->startFadeOut(guiGameSpeed); /*cout << "Fade Out index6" << endl;*/
+					boardCardsArray[4]->startFadeOut(animationSpeed); /*cout << "Fade Out index6" << endl;*/
 				}
 			}
 			//Pot-Verteilung Loggen
@@ -2681,8 +2737,8 @@ void gameTableImpl::postRiverRunAnimation3()
 			  ) {
 
 				//aufgedeckte Gegner auch ausblenden
-				holeCardsArray[(*it_c)->getMyID()][0]->startFadeOut(guiGameSpeed);
-				holeCardsArray[(*it_c)->getMyID()][1]->startFadeOut(guiGameSpeed);
+				holeCardsArray[(*it_c)->getMyID()][0]->startFadeOut(animationSpeed);
+				holeCardsArray[(*it_c)->getMyID()][1]->startFadeOut(animationSpeed);
 			}
 		}
 	}
@@ -2842,9 +2898,9 @@ void gameTableImpl::showHoleCards(unsigned playerId, bool allIn)
 			for(j=0; j<2; j++) {
 
 				if(showFlipcardAnimation) { // with Eye-Candy
-					holeCardsArray[(*it_c)->getMyID()][j]->startFlipCards(guiGameSpeed, QPixmap::fromImage(QImage(myCardDeckStyle->getCurrentDir()+QString::number(tempCardsIntArray[j], 10)+".png")), flipside);
+					holeCardsArray[(*it_c)->getMyID()][j]->startFlipCards(animationSpeed, myCardDeckStyle->getCardPixmap(tempCardsIntArray[j]), flipside);
 				} else { //without Eye-Candy
-					tempCardsPixmapArray[j] = QPixmap::fromImage(QImage(myCardDeckStyle->getCurrentDir()+QString::number(tempCardsIntArray[j], 10)+".png"));
+					tempCardsPixmapArray[j] = myCardDeckStyle->getCardPixmap(tempCardsIntArray[j]);
 					holeCardsArray[(*it_c)->getMyID()][j]->setPixmap(tempCardsPixmapArray[j], false);
 				}
 			}
@@ -2930,7 +2986,7 @@ void gameTableImpl::nextRoundCleanGui()
 	int i,j;
 
 	// GUI bereinigen - Bilder löschen, Animationen unterbrechen
-	QPixmap onePix = QPixmap::fromImage(QImage(myAppDataPath +"gfx/gui/misc/1px.png"));
+	QPixmap onePix = myGameTableStyle->getOnePixPixmap();
 	for (i=0; i<5; i++ ) {
 		boardCardsArray[i]->setPixmap(onePix, false);
 		boardCardsArray[i]->setFadeOutAction(false);
@@ -3047,7 +3103,8 @@ void gameTableImpl::stopTimer()
 void gameTableImpl::setSpeeds()
 {
 
-	gameSpeed = (11-guiGameSpeed)*10;
+	animationSpeed = fastForward ? 11 : guiGameSpeed;
+	gameSpeed = (11-animationSpeed)*10;
 	dealCardsSpeed = (gameSpeed/2)*10; //milliseconds
 	preDealCardsSpeed = dealCardsSpeed*2; //Zeit for Karten aufdecken auf dem Board (Flop, Turn, River)
 	postDealCardsSpeed = dealCardsSpeed*3; //Zeit nach Karten aufdecken auf dem Board (Flop, Turn, River)
@@ -3061,6 +3118,18 @@ void gameTableImpl::setSpeeds()
 	preflopNextPlayerSpeed = gameSpeed*10; // Zeit bis zwischen Aufhellen und Aktion im Preflop (etwas langsamer da nicht gerechnet wird. )
 }
 
+void gameTableImpl::toggleFastForward()
+{
+	fastForward = !fastForward;
+	setSpeeds();
+
+#ifdef GUI_800x480
+	tabs.horizontalSlider_speed->setDisabled(fastForward);
+#else
+	horizontalSlider_speed->setDisabled(fastForward);
+#endif
+}
+
 void gameTableImpl::breakButtonClicked()
 {
 
@@ -3156,6 +3225,11 @@ void gameTableImpl::keyPressEvent ( QKeyEvent * event )
 	if (event->key() == Qt::Key_F5) {
 		pushButton_showMyCards->click();
 	}
+	if (event->key() == Qt::Key_F9) {
+		if(myStartWindow->getSession()->getGameType() == Session::GAME_TYPE_LOCAL) {
+			toggleFastForward();
+		}
+	}
 
 #ifndef GUI_800x480
 	if (event->key() == Qt::Key_F6) {
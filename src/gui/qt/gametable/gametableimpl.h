@@ -112,6 +112,17 @@ public:
 
 	void setSpeeds();
 
+	// refresh requests of the engine, painted at most once per frame
+	enum RefreshFlag {
+		REFRESH_SET = 0x01,
+		REFRESH_CASH = 0x02,
+		REFRESH_CHANGE_PLAYER = 0x04,
+		REFRESH_POT = 0x08,
+		REFRESH_ALL = 0x10,
+		REFRESH_PLAYER_NAME = 0x20,
+		REFRESH_BUTTON = 0x40
+	};
+
 #ifdef GUI_800x480
 	Ui::tabs tabs;
 	QDialog *tabsDiag;
@@ -196,6 +207,30 @@ public slots:
 	void refreshActionButtonFKeyIndicator(bool =0);
 	void setPlayerAvatar(int myID, QString myAvatar);
 
+	void scheduleRefresh(int flags);
+	void flushRefresh();
+	void scheduleRefreshSet() {
+		scheduleRefresh(REFRESH_SET);
+	}
+	void scheduleRefreshCash() {
+		scheduleRefresh(REFRESH_CASH);
+	}
+	void scheduleRefreshChangePlayer() {
+		scheduleRefresh(REFRESH_CHANGE_PLAYER);
+	}
+	void scheduleRefreshPot() {
+		scheduleRefresh(REFRESH_POT);
+	}
+	void scheduleRefreshAll() {
+		scheduleRefresh(REFRESH_ALL);
+	}
+	void scheduleRefreshPlayerName() {
+		scheduleRefresh(REFRESH_PLAYER_NAME);
+	}
+	void scheduleRefreshButton() {
+		scheduleRefresh(REFRESH_BUTTON);
+	}
+
 	SeatState getCurrentSeatState(boost::shared_ptr<PlayerInterface> );
 
 	void guiUpdateDone();
@@ -215,6 +250,7 @@ public slots:
 		guiGameSpeed = theValue;    // Achtung Faktor 10!!!
 		setSpeeds();
 	}
+	void toggleFastForward();
 
 	void callSettingsDialog();
 	void applySettings(settingsDialogImpl*);
@@ -426,6 +462,8 @@ private:
 	QTimer *voteOnKickTimeoutTimer;
 	boost::timers::portable::microsec_timer voteOnKickRealTimer;
 	QTimer *enableCallCheckPushButtonTimer;
+	QTimer *refreshFrameTimer;
+	int pendingRefreshFlags;
 
 	QWidget *userWidgetsArray[6];
 	QLabel *buttonLabelArray[MAX_NUMBER_OF_PLAYERS];
@@ -463,6 +501,8 @@ private:
 
 	//Speed
 	int guiGameSpeed;
+	bool fastForward; // local games only, runs every animation step at once
+	int animationSpeed;
 	int gameSpeed;
 	int dealCardsSpeed;
 	int preDealCardsSpeed;
@@ -39,7 +39,7 @@
 using namespace std;
 
 SDLPlayer::SDLPlayer(ConfigFile *c)
-	: sound(NULL), soundData(NULL), currentChannel(0), audioEnabled(false), myConfig(c)
+	: currentChannel(0), audioEnabled(false), myConfig(c)
 {
 	myAppDataPath = QString::fromUtf8(myConfig->readConfigString("AppDataDir").c_str());
 	SDL_Init(SDL_INIT_AUDIO);
@@ -60,11 +60,14 @@ void SDLPlayer::initAudio()
 		Uint16	audio_format = AUDIO_S16; /* 16-bit stereo */
 		int		audio_channels = 2;
 		int		audio_buffers = 4096;
-		sound = NULL;
 
 		if( Mix_OpenAudio(audio_rate, audio_format, audio_channels, audio_buffers) == 0) {
 			Mix_QuerySpec(&audio_rate, &audio_format, &audio_channels);
 			audioEnabled = 1;
+
+			// settings changes call reInit, so the volume is set only once
+			Mix_Volume(-1,myConfig->readConfigInt("SoundVolume")*10);
+			loadSoundBank();
 		} else {
 			qDebug() << "Mix_OpenAudio() was not successfull, no sound possible :(";
 		}
@@ -73,11 +76,11 @@ void SDLPlayer::initAudio()
 
 void SDLPlayer::playSound(string audioString, int playerID)
 {
-	if(audioEnabled && myConfig->readConfigInt("PlaySoundEffects")) {
+	if(audioEnabled) {
 
-		QFile myFile(myAppDataPath + "sounds/default/" + QString::fromStdString(audioString)+".wav");
+		map<string, Mix_Chunk *>::const_iterator pos = soundBank.find(audioString);
 
-		if(myFile.open(QIODevice::ReadOnly)) {
+		if(pos != soundBank.end()) {
 
 			//set 3d position for player
 			int position = 0;
@@ -127,32 +130,50 @@ void SDLPlayer::playSound(string audioString, int playerID)
 			break;
 			}
 
-			QDataStream in(&myFile);
-			soundData = new Uint8[(int)myFile.size()];
-			in.readRawData( (char*)soundData, (int)myFile.size() );
-			sound = Mix_QuickLoad_WAV(soundData);
-
-			// set channel 0 to settings volume
-			Mix_Volume(-1,myConfig->readConfigInt("SoundVolume")*10);
-
 			// set 3d effect
 			if(!Mix_SetPosition(0, position, distance)) {
 				printf("Mix_SetPosition: %s\n", Mix_GetError());
 				// no position effect, is it ok?
 			}
-			currentChannel = Mix_PlayChannel(-1, sound,0);
+			currentChannel = Mix_PlayChannel(-1, pos->second,0);
 		}
 	}
 }
 
+void SDLPlayer::loadSoundBank()
+{
+	QDir soundDir(myAppDataPath + "sounds/default/");
+	QStringList soundFiles = soundDir.entryList(QStringList() << "*.wav", QDir::Files);
+
+	foreach(QString fileName, soundFiles) {
+		QFile myFile(soundDir.filePath(fileName));
+		if(myFile.open(QIODevice::ReadOnly)) {
+			QByteArray wavData = myFile.readAll();
+			// decodes to the mixer format and copies, so wavData may be freed
+			Mix_Chunk *chunk = Mix_LoadWAV_RW(SDL_RWFromConstMem(wavData.constData(), wavData.size()), 1);
+			if(chunk) {
+				soundBank[QFileInfo(fileName).completeBaseName().toStdString()] = chunk;
+			} else {
+				qDebug() << "Mix_LoadWAV_RW() failed for" << fileName << ":" << Mix_GetError();
+			}
+		}
+	}
+}
+
+void SDLPlayer::freeSoundBank()
+{
+	map<string, Mix_Chunk *>::iterator i;
+	for(i = soundBank.begin(); i != soundBank.end(); ++i) {
+		Mix_FreeChunk(i->second);
+	}
+	soundBank.clear();
+}
+
 void SDLPlayer::closeAudio()
 {
 	if(audioEnabled) {
-		Mix_HaltChannel(currentChannel);
-		Mix_FreeChunk(sound);
-		sound = NULL;
-		delete[] soundData;
-		soundData = NULL;
+		Mix_HaltChannel(-1);
+		freeSoundBank();
 		Mix_CloseAudio();
 		qDebug() << "Mix_CloseAudio()";
 		audioEnabled = false;
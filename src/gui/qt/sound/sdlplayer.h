@@ -35,6 +35,7 @@
 
 #include "configfile.h"
 #include <string>
+#include <map>
 
 #ifdef __APPLE__
 #include <SDL_mixer.h>
@@ -60,8 +61,11 @@ public:
 	void reInit();
 
 private:
-	Mix_Chunk *sound;
-	unsigned char *soundData;
+	void loadSoundBank();
+	void freeSoundBank();
+
+	// all sound effects, decoded once by initAudio
+	std::map<std::string, Mix_Chunk *> soundBank;
 	int currentChannel;
 	bool audioEnabled;
 	ConfigFile *myConfig;
@@ -39,7 +39,7 @@
 
 using namespace std;
 
-CardDeckStyleReader::CardDeckStyleReader(ConfigFile *c, QWidget *w) : myConfig(c), myW(w), fallBack(0), loadedSuccessfull(0), myState(CD_STYLE_UNDEFINED)
+CardDeckStyleReader::CardDeckStyleReader(ConfigFile *c, QWidget *w) : myConfig(c), myW(w), fallBack(0), loadedSuccessfull(0), pixmapsLoaded(false), myState(CD_STYLE_UNDEFINED)
 {
 
 }
@@ -52,6 +52,7 @@ CardDeckStyleReader::~CardDeckStyleReader()
 void CardDeckStyleReader::readStyleFile(QString file)
 {
 	BigIndexesActionBottom = "";
+	pixmapsLoaded = false;
 
 #ifdef ANDROID
 	//on Android we use just the defaul style packed with the binary via qrc
@@ -173,6 +174,35 @@ void CardDeckStyleReader::readStyleFile(QString file)
 	}
 }
 
+void CardDeckStyleReader::loadPixmaps()
+{
+	int i;
+	for(i=0; i<52; i++) {
+		cardPixmaps[i] = QPixmap::fromImage(QImage(currentDir+QString::number(i, 10)+".png"));
+	}
+	flipsidePixmap = QPixmap::fromImage(QImage(currentDir+"flipside.png"));
+	pixmapsLoaded = true;
+}
+
+QPixmap CardDeckStyleReader::getCardPixmap(int card)
+{
+	if(!pixmapsLoaded) {
+		loadPixmaps();
+	}
+	if(card >= 0 && card < 52) {
+		return cardPixmaps[card];
+	}
+	return QPixmap();
+}
+
+QPixmap CardDeckStyleReader::getFlipsidePixmap()
+{
+	if(!pixmapsLoaded) {
+		loadPixmaps();
+	}
+	return flipsidePixmap;
+}
+
 
 void CardDeckStyleReader::showErrorMessage()
 {
@@ -95,6 +95,11 @@ public:
 		return myState;
 	}
 
+	// decode all card pictures of the current style once
+	void loadPixmaps();
+	QPixmap getCardPixmap(int card);
+	QPixmap getFlipsidePixmap();
+
 	QString getMyStateToolTipInfo();
 	void showErrorMessage();
 	void showLeftItemsErrorMessage();
@@ -118,6 +123,10 @@ private:
 	QStringList cardsLeft;
 	QStringList leftItems;
 
+	QPixmap cardPixmaps[52];
+	QPixmap flipsidePixmap;
+	bool pixmapsLoaded;
+
 	ConfigFile *myConfig;
 	QWidget *myW;
 
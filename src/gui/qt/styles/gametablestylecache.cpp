@@ -0,0 +1,255 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+#include "gametablestylecache.h"
+#include "gametablestylereader.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDataStream>
+#include <QMutexLocker>
+
+#define GT_STYLE_CACHE_FILE_NAME	"tablestyles.cache"
+#define GT_STYLE_CACHE_MAGIC		0x50544753
+#define GT_STYLE_CACHE_VERSION		((1 << 8) | POKERTH_GT_STYLE_FILE_VERSION)
+
+GameTableStyleCache &GameTableStyleCache::getInstance()
+{
+	static GameTableStyleCache inst;
+	return inst;
+}
+
+GameTableStyleCache::GameTableStyleCache()
+	: loaded(false), dirty(false), quit(false)
+{
+}
+
+GameTableStyleCache::~GameTableStyleCache()
+{
+	{
+		QMutexLocker lock(&mutex);
+		quit = true;
+	}
+	wait();
+	if (dirty) {
+		saveCacheFile();
+	}
+}
+
+bool GameTableStyleCache::lookup(const QString &cacheDir, const QString &fileName, GameTableStyleCacheEntry &entry)
+{
+	bool retVal = false;
+	bool startValidation = false;
+	QFileInfo info(fileName);
+	{
+		QMutexLocker lock(&mutex);
+		if (!loaded) {
+			cacheFileName = cacheDir + GT_STYLE_CACHE_FILE_NAME;
+			loadCacheFile();
+			loaded = true;
+			startValidation = !entries.isEmpty();
+		}
+		EntryMap::const_iterator i = entries.constFind(fileName);
+		if (i != entries.constEnd() && i.value().fileSize == info.size() && i.value().modified == info.lastModified().toTime_t()) {
+			entry = i.value();
+			retVal = true;
+		}
+	}
+	if (startValidation) {
+		start(QThread::LowestPriority);
+	}
+	return retVal;
+}
+
+void GameTableStyleCache::store(const QString &fileName, const GameTableStyleCacheEntry &entry)
+{
+	{
+		QMutexLocker lock(&mutex);
+		if (!loaded) {
+			return;
+		}
+		GameTableStyleCacheEntry &newEntry = entries[fileName];
+		newEntry = entry;
+		newEntry.validated = true;
+		dirty = true;
+	}
+	// Write the cache file in the background.
+	start(QThread::LowestPriority);
+}
+
+void GameTableStyleCache::run()
+{
+	for (;;) {
+		QStringList toValidate;
+		{
+			QMutexLocker lock(&mutex);
+			if (quit) {
+				return;
+			}
+			EntryMap::const_iterator i = entries.constBegin();
+			EntryMap::const_iterator end = entries.constEnd();
+			while (i != end) {
+				if (!i.value().validated) {
+					toValidate << i.key();
+				}
+				++i;
+			}
+			if (toValidate.isEmpty() && !dirty) {
+				return;
+			}
+		}
+		QStringListIterator k(toValidate);
+		while (k.hasNext()) {
+			QString fileName = k.next();
+			GameTableStyleCacheEntry entry;
+			{
+				QMutexLocker lock(&mutex);
+				if (quit) {
+					return;
+				}
+				EntryMap::const_iterator i = entries.constFind(fileName);
+				if (i == entries.constEnd()) {
+					continue;
+				}
+				entry = i.value();
+			}
+			bool valid = isStillValid(fileName, entry);
+			{
+				QMutexLocker lock(&mutex);
+				EntryMap::iterator i = entries.find(fileName);
+				// Skip entries which were replaced in the meantime.
+				if (i != entries.end() && i.value().modified == entry.modified && i.value().fileSize == entry.fileSize) {
+					if (valid) {
+						i.value().validated = true;
+					} else {
+						entries.erase(i);
+						dirty = true;
+					}
+				}
+			}
+		}
+		saveCacheFile();
+	}
+}
+
+void GameTableStyleCache::loadCacheFile()
+{
+	QFile file(cacheFileName);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return;
+	}
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_4_6);
+
+	quint32 magic = 0, version = 0, count = 0;
+	in >> magic >> version >> count;
+	if (magic != GT_STYLE_CACHE_MAGIC || version != GT_STYLE_CACHE_VERSION) {
+		return;
+	}
+	for (quint32 n = 0; n < count && in.status() == QDataStream::Ok; n++) {
+		QString fileName;
+		GameTableStyleCacheEntry entry;
+		quint32 modified = 0;
+		qint32 state = 0;
+		in >> fileName >> entry.fileSize >> modified >> state;
+		in >> entry.values >> entry.leftItems >> entry.itemPicsLeft >> entry.pictures;
+		entry.modified = modified;
+		entry.state = state;
+		entries.insert(fileName, entry);
+	}
+	if (in.status() != QDataStream::Ok) {
+		entries.clear();
+	}
+}
+
+void GameTableStyleCache::saveCacheFile()
+{
+	EntryMap tmpEntries;
+	QString tmpFileName;
+	{
+		QMutexLocker lock(&mutex);
+		if (!dirty || cacheFileName.isEmpty()) {
+			return;
+		}
+		tmpEntries = entries;
+		tmpFileName = cacheFileName;
+		dirty = false;
+	}
+
+	// Write to a temporary file first, the old cache stays usable until the rename.
+	QFile file(tmpFileName + ".tmp");
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		return;
+	}
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_4_6);
+	out << (quint32)GT_STYLE_CACHE_MAGIC << (quint32)GT_STYLE_CACHE_VERSION << (quint32)tmpEntries.size();
+
+	EntryMap::const_iterator i = tmpEntries.constBegin();
+	EntryMap::const_iterator end = tmpEntries.constEnd();
+	while (i != end) {
+		const GameTableStyleCacheEntry &entry = i.value();
+		out << i.key() << entry.fileSize << (quint32)entry.modified << (qint32)entry.state;
+		out << entry.values << entry.leftItems << entry.itemPicsLeft << entry.pictures;
+		++i;
+	}
+	file.close();
+
+	if (out.status() == QDataStream::Ok) {
+		QFile::remove(tmpFileName);
+		QFile::rename(tmpFileName + ".tmp", tmpFileName);
+	} else {
+		QFile::remove(tmpFileName + ".tmp");
+	}
+}
+
+bool GameTableStyleCache::isStillValid(const QString &fileName, const GameTableStyleCacheEntry &entry)
+{
+	QFileInfo info(fileName);
+	if (!info.exists() || info.size() != entry.fileSize || info.lastModified().toTime_t() != entry.modified) {
+		return false;
+	}
+	QStringListIterator i(entry.pictures);
+	while (i.hasNext()) {
+		if (!QFile::exists(i.next())) {
+			return false;
+		}
+	}
+	// Pictures which were missing should still be missing.
+	QStringListIterator j(entry.itemPicsLeft);
+	while (j.hasNext()) {
+		QString item = j.next();
+		int pos = item.indexOf(" = ");
+		if (pos >= 0 && QFile::exists(item.mid(pos + 3))) {
+			return false;
+		}
+	}
+	return true;
+}
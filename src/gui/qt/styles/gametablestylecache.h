@@ -0,0 +1,86 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+#ifndef GAMETABLESTYLECACHE_H
+#define GAMETABLESTYLECACHE_H
+
+#include <QThread>
+#include <QMutex>
+#include <QHash>
+#include <QStringList>
+
+struct GameTableStyleCacheEntry {
+	GameTableStyleCacheEntry() : fileSize(0), modified(0), state(0), validated(false) {}
+	qint64 fileSize;
+	uint modified;
+	QStringList values;
+	QStringList leftItems;
+	QStringList itemPicsLeft;
+	QStringList pictures;
+	int state;
+	bool validated;
+};
+
+// Parsed game table styles, stored in a binary file in the cache dir.
+// Entries are keyed by style file name, size and modification time.
+// The file is loaded on first use, the picture files of the cached styles
+// are checked again in a background thread and stale entries are dropped.
+class GameTableStyleCache : public QThread
+{
+	Q_OBJECT
+
+public:
+	static GameTableStyleCache &getInstance();
+	~GameTableStyleCache();
+
+	bool lookup(const QString &cacheDir, const QString &fileName, GameTableStyleCacheEntry &entry);
+	void store(const QString &fileName, const GameTableStyleCacheEntry &entry);
+
+protected:
+	GameTableStyleCache();
+
+	void run();
+
+	void loadCacheFile();
+	void saveCacheFile();
+	static bool isStillValid(const QString &fileName, const GameTableStyleCacheEntry &entry);
+
+private:
+	typedef QHash<QString, GameTableStyleCacheEntry> EntryMap;
+
+	QMutex mutex;
+	EntryMap entries;
+	QString cacheFileName;
+	bool loaded;
+	bool dirty;
+	bool quit;
+};
+
+#endif // GAMETABLESTYLECACHE_H
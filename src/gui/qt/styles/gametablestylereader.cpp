@@ -29,6 +29,7 @@
  * as that of the covered work.                                              *
  *****************************************************************************/
 #include "gametablestylereader.h"
+#include "gametablestylecache.h"
 #include <cstdlib>
 
 using namespace std;
@@ -112,6 +113,8 @@ GameTableStyleReader::~GameTableStyleReader()
 
 void GameTableStyleReader::readStyleFile(QString file)
 {
+	pixmapCache.clear();
+
 #ifdef ANDROID
 	//on Android we currently just use the defaul style packed with the binary via qrc
 	currentFileName = ":/android/android-data/gfx/gui/table/default_800x480/android_tablestyle_800x480.xml";
@@ -129,6 +132,23 @@ void GameTableStyleReader::readStyleFile(QString file)
 	currentDir = info.absolutePath()+"/";
 #endif
 
+	//use the parsed style from the cache if the file did not change
+	QList<QString *> styleFields;
+	getStyleFields(styleFields);
+	QString cacheDir(QString::fromUtf8(myConfig->readConfigString("CacheDir").c_str()));
+	bool useCache = !currentFileName.startsWith(":") && !cacheDir.isEmpty();
+	GameTableStyleCacheEntry cacheEntry;
+	if(useCache && GameTableStyleCache::getInstance().lookup(cacheDir, currentFileName, cacheEntry) && cacheEntry.values.size() == styleFields.size()) {
+		for(int i=0; i<styleFields.size(); i++) {
+			*styleFields[i] = cacheEntry.values.at(i);
+		}
+		leftItems = cacheEntry.leftItems;
+		itemPicsLeft = cacheEntry.itemPicsLeft;
+		myState = (GtStyleState)cacheEntry.state;
+		loadedSuccessfull = 1;
+		return;
+	}
+
 	QFile myFile(currentFileName);
 	myFile.open(QIODevice::ReadOnly);
 	fileContent = myFile.readAll();
@@ -1265,6 +1285,25 @@ void GameTableStyleReader::readStyleFile(QString file)
 				//                qDebug() << "myState of: " << StyleDescription << "is now: " << myState;
 			}
 			loadedSuccessfull = 1;
+
+			if(useCache && myW != 0) {
+				QFileInfo styleInfo(currentFileName);
+				cacheEntry.fileSize = styleInfo.size();
+				cacheEntry.modified = styleInfo.lastModified().toTime_t();
+				cacheEntry.values.clear();
+				cacheEntry.pictures.clear();
+				for(int i=0; i<styleFields.size(); i++) {
+					const QString &value = *styleFields[i];
+					cacheEntry.values << value;
+					if(!value.endsWith("NULL") && QFileInfo(value).isAbsolute() && QFile(value).exists()) {
+						cacheEntry.pictures << value;
+					}
+				}
+				cacheEntry.leftItems = leftItems;
+				cacheEntry.itemPicsLeft = itemPicsLeft;
+				cacheEntry.state = myState;
+				GameTableStyleCache::getInstance().store(currentFileName, cacheEntry);
+			}
 		}
 	} else {
 		loadedSuccessfull = 0;
@@ -1274,6 +1313,138 @@ void GameTableStyleReader::readStyleFile(QString file)
 	}
 }
 
+void GameTableStyleReader::getStyleFields(QList<QString *> &fields)
+{
+	//order of the values in the style cache
+	fields << &StyleDescription;
+	fields << &StyleMaintainerName;
+	fields << &StyleMaintainerEMail;
+	fields << &StyleCreateDate;
+	fields << &PokerTHStyleFileVersion;
+	fields << &IfFixedWindowSize;
+	fields << &FixedWindowWidth;
+	fields << &FixedWindowHeight;
+	fields << &MinimumWindowWidth;
+	fields << &MinimumWindowHeight;
+	fields << &MaximumWindowWidth;
+	fields << &MaximumWindowHeight;
+	fields << &Preview;
+	fields << &ActionAllInI18NPic;
+	fields << &ActionRaiseI18NPic;
+	fields << &ActionBetI18NPic;
+	fields << &ActionCallI18NPic;
+	fields << &ActionCheckI18NPic;
+	fields << &ActionFoldI18NPic;
+	fields << &ActionWinnerI18NPic;
+	fields << &BigBlindPuck;
+	fields << &SmallBlindPuck;
+	fields << &DealerPuck;
+	fields << &DefaultAvatar;
+	fields << &CardHolderFlop;
+	fields << &CardHolderTurn;
+	fields << &CardHolderRiver;
+	fields << &FoldButtonDefault;
+	fields << &FoldButtonHover;
+	fields << &FoldButtonChecked;
+	fields << &FoldButtonCheckedHover;
+	fields << &CheckCallButtonDefault;
+	fields << &CheckCallButtonHover;
+	fields << &CheckCallButtonChecked;
+	fields << &CheckCallButtonCheckedHover;
+	fields << &BetRaiseButtonDefault;
+	fields << &BetRaiseButtonHover;
+	fields << &BetRaiseButtonChecked;
+	fields << &BetRaiseButtonCheckedHover;
+	fields << &AllInButtonDefault;
+	fields << &AllInButtonHover;
+	fields << &AllInButtonChecked;
+	fields << &AllInButtonCheckedHover;
+	fields << &RadioButtonPressed;
+	fields << &RadioButtonChecked;
+	fields << &RadioButtonCheckedHover;
+	fields << &RadioButtonUnchecked;
+	fields << &RadioButtonUncheckedHover;
+	fields << &PlayerTopSeatInactive;
+	fields << &PlayerTopSeatActive;
+	fields << &PlayerBottomSeatInactive;
+	fields << &PlayerBottomSeatActive;
+	fields << &Table;
+	fields << &HandRanking;
+	fields << &ToolBoxBackground;
+	fields << &ShowMyCardsButtonDefault;
+	fields << &ShowMyCardsButtonHover;
+	fields << &ActionAllInI18NString;
+	fields << &ActionRaiseI18NString;
+	fields << &ActionBetI18NString;
+	fields << &ActionCallI18NString;
+	fields << &ActionCheckI18NString;
+	fields << &ActionFoldI18NString;
+	fields << &PotI18NString;
+	fields << &TotalI18NString;
+	fields << &BetsI18NString;
+	fields << &GameI18NString;
+	fields << &HandI18NString;
+	fields << &PreflopI18NString;
+	fields << &FlopI18NString;
+	fields << &TurnI18NString;
+	fields << &RiverI18NString;
+	fields << &FKeyIndicatorColor;
+	fields << &ChanceLabelPossibleColor;
+	fields << &ChanceLabelImpossibleColor;
+	fields << &ChatTextNickNotifyColor;
+	fields << &ChatLogTextColor;
+	fields << &ChatLogBgColor;
+	fields << &ChatLogScrollBarBorderColor;
+	fields << &ChatLogScrollBarBgColor;
+	fields << &ChatLogScrollBarHandleBorderColor;
+	fields << &ChatLogScrollBarHandleBgColor;
+	fields << &ChatLogScrollBarArrowBorderColor;
+	fields << &ChatLogScrollBarArrowBgColor;
+	fields << &LogWinnerMainPotColor;
+	fields << &LogWinnerSidePotColor;
+	fields << &LogPlayerSitsOutColor;
+	fields << &LogNewGameAdminColor;
+	fields << &TabWidgetBorderColor;
+	fields << &TabWidgetBgColor;
+	fields << &TabWidgetTextColor;
+	fields << &MenuBgColor;
+	fields << &MenuTextColor;
+	fields << &BreakLobbyButtonBgColor;
+	fields << &BreakLobbyButtonTextColor;
+	fields << &BreakLobbyButtonBgDisabledColor;
+	fields << &BreakLobbyButtonTextDisabledColor;
+	fields << &BreakLobbyButtonBgBlinkColor;
+	fields << &BreakLobbyButtonTextBlinkColor;
+	fields << &PlayerCashTextColor;
+	fields << &PlayerBetTextColor;
+	fields << &PlayerNickTextColor;
+	fields << &BoardBigTextColor;
+	fields << &BoardSmallTextColor;
+	fields << &SpeedTextColor;
+	fields << &VoteButtonBgColor;
+	fields << &VoteButtonTextColor;
+	fields << &BetInputTextColor;
+	fields << &BetInputBgColor;
+	fields << &BetInputDisabledTextColor;
+	fields << &BetInputDisabledBgColor;
+	fields << &FoldButtonTextColor;
+	fields << &FoldButtonCheckableTextColor;
+	fields << &CheckCallButtonTextColor;
+	fields << &CheckCallButtonCheckableTextColor;
+	fields << &BetRaiseButtonTextColor;
+	fields << &BetRaiseButtonCheckableTextColor;
+	fields << &AllInButtonTextColor;
+	fields << &AllInButtonCheckableTextColor;
+	fields << &BetSpeedSliderGrooveBgColor;
+	fields << &BetSpeedSliderGrooveBorderColor;
+	fields << &BetSpeedSliderHandleBgColor;
+	fields << &BetSpeedSliderHandleBorderColor;
+	fields << &ShowMyCardsButtonTextColor;
+	fields << &RatingStarsColor;
+	fields << &PlayerInfoHintTextColor;
+	fields << &ChatLogTextSize;
+}
+
 void GameTableStyleReader::showErrorMessage()
 {
 	switch (myState) {
@@ -1550,6 +1721,36 @@ QString GameTableStyleReader::getActionPic(int action)
 	return QString("");
 }
 
+void GameTableStyleReader::loadPixmaps()
+{
+	getPixmap(DealerPuck);
+	getPixmap(SmallBlindPuck);
+	getPixmap(BigBlindPuck);
+	getPixmap(DefaultAvatar);
+	getOnePixPixmap();
+
+	int i;
+	for(i=1; i<=7; i++) {
+		getPixmap(getActionPic(i));
+	}
+}
+
+QPixmap GameTableStyleReader::getPixmap(const QString &fileName)
+{
+	QHash<QString, QPixmap>::const_iterator i = pixmapCache.constFind(fileName);
+	if(i != pixmapCache.constEnd()) {
+		return i.value();
+	}
+	QPixmap pix = QPixmap::fromImage(QImage(fileName));
+	pixmapCache.insert(fileName, pix);
+	return pix;
+}
+
+QPixmap GameTableStyleReader::getOnePixPixmap()
+{
+	return getPixmap(QString::fromUtf8(myConfig->readConfigString("AppDataDir").c_str())+"gfx/gui/misc/1px.png");
+}
+
 void GameTableStyleReader::setButtonsStyle(MyActionButton *br, MyActionButton *cc, MyActionButton *f, MyActionButton *a, int state)
 {
 	br->setMyStyle(this);
@@ -106,6 +106,11 @@ public:
 
 	QString getActionPic(int);
 
+	// decoded table pictures of the current style, keyed by file name
+	void loadPixmaps();
+	QPixmap getPixmap(const QString &fileName);
+	QPixmap getOnePixPixmap();
+
 	QString getFKeyIndicatorColor() const {
 		return FKeyIndicatorColor;
 	}
@@ -281,6 +286,8 @@ public:
 	QString getMyStateToolTipInfo();
 
 private:
+	void getStyleFields(QList<QString *> &fields);
+
 	//style values
 	// 	INFOS
 	QString StyleDescription;
@@ -441,6 +448,8 @@ private:
 	QStringList leftItems;
 	QStringList itemPicsLeft;
 
+	QHash<QString, QPixmap> pixmapCache;
+
 	ConfigFile *myConfig;
 	QWidget *myW;
 
@@ -87,10 +87,13 @@ public:
 	virtual void AsyncSendNextPacket(boost::shared_ptr<SessionData> session);
 	void AsyncSendNextPacket(boost::shared_ptr<boost::asio::ip::tcp::socket> socket);
 	virtual void InternalStorePacket(boost::shared_ptr<SessionData> session, boost::shared_ptr<NetPacket> packet);
+	virtual void InternalStoreEncoded(boost::shared_ptr<SessionData> session, const std::string &msgData);
 	int EncodeToBuf(const void *data, size_t size);
 
 	virtual void HandleWrite(boost::shared_ptr<boost::asio::ip::tcp::socket> socket, const boost::system::error_code &error);
 
+	virtual size_t GetQueuedBytes() const;
+
 private:
 	char *sendBuf;
 	char *curWriteBuf;
@@ -37,7 +37,10 @@
 #include <boost/asio.hpp>
 #include <boost/asio/steady_timer.hpp>
 #include <boost/enable_shared_from_this.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
 #include <string>
+#include <vector>
 #include <algorithm>
 #include <numeric>
 
@@ -176,6 +179,9 @@ protected:
 	typedef std::map<unsigned, GameInfo> GameInfoMap;
 	typedef std::list<boost::shared_ptr<NetPacket> > NetPacketList;
 	typedef std::map<unsigned, PlayerInfo> PlayerInfoMap;
+	typedef boost::unordered_map<std::string, unsigned> PlayerNameIndex;
+	typedef std::vector<std::pair<unsigned, PlayerInfo> > PlayerInfoList;
+	typedef boost::unordered_set<unsigned> PlayerIdSet;
 	typedef std::map<unsigned, boost::shared_ptr<AvatarFile> > AvatarFileMap;
 	typedef std::map<unsigned, ServerInfo> ServerInfoMap;
 	struct LoginData {
@@ -201,6 +207,12 @@ protected:
 	void RequestPlayerInfo(unsigned id, bool requestAvatar = false);
 	void RequestPlayerInfo(const std::list<unsigned> &idList, bool requestAvatar = false);
 	void SetPlayerInfo(unsigned id, const PlayerInfo &info);
+	void SetPlayerInfoList(const PlayerInfoList &infoList);
+	void QueuePlayerInfo(unsigned id, const PlayerInfo &info);
+	void FlushPlayerInfo();
+	void InternalSetPlayerInfo(unsigned id, const PlayerInfo &info);
+	void InternalRemovePlayerName(unsigned id, const std::string &playerName);
+	void InternalPlayerInfoChanged(unsigned id, const PlayerInfo &info);
 	void SetUnknownPlayer(unsigned id);
 	void SetNewGameAdmin(unsigned id);
 	void RetrieveAvatarIfNeeded(unsigned id, const PlayerInfo &info);
@@ -322,10 +334,12 @@ private:
 	boost::shared_ptr<QtToolsInterface> myQtToolsInterface;
 
 	PlayerInfoMap m_playerInfoMap;
+	PlayerNameIndex m_playerNameIndex;
 	mutable boost::mutex m_playerInfoMapMutex;
-	PlayerIdList m_playerInfoRequestList;
-	PlayerIdList m_avatarShouldRequestList;
-	PlayerIdList m_avatarHasRequestedList;
+	PlayerInfoList m_pendingPlayerInfoList;
+	PlayerIdSet m_playerInfoRequestList;
+	PlayerIdSet m_avatarShouldRequestList;
+	PlayerIdSet m_avatarHasRequestedList;
 
 	unsigned m_curGameId;
 	mutable boost::mutex m_curGameIdMutex;
@@ -34,6 +34,7 @@
 
 #include <net/asioreceivebuffer.h>
 #include <net/sessiondata.h>
+#include <net/servermetrics.h>
 #include <core/loghelper.h>
 #include <boost/swap.hpp>
 
@@ -65,6 +66,7 @@ AsioReceiveBuffer::HandleRead(boost::shared_ptr<SessionData> session, const boos
 		try {
 			if (!error) {
 				recvBufUsed += bytesRead;
+				ServerMetrics::AddCounter(METRIC_BYTES_IN, bytesRead);
 				ScanPackets(session);
 				ProcessPackets(session);
 				StartAsyncRead(session);
@@ -35,6 +35,7 @@
 #include <net/asiosendbuffer.h>
 #include <net/sessiondata.h>
 #include <net/netpacket.h>
+#include <net/servermetrics.h>
 #include <boost/swap.hpp>
 
 using namespace std;
@@ -98,6 +99,12 @@ AsioSendBuffer::AsyncSendNextPacket(boost::shared_ptr<boost::asio::ip::tcp::sock
 	}
 }
 
+size_t
+AsioSendBuffer::GetQueuedBytes() const
+{
+	return sendBufUsed + curWriteBufUsed;
+}
+
 void
 AsioSendBuffer::InternalStorePacket(boost::shared_ptr<SessionData> /*session*/, boost::shared_ptr<NetPacket> packet)
 {
@@ -107,6 +114,23 @@ AsioSendBuffer::InternalStorePacket(boost::shared_ptr<SessionData> /*session*/,
 	packet->GetMsg()->SerializeWithCachedSizesToArray(&buf[NET_HEADER_SIZE]);
 	EncodeToBuf(buf, packetSize + NET_HEADER_SIZE);
 	delete[] buf;
+	ServerMetrics::AddCounter(METRIC_BYTES_OUT, packetSize + NET_HEADER_SIZE);
+}
+
+void
+AsioSendBuffer::InternalStoreEncoded(boost::shared_ptr<SessionData> /*session*/, const std::string &msgData)
+{
+	uint32_t packetSize = (uint32_t)msgData.size();
+	// Header and data are stored together or not at all.
+	while (GetSendBufLeft() < packetSize + NET_HEADER_SIZE) {
+		if (!ReallocSendBuf()) {
+			return;
+		}
+	}
+	uint32_t header = htonl(packetSize);
+	AppendToSendBufWithoutCheck((const char *)&header, NET_HEADER_SIZE);
+	AppendToSendBufWithoutCheck(msgData.data(), packetSize);
+	ServerMetrics::AddCounter(METRIC_BYTES_OUT, packetSize + NET_HEADER_SIZE);
 }
 
 int
@@ -584,7 +584,7 @@ AbstractClientStateReceiving::HandleLobbyMsg(boost::shared_ptr<ClientThread> cli
 				memcpy(tmpInfo.avatar.GetData(), netInfo.avatardata().avatarhash().data(), MD5_DATA_SIZE);
 				tmpInfo.avatarType = static_cast<AvatarFileType>(netInfo.avatardata().avatartype());
 			}
-			client->SetPlayerInfo(
+			client->QueuePlayerInfo(
 				playerId,
 				tmpInfo);
 		} else {
@@ -56,7 +56,6 @@
 #include <cassert>
 #include <gsasl.h>
 
-#define TEMP_AVATAR_FILENAME	"avatar.tmp"
 #define TEMP_GUID_FILENAME		"guid.tmp"
 #define CLIENT_GUID_SIZE		16
 #define CLIENT_AVATAR_LOOP_MSEC	100
@@ -72,6 +71,12 @@ using namespace std::chrono;
 using namespace boost::chrono;
 #endif
 
+static bool
+IsComputerPlayerName(const string &playerName)
+{
+	return playerName.compare(0, sizeof(SERVER_COMPUTER_PLAYER_NAME) - 1, SERVER_COMPUTER_PLAYER_NAME) == 0;
+}
+
 ClientThread::ClientThread(GuiInterface &gui, AvatarManager &avatarManager, Log *myLog)
 	: m_ioService(new boost::asio::io_service), m_clientLog(myLog), m_curState(NULL), m_gui(gui),
 	  m_avatarManager(avatarManager), m_isServerSelected(false),
@@ -484,6 +489,11 @@ ClientThread::CloseSession(boost::shared_ptr<SessionData> /*session*/)
 void
 ClientThread::HandlePacket(boost::shared_ptr<SessionData> /*session*/, boost::shared_ptr<NetPacket> packet)
 {
+	// Queued player info needs to be available for all other messages.
+	if (packet->GetMsg()->messagetype() != PokerTHMessage::Type_LobbyMessage
+			|| packet->GetMsg()->lobbymessage().messagetype() != LobbyMessage::Type_PlayerInfoReplyMessage) {
+		FlushPlayerInfo();
+	}
 	switch (packet->GetMsg()->messagetype()) {
 	case PokerTHMessage::Type_AnnounceMessage :
 		GetState().HandleAnnounceMsg(shared_from_this(), packet->GetMsg()->announcemessage());
@@ -560,16 +570,10 @@ ClientThread::GetPlayerIdFromName(const string &playerName, unsigned &playerId)
 	bool retVal = false;
 
 	boost::mutex::scoped_lock lock(m_playerInfoMapMutex);
-	PlayerInfoMap::const_reverse_iterator i = m_playerInfoMap.rbegin();
-	PlayerInfoMap::const_reverse_iterator end = m_playerInfoMap.rend();
-
-	while (i != end) {
-		if (i->second.playerName == playerName) {
-			playerId = i->first;
-			retVal = true;
-			break;
-		}
-		++i;
+	PlayerNameIndex::const_iterator pos = m_playerNameIndex.find(playerName);
+	if (pos != m_playerNameIndex.end()) {
+		playerId = pos->second;
+		retVal = true;
 	}
 	return retVal;
 }
@@ -632,7 +636,8 @@ ClientThread::Main()
 	try {
 		InitAuthContext();
 		// Start sub-threads.
-		m_avatarDownloader.reset(new DownloaderThread);
+		m_avatarDownloader.reset(new DownloaderThread(
+			DOWNLOADER_MAX_TRANSFERS, DOWNLOADER_MAX_HOST_CONNECTIONS, MAX_AVATAR_FILE_SIZE));
 		m_avatarDownloader->Run();
 		SetState(CLIENT_INITIAL_STATE::Instance());
 		RegisterTimers();
@@ -780,13 +785,12 @@ ClientThread::RequestPlayerInfo(const list<unsigned> &idList, bool requestAvatar
 	netLobby->set_messagetype(LobbyMessage::Type_PlayerInfoRequestMessage);
 	PlayerInfoRequestMessage *netPlayerInfo = netLobby->mutable_playerinforequestmessage();
 	BOOST_FOREACH(unsigned playerId, idList) {
-		if (find(m_playerInfoRequestList.begin(), m_playerInfoRequestList.end(), playerId) == m_playerInfoRequestList.end()) {
+		if (m_playerInfoRequestList.insert(playerId).second) {
 			netPlayerInfo->add_playerid(playerId);
-			m_playerInfoRequestList.push_back(playerId);
 		}
 		// Remember that we have to request an avatar.
 		if (requestAvatar) {
-			m_avatarShouldRequestList.push_back(playerId);
+			m_avatarShouldRequestList.insert(playerId);
 		}
 	}
 	if (netPlayerInfo->playerid_size() > 0) {
@@ -799,25 +803,107 @@ ClientThread::SetPlayerInfo(unsigned id, const PlayerInfo &info)
 {
 	{
 		boost::mutex::scoped_lock lock(m_playerInfoMapMutex);
+		InternalSetPlayerInfo(id, info);
+	}
+	InternalPlayerInfoChanged(id, info);
+}
+
+void
+ClientThread::SetPlayerInfoList(const PlayerInfoList &infoList)
+{
+	{
+		// Insert everything with a single lock, e.g. for the initial lobby player list.
+		boost::mutex::scoped_lock lock(m_playerInfoMapMutex);
+		m_playerNameIndex.reserve(m_playerNameIndex.size() + infoList.size());
+		PlayerInfoList::const_iterator i = infoList.begin();
+		PlayerInfoList::const_iterator end = infoList.end();
+		while (i != end) {
+			InternalSetPlayerInfo(i->first, i->second);
+			++i;
+		}
+	}
+	PlayerInfoList::const_iterator i = infoList.begin();
+	PlayerInfoList::const_iterator end = infoList.end();
+	while (i != end) {
+		InternalPlayerInfoChanged(i->first, i->second);
+		++i;
+	}
+}
+
+void
+ClientThread::QueuePlayerInfo(unsigned id, const PlayerInfo &info)
+{
+	// Player info replies usually arrive in bursts, collect them and
+	// insert them after the received packets have been processed.
+	if (m_pendingPlayerInfoList.empty()) {
+		m_ioService->post(boost::bind(&ClientThread::FlushPlayerInfo, shared_from_this()));
+	}
+	m_pendingPlayerInfoList.push_back(make_pair(id, info));
+}
+
+void
+ClientThread::FlushPlayerInfo()
+{
+	if (!m_pendingPlayerInfoList.empty()) {
+		PlayerInfoList tmpList;
+		tmpList.swap(m_pendingPlayerInfoList);
+		SetPlayerInfoList(tmpList);
+	}
+}
+
+void
+ClientThread::InternalSetPlayerInfo(unsigned id, const PlayerInfo &info)
+{
+	// Needs to be called with m_playerInfoMapMutex locked.
+	PlayerInfoMap::iterator pos = m_playerInfoMap.find(id);
+	if (pos != m_playerInfoMap.end() && pos->second.playerName != info.playerName) {
+		InternalRemovePlayerName(id, pos->second.playerName);
+	}
+	PlayerNameIndex::iterator namePos = m_playerNameIndex.find(info.playerName);
+	if (namePos != m_playerNameIndex.end() && namePos->second != id) {
 		// Remove previous player entry with different id
 		// for the same player name if it exists.
 		// This can only be one entry, since every time a duplicate
 		// name is added one is removed.
 		// Only erase non computer player entries.
-		if (info.playerName.substr(0, sizeof(SERVER_COMPUTER_PLAYER_NAME) - 1) != SERVER_COMPUTER_PLAYER_NAME) {
-			PlayerInfoMap::iterator i = m_playerInfoMap.begin();
-			PlayerInfoMap::iterator end = m_playerInfoMap.end();
+		if (!IsComputerPlayerName(info.playerName)) {
+			m_playerInfoMap.erase(namePos->second);
+			namePos->second = id;
+		} else if (namePos->second < id) {
+			// Computer players may share a name, the highest id is found first.
+			namePos->second = id;
+		}
+	} else if (namePos == m_playerNameIndex.end()) {
+		m_playerNameIndex[info.playerName] = id;
+	}
+	m_playerInfoMap[id] = info;
+}
+
+void
+ClientThread::InternalRemovePlayerName(unsigned id, const string &playerName)
+{
+	// Needs to be called with m_playerInfoMapMutex locked.
+	PlayerNameIndex::iterator namePos = m_playerNameIndex.find(playerName);
+	if (namePos != m_playerNameIndex.end() && namePos->second == id) {
+		m_playerNameIndex.erase(namePos);
+		if (IsComputerPlayerName(playerName)) {
+			// Another computer player may still use this name.
+			PlayerInfoMap::const_reverse_iterator i = m_playerInfoMap.rbegin();
+			PlayerInfoMap::const_reverse_iterator end = m_playerInfoMap.rend();
 			while (i != end) {
-				if (i->first != id && i->second.playerName == info.playerName) {
-					m_playerInfoMap.erase(i);
+				if (i->first != id && i->second.playerName == playerName) {
+					m_playerNameIndex[playerName] = i->first;
 					break;
 				}
 				++i;
 			}
 		}
-		m_playerInfoMap[id] = info;
 	}
+}
 
+void
+ClientThread::InternalPlayerInfoChanged(unsigned id, const PlayerInfo &info)
+{
 	// Update player data for current game.
 	boost::shared_ptr<PlayerData> playerData(GetPlayerDataByUniqueId(id));
 	if (playerData) {
@@ -837,14 +923,13 @@ ClientThread::SetPlayerInfo(unsigned id, const PlayerInfo &info)
 		// Skip avatar here, the game is already running.
 	}
 
-	if (find(m_avatarShouldRequestList.begin(), m_avatarShouldRequestList.end(), id) != m_avatarShouldRequestList.end()) {
-		m_avatarShouldRequestList.remove(id);
+	if (m_avatarShouldRequestList.erase(id)) {
 		// Retrieve avatar if needed.
 		RetrieveAvatarIfNeeded(id, info);
 	}
 
 	// Remove it from the request list.
-	m_playerInfoRequestList.remove(id);
+	m_playerInfoRequestList.erase(id);
 
 	// Notify GUI
 	GetCallback().SignalNetClientPlayerChanged(id, info.playerName);
@@ -855,8 +940,8 @@ void
 ClientThread::SetUnknownPlayer(unsigned id)
 {
 	// Just remove it from the request list.
-	m_playerInfoRequestList.remove(id);
-	m_avatarShouldRequestList.remove(id);
+	m_playerInfoRequestList.erase(id);
+	m_avatarShouldRequestList.erase(id);
 	LOG_ERROR("Server reported unknown player id: " << id);
 }
 
@@ -877,16 +962,16 @@ ClientThread::SetNewGameAdmin(unsigned id)
 void
 ClientThread::RetrieveAvatarIfNeeded(unsigned id, const PlayerInfo &info)
 {
-	if (find(m_avatarHasRequestedList.begin(), m_avatarHasRequestedList.end(), id) == m_avatarHasRequestedList.end()) {
+	if (m_avatarHasRequestedList.find(id) == m_avatarHasRequestedList.end()) {
 		if (info.hasAvatar && !info.avatar.IsZero() && !GetAvatarManager().HasAvatar(info.avatar)) {
-			m_avatarHasRequestedList.push_back(id); // Never remove from this list. Only request once.
+			m_avatarHasRequestedList.insert(id); // Never remove from this list. Only request once.
 
 			// Download from avatar server if applicable.
 			string avatarServerAddress(GetContext().GetAvatarServerAddr());
 			if (!avatarServerAddress.empty() && m_avatarDownloader) {
 				string serverFileName(info.avatar.ToString() + AvatarManager::GetAvatarFileExtension(info.avatarType));
 				m_avatarDownloader->QueueDownload(
-					id, avatarServerAddress + serverFileName, GetContext().GetCacheDir() + TEMP_AVATAR_FILENAME);
+					id, avatarServerAddress + serverFileName);
 			} else {
 				boost::shared_ptr<NetPacket> packet(new NetPacket);
 				packet->GetMsg()->set_messagetype(PokerTHMessage::Type_LobbyMessage);
@@ -987,7 +1072,8 @@ void
 ClientThread::TimerCheckAvatarDownloads(const boost::system::error_code& ec)
 {
 	if (!ec) {
-		if (m_avatarDownloader && m_avatarDownloader->HasDownloadResult()) {
+		// Several downloads may finish at once, pass all of them.
+		while (m_avatarDownloader && m_avatarDownloader->HasDownloadResult()) {
 			unsigned playerId;
 			boost::shared_ptr<AvatarFile> tmpAvatar(new AvatarFile);
 			m_avatarDownloader->GetDownloadResult(playerId, tmpAvatar->fileData);
@@ -29,36 +29,76 @@
  * as that of the covered work.                                              *
  *****************************************************************************/
 
+#include <net/socket_helper.h>
 #include <net/downloaderthread.h>
-#include <net/downloadhelper.h>
 #include <net/netexception.h>
-#include <boost/filesystem.hpp>
+#include <net/socket_msg.h>
 #include <core/loghelper.h>
 
-#include <fstream>
-#include <algorithm>
+#include <curl/curl.h>
+#include <deque>
+#include <map>
 
-#define DOWNLOAD_DELAY_MSEC					20
+#define DOWNLOAD_IDLE_DELAY_MSEC			20
+#define DOWNLOAD_SELECT_TIMEOUT_MSEC		50
 
 using namespace std;
-using namespace boost::filesystem;
 
 
-DownloaderThread::DownloaderThread()
-	: m_downloadInProgress(false)
+struct ActiveDownload {
+	ActiveDownload(const string &u, size_t m) : url(u), curlHandle(NULL), maxSize(m) {}
+
+	// Curl needs the url string as long as the transfer runs.
+	string url;
+	CURL *curlHandle;
+	size_t maxSize;
+	vector<unsigned char> data;
+	// Every request for this url.
+	vector<unsigned> idList;
+};
+
+typedef map<string, boost::shared_ptr<ActiveDownload> > ActiveDownloadMap;
+typedef deque<boost::shared_ptr<ActiveDownload> > ActiveDownloadList;
+
+struct DownloaderData {
+	DownloaderData() : curlMultiHandle(NULL), numRunning(0) {}
+
+	CURLM *curlMultiHandle;
+	// Waiting and running downloads by url.
+	ActiveDownloadMap downloadMap;
+	ActiveDownloadList waitingList;
+	unsigned numRunning;
+};
+
+static size_t
+WriteToMemory(char *ptr, size_t size, size_t nmemb, void *userdata)
+{
+	ActiveDownload *download = static_cast<ActiveDownload *>(userdata);
+	size_t numBytes = size * nmemb;
+	// Returning less than numBytes aborts the transfer.
+	if (download->maxSize && download->data.size() + numBytes > download->maxSize)
+		return 0;
+	download->data.insert(download->data.end(), ptr, ptr + numBytes);
+	return numBytes;
+}
+
+
+DownloaderThread::DownloaderThread(unsigned maxTransfers, unsigned maxHostConnections, size_t maxFileSize)
+	: m_data(new DownloaderData), m_maxTransfers(maxTransfers ? maxTransfers : 1),
+	  m_maxHostConnections(maxHostConnections), m_maxFileSize(maxFileSize)
 {
-	m_downloadHelper.reset(new DownloadHelper());
 }
 
 DownloaderThread::~DownloaderThread()
 {
+	CleanupTransfers();
 }
 
 void
-DownloaderThread::QueueDownload(unsigned downloadId, const std::string &url, const std::string &filename)
+DownloaderThread::QueueDownload(unsigned downloadId, const std::string &url)
 {
 	boost::mutex::scoped_lock lock(m_downloadQueueMutex);
-	m_downloadQueue.push(DownloadData(downloadId, url, filename));
+	m_downloadQueue.push(DownloadData(downloadId, url));
 }
 
 bool
@@ -74,9 +114,9 @@ DownloaderThread::GetDownloadResult(unsigned &downloadId, std::vector<unsigned c
 	bool result = false;
 	boost::mutex::scoped_lock lock(m_downloadDoneQueueMutex);
 	if (!m_downloadDoneQueue.empty()) {
-		const ResultData &d = m_downloadDoneQueue.front();
+		ResultData &d = m_downloadDoneQueue.front();
 		downloadId = d.id;
-		filedata = d.data;
+		filedata.swap(d.data);
 		m_downloadDoneQueue.pop();
 		result = true;
 	}
@@ -88,59 +128,189 @@ DownloaderThread::Main()
 {
 	while (!ShouldTerminate()) {
 		try {
-			if (m_downloadInProgress) {
-				m_downloadInProgress = !m_downloadHelper->Process();
-			}
+			if (!m_data->curlMultiHandle)
+				InitTransfers();
 
-			if (!m_downloadInProgress) {
-				// Previous download was finished.
-				if (m_curDownloadData) {
-					path filepath(m_curDownloadData->filename);
-					std::ifstream instream(filepath.file_string().c_str(), ios_base::in | ios_base::binary);
-					// Find out file size.
-					// Not fully portable, but works on win/linux/mac.
-					instream.seekg(0, ios_base::beg);
-					std::streampos startPos = instream.tellg();
-					instream.seekg(0, ios_base::end);
-					std::streampos endPos = instream.tellg();
-					instream.seekg(0, ios_base::beg);
-					std::streamoff posDiff(endPos - startPos);
-					unsigned fileSize = (unsigned)posDiff;
-
-					vector<unsigned char> fileData(fileSize);
-					instream.read((char *)&fileData[0], fileSize);
-					instream.close();
-					remove(filepath);
-
-					{
-						boost::mutex::scoped_lock lock(m_downloadDoneQueueMutex);
-						m_downloadDoneQueue.push(ResultData(m_curDownloadData->id, fileData));
-					}
-					m_curDownloadData.reset();
-				}
-
-				// Take a break.
-				Msleep(DOWNLOAD_DELAY_MSEC);
-
-				// Start next download.
-				{
-					boost::mutex::scoped_lock lock(m_downloadQueueMutex);
-					if (!m_downloadQueue.empty()) {
-						m_curDownloadData.reset(new DownloadData(m_downloadQueue.front()));
-						m_downloadQueue.pop();
-					}
-				}
-				if (m_curDownloadData && !m_curDownloadData->filename.empty()) {
-					path filepath(m_curDownloadData->filename);
-					m_downloadHelper->Init(m_curDownloadData->address, filepath.file_string());
-					m_downloadInProgress = true;
-				}
-			}
+			AcceptNewDownloads();
+			StartWaitingDownloads();
+
+			if (m_data->numRunning)
+				ProcessTransfers();
+			else
+				Msleep(DOWNLOAD_IDLE_DELAY_MSEC);
 		} catch (const NetException &e) {
 			LOG_ERROR("Download failed: " << e.what());
-			m_downloadInProgress = false;
-			m_curDownloadData.reset();
+			// Drop all downloads, the multi handle is created again.
+			CleanupTransfers();
+			Msleep(DOWNLOAD_IDLE_DELAY_MSEC);
+		}
+	}
+	CleanupTransfers();
+}
+
+void
+DownloaderThread::InitTransfers()
+{
+	m_data->curlMultiHandle = curl_multi_init();
+	if (!m_data->curlMultiHandle)
+		throw NetException(__FILE__, __LINE__, ERR_SOCK_TRANSFER_INIT_FAILED, 0);
+	// Idle connections are kept in the cache of the multi handle.
+	curl_multi_setopt(m_data->curlMultiHandle, CURLMOPT_MAXCONNECTS, static_cast<long>(m_maxTransfers));
+#if LIBCURL_VERSION_NUM >= 0x071e00
+	if (m_maxHostConnections)
+		curl_multi_setopt(m_data->curlMultiHandle, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(m_maxHostConnections));
+#endif
+}
+
+void
+DownloaderThread::CleanupTransfers()
+{
+	ActiveDownloadMap::iterator i = m_data->downloadMap.begin();
+	ActiveDownloadMap::iterator end = m_data->downloadMap.end();
+	while (i != end) {
+		if (i->second->curlHandle) {
+			curl_multi_remove_handle(m_data->curlMultiHandle, i->second->curlHandle);
+			curl_easy_cleanup(i->second->curlHandle);
+			i->second->curlHandle = NULL;
+		}
+		++i;
+	}
+	m_data->downloadMap.clear();
+	m_data->waitingList.clear();
+	m_data->numRunning = 0;
+	if (m_data->curlMultiHandle) {
+		curl_multi_cleanup(m_data->curlMultiHandle);
+		m_data->curlMultiHandle = NULL;
+	}
+}
+
+void
+DownloaderThread::AcceptNewDownloads()
+{
+	vector<DownloadData> newDownloads;
+	{
+		boost::mutex::scoped_lock lock(m_downloadQueueMutex);
+		while (!m_downloadQueue.empty()) {
+			newDownloads.push_back(m_downloadQueue.front());
+			m_downloadQueue.pop();
+		}
+	}
+	vector<DownloadData>::const_iterator i = newDownloads.begin();
+	vector<DownloadData>::const_iterator end = newDownloads.end();
+	while (i != end) {
+		boost::shared_ptr<ActiveDownload> &download = m_data->downloadMap[i->address];
+		if (!download) {
+			download.reset(new ActiveDownload(i->address, m_maxFileSize));
+			m_data->waitingList.push_back(download);
 		}
+		download->idList.push_back(i->id);
+		++i;
 	}
 }
 
+void
+DownloaderThread::StartWaitingDownloads()
+{
+	while (m_data->numRunning < m_maxTransfers && !m_data->waitingList.empty()) {
+		boost::shared_ptr<ActiveDownload> download(m_data->waitingList.front());
+		m_data->waitingList.pop_front();
+
+		download->curlHandle = curl_easy_init();
+		if (!download->curlHandle)
+			throw NetException(__FILE__, __LINE__, ERR_SOCK_TRANSFER_INIT_FAILED, 0);
+		if (curl_easy_setopt(download->curlHandle, CURLOPT_URL, download->url.c_str()) != CURLE_OK) {
+			curl_easy_cleanup(download->curlHandle);
+			download->curlHandle = NULL;
+			FinishDownload(download->url, false);
+			continue;
+		}
+		// Assume that the following calls never fail.
+		curl_easy_setopt(download->curlHandle, CURLOPT_WRITEFUNCTION, WriteToMemory);
+		curl_easy_setopt(download->curlHandle, CURLOPT_WRITEDATA, download.get());
+		curl_easy_setopt(download->curlHandle, CURLOPT_PRIVATE, download.get());
+		curl_easy_setopt(download->curlHandle, CURLOPT_FAILONERROR, 1L);
+		curl_easy_setopt(download->curlHandle, CURLOPT_NOSIGNAL, 1L);
+
+		if (curl_multi_add_handle(m_data->curlMultiHandle, download->curlHandle) != CURLM_OK)
+			throw NetException(__FILE__, __LINE__, ERR_SOCK_TRANSFER_INIT_FAILED, 0);
+		m_data->numRunning++;
+	}
+}
+
+void
+DownloaderThread::ProcessTransfers()
+{
+	int runningHandles = 0;
+	CURLMcode curlResult;
+	do {
+		curlResult = curl_multi_perform(m_data->curlMultiHandle, &runningHandles);
+	} while (curlResult == CURLM_CALL_MULTI_PERFORM);
+
+	if (curlResult != CURLM_OK)
+		throw NetException(__FILE__, __LINE__, ERR_SOCK_TRANSFER_FAILED, 0);
+
+	int numMsgs;
+	CURLMsg *tmpMsg;
+	while ((tmpMsg = curl_multi_info_read(m_data->curlMultiHandle, &numMsgs)) != NULL) {
+		if (tmpMsg->msg == CURLMSG_DONE) {
+			char *privateData = NULL;
+			curl_easy_getinfo(tmpMsg->easy_handle, CURLINFO_PRIVATE, &privateData);
+			bool success = tmpMsg->data.result == CURLE_OK;
+			FinishDownload(reinterpret_cast<ActiveDownload *>(privateData)->url, success);
+		}
+	}
+
+	if (runningHandles) {
+		struct timeval timeout;
+		fd_set readSet;
+		fd_set writeSet;
+		fd_set exceptSet;
+		int maxfd = -1;
+
+		FD_ZERO(&readSet);
+		FD_ZERO(&writeSet);
+		FD_ZERO(&exceptSet);
+
+		timeout.tv_sec = 0;
+		timeout.tv_usec = DOWNLOAD_SELECT_TIMEOUT_MSEC * 1000;
+
+		curl_multi_fdset(m_data->curlMultiHandle, &readSet, &writeSet, &exceptSet, &maxfd);
+
+		if (maxfd >= 0) {
+			int selectResult = select(maxfd+1, &readSet, &writeSet, &exceptSet, &timeout);
+			if (selectResult == -1)
+				throw NetException(__FILE__, __LINE__, ERR_SOCK_TRANSFER_SELECT_FAILED, 0);
+		} else {
+			// Curl is waiting for a timer, e.g. name resolution.
+			Msleep(DOWNLOAD_IDLE_DELAY_MSEC);
+		}
+	}
+}
+
+void
+DownloaderThread::FinishDownload(const std::string &url, bool success)
+{
+	ActiveDownloadMap::iterator pos = m_data->downloadMap.find(url);
+	if (pos != m_data->downloadMap.end()) {
+		boost::shared_ptr<ActiveDownload> download(pos->second);
+		m_data->downloadMap.erase(pos);
+		if (download->curlHandle) {
+			curl_multi_remove_handle(m_data->curlMultiHandle, download->curlHandle);
+			curl_easy_cleanup(download->curlHandle);
+			download->curlHandle = NULL;
+			m_data->numRunning--;
+		}
+
+		if (success) {
+			boost::mutex::scoped_lock lock(m_downloadDoneQueueMutex);
+			vector<unsigned>::const_iterator i = download->idList.begin();
+			vector<unsigned>::const_iterator end = download->idList.end();
+			while (i != end) {
+				m_downloadDoneQueue.push(ResultData(*i, download->data));
+				++i;
+			}
+		} else {
+			LOG_ERROR("Download failed: " << url);
+		}
+	}
+}
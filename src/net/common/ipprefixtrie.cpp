@@ -0,0 +1,150 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+
+#include <net/ipprefixtrie.h>
+#include <boost/asio/ip/address.hpp>
+#include <cstdlib>
+
+using namespace std;
+
+#define IPV4_MAPPED_PREFIX_BITS		96
+
+IPPrefixTrie::IPPrefixTrie()
+{
+	Clear();
+}
+
+void
+IPPrefixTrie::Clear()
+{
+	m_nodes.assign(1, Node());
+}
+
+bool
+IPPrefixTrie::IsEmpty() const
+{
+	return m_nodes.size() == 1 && !m_nodes[0].terminal;
+}
+
+bool
+IPPrefixTrie::AddRange(const std::string &range)
+{
+	string addressStr(range);
+	int prefixLen = -1;
+	string::size_type slashPos = range.find('/');
+	if (slashPos != string::npos) {
+		addressStr = range.substr(0, slashPos);
+		string prefixStr(range.substr(slashPos + 1));
+		if (prefixStr.empty() || prefixStr.find_first_not_of("0123456789") != string::npos)
+			return false;
+		prefixLen = atoi(prefixStr.c_str());
+	}
+
+	AddressBytes address;
+	unsigned prefixOffset;
+	if (!ParseAddress(addressStr, address, prefixOffset))
+		return false;
+	if (prefixLen < 0)
+		prefixLen = IP_ADDRESS_NUM_BITS - prefixOffset;
+	if (static_cast<unsigned>(prefixLen) + prefixOffset > IP_ADDRESS_NUM_BITS)
+		return false;
+	prefixLen += prefixOffset;
+
+	unsigned node = 0;
+	for (int i = 0; i < prefixLen && !m_nodes[node].terminal; i++) {
+		unsigned bit = (address[i / 8] >> (7 - i % 8)) & 1;
+		if (!m_nodes[node].child[bit]) {
+			m_nodes[node].child[bit] = static_cast<unsigned>(m_nodes.size());
+			m_nodes.push_back(Node());
+		}
+		node = m_nodes[node].child[bit];
+	}
+	// Longer ranges below this node are covered now.
+	m_nodes[node].terminal = true;
+	m_nodes[node].child[0] = m_nodes[node].child[1] = 0;
+	return true;
+}
+
+bool
+IPPrefixTrie::Contains(const std::string &ipAddress) const
+{
+	AddressBytes address;
+	unsigned prefixOffset;
+	return ParseAddress(ipAddress, address, prefixOffset) && Contains(address);
+}
+
+bool
+IPPrefixTrie::Contains(const AddressBytes &address) const
+{
+	unsigned node = 0;
+	for (unsigned i = 0; i < IP_ADDRESS_NUM_BITS; i++) {
+		if (m_nodes[node].terminal)
+			return true;
+		node = m_nodes[node].child[(address[i / 8] >> (7 - i % 8)) & 1];
+		if (!node)
+			return false;
+	}
+	return m_nodes[node].terminal;
+}
+
+bool
+IPPrefixTrie::ParseAddress(const std::string &ipAddress, AddressBytes &outAddress, unsigned &outIPv4PrefixOffset)
+{
+	boost::system::error_code ec;
+	boost::asio::ip::address tmpAddress = boost::asio::ip::address::from_string(ipAddress, ec);
+	if (ec)
+		return false;
+
+	outIPv4PrefixOffset = 0;
+	if (tmpAddress.is_v4()) {
+		boost::asio::ip::address_v4::bytes_type v4Bytes = tmpAddress.to_v4().to_bytes();
+		outAddress.assign(0);
+		outAddress[10] = outAddress[11] = 0xFF;
+		copy(v4Bytes.begin(), v4Bytes.end(), outAddress.begin() + 12);
+		outIPv4PrefixOffset = IPV4_MAPPED_PREFIX_BITS;
+	} else {
+		boost::asio::ip::address_v6::bytes_type v6Bytes = tmpAddress.to_v6().to_bytes();
+		copy(v6Bytes.begin(), v6Bytes.end(), outAddress.begin());
+	}
+	return true;
+}
+
+std::string
+IPPrefixTrie::NormalizeAddress(const std::string &ipAddress)
+{
+	boost::system::error_code ec;
+	boost::asio::ip::address tmpAddress = boost::asio::ip::address::from_string(ipAddress, ec);
+	if (ec)
+		return ipAddress;
+	if (tmpAddress.is_v6() && tmpAddress.to_v6().is_v4_mapped())
+		return tmpAddress.to_v6().to_v4().to_string();
+	return tmpAddress.to_string();
+}
@@ -34,6 +34,8 @@
 #include <net/sendbuffer.h>
 #include <net/socket_helper.h>
 #include <net/socket_msg.h>
+#include <net/servermetrics.h>
+#include <net/netpacket.h>
 #include <core/loghelper.h>
 #include <cstring>
 #include <cassert>
@@ -57,8 +59,10 @@ SenderHelper::Send(boost::shared_ptr<SessionData> session, boost::shared_ptr<Net
 		// Add packet to specific queue.
 		boost::mutex::scoped_lock lock(tmpBuffer.dataMutex);
 		tmpBuffer.InternalStorePacket(session, packet);
+		ServerMetrics::AddPacketOut(*packet->GetMsg());
 		// Activate async send, if needed.
 		tmpBuffer.AsyncSendNextPacket(session);
+		ServerMetrics::AddValue(METRIC_SEND_QUEUE_BYTES, tmpBuffer.GetQueuedBytes());
 	}
 }
 
@@ -72,15 +76,40 @@ SenderHelper::Send(boost::shared_ptr<SessionData> session, const NetPacketList &
 		NetPacketList::const_iterator i = packetList.begin();
 		NetPacketList::const_iterator end = packetList.end();
 		while (i != end) {
-			if (*i)
+			if (*i) {
 				tmpBuffer.InternalStorePacket(session, *i);
+				ServerMetrics::AddPacketOut(*(*i)->GetMsg());
+			}
 			++i;
 		}
 		// Activate async send, if needed.
 		tmpBuffer.AsyncSendNextPacket(session);
+		ServerMetrics::AddValue(METRIC_SEND_QUEUE_BYTES, tmpBuffer.GetQueuedBytes());
 	}
 }
 
+void
+SenderHelper::SendEncoded(boost::shared_ptr<SessionData> session, const std::string &msgData, int packetType)
+{
+	if (session) {
+		SendBuffer &tmpBuffer = session->GetSendBuffer();
+		boost::mutex::scoped_lock lock(tmpBuffer.dataMutex);
+		tmpBuffer.InternalStoreEncoded(session, msgData);
+		ServerMetrics::AddPacketOut(packetType);
+		// Activate async send, if needed.
+		tmpBuffer.AsyncSendNextPacket(session);
+		ServerMetrics::AddValue(METRIC_SEND_QUEUE_BYTES, tmpBuffer.GetQueuedBytes());
+	}
+}
+
+size_t
+SenderHelper::GetQueuedBytes(boost::shared_ptr<SessionData> session) const
+{
+	SendBuffer &tmpBuffer = session->GetSendBuffer();
+	boost::mutex::scoped_lock lock(tmpBuffer.dataMutex);
+	return tmpBuffer.GetQueuedBytes();
+}
+
 void
 SenderHelper::SetCloseAfterSend(boost::shared_ptr<SessionData> session)
 {
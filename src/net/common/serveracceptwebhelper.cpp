@@ -33,6 +33,7 @@
 #include <net/sessiondata.h>
 #include <net/webreceivebuffer.h>
 #include <net/websocketdata.h>
+#include <core/loghelper.h>
 
 using namespace std;
 
@@ -104,6 +105,7 @@ ServerAcceptWebHelper::on_close(websocketpp::connection_hdl hdl)
 	if (pos != m_sessionMap.end()) {
 		boost::shared_ptr<SessionData> tmpSession = pos->second.lock();
 		if (tmpSession) {
+			LogStatistics(*tmpSession);
 			tmpSession->Close();
 		}
 		m_sessionMap.erase(pos);
@@ -118,9 +120,31 @@ ServerAcceptWebHelper::on_message(websocketpp::connection_hdl hdl, server::messa
 		if (pos != m_sessionMap.end()) {
 			boost::shared_ptr<SessionData> tmpSession = pos->second.lock();
 			if (tmpSession) {
+				boost::shared_ptr<WebSocketData> webData = tmpSession->GetWebData();
+				{
+					boost::mutex::scoped_lock lock(webData->statsMutex);
+					webData->stats.messagesIn++;
+					webData->stats.bytesIn += msg->get_payload().size();
+				}
 				tmpSession->GetReceiveBuffer().HandleMessage(tmpSession, msg->get_payload());
 			}
 		}
 	}
 }
 
+void
+ServerAcceptWebHelper::LogStatistics(SessionData &session)
+{
+	boost::shared_ptr<WebSocketData> webData = session.GetWebData();
+	WebSocketStatistics tmpStats;
+	{
+		boost::mutex::scoped_lock lock(webData->statsMutex);
+		tmpStats = webData->stats;
+	}
+	LOG_VERBOSE("Websocket session " << session.GetId()
+				<< ": sent " << tmpStats.messagesOut << " messages (" << tmpStats.compressedMessagesOut << " compressed), "
+				<< tmpStats.payloadBytesOut << " bytes payload, " << tmpStats.wireBytesOut << " bytes on the wire, "
+				<< tmpStats.sendCpuMicroSec << " usec send cpu; received " << tmpStats.messagesIn << " messages, "
+				<< tmpStats.bytesIn << " bytes.");
+}
+
@@ -37,6 +37,7 @@
 #include <net/socket_msg.h>
 #include <net/socket_startup.h>
 #include <core/loghelper.h>
+#include <core/tracehelper.h>
 
 #include <boost/filesystem.hpp>
 #include <boost/bind.hpp>
@@ -214,6 +215,19 @@ ServerAdminBot::SignalIrcChatMsg(const std::string &nickName, const std::string
 								<< "    (Max at a time: " << tmpStats.maxGamesOpen << ")";
 						m_ircAdminThread->SendChatMessage(statStream.str());
 					}
+				} else if (command == "trace") {
+					unsigned lastSeconds = 10;
+					while (msgStream.peek() == ' ')
+						msgStream.get();
+					if (!msgStream.eof())
+						msgStream >> lastSeconds;
+					string fileName;
+					if (!tracehelper_enabled())
+						m_ircAdminThread->SendChatMessage(nickName + ": Tracing is not enabled in this build.");
+					else if (GetLobbyThread().DumpTrace(lastSeconds, fileName))
+						m_ircAdminThread->SendChatMessage(nickName + ": Trace written to \"" + fileName + "\".");
+					else
+						m_ircAdminThread->SendChatMessage(nickName + ": Failed to write trace file.");
 				} else if (command == "chat") {
 					while (msgStream.peek() == ' ')
 						msgStream.get();
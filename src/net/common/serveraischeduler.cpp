@@ -0,0 +1,143 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+
+#include <net/serveraischeduler.h>
+#include <localplayer.h>
+
+#include <boost/bind.hpp>
+#include <algorithm>
+
+#define SERVER_AI_QUEUE_RESERVE		64
+
+using namespace std;
+
+
+ServerAiScheduler::ServerAiScheduler(boost::shared_ptr<boost::asio::io_service> ioService)
+	: m_ioService(ioService), m_nextQueue(0), m_numPendingJobs(0), m_numIdleWorkers(0), m_terminate(false)
+{
+}
+
+ServerAiScheduler::~ServerAiScheduler()
+{
+	Stop();
+}
+
+void
+ServerAiScheduler::Start(unsigned numWorkers)
+{
+	for (unsigned i = 0; i < numWorkers; i++)
+		m_queues.push_back(boost::shared_ptr<JobQueue>(new JobQueue(SERVER_AI_QUEUE_RESERVE)));
+	for (unsigned i = 0; i < numWorkers; i++)
+		m_workers.create_thread(boost::bind(&ServerAiScheduler::WorkerMain, this, i));
+}
+
+void
+ServerAiScheduler::Stop()
+{
+	m_terminate = true;
+	{
+		boost::mutex::scoped_lock lock(m_idleMutex);
+		m_idleCond.notify_all();
+	}
+	m_workers.join_all();
+
+	// Drop jobs which were not started, their games are gone anyway.
+	Job *job;
+	for (unsigned i = 0; i < m_queues.size(); i++) {
+		while (m_queues[i]->pop(job))
+			delete job;
+	}
+	m_queues.clear();
+}
+
+void
+ServerAiScheduler::PostOddsJob(int round, const int *holeCards, const int *boardCards, int numPlayers, OddsHandler handler)
+{
+	Job *job = new Job;
+	job->round = round;
+	std::copy(holeCards, holeCards + 2, job->holeCards);
+	std::copy(boardCards, boardCards + 5, job->boardCards);
+	job->numPlayers = numPlayers;
+	job->handler = handler;
+
+	if (m_queues.empty()) {
+		m_ioService->post(boost::bind(&ServerAiScheduler::RunJob, job, boost::ref(*m_ioService)));
+		return;
+	}
+	m_numPendingJobs++;
+	m_queues[m_nextQueue++ % m_queues.size()]->push(job);
+	// Idle workers re-check the pending jobs while holding the mutex,
+	// so the notification is not lost.
+	if (m_numIdleWorkers > 0) {
+		boost::mutex::scoped_lock lock(m_idleMutex);
+		m_idleCond.notify_one();
+	}
+}
+
+void
+ServerAiScheduler::WorkerMain(unsigned index)
+{
+	while (!m_terminate) {
+		Job *job = NextJob(index);
+		if (job) {
+			m_numPendingJobs--;
+			RunJob(job, *m_ioService);
+		} else {
+			boost::mutex::scoped_lock lock(m_idleMutex);
+			m_numIdleWorkers++;
+			while (!m_terminate && m_numPendingJobs == 0)
+				m_idleCond.wait(lock);
+			m_numIdleWorkers--;
+		}
+	}
+}
+
+ServerAiScheduler::Job *
+ServerAiScheduler::NextJob(unsigned index)
+{
+	Job *job = NULL;
+	if (!m_queues[index]->pop(job)) {
+		// Steal from the other workers.
+		for (unsigned i = 1; i < m_queues.size(); i++) {
+			if (m_queues[(index + i) % m_queues.size()]->pop(job))
+				break;
+		}
+	}
+	return job;
+}
+
+void
+ServerAiScheduler::RunJob(Job *job, boost::asio::io_service &ioService)
+{
+	double odds = LocalPlayer::calcOdds(job->round, job->holeCards, job->boardCards, job->numPlayers);
+	ioService.post(boost::bind(job->handler, odds));
+	delete job;
+}
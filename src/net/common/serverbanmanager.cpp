@@ -30,6 +30,7 @@
  *****************************************************************************/
 
 #include <net/serverbanmanager.h>
+#include <boost/algorithm/string/case_conv.hpp>
 #include <algorithm>
 
 using namespace std;
@@ -41,7 +42,7 @@ using namespace boost::chrono;
 #endif
 
 ServerBanManager::ServerBanManager(boost::shared_ptr<boost::asio::io_service> ioService)
-	: m_ioService(ioService), m_curBanId(0)
+	: m_ioService(ioService), m_lookup(new BanLookup), m_curBanId(0)
 {
 }
 
@@ -68,6 +69,7 @@ ServerBanManager::BanPlayerName(const std::string &playerName, unsigned duration
 	tmpBan.timer = InternalRegisterTimedBan(banId, durationHours);
 	tmpBan.nameStr = playerName;
 	m_banPlayerNameMap[banId] = tmpBan;
+	InternalUpdateLookup();
 }
 
 void
@@ -80,6 +82,7 @@ ServerBanManager::BanPlayerRegex(const string &playerRegex, unsigned durationHou
 	tmpBan.timer = InternalRegisterTimedBan(banId, durationHours);
 	tmpBan.nameRegex = boost::regex(playerRegex, boost::regex::extended | boost::regex::icase);
 	m_banPlayerNameMap[banId] = tmpBan;
+	InternalUpdateLookup();
 }
 
 void
@@ -92,6 +95,7 @@ ServerBanManager::BanIPAddress(const string &ipAddress, unsigned durationHours)
 	tmpBan.timer = InternalRegisterTimedBan(banId, durationHours);
 	tmpBan.ipAddress = ipAddress;
 	m_banIPAddressMap[banId] = tmpBan;
+	InternalUpdateLookup();
 }
 
 bool
@@ -114,6 +118,8 @@ ServerBanManager::UnBan(unsigned banId)
 			retVal = true;
 		}
 	}
+	if (retVal)
+		InternalUpdateLookup();
 	return retVal;
 }
 
@@ -153,6 +159,7 @@ ServerBanManager::ClearBanList()
 	boost::mutex::scoped_lock lock(m_banMutex);
 	m_banPlayerNameMap.clear();
 	m_banIPAddressMap.clear();
+	InternalUpdateLookup();
 }
 
 bool
@@ -172,70 +179,67 @@ ServerBanManager::IsAdminPlayer(DB_id playerId) const
 bool
 ServerBanManager::IsPlayerBanned(const std::string &name) const
 {
-	bool retVal = false;
-	boost::mutex::scoped_lock lock(m_banMutex);
-	RegexMap::const_iterator i = m_banPlayerNameMap.begin();
-	RegexMap::const_iterator end = m_banPlayerNameMap.end();
-	while (i != end) {
-		// Use regex only if name not set.
-		if ((*i).second.nameStr.empty()) {
-			if (regex_match(name, (*i).second.nameRegex)) {
-				retVal = true;
-				break;
-			}
-		} else {
-			if (name == (*i).second.nameStr) {
-				retVal = true;
-				break;
-			}
-		}
-		++i;
-	}
-
+	boost::shared_ptr<const BanLookup> lookup(GetLookup());
+	bool retVal = lookup->playerNames.find(name) != lookup->playerNames.end();
+	if (!retVal && lookup->playerRegex)
+		retVal = regex_match(name, *lookup->playerRegex);
 	return retVal;
 }
 
 bool
 ServerBanManager::IsIPAddressBanned(const std::string &ipAddress) const
 {
-	bool retVal = false;
-	boost::mutex::scoped_lock lock(m_banMutex);
-	IPAddressMap::const_iterator i = m_banIPAddressMap.begin();
-	IPAddressMap::const_iterator end = m_banIPAddressMap.end();
-	while (i != end) {
-		if (ipAddress == (*i).second.ipAddress) {
-			retVal = true;
-			break;
-		}
-		++i;
-	}
-
+	boost::shared_ptr<const BanLookup> lookup(GetLookup());
+	bool retVal = lookup->ipAddresses.find(IPPrefixTrie::NormalizeAddress(ipAddress)) != lookup->ipAddresses.end();
+	if (!retVal && !lookup->ipRanges.IsEmpty())
+		retVal = lookup->ipRanges.Contains(ipAddress);
 	return retVal;
 }
 
 void
 ServerBanManager::InitGameNameBadWordList(const std::list<string> &badWordList)
 {
+	static const string wildcard(".*");
+	static const string regexChars("\\^$.|?*+()[]{}");
+
+	m_gameNameBadWordMatcher.Clear();
 	list<string>::const_iterator i = badWordList.begin();
 	list<string>::const_iterator end = badWordList.end();
 	while (i != end) {
-		m_gameNameBadWordFilter.push_back(boost::regex(*i, boost::regex::extended | boost::regex::icase));
+		// Plain ".*word.*" entries are matched as substrings in one pass,
+		// all other entries remain regular expressions.
+		const string &entry = *i;
+		string word;
+		if (entry.size() > 2 * wildcard.size()
+				&& entry.compare(0, wildcard.size(), wildcard) == 0
+				&& entry.compare(entry.size() - wildcard.size(), wildcard.size(), wildcard) == 0) {
+			word = entry.substr(wildcard.size(), entry.size() - 2 * wildcard.size());
+			if (word.find_first_of(regexChars) != string::npos)
+				word.clear();
+		}
+		if (!word.empty())
+			m_gameNameBadWordMatcher.AddPattern(boost::algorithm::to_lower_copy(word));
+		else
+			m_gameNameBadWordFilter.push_back(boost::regex(entry, boost::regex::extended | boost::regex::icase));
 		++i;
 	}
+	m_gameNameBadWordMatcher.Build();
 }
 
 bool
 ServerBanManager::IsBadGameName(const std::string &name) const
 {
-	bool retVal = false;
-	RegexList::const_iterator i = m_gameNameBadWordFilter.begin();
-	RegexList::const_iterator end = m_gameNameBadWordFilter.end();
-	while (i != end) {
-		if (regex_match(name, *i)) {
-			retVal = true;
-			break;
+	bool retVal = m_gameNameBadWordMatcher.FindAny(boost::algorithm::to_lower_copy(name));
+	if (!retVal) {
+		RegexList::const_iterator i = m_gameNameBadWordFilter.begin();
+		RegexList::const_iterator end = m_gameNameBadWordFilter.end();
+		while (i != end) {
+			if (regex_match(name, *i)) {
+				retVal = true;
+				break;
+			}
+			++i;
 		}
-		++i;
 	}
 	return retVal;
 }
@@ -262,6 +266,47 @@ ServerBanManager::TimerRemoveBan(const boost::system::error_code &ec, unsigned b
 		UnBan(banId);
 }
 
+void
+ServerBanManager::InternalUpdateLookup()
+{
+	// Called with m_banMutex held.
+	boost::shared_ptr<BanLookup> tmpLookup(new BanLookup);
+
+	string mergedRegex;
+	RegexMap::const_iterator i_nick = m_banPlayerNameMap.begin();
+	RegexMap::const_iterator end_nick = m_banPlayerNameMap.end();
+	while (i_nick != end_nick) {
+		if ((*i_nick).second.nameStr.empty()) {
+			if (!mergedRegex.empty())
+				mergedRegex += "|";
+			mergedRegex += "(" + (*i_nick).second.nameRegex.str() + ")";
+		} else {
+			tmpLookup->playerNames.insert((*i_nick).second.nameStr);
+		}
+		++i_nick;
+	}
+	// All regex bans are matched as one alternation.
+	if (!mergedRegex.empty())
+		tmpLookup->playerRegex.reset(new boost::regex(mergedRegex, boost::regex::extended | boost::regex::icase));
+
+	IPAddressMap::const_iterator i_ip = m_banIPAddressMap.begin();
+	IPAddressMap::const_iterator end_ip = m_banIPAddressMap.end();
+	while (i_ip != end_ip) {
+		const string &ipAddress = (*i_ip).second.ipAddress;
+		if (ipAddress.find('/') == string::npos || !tmpLookup->ipRanges.AddRange(ipAddress))
+			tmpLookup->ipAddresses.insert(IPPrefixTrie::NormalizeAddress(ipAddress));
+		++i_ip;
+	}
+
+	boost::atomic_store(&m_lookup, boost::shared_ptr<const BanLookup>(tmpLookup));
+}
+
+boost::shared_ptr<const ServerBanManager::BanLookup>
+ServerBanManager::GetLookup() const
+{
+	return boost::atomic_load(&m_lookup);
+}
+
 unsigned
 ServerBanManager::GetNextBanId()
 {
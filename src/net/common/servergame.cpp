@@ -50,6 +50,7 @@
 
 #define SERVER_CHECK_VOTE_KICK_INTERVAL_MSEC	500
 #define SERVER_KICK_TIMEOUT_ADD_DELAY_SEC		2
+#define SERVER_SPECTATOR_STREAM_INTERVAL_MSEC	100
 
 using namespace std;
 
@@ -68,10 +69,12 @@ static bool LessThanPlayerHandStartMoney(const boost::shared_ptr<PlayerInterface
 ServerGame::ServerGame(boost::shared_ptr<ServerLobbyThread> lobbyThread, u_int32_t id, const string &name, const string &pwd, const GameData &gameData,
 					   unsigned adminPlayerId, unsigned creatorPlayerDBId, GuiInterface &gui, ConfigFile &playerConfig, const ServerMode mode)
 	: m_adminPlayerId(adminPlayerId), m_lobbyThread(lobbyThread), m_gui(gui),
-	  m_serverDelayTime(mode), m_gameData(gameData), m_curState(NULL), m_id(id), m_name(name),
+	  m_serverDelayTime(mode), m_gameData(gameData), m_engineEvents(m_engineEventData, SERVER_MAX_ENGINE_EVENTS),
+	  m_curState(NULL), m_id(id), m_name(name),
 	  m_password(pwd), m_creatorPlayerDBId(creatorPlayerDBId), m_playerConfig(playerConfig),
 	  m_gameNum(1), m_curPetitionId(1), m_voteKickTimer(lobbyThread->GetIOService()),
 	  m_stateTimer1(lobbyThread->GetIOService()), m_stateTimer2(lobbyThread->GetIOService()),
+	  m_spectatorTimer(lobbyThread->GetIOService()),
 	  m_isNameReported(false)
 {
 	LOG_VERBOSE("Game object " << GetId() << " created.");
@@ -92,6 +95,8 @@ void
 ServerGame::Exit()
 {
 	m_voteKickTimer.cancel();
+	m_spectatorTimer.cancel();
+	m_spectatorStream.Clear();
 	SetState(ServerGameStateFinal::Instance());
 }
 
@@ -185,13 +190,27 @@ ServerGame::GetCurRound() const
 void
 ServerGame::SendToAllPlayers(boost::shared_ptr<NetPacket> packet, int state)
 {
-	GetSessionManager().SendToAllSessions(GetLobbyThread().GetSender(), packet, state);
+	if (state & SessionData::Spectating) {
+		m_spectatorStream.Append(*packet);
+		PumpSpectatorStream();
+		state &= ~SessionData::Spectating;
+	}
+	if (state) {
+		GetSessionManager().SendToAllSessions(GetLobbyThread().GetSender(), packet, state);
+	}
 }
 
 void
 ServerGame::SendToAllButOnePlayers(boost::shared_ptr<NetPacket> packet, SessionId except, int state)
 {
-	GetSessionManager().SendToAllButOneSessions(GetLobbyThread().GetSender(), packet, except, state);
+	if (state & SessionData::Spectating) {
+		m_spectatorStream.Append(*packet, except);
+		PumpSpectatorStream();
+		state &= ~SessionData::Spectating;
+	}
+	if (state) {
+		GetSessionManager().SendToAllButOneSessions(GetLobbyThread().GetSender(), packet, except, state);
+	}
 }
 
 void
@@ -293,6 +312,14 @@ ServerGame::TimerVoteKick(const boost::system::error_code &ec)
 	}
 }
 
+void
+ServerGame::TimerSpectatorStream(const boost::system::error_code &ec)
+{
+	if (!ec && m_curState != &ServerGameStateFinal::Instance()) {
+		PumpSpectatorStream();
+	}
+}
+
 PlayerDataList
 ServerGame::InternalStartGame()
 {
@@ -318,6 +345,9 @@ ServerGame::InternalStartGame()
 
 		// Create EngineFactory
 		boost::shared_ptr<EngineFactory> factory(new LocalEngineFactory(&m_playerConfig)); // LocalEngine erstellen
+		// The server has no gui, the hand is reported as events.
+		m_engineEvents.clear();
+		factory->setEventBuffer(&m_engineEvents);
 
 		// Set start data.
 		StartData startData;
@@ -890,6 +920,7 @@ ServerGame::RemoveSession(boost::shared_ptr<SessionData> session, int reason)
 	if (!session)
 		throw ServerException(__FILE__, __LINE__, ERR_NET_INVALID_SESSION, 0);
 
+	m_spectatorStream.RemoveSpectator(session->GetId());
 	if (GetSessionManager().RemoveSession(session->GetId())) {
 		boost::shared_ptr<PlayerData> tmpPlayerData = session->GetPlayerData();
 		if (tmpPlayerData && !tmpPlayerData->GetName().empty()) {
@@ -957,7 +988,7 @@ ServerGame::RemovePlayerData(boost::shared_ptr<PlayerData> player, int reason, b
 		netPlayerLeft->set_playerid(player->GetUniqueId());
 		netPlayerLeft->set_gameplayerleftreason(netReason);
 	}
-	GetSessionManager().SendToAllSessions(GetLobbyThread().GetSender(), thisPlayerLeft, SessionData::Game | SessionData::Spectating | SessionData::SpectatorWaiting);
+	SendToAllPlayers(thisPlayerLeft, SessionData::Game | SessionData::Spectating | SessionData::SpectatorWaiting);
 
 	GetState().NotifySessionRemoved(shared_from_this());
 	if (spectateOnly) {
@@ -967,6 +998,36 @@ ServerGame::RemovePlayerData(boost::shared_ptr<PlayerData> player, int reason, b
 	}
 }
 
+void
+ServerGame::AddSpectatorToStream(boost::shared_ptr<SessionData> session)
+{
+	m_spectatorStream.AddSpectator(session);
+}
+
+void
+ServerGame::PumpSpectatorStream()
+{
+	SpectatorStream::SessionList lostSessions;
+	bool pending = m_spectatorStream.Pump(GetLobbyThread().GetSender(), lostSessions);
+
+	// Spectators which fell out of the stream cannot be resynced.
+	SpectatorStream::SessionList::iterator i = lostSessions.begin();
+	SpectatorStream::SessionList::iterator end = lostSessions.end();
+	while (i != end) {
+		MoveSessionToLobby(*i, NTF_NET_REMOVED_TIMEOUT);
+		++i;
+	}
+
+	// Retry later if the send queues of some spectators are full.
+	if (pending && m_spectatorTimer.expires_from_now() <= boost::asio::steady_timer::duration::zero()) {
+		m_spectatorTimer.expires_from_now(
+			milliseconds(SERVER_SPECTATOR_STREAM_INTERVAL_MSEC));
+		m_spectatorTimer.async_wait(
+			boost::bind(
+				&ServerGame::TimerSpectatorStream, shared_from_this(), boost::asio::placeholders::error));
+	}
+}
+
 void
 ServerGame::SessionError(boost::shared_ptr<SessionData> session, int errorCode)
 {
@@ -1107,6 +1168,17 @@ ServerGame::GetStateTimer2()
 	return m_stateTimer2;
 }
 
+unsigned
+ServerGame::GetNumActiveTimers() const
+{
+	// Cancelled timers keep their expiry time, so this is an upper bound.
+	const boost::asio::steady_timer::duration zero = boost::asio::steady_timer::duration::zero();
+	return (m_stateTimer1.expires_from_now() > zero ? 1 : 0)
+		   + (m_stateTimer2.expires_from_now() > zero ? 1 : 0)
+		   + (m_voteKickTimer.expires_from_now() > zero ? 1 : 0)
+		   + (m_spectatorTimer.expires_from_now() > zero ? 1 : 0);
+}
+
 Game &
 ServerGame::GetGame()
 {
@@ -1139,6 +1211,41 @@ ServerGame::SetStartData(const StartData &startData)
 	m_startData = startData;
 }
 
+EngineEventBuffer &
+ServerGame::GetEngineEvents()
+{
+	return m_engineEvents;
+}
+
+ComputerDecision &
+ServerGame::GetComputerDecision()
+{
+	return m_computerDecision;
+}
+
+boost::shared_ptr<NetPacket>
+ServerGame::GetGameDataSnapshot() const
+{
+	return m_gameDataSnapshot;
+}
+
+const std::string &
+ServerGame::GetEncodedGameDataSnapshot() const
+{
+	return m_encodedGameDataSnapshot;
+}
+
+void
+ServerGame::SetGameDataSnapshot(boost::shared_ptr<NetPacket> packet)
+{
+	m_gameDataSnapshot = packet;
+	// Serialize only once for all receivers of the snapshot.
+	m_encodedGameDataSnapshot.clear();
+	if (packet) {
+		packet->GetMsg()->SerializeToString(&m_encodedGameDataSnapshot);
+	}
+}
+
 bool
 ServerGame::IsPasswordProtected() const
 {
@@ -38,8 +38,11 @@
 #include <net/serverexception.h>
 #include <net/net_helper.h>
 #include <net/chatcleanermanager.h>
+#include <net/servermetrics.h>
+#include <net/serveraischeduler.h>
 #include <db/serverdbinterface.h>
 #include <core/loghelper.h>
+#include <core/tracehelper.h>
 #include <core/avatarmanager.h>
 #include <gamedata.h>
 #include <game.h>
@@ -49,6 +52,7 @@
 #include <boost/bind.hpp>
 
 #include <sstream>
+#include <cstdio>
 
 using namespace std;
 
@@ -66,7 +70,18 @@ using namespace boost::chrono;
 #define SERVER_GAME_FORCED_TIMEOUT_FACTOR			60
 #define SERVER_VOTE_KICK_TIMEOUT_SEC				30
 #define SERVER_LOOP_DELAY_MSEC						50
-#define SERVER_MAX_NUM_SPECTATORS_PER_GAME			100
+#define SERVER_COMPUTER_DECISION_DEADLINE_MSEC		500
+#define SERVER_MAX_NUM_SPECTATORS_PER_GAME			2000
+#define HOLE_CARD_PLAIN_BUF_SIZE					64
+
+struct HoleCardData {
+	boost::shared_ptr<PlayerInterface> player;
+	boost::shared_ptr<SessionData> session;
+	int cards[2];
+	bool encrypt;
+	unsigned cipherSize;
+	unsigned char cipher[HOLE_CARD_PLAIN_BUF_SIZE];
+};
 
 // Helper functions
 
@@ -93,10 +108,8 @@ static void SendPlayerAction(ServerGame &server, boost::shared_ptr<PlayerInterfa
 	server.SendToAllPlayers(packet, SessionData::Game | SessionData::Spectating);
 }
 
-static void SendNewRoundCards(ServerGame &server, Game &curGame, int state)
+static void SendNewRoundCards(ServerGame &server, int state, const int *cards)
 {
-	int cards[5];
-	curGame.getCurrentHand()->getBoard()->getMyCards(cards);
 	switch(state) {
 	case GAME_STATE_PREFLOP: {
 		// nothing to do
@@ -193,6 +206,8 @@ static void PerformPlayerAction(ServerGame &server, boost::shared_ptr<PlayerInte
 		// Update total sets.
 		curGame.getCurrentHand()->getBoard()->collectSets();
 	}
+	// Let the engine report the action, like it does for computer players.
+	curGame.getCurrentHand()->setPreviousPlayerID(player->getMyID());
 
 	SendPlayerAction(server, player);
 }
@@ -444,6 +459,9 @@ AbstractServerGameStateReceiving::AcceptNewSession(boost::shared_ptr<ServerGame>
 
 	// Accept session.
 	server->GetSessionManager().AddSession(session);
+	if (spectateOnly && session->GetState() == SessionData::Spectating) {
+		server->AddSpectatorToStream(session);
+	}
 
 	// Notify lobby.
 	if (spectateOnly) {
@@ -877,8 +895,8 @@ void
 AbstractServerGameStateRunning::HandleNewSpectator(boost::shared_ptr<ServerGame> server, boost::shared_ptr<SessionData> session)
 {
 	if (session && session->GetPlayerData()) {
-		AcceptNewSession(server, session, true);
 		session->SetState(SessionData::SpectatorWaiting);
+		AcceptNewSession(server, session, true);
 		server->AddNewSpectator(session->GetPlayerData()->GetUniqueId());
 	}
 }
@@ -935,6 +953,8 @@ void
 ServerGameStateHand::TimerLoop(const boost::system::error_code &ec, boost::shared_ptr<ServerGame> server)
 {
 	if (!ec && &server->GetState() == this) {
+		TRACE_SCOPE("ServerGameStateHand::TimerLoop");
+		ServerMetrics::AddCounter(METRIC_TIMER_CALLBACKS);
 		try {
 			EngineLoop(server);
 		} catch (const PokerTHException &e) {
@@ -947,7 +967,11 @@ ServerGameStateHand::TimerLoop(const boost::system::error_code &ec, boost::share
 void
 ServerGameStateHand::EngineLoop(boost::shared_ptr<ServerGame> server)
 {
+	TRACE_SCOPE("ServerGameStateHand::EngineLoop");
+	ServerMetricsTimer stepTimer(METRIC_ENGINE_STEP_USEC);
 	Game &curGame = server->GetGame();
+	EngineEventBuffer &events = server->GetEngineEvents();
+	events.clear();
 
 	// Main game loop.
 	int curRound = curGame.getCurrentHand()->getCurrentRound();
@@ -956,18 +980,37 @@ ServerGameStateHand::EngineLoop(boost::shared_ptr<ServerGame> server)
 		curGame.getCurrentHand()->getCurrentBeRo()->run();
 	int newRound = curGame.getCurrentHand()->getCurrentRound();
 
+	// Take the cards of the new round from the engine events.
+	int newRoundCards[5] = { -1, -1, -1, -1, -1 };
+	for (unsigned e = 0; e < events.size(); e++) {
+		const EngineEvent &event = events.at(e);
+		if (event.type == ENGINE_EVENT_BOARD_CARDS) {
+			for (int c = 0; c < 5; c++)
+				newRoundCards[c] = event.cards[c];
+		}
+	}
+	if (events.getOverflow())
+		LOG_ERROR("Game " << server->GetId() << " - Engine event buffer overflow.");
+
 	// If round changes, deal cards if needed.
 	if (newRound != curRound && newRound != GAME_STATE_POST_RIVER) {
 		if (newRound <= curRound)
 			throw ServerException(__FILE__, __LINE__, ERR_NET_INVALID_GAME_ROUND, 0);
 
-		// Retrieve non-fold players. If only one player is left, no cards are shown.
-		list<boost::shared_ptr<PlayerInterface> > nonFoldPlayers = *curGame.getActivePlayerList();
-		nonFoldPlayers.remove_if(boost::bind(&PlayerInterface::getMyAction, _1) == PLAYER_ACTION_FOLD);
+		// Count non-fold players. If only one player is left, no cards are shown.
+		PlayerList activePlayers = curGame.getActivePlayerList();
+		PlayerListConstIterator i = activePlayers->begin();
+		PlayerListConstIterator end = activePlayers->end();
+		size_t numNonFoldPlayers = 0;
+		while (i != end) {
+			if ((*i)->getMyAction() != PLAYER_ACTION_FOLD)
+				numNonFoldPlayers++;
+			++i;
+		}
 
 		if (curGame.getCurrentHand()->getAllInCondition()
 				&& !curGame.getCurrentHand()->getCardsShown()
-				&& nonFoldPlayers.size() > 1) {
+				&& numNonFoldPlayers > 1) {
 			// Send cards of all active players to all players (all in).
 			boost::shared_ptr<NetPacket> allIn(new NetPacket);
 			allIn->GetMsg()->set_messagetype(PokerTHMessage::Type_GameMessage);
@@ -978,17 +1021,15 @@ ServerGameStateHand::EngineLoop(boost::shared_ptr<ServerGame> server)
 			netEngine->set_messagetype(GameEngineMessage::Type_AllInShowCardsMessage);
 			AllInShowCardsMessage *netAllInShow = netEngine->mutable_allinshowcardsmessage();
 
-			PlayerListConstIterator i = nonFoldPlayers.begin();
-			PlayerListConstIterator end = nonFoldPlayers.end();
-
-			while (i != end) {
+			for (i = activePlayers->begin(); i != end; ++i) {
+				if ((*i)->getMyAction() == PLAYER_ACTION_FOLD)
+					continue;
 				AllInShowCardsMessage::PlayerAllIn *playerAllIn = netAllInShow->add_playersallin();
 				playerAllIn->set_playerid((*i)->getMyUniqueID());
 				int tmpCards[2];
 				(*i)->getMyHoleCards(tmpCards);
 				playerAllIn->set_allincard1(tmpCards[0]);
 				playerAllIn->set_allincard2(tmpCards[1]);
-				++i;
 			}
 			server->SendToAllPlayers(allIn, SessionData::Game | SessionData::Spectating);
 			curGame.getCurrentHand()->setCardsShown(true);
@@ -1000,7 +1041,7 @@ ServerGameStateHand::EngineLoop(boost::shared_ptr<ServerGame> server)
 				boost::bind(
 					&ServerGameStateHand::TimerShowCards, this, boost::asio::placeholders::error, server));
 		} else {
-			SendNewRoundCards(*server, curGame, newRound);
+			SendNewRoundCards(*server, newRound, newRoundCards);
 
 			server->GetStateTimer1().expires_from_now(
 				seconds(GetDealCardsDelaySec(*server)));
@@ -1035,6 +1076,8 @@ ServerGameStateHand::EngineLoop(boost::shared_ptr<ServerGame> server)
 
 			// If the player is computer controlled, let the engine act.
 			if (curPlayer->getMyType() == PLAYER_TYPE_COMPUTER) {
+				StartComputerDecision(server, curPlayer);
+
 				server->GetStateTimer1().expires_from_now(
 					seconds(server->GetServerDelayTime().getComputerActionDelay()));
 
@@ -1140,8 +1183,11 @@ void
 ServerGameStateHand::TimerShowCards(const boost::system::error_code &ec, boost::shared_ptr<ServerGame> server)
 {
 	if (!ec && &server->GetState() == this) {
+		ServerMetrics::AddCounter(METRIC_TIMER_CALLBACKS);
 		Game &curGame = server->GetGame();
-		SendNewRoundCards(*server, curGame, curGame.getCurrentHand()->getCurrentRound());
+		int cards[5];
+		curGame.getCurrentHand()->getBoard()->getMyCards(cards);
+		SendNewRoundCards(*server, curGame.getCurrentHand()->getCurrentRound(), cards);
 
 		server->GetStateTimer1().expires_from_now(
 			seconds(GetDealCardsDelaySec(*server)));
@@ -1155,21 +1201,113 @@ void
 ServerGameStateHand::TimerComputerAction(const boost::system::error_code &ec, boost::shared_ptr<ServerGame> server)
 {
 	if (!ec && &server->GetState() == this) {
+		ServerMetrics::AddCounter(METRIC_TIMER_CALLBACKS);
+		ComputerDecision &decision = server->GetComputerDecision();
+		if (decision.oddsPending) {
+			// The workers are busy, wait a little longer before falling back.
+			decision.waitingForOdds = true;
+			server->GetStateTimer1().expires_from_now(
+				milliseconds(SERVER_COMPUTER_DECISION_DEADLINE_MSEC));
+			server->GetStateTimer1().async_wait(
+				boost::bind(
+					&ServerGameStateHand::TimerComputerDeadline, this, boost::asio::placeholders::error, server));
+		} else {
+			PerformComputerAction(server);
+		}
+	}
+}
+
+void
+ServerGameStateHand::TimerComputerDeadline(const boost::system::error_code &ec, boost::shared_ptr<ServerGame> server)
+{
+	ComputerDecision &decision = server->GetComputerDecision();
+	if (!ec && &server->GetState() == this && decision.waitingForOdds) {
+		ServerMetrics::AddCounter(METRIC_TIMER_CALLBACKS);
+		ServerMetrics::AddCounter(METRIC_COMPUTER_DEADLINE_MISSES);
+		// Ignore the late result.
+		decision.oddsPending = false;
+		decision.waitingForOdds = false;
 		try {
-			boost::shared_ptr<PlayerInterface> curPlayer = server->GetGame().getCurrentPlayer();
+			Game &curGame = server->GetGame();
+			boost::shared_ptr<PlayerInterface> curPlayer = curGame.getCurrentPlayer();
 			if (!curPlayer)
 				throw ServerException(__FILE__, __LINE__, ERR_NET_NO_CURRENT_PLAYER, 0);
 
-			curPlayer->action();
-			SendPlayerAction(*server, curPlayer);
+			LOG_VERBOSE("Game " << server->GetId() << " - Computer player " << curPlayer->getMyUniqueID() << " missed the decision deadline.");
+			if (curGame.getCurrentHand()->getCurrentBeRo()->getHighestSet() == curPlayer->getMySet())
+				PerformPlayerAction(*server, curPlayer, PLAYER_ACTION_CHECK, 0);
+			else
+				PerformPlayerAction(*server, curPlayer, PLAYER_ACTION_FOLD, 0);
 			EngineLoop(server);
 		} catch (const PokerTHException &e) {
-			LOG_ERROR("Game " << server->GetId() << " - Computer timer exception: " << e.what());
+			LOG_ERROR("Game " << server->GetId() << " - Computer deadline exception: " << e.what());
 			server->RemoveAllSessions(); // Close this game on error.
 		}
 	}
 }
 
+void
+ServerGameStateHand::StartComputerDecision(boost::shared_ptr<ServerGame> server, boost::shared_ptr<PlayerInterface> player)
+{
+	HandInterface *curHand = server->GetGame().getCurrentHand().get();
+	ComputerDecision &decision = server->GetComputerDecision();
+	decision.id++;
+	decision.waitingForOdds = false;
+	decision.odds = -1.0;
+	// Preflop and flop odds are table lookups, only turn and river
+	// enumerate the opponent cards.
+	int round = curHand->getCurrentRound();
+	decision.oddsPending = (round == GAME_STATE_TURN || round == GAME_STATE_RIVER);
+	if (decision.oddsPending) {
+		int holeCards[2];
+		int boardCards[5];
+		player->getMyHoleCards(holeCards);
+		curHand->getBoard()->getMyCards(boardCards);
+		server->GetLobbyThread().GetAiScheduler().PostOddsJob(
+			round, holeCards, boardCards, static_cast<int>(curHand->getActivePlayerList()->size()),
+			boost::bind(&ServerGameStateHand::ComputerOddsDone, this, _1, server, decision.id));
+	}
+}
+
+void
+ServerGameStateHand::ComputerOddsDone(double odds, boost::shared_ptr<ServerGame> server, unsigned decisionId)
+{
+	ComputerDecision &decision = server->GetComputerDecision();
+	if (&server->GetState() == this && decision.id == decisionId && decision.oddsPending) {
+		decision.odds = odds;
+		decision.oddsPending = false;
+		// The action delay is already over, so do not wait for the deadline.
+		if (decision.waitingForOdds) {
+			decision.waitingForOdds = false;
+			server->GetStateTimer1().cancel();
+			PerformComputerAction(server);
+		}
+	}
+}
+
+void
+ServerGameStateHand::PerformComputerAction(boost::shared_ptr<ServerGame> server)
+{
+	TRACE_SCOPE("ServerGameStateHand::PerformComputerAction");
+	try {
+		boost::shared_ptr<PlayerInterface> curPlayer = server->GetGame().getCurrentPlayer();
+		if (!curPlayer)
+			throw ServerException(__FILE__, __LINE__, ERR_NET_NO_CURRENT_PLAYER, 0);
+
+		ComputerDecision &decision = server->GetComputerDecision();
+		if (decision.odds >= 0) {
+			curPlayer->setPrecomputedOdds(decision.odds);
+			decision.odds = -1.0;
+		}
+		curPlayer->action();
+		SendPlayerAction(*server, curPlayer);
+		EngineLoop(server);
+	} catch (const PokerTHException &e) {
+		LOG_ERROR("Game " << server->GetId() << " - Computer timer exception: " << e.what());
+		server->RemoveAllSessions(); // Close this game on error.
+	}
+}
+
 void
 ServerGameStateHand::TimerNextHand(const boost::system::error_code &ec, boost::shared_ptr<ServerGame> server)
 {
@@ -1230,6 +1368,9 @@ ServerGameStateHand::StartNewHand(boost::shared_ptr<ServerGame> server)
 {
 	Game &curGame = server->GetGame();
 
+	// The game data of the previous hand is outdated.
+	server->SetGameDataSnapshot(boost::shared_ptr<NetPacket>());
+
 	// Reactivate players which were previously inactive.
 	ReactivatePlayers(server);
 
@@ -1243,62 +1384,64 @@ ServerGameStateHand::StartNewHand(boost::shared_ptr<ServerGame> server)
 	// Kick inactive players.
 	CheckPlayerTimeouts(server);
 
-	// Initialize hand.
+	// Initialize hand. The hand start is sent from the player state below,
+	// the events of the deal are not needed.
 	curGame.initHand();
-
-	// HACK: Skip GUI notification run
-	curGame.getCurrentHand()->getFlop()->skipFirstRunGui();
-	curGame.getCurrentHand()->getTurn()->skipFirstRunGui();
-	curGame.getCurrentHand()->getRiver()->skipFirstRunGui();
+	server->GetEngineEvents().clear();
 
 	// Consider all players, even inactive.
 	PlayerListIterator i = curGame.getSeatsList()->begin();
 	PlayerListIterator end = curGame.getSeatsList()->end();
 
-	// Send cards to all players.
-	while (i != end) {
+	// Encrypt the hole cards of all seats in one pass, using the cipher contexts
+	// which were set up at login and fixed size buffers.
+	HoleCardData seatCards[MAX_NUMBER_OF_PLAYERS];
+	unsigned numSeats = 0;
+	while (i != end && numSeats < MAX_NUMBER_OF_PLAYERS) {
 		// Also send to inactive players.
-		boost::shared_ptr<PlayerInterface> tmpPlayer = *i;
-		boost::shared_ptr<SessionData> tmpSession = server->GetSessionManager().GetSessionByUniquePlayerId(tmpPlayer->getMyUniqueID());
-		if (tmpSession) {
-			int cards[2];
-			bool errorFlag = false;
-			tmpPlayer->getMyHoleCards(cards);
-
-			boost::shared_ptr<NetPacket> notifyCards = CreateNetPacketHandStart(*server);
-			HandStartMessage *netHandStart = notifyCards->GetMsg()->mutable_gamemessage()->mutable_gameenginemessage()->mutable_handstartmessage();
-			string tmpPassword(tmpSession->AuthGetPassword());
-			if (tmpPassword.empty()) { // encrypt only if password is present
-				HandStartMessage::PlainCards *plainCards = netHandStart->mutable_plaincards();
-				plainCards->set_plaincard1(cards[0]);
-				plainCards->set_plaincard2(cards[1]);
-			} else {
-				ostringstream cardDataStream;
-				vector<unsigned char> tmpCipher;
-				cardDataStream
-						<< tmpPlayer->getMyUniqueID() << " "
-						<< server->GetId() << " "
-						<< curGame.getCurrentHandID() << " "
-						<< cards[0] << " "
-						<< cards[1];
-				if (CryptHelper::AES128Encrypt((const unsigned char *)tmpPassword.c_str(),
-											   (unsigned)tmpPassword.size(),
-											   cardDataStream.str(),
-											   tmpCipher)
-						&& !tmpCipher.empty()) {
-					netHandStart->set_encryptedcards((const char *)&tmpCipher[0], tmpCipher.size());
-				} else {
-					server->RemovePlayer(tmpPlayer->getMyUniqueID(), ERR_SOCK_INVALID_STATE);
-					errorFlag = true;
+		HoleCardData &curSeat = seatCards[numSeats];
+		curSeat.player = *i;
+		curSeat.session = server->GetSessionManager().GetSessionByUniquePlayerId(curSeat.player->getMyUniqueID());
+		if (curSeat.session) {
+			curSeat.player->getMyHoleCards(curSeat.cards);
+			curSeat.cipherSize = 0;
+			curSeat.encrypt = !curSeat.session->AuthGetPassword().empty(); // encrypt only if password is present
+			if (curSeat.encrypt) {
+				char plainData[HOLE_CARD_PLAIN_BUF_SIZE];
+				int plainSize = snprintf(plainData, sizeof(plainData), "%u %u %d %d %d",
+										 curSeat.player->getMyUniqueID(),
+										 server->GetId(),
+										 curGame.getCurrentHandID(),
+										 curSeat.cards[0],
+										 curSeat.cards[1]);
+				if (plainSize > 0 && plainSize < (int)sizeof(plainData)
+						&& curSeat.session->AuthGetCipher().Encrypt((const unsigned char *)plainData, plainSize, curSeat.cipher, sizeof(curSeat.cipher))) {
+					curSeat.cipherSize = ADD_PADDING(plainSize);
 				}
 			}
-
-			if (!errorFlag) {
-				server->GetLobbyThread().GetSender().Send(tmpSession, notifyCards);
-			}
+			numSeats++;
 		}
 		++i;
 	}
+
+	// Send cards to all players.
+	for (unsigned n = 0; n < numSeats; n++) {
+		HoleCardData &curSeat = seatCards[n];
+		if (curSeat.encrypt && !curSeat.cipherSize) {
+			server->RemovePlayer(curSeat.player->getMyUniqueID(), ERR_SOCK_INVALID_STATE);
+			continue;
+		}
+		boost::shared_ptr<NetPacket> notifyCards = CreateNetPacketHandStart(*server);
+		HandStartMessage *netHandStart = notifyCards->GetMsg()->mutable_gamemessage()->mutable_gameenginemessage()->mutable_handstartmessage();
+		if (!curSeat.encrypt) {
+			HandStartMessage::PlainCards *plainCards = netHandStart->mutable_plaincards();
+			plainCards->set_plaincard1(curSeat.cards[0]);
+			plainCards->set_plaincard2(curSeat.cards[1]);
+		} else {
+			netHandStart->set_encryptedcards((const char *)curSeat.cipher, curSeat.cipherSize);
+		}
+		server->GetLobbyThread().GetSender().Send(curSeat.session, notifyCards);
+	}
 	server->SendToAllPlayers(CreateNetPacketHandStart(*server), SessionData::Spectating);
 
 	// Start hand.
@@ -1441,6 +1584,7 @@ ServerGameStateHand::InitNewSpectators(boost::shared_ptr<ServerGame> server)
 		boost::shared_ptr<SessionData> session(server->GetSessionManager().GetSessionByUniquePlayerId(*i));
 		if (session && session->GetPlayerData()) {
 			session->SetState(SessionData::Spectating);
+			server->AddSpectatorToStream(session);
 			SendGameData(server, session);
 		}
 		++i;
@@ -1467,6 +1611,7 @@ ServerGameStateHand::PerformRejoin(boost::shared_ptr<ServerGame> server, boost::
 		netIdChanged->set_newplayerid(session->GetPlayerData()->GetUniqueId());
 		server->SendToAllButOnePlayers(packet, session->GetId(), SessionData::Game | SessionData::Spectating | SessionData::SpectatorWaiting);
 
+		UpdateGameDataSnapshotId(*server, rejoinPlayer->getMyUniqueID(), session->GetPlayerData()->GetUniqueId());
 		// Update the dealer, if necessary.
 		curGame.replaceDealer(rejoinPlayer->getMyUniqueID(), session->GetPlayerData()->GetUniqueId());
 		// Update the ranking map.
@@ -1485,31 +1630,62 @@ ServerGameStateHand::PerformRejoin(boost::shared_ptr<ServerGame> server, boost::
 void
 ServerGameStateHand::SendGameData(boost::shared_ptr<ServerGame> server, boost::shared_ptr<SessionData> session)
 {
-	Game &curGame = server->GetGame();
 	// Send game start notification to rejoining client.
-	boost::shared_ptr<NetPacket> packet(new NetPacket);
-	packet->GetMsg()->set_messagetype(PokerTHMessage::Type_GameMessage);
-	GameMessage *netGame = packet->GetMsg()->mutable_gamemessage();
-	netGame->set_gameid(server->GetId());
-	netGame->set_messagetype(GameMessage::Type_GameManagementMessage);
-	GameManagementMessage *netManage = netGame->mutable_gamemanagementmessage();
-	netManage->set_messagetype(GameManagementMessage::Type_GameStartRejoinMessage);
-	GameStartRejoinMessage *netGameStart = netManage->mutable_gamestartrejoinmessage();
-	netGameStart->set_startdealerplayerid(curGame.getDealerPosition());
-	netGameStart->set_handnum(curGame.getCurrentHandID());
-	PlayerListIterator player_i = curGame.getSeatsList()->begin();
-	PlayerListIterator player_end = curGame.getSeatsList()->end();
-	int player_count = 0;
-	while (player_i != player_end && player_count < server->GetStartData().numberOfPlayers) {
-		boost::shared_ptr<PlayerInterface> tmpPlayer = *player_i;
-		GameStartRejoinMessage::RejoinPlayerData *playerSlot = netGameStart->add_rejoinplayerdata();
-		playerSlot->set_playerid(tmpPlayer->getMyUniqueID());
-		playerSlot->set_playermoney(tmpPlayer->getMyCash());
-		++player_i;
-		++player_count;
+	// All rejoining players and new spectators receive the same encoded buffer.
+	UpdateGameDataSnapshot(*server);
+	server->GetLobbyThread().GetSender().SendEncoded(session, server->GetEncodedGameDataSnapshot(),
+			ServerMetrics::GetPacketType(*server->GetGameDataSnapshot()->GetMsg()));
+}
+
+void
+ServerGameStateHand::UpdateGameDataSnapshot(ServerGame &server)
+{
+	// The game data is built and encoded once per hand.
+	if (!server.GetGameDataSnapshot()) {
+		boost::shared_ptr<NetPacket> packet(new NetPacket);
+		Game &curGame = server.GetGame();
+		packet->GetMsg()->set_messagetype(PokerTHMessage::Type_GameMessage);
+		GameMessage *netGame = packet->GetMsg()->mutable_gamemessage();
+		netGame->set_gameid(server.GetId());
+		netGame->set_messagetype(GameMessage::Type_GameManagementMessage);
+		GameManagementMessage *netManage = netGame->mutable_gamemanagementmessage();
+		netManage->set_messagetype(GameManagementMessage::Type_GameStartRejoinMessage);
+		GameStartRejoinMessage *netGameStart = netManage->mutable_gamestartrejoinmessage();
+		netGameStart->set_startdealerplayerid(curGame.getDealerPosition());
+		netGameStart->set_handnum(curGame.getCurrentHandID());
+		PlayerListIterator player_i = curGame.getSeatsList()->begin();
+		PlayerListIterator player_end = curGame.getSeatsList()->end();
+		int player_count = 0;
+		while (player_i != player_end && player_count < server.GetStartData().numberOfPlayers) {
+			boost::shared_ptr<PlayerInterface> tmpPlayer = *player_i;
+			GameStartRejoinMessage::RejoinPlayerData *playerSlot = netGameStart->add_rejoinplayerdata();
+			playerSlot->set_playerid(tmpPlayer->getMyUniqueID());
+			playerSlot->set_playermoney(tmpPlayer->getMyCash());
+			++player_i;
+			++player_count;
+		}
+		server.SetGameDataSnapshot(packet);
 	}
+}
 
-	server->GetLobbyThread().GetSender().Send(session, packet);
+void
+ServerGameStateHand::UpdateGameDataSnapshotId(ServerGame &server, unsigned oldPlayerId, unsigned newPlayerId)
+{
+	boost::shared_ptr<NetPacket> packet(server.GetGameDataSnapshot());
+	if (packet) {
+		// Patch the ids and encode the snapshot again, previous sends already copied the old buffer.
+		GameStartRejoinMessage *netGameStart = packet->GetMsg()->mutable_gamemessage()->mutable_gamemanagementmessage()->mutable_gamestartrejoinmessage();
+		if (netGameStart->startdealerplayerid() == oldPlayerId) {
+			netGameStart->set_startdealerplayerid(newPlayerId);
+		}
+		for (int i = 0; i < netGameStart->rejoinplayerdata_size(); i++) {
+			GameStartRejoinMessage::RejoinPlayerData *playerSlot = netGameStart->mutable_rejoinplayerdata(i);
+			if (playerSlot->playerid() == oldPlayerId) {
+				playerSlot->set_playerid(newPlayerId);
+			}
+		}
+		server.SetGameDataSnapshot(packet);
+	}
 }
 
 //-----------------------------------------------------------------------------
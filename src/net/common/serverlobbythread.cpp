@@ -39,6 +39,9 @@
 #include <net/socket_msg.h>
 #include <net/chatcleanermanager.h>
 #include <net/net_helper.h>
+#include <net/servermetrics.h>
+#include <net/servermetricshelper.h>
+#include <net/serveraischeduler.h>
 #include <db/serverdbinterface.h>
 #ifdef POKERTH_OFFICIAL_SERVER
 #include <dbofficial/serverdbfactoryinternal.h>
@@ -47,6 +50,7 @@
 #endif
 #include <core/avatarmanager.h>
 #include <core/loghelper.h>
+#include <core/tracehelper.h>
 #include <core/openssl_wrapper.h>
 #include <configfile.h>
 #include <playerinterface.h>
@@ -71,6 +75,7 @@
 #define SERVER_REMOVE_GAME_INTERVAL_MSEC			500
 #define SERVER_REMOVE_PLAYER_INTERVAL_MSEC			100
 #define SERVER_UPDATE_LOGIN_LOCK_INTERVAL_MSEC		1000
+#define SERVER_CLEANUP_AVATAR_CACHE_INTERVAL_SEC	600
 #define SERVER_PROCESS_SEND_INTERVAL_MSEC			10
 
 #define SERVER_INIT_LOGIN_CLIENT_LOCK_SEC			NetHelper::GetLoginLockSec()
@@ -85,6 +90,7 @@
 #define SERVER_ADDRESS_LOCALHOST_STR				"::1"
 
 #define SERVER_STATISTICS_FILE_NAME					"server_statistics.log"
+#define SERVER_TRACE_FILE_PREFIX					"server_trace_"
 #define SERVER_STATISTICS_STR_TOTAL_PLAYERS			"TotalNumPlayersLoggedIn"
 #define SERVER_STATISTICS_STR_TOTAL_GAMES			"TotalNumGamesCreated"
 #define SERVER_STATISTICS_STR_MAX_GAMES				"MaxGamesOpen"
@@ -173,26 +179,31 @@ public:
 
 	virtual void PlayerLoginSuccess(unsigned requestId, boost::shared_ptr<DBPlayerData> dbPlayerData)
 	{
+		TRACE_SCOPE("DB PlayerLoginSuccess");
 		m_server.UserValid(requestId, *dbPlayerData);
 	}
 
 	virtual void PlayerLoginFailed(unsigned requestId)
 	{
+		TRACE_SCOPE("DB PlayerLoginFailed");
 		m_server.UserInvalid(requestId);
 	}
 
 	virtual void PlayerLoginBlocked(unsigned requestId)
 	{
+		TRACE_SCOPE("DB PlayerLoginBlocked");
 		m_server.UserBlocked(requestId);
 	}
 
 	virtual void AvatarIsBlacklisted(unsigned requestId)
 	{
+		TRACE_SCOPE("DB AvatarIsBlacklisted");
 		m_server.AvatarBlacklisted(requestId);
 	}
 
 	virtual void AvatarIsOK(unsigned requestId)
 	{
+		TRACE_SCOPE("DB AvatarIsOK");
 		m_server.AvatarOK(requestId);
 	}
 
@@ -209,36 +220,43 @@ public:
 
 	virtual void ReportAvatarSuccess(unsigned requestId, unsigned replyId)
 	{
+		TRACE_SCOPE("DB ReportAvatarSuccess");
 		m_server.SendReportAvatarResult(requestId, replyId, true);
 	}
 
 	virtual void ReportAvatarFailed(unsigned requestId, unsigned replyId)
 	{
+		TRACE_SCOPE("DB ReportAvatarFailed");
 		m_server.SendReportAvatarResult(requestId, replyId, false);
 	}
 
 	virtual void ReportGameSuccess(unsigned requestId, unsigned replyId)
 	{
+		TRACE_SCOPE("DB ReportGameSuccess");
 		m_server.SendReportGameResult(requestId, replyId, true);
 	}
 
 	virtual void ReportGameFailed(unsigned requestId, unsigned replyId)
 	{
+		TRACE_SCOPE("DB ReportGameFailed");
 		m_server.SendReportGameResult(requestId, replyId, false);
 	}
 
 	virtual void PlayerAdminList(unsigned /*requestId*/, std::list<DB_id> adminList)
 	{
+		TRACE_SCOPE("DB PlayerAdminList");
 		m_server.GetBanManager().SetAdminPlayerIds(adminList);
 	}
 
 	virtual void BlockPlayerSuccess(unsigned requestId, unsigned replyId)
 	{
+		TRACE_SCOPE("DB BlockPlayerSuccess");
 		m_server.SendAdminBanPlayerResult(requestId, replyId, true);
 	}
 
 	virtual void BlockPlayerFailed(unsigned requestId, unsigned replyId)
 	{
+		TRACE_SCOPE("DB BlockPlayerFailed");
 		m_server.SendAdminBanPlayerResult(requestId, replyId, false);
 	}
 
@@ -252,13 +270,14 @@ ServerLobbyThread::ServerLobbyThread(GuiInterface &gui, ServerMode mode, ServerI
 	: m_ioService(ioService), m_authContext(NULL), m_gui(gui), m_ircBotCb(ircBotCb), m_avatarManager(avatarManager),
 	  m_mode(mode), m_serverConfig(serverConfig), m_curGameId(0), m_curUniquePlayerId(0), m_curSessionId(INVALID_SESSION + 1),
 	  m_statDataChanged(false), m_removeGameTimer(*ioService),
-	  m_saveStatisticsTimer(*ioService), m_loginLockTimer(*ioService),
+	  m_saveStatisticsTimer(*ioService), m_loginLockTimer(*ioService), m_avatarCleanupTimer(*ioService),
 	  m_startTime(boost::posix_time::second_clock::local_time())
 {
 	m_internalServerCallback.reset(new InternalServerCallback(*this));
 	m_sender.reset(new SenderHelper(m_ioService));
 	m_banManager.reset(new ServerBanManager(m_ioService));
 	m_chatCleanerManager.reset(new ChatCleanerManager(*m_internalServerCallback, m_ioService));
+	m_aiScheduler.reset(new ServerAiScheduler(m_ioService));
 	DBFactory dbFactory;
 	m_database = dbFactory.CreateServerDBObject(*m_internalServerCallback, m_ioService);
 }
@@ -270,6 +289,7 @@ ServerLobbyThread::~ServerLobbyThread()
 void
 ServerLobbyThread::Init(const string &logDir)
 {
+	m_logDir = logDir;
 	// Read previous server statistics.
 	if (!logDir.empty()) {
 		boost::filesystem::path logPath(logDir);
@@ -302,6 +322,7 @@ ServerLobbyThread::AddConnection(boost::shared_ptr<SessionData> sessionData)
 {
 	// Create a new session.
 	m_sessionManager.AddSession(sessionData);
+	ServerMetrics::AddCounter(METRIC_CONNECTIONS_ACCEPTED);
 
 	LOG_VERBOSE("Accepted connection - session #" << sessionData->GetId() << ".");
 
@@ -420,6 +441,7 @@ ServerLobbyThread::CloseSession(boost::shared_ptr<SessionData> session)
 {
 	if (session && session->GetState() != SessionData::Closed) { // Make this call reentrant.
 		LOG_VERBOSE("Closing session #" << session->GetId() << ".");
+		ServerMetrics::AddCounter(METRIC_CONNECTIONS_CLOSED);
 
 		boost::shared_ptr<ServerGame> tmpGame = session->GetGame();
 		if (tmpGame) {
@@ -756,6 +778,46 @@ ServerLobbyThread::GetStats() const
 	return m_statData;
 }
 
+void
+ServerLobbyThread::WriteMetrics(ostream &o) const
+{
+	ServerStats stats = GetStats();
+	unsigned numActiveTimers = 0;
+	GameMap::const_iterator i = m_gameMap.begin();
+	GameMap::const_iterator end = m_gameMap.end();
+	while (i != end) {
+		numActiveTimers += i->second->GetNumActiveTimers();
+		++i;
+	}
+	o << "# TYPE pokerth_players_logged_in gauge\n"
+	  << "pokerth_players_logged_in " << stats.numberOfPlayersOnServer << "\n"
+	  << "# TYPE pokerth_games_open gauge\n"
+	  << "pokerth_games_open " << stats.numberOfGamesOpen << "\n"
+	  << "# TYPE pokerth_lobby_sessions gauge\n"
+	  << "pokerth_lobby_sessions " << m_sessionManager.GetRawSessionCount() << "\n"
+	  << "# TYPE pokerth_game_sessions gauge\n"
+	  << "pokerth_game_sessions " << m_gameSessionManager.GetRawSessionCount() << "\n"
+	  << "# TYPE pokerth_game_timers_active gauge\n"
+	  << "pokerth_game_timers_active " << numActiveTimers << "\n"
+	  << "# TYPE pokerth_uptime_seconds gauge\n"
+	  << "pokerth_uptime_seconds " << (boost::posix_time::second_clock::local_time() - m_startTime).total_seconds() << "\n";
+}
+
+bool
+ServerLobbyThread::DumpTrace(unsigned lastSeconds, string &outFileName) const
+{
+	bool retVal = false;
+	if (!m_logDir.empty()) {
+		ostringstream fileName;
+		fileName << SERVER_TRACE_FILE_PREFIX << boost::posix_time::to_iso_string(boost::posix_time::second_clock::local_time()) << ".json";
+		boost::filesystem::path tracePath(m_logDir);
+		tracePath /= fileName.str();
+		outFileName = tracePath.directory_string();
+		retVal = tracehelper_dump(outFileName, lastSeconds);
+	}
+	return retVal;
+}
+
 boost::posix_time::ptime
 ServerLobbyThread::GetStartTime() const
 {
@@ -795,6 +857,13 @@ ServerLobbyThread::GetBanManager()
 	return *m_banManager;
 }
 
+ServerAiScheduler &
+ServerLobbyThread::GetAiScheduler()
+{
+	assert(m_aiScheduler);
+	return *m_aiScheduler;
+}
+
 SessionDataCallback &
 ServerLobbyThread::GetSessionDataCallback()
 {
@@ -835,6 +904,9 @@ ServerLobbyThread::Main()
 		InitAuthContext();
 
 		InitChatCleaner();
+		InitMetrics();
+		// Start computer player workers.
+		m_aiScheduler->Start(max(m_serverConfig.readConfigInt("ServerAiWorkerThreads"), 0));
 		// Start database engine.
 		m_database->Start();
 		// Register all timers.
@@ -847,6 +919,8 @@ ServerLobbyThread::Main()
 		GetCallback().SignalNetServerError(e.GetErrorId(), e.GetOsErrorCode());
 		LOG_ERROR("Lobby exception: " << e.what());
 	}
+	// Stop computer player workers.
+	m_aiScheduler->Stop();
 	// Clear all sessions and games.
 	m_sessionManager.Clear();
 	m_gameSessionManager.Clear();
@@ -854,6 +928,10 @@ ServerLobbyThread::Main()
 		tmpGame.second->Exit();
 	}
 	m_gameMap.clear();
+	if (m_metricsHelper) {
+		m_metricsHelper->Close();
+		m_metricsHelper.reset();
+	}
 	// Cancel pending timer callbacks.
 	CancelTimers();
 	// Stop database engine.
@@ -883,6 +961,12 @@ ServerLobbyThread::RegisterTimers()
 	m_loginLockTimer.async_wait(
 		boost::bind(
 			&ServerLobbyThread::TimerUpdateClientLoginLock, shared_from_this(), boost::asio::placeholders::error));
+	// Clean up avatar uploads and write the avatar cache index.
+	m_avatarCleanupTimer.expires_from_now(
+		seconds(SERVER_CLEANUP_AVATAR_CACHE_INTERVAL_SEC));
+	m_avatarCleanupTimer.async_wait(
+		boost::bind(
+			&ServerLobbyThread::TimerCleanupAvatarCache, shared_from_this(), boost::asio::placeholders::error));
 }
 
 void
@@ -891,6 +975,7 @@ ServerLobbyThread::CancelTimers()
 	m_removeGameTimer.cancel();
 	m_saveStatisticsTimer.cancel();
 	m_loginLockTimer.cancel();
+	m_avatarCleanupTimer.cancel();
 }
 
 void
@@ -926,10 +1011,23 @@ ServerLobbyThread::InitChatCleaner()
 	}
 }
 
+void
+ServerLobbyThread::InitMetrics()
+{
+	int metricsPort = m_serverConfig.readConfigInt("ServerMetricsPort");
+	if (metricsPort > 0) {
+		m_metricsHelper.reset(new ServerMetricsHelper(m_ioService, shared_from_this()));
+		if (!m_metricsHelper->Listen(m_serverConfig.readConfigString("ServerMetricsAddress"), metricsPort))
+			m_metricsHelper.reset();
+	}
+}
+
 void
 ServerLobbyThread::DispatchPacket(boost::shared_ptr<SessionData> session, boost::shared_ptr<NetPacket> packet)
 {
 	if (session) {
+		ServerMetricsTimer handlerTimer(METRIC_HANDLER_USEC);
+		ServerMetrics::AddPacketIn(*packet->GetMsg());
 		if (packet->IsClientActivity()) {
 			session->ResetActivityTimer();
 		}
@@ -938,6 +1036,7 @@ ServerLobbyThread::DispatchPacket(boost::shared_ptr<SessionData> session, boost:
 		if (game && packet->GetMsg()->messagetype() == PokerTHMessage::Type_GameMessage) {
 			// We need to catch game-specific exceptions, so that they do not affect the server.
 			try {
+				TRACE_SCOPE("ServerGame::HandleGameMsg");
 				game->HandleGameMsg(session, packet->GetMsg()->gamemessage());
 			} catch (const PokerTHException &e) {
 				LOG_ERROR("Game " << game->GetId() << " - Read handler exception: " << e.what());
@@ -951,6 +1050,7 @@ ServerLobbyThread::DispatchPacket(boost::shared_ptr<SessionData> session, boost:
 void
 ServerLobbyThread::HandlePacket(boost::shared_ptr<SessionData> session, boost::shared_ptr<NetPacket> packet)
 {
+	TRACE_SCOPE("ServerLobbyThread::HandlePacket");
 	if (session && packet) {
 		if (packet->IsClientActivity())
 			session->ResetActivityTimer();
@@ -1311,12 +1411,11 @@ ServerLobbyThread::HandleNetPacketRetrieveAvatar(boost::shared_ptr<SessionData>
 {
 	bool avatarFound = false;
 
-	string tmpFile;
 	MD5Buf tmpMD5;
 	memcpy(tmpMD5.GetData(), retrieveAvatar.avatarhash().data(), MD5_DATA_SIZE);
-	if (GetAvatarManager().GetAvatarFileName(tmpMD5, tmpFile)) {
+	if (GetAvatarManager().HasAvatar(tmpMD5)) {
 		NetPacketList tmpPackets;
-		if (GetAvatarManager().AvatarFileToNetPackets(tmpFile, retrieveAvatar.requestid(), tmpPackets) == 0) {
+		if (GetAvatarManager().AvatarToNetPackets(tmpMD5, retrieveAvatar.requestid(), tmpPackets) == 0) {
 			avatarFound = true;
 			GetSender().Send(session, tmpPackets);
 		} else
@@ -2424,6 +2523,22 @@ ServerLobbyThread::TimerSaveStatisticsFile(const boost::system::error_code &ec)
 	}
 }
 
+void
+ServerLobbyThread::TimerCleanupAvatarCache(const boost::system::error_code &ec)
+{
+	if (!ec) {
+		LOG_VERBOSE("Cleaning up avatar cache.");
+		// The disk work is done on the cache thread of the avatar manager.
+		GetAvatarManager().StartCacheCleanup();
+		// Restart timer
+		m_avatarCleanupTimer.expires_from_now(
+			seconds(SERVER_CLEANUP_AVATAR_CACHE_INTERVAL_SEC));
+		m_avatarCleanupTimer.async_wait(
+			boost::bind(
+				&ServerLobbyThread::TimerCleanupAvatarCache, shared_from_this(), boost::asio::placeholders::error));
+	}
+}
+
 ServerCallback &
 ServerLobbyThread::GetCallback()
 {
@@ -39,6 +39,8 @@
 #include <net/socket_msg.h>
 #include <net/socket_startup.h>
 #include <net/serverircbotcallback.h>
+#include <net/websocketdeflate.h>
+#include <config/configfile.h>
 #include <core/loghelper.h>
 
 #include <boost/bind.hpp>
@@ -95,6 +97,13 @@ ServerManager::Init(unsigned serverPort, unsigned websocketPort, bool ipv6, int
 			m_acceptHelperPool.push_back(sctpAcceptHelper);
 		}*/
 	if (proto & TRANSPORT_PROTOCOL_WEBSOCKET) {
+		WebSocketDeflateConfig deflateConfig;
+		deflateConfig.enabled = m_playerConfig.readConfigInt("ServerWebSocketCompression") != 0;
+		deflateConfig.windowBits = m_playerConfig.readConfigInt("ServerWebSocketDeflateWindowBits");
+		deflateConfig.memLevel = m_playerConfig.readConfigInt("ServerWebSocketDeflateMemLevel");
+		deflateConfig.minSize = m_playerConfig.readConfigInt("ServerWebSocketDeflateMinSize");
+		SetWebSocketDeflateConfig(deflateConfig);
+
 		boost::shared_ptr<ServerAcceptInterface> webAcceptHelper(
 			new ServerAcceptWebHelper(GetGui(), m_ioService, webSocketResource, webSocketOrigin));
 		webAcceptHelper->Listen(websocketPort, ipv6, logDir, m_lobbyThread);
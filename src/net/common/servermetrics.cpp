@@ -0,0 +1,303 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+
+#include <net/servermetrics.h>
+#include <third_party/protobuf/pokerth.pb.h>
+#include <boost/atomic.hpp>
+#include <boost/thread.hpp>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+typedef boost::atomic<boost::uint64_t> MetricValue;
+
+struct MetricsShard {
+	MetricsShard() : inUse(false)
+	{
+		Clear(counters, METRIC_COUNTER_COUNT);
+		Clear(&buckets[0][0], METRIC_HISTOGRAM_COUNT * SERVER_METRICS_NUM_BUCKETS);
+		Clear(sums, METRIC_HISTOGRAM_COUNT);
+		Clear(&packetsIn[0][0], METRIC_MSG_CATEGORY_COUNT * SERVER_METRICS_MAX_MSG_TYPES);
+		Clear(&packetsOut[0][0], METRIC_MSG_CATEGORY_COUNT * SERVER_METRICS_MAX_MSG_TYPES);
+	}
+
+	static void Clear(MetricValue *values, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+			values[i].store(0, boost::memory_order_relaxed);
+	}
+
+	MetricValue counters[METRIC_COUNTER_COUNT];
+	MetricValue buckets[METRIC_HISTOGRAM_COUNT][SERVER_METRICS_NUM_BUCKETS];
+	MetricValue sums[METRIC_HISTOGRAM_COUNT];
+	MetricValue packetsIn[METRIC_MSG_CATEGORY_COUNT][SERVER_METRICS_MAX_MSG_TYPES];
+	MetricValue packetsOut[METRIC_MSG_CATEGORY_COUNT][SERVER_METRICS_MAX_MSG_TYPES];
+	// Protected by the registry mutex.
+	bool inUse;
+};
+
+static const char *s_counterNames[METRIC_COUNTER_COUNT] = {
+	"pokerth_bytes_in_total",
+	"pokerth_bytes_out_total",
+	"pokerth_connections_accepted_total",
+	"pokerth_connections_closed_total",
+	"pokerth_timer_callbacks_total",
+	"pokerth_db_errors_total",
+	"pokerth_spectators_dropped_total",
+	"pokerth_computer_deadline_misses_total"
+};
+
+static const char *s_histogramNames[METRIC_HISTOGRAM_COUNT] = {
+	"pokerth_handler_latency_usec",
+	"pokerth_engine_step_usec",
+	"pokerth_db_query_usec",
+	"pokerth_send_queue_bytes"
+};
+
+static const char *s_categoryNames[METRIC_MSG_CATEGORY_COUNT] = {
+	"announce",
+	"auth",
+	"lobby",
+	"game_management",
+	"game_engine"
+};
+
+// Shards are never freed. The shard of a terminated thread keeps its values
+// and is handed to the next new thread.
+static boost::mutex s_shardMutex;
+static vector<MetricsShard *> s_shardList;
+
+static void
+ReleaseShard(MetricsShard *shard)
+{
+	boost::mutex::scoped_lock lock(s_shardMutex);
+	shard->inUse = false;
+}
+
+static boost::thread_specific_ptr<MetricsShard> s_threadShard(&ReleaseShard);
+
+static MetricsShard &
+GetThreadShard()
+{
+	MetricsShard *shard = s_threadShard.get();
+	if (!shard) {
+		boost::mutex::scoped_lock lock(s_shardMutex);
+		vector<MetricsShard *>::iterator i = s_shardList.begin();
+		vector<MetricsShard *>::iterator end = s_shardList.end();
+		while (i != end && (*i)->inUse)
+			++i;
+		if (i != end) {
+			shard = *i;
+		} else {
+			shard = new MetricsShard;
+			s_shardList.push_back(shard);
+		}
+		shard->inUse = true;
+		s_threadShard.reset(shard);
+	}
+	return *shard;
+}
+
+// Only the owning thread writes, so no atomic read-modify-write is needed.
+static inline void
+Increment(MetricValue &value, boost::uint64_t amount)
+{
+	value.store(value.load(boost::memory_order_relaxed) + amount, boost::memory_order_relaxed);
+}
+
+int
+ServerMetrics::GetPacketType(const PokerTHMessage &msg)
+{
+	int category;
+	int type;
+	switch (msg.messagetype()) {
+	case PokerTHMessage::Type_AnnounceMessage :
+		category = METRIC_MSG_ANNOUNCE;
+		type = 0;
+		break;
+	case PokerTHMessage::Type_AuthMessage :
+		category = METRIC_MSG_AUTH;
+		type = msg.authmessage().messagetype();
+		break;
+	case PokerTHMessage::Type_LobbyMessage :
+		category = METRIC_MSG_LOBBY;
+		type = msg.lobbymessage().messagetype();
+		break;
+	case PokerTHMessage::Type_GameMessage :
+		if (msg.gamemessage().messagetype() == GameMessage::Type_GameManagementMessage) {
+			category = METRIC_MSG_GAME_MANAGEMENT;
+			type = msg.gamemessage().gamemanagementmessage().messagetype();
+		} else {
+			category = METRIC_MSG_GAME_ENGINE;
+			type = msg.gamemessage().gameenginemessage().messagetype();
+		}
+		break;
+	default :
+		return -1;
+	}
+	return (type >= 0 && type < SERVER_METRICS_MAX_MSG_TYPES) ? category * SERVER_METRICS_MAX_MSG_TYPES + type : -1;
+}
+
+static MetricValue *
+GetPacketSlot(MetricValue (&packets)[METRIC_MSG_CATEGORY_COUNT][SERVER_METRICS_MAX_MSG_TYPES], int packetType)
+{
+	return packetType >= 0 ? &packets[0][0] + packetType : NULL;
+}
+
+static inline unsigned
+GetBucket(boost::uint64_t value)
+{
+	// Bucket i holds values up to 2^i, the last bucket is unbounded.
+	unsigned bucket = 0;
+	boost::uint64_t bound = 1;
+	while (value > bound && bucket < SERVER_METRICS_NUM_BUCKETS - 1) {
+		bound <<= 1;
+		++bucket;
+	}
+	return bucket;
+}
+
+void
+ServerMetrics::AddCounter(ServerMetricCounter counter, boost::uint64_t value)
+{
+	Increment(GetThreadShard().counters[counter], value);
+}
+
+void
+ServerMetrics::AddValue(ServerMetricHistogram histogram, boost::uint64_t value)
+{
+	MetricsShard &shard = GetThreadShard();
+	Increment(shard.buckets[histogram][GetBucket(value)], 1);
+	Increment(shard.sums[histogram], value);
+}
+
+void
+ServerMetrics::AddPacketIn(const PokerTHMessage &msg)
+{
+	MetricValue *slot = GetPacketSlot(GetThreadShard().packetsIn, GetPacketType(msg));
+	if (slot)
+		Increment(*slot, 1);
+}
+
+void
+ServerMetrics::AddPacketOut(const PokerTHMessage &msg)
+{
+	AddPacketOut(GetPacketType(msg));
+}
+
+void
+ServerMetrics::AddPacketOut(int packetType)
+{
+	MetricValue *slot = GetPacketSlot(GetThreadShard().packetsOut, packetType);
+	if (slot)
+		Increment(*slot, 1);
+}
+
+struct MetricsSnapshot {
+	MetricsSnapshot()
+	{
+		memset(this, 0, sizeof(MetricsSnapshot));
+	}
+
+	void Add(const MetricsShard &shard)
+	{
+		Add(counters, shard.counters, METRIC_COUNTER_COUNT);
+		Add(&buckets[0][0], &shard.buckets[0][0], METRIC_HISTOGRAM_COUNT * SERVER_METRICS_NUM_BUCKETS);
+		Add(sums, shard.sums, METRIC_HISTOGRAM_COUNT);
+		Add(&packetsIn[0][0], &shard.packetsIn[0][0], METRIC_MSG_CATEGORY_COUNT * SERVER_METRICS_MAX_MSG_TYPES);
+		Add(&packetsOut[0][0], &shard.packetsOut[0][0], METRIC_MSG_CATEGORY_COUNT * SERVER_METRICS_MAX_MSG_TYPES);
+	}
+
+	static void Add(boost::uint64_t *sum, const MetricValue *values, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+			sum[i] += values[i].load(boost::memory_order_relaxed);
+	}
+
+	boost::uint64_t counters[METRIC_COUNTER_COUNT];
+	boost::uint64_t buckets[METRIC_HISTOGRAM_COUNT][SERVER_METRICS_NUM_BUCKETS];
+	boost::uint64_t sums[METRIC_HISTOGRAM_COUNT];
+	boost::uint64_t packetsIn[METRIC_MSG_CATEGORY_COUNT][SERVER_METRICS_MAX_MSG_TYPES];
+	boost::uint64_t packetsOut[METRIC_MSG_CATEGORY_COUNT][SERVER_METRICS_MAX_MSG_TYPES];
+};
+
+static void
+WritePackets(ostream &o, const char *name, const boost::uint64_t (&packets)[METRIC_MSG_CATEGORY_COUNT][SERVER_METRICS_MAX_MSG_TYPES])
+{
+	o << "# TYPE " << name << " counter\n";
+	for (int category = 0; category < METRIC_MSG_CATEGORY_COUNT; category++) {
+		for (int type = 0; type < SERVER_METRICS_MAX_MSG_TYPES; type++) {
+			if (packets[category][type])
+				o << name << "{category=\"" << s_categoryNames[category] << "\",type=\"" << type << "\"} " << packets[category][type] << "\n";
+		}
+	}
+}
+
+void
+ServerMetrics::WriteText(ostream &o)
+{
+	MetricsSnapshot snapshot;
+	{
+		boost::mutex::scoped_lock lock(s_shardMutex);
+		vector<MetricsShard *>::const_iterator i = s_shardList.begin();
+		vector<MetricsShard *>::const_iterator end = s_shardList.end();
+		while (i != end) {
+			snapshot.Add(**i);
+			++i;
+		}
+	}
+
+	for (int c = 0; c < METRIC_COUNTER_COUNT; c++) {
+		o << "# TYPE " << s_counterNames[c] << " counter\n";
+		o << s_counterNames[c] << " " << snapshot.counters[c] << "\n";
+	}
+
+	WritePackets(o, "pokerth_packets_in_total", snapshot.packetsIn);
+	WritePackets(o, "pokerth_packets_out_total", snapshot.packetsOut);
+
+	for (int h = 0; h < METRIC_HISTOGRAM_COUNT; h++) {
+		const char *name = s_histogramNames[h];
+		o << "# TYPE " << name << " histogram\n";
+		boost::uint64_t count = 0;
+		boost::uint64_t bound = 1;
+		for (int b = 0; b < SERVER_METRICS_NUM_BUCKETS; b++) {
+			count += snapshot.buckets[h][b];
+			if (b < SERVER_METRICS_NUM_BUCKETS - 1)
+				o << name << "_bucket{le=\"" << bound << "\"} " << count << "\n";
+			else
+				o << name << "_bucket{le=\"+Inf\"} " << count << "\n";
+			bound <<= 1;
+		}
+		o << name << "_sum " << snapshot.sums[h] << "\n";
+		o << name << "_count " << count << "\n";
+	}
+}
@@ -0,0 +1,163 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+
+#include <net/servermetricshelper.h>
+#include <net/servermetrics.h>
+#include <net/serverlobbythread.h>
+#include <core/loghelper.h>
+
+#include <boost/bind.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <sstream>
+
+#define SERVER_METRICS_REQUEST_TIMEOUT_SEC		10
+
+using namespace std;
+using boost::asio::ip::tcp;
+
+
+ServerMetricsHelper::ServerMetricsHelper(boost::shared_ptr<boost::asio::io_service> ioService, boost::shared_ptr<ServerLobbyThread> lobbyThread)
+	: m_ioService(ioService), m_acceptor(*ioService), m_lobbyThread(lobbyThread)
+{
+}
+
+ServerMetricsHelper::~ServerMetricsHelper()
+{
+}
+
+bool
+ServerMetricsHelper::Listen(const string &address, unsigned port)
+{
+	bool retVal = false;
+	try {
+		tcp::endpoint endpoint(boost::asio::ip::address::from_string(address), port);
+		m_acceptor.open(endpoint.protocol());
+		m_acceptor.set_option(tcp::acceptor::reuse_address(true));
+		m_acceptor.bind(endpoint);
+		m_acceptor.listen();
+		StartAccept();
+		retVal = true;
+	} catch (const exception &e) {
+		LOG_ERROR("Cannot listen for metrics requests on " << address << ":" << port << ": " << e.what());
+	}
+	return retVal;
+}
+
+void
+ServerMetricsHelper::Close()
+{
+	boost::system::error_code ec;
+	m_acceptor.close(ec);
+}
+
+void
+ServerMetricsHelper::StartAccept()
+{
+	boost::shared_ptr<Request> request(new Request(*m_ioService));
+	m_acceptor.async_accept(
+		request->socket,
+		boost::bind(&ServerMetricsHelper::HandleAccept, shared_from_this(), request, boost::asio::placeholders::error));
+}
+
+void
+ServerMetricsHelper::HandleAccept(boost::shared_ptr<Request> request, const boost::system::error_code &ec)
+{
+	if (ec == boost::asio::error::operation_aborted)
+		return;
+	if (!ec) {
+		request->timer.expires_from_now(boost::posix_time::seconds(SERVER_METRICS_REQUEST_TIMEOUT_SEC));
+		request->timer.async_wait(
+			boost::bind(&ServerMetricsHelper::HandleTimeout, shared_from_this(), request, boost::asio::placeholders::error));
+		boost::asio::async_read_until(
+			request->socket, request->requestBuf, "\r\n\r\n",
+			boost::bind(&ServerMetricsHelper::HandleRead, shared_from_this(), request, boost::asio::placeholders::error));
+	}
+	StartAccept();
+}
+
+void
+ServerMetricsHelper::HandleRead(boost::shared_ptr<Request> request, const boost::system::error_code &ec)
+{
+	if (!ec) {
+		istream requestStream(&request->requestBuf);
+		string requestLine;
+		getline(requestStream, requestLine);
+		request->response = CreateResponse(requestLine);
+		boost::asio::async_write(
+			request->socket, boost::asio::buffer(request->response),
+			boost::bind(&ServerMetricsHelper::HandleWrite, shared_from_this(), request, boost::asio::placeholders::error));
+	} else {
+		request->timer.cancel();
+	}
+}
+
+void
+ServerMetricsHelper::HandleWrite(boost::shared_ptr<Request> request, const boost::system::error_code &/*ec*/)
+{
+	request->timer.cancel();
+	boost::system::error_code ec;
+	request->socket.shutdown(tcp::socket::shutdown_both, ec);
+	request->socket.close(ec);
+}
+
+void
+ServerMetricsHelper::HandleTimeout(boost::shared_ptr<Request> request, const boost::system::error_code &ec)
+{
+	if (!ec) {
+		boost::system::error_code closeEc;
+		request->socket.close(closeEc);
+	}
+}
+
+string
+ServerMetricsHelper::CreateResponse(const string &requestLine)
+{
+	ostringstream body;
+	string status;
+	if (boost::algorithm::starts_with(requestLine, "GET /metrics ") || boost::algorithm::starts_with(requestLine, "GET / ")) {
+		status = "200 OK";
+		// This handler runs on the lobby thread, so the lobby data can be read directly.
+		m_lobbyThread->WriteMetrics(body);
+		ServerMetrics::WriteText(body);
+	} else {
+		status = "404 Not Found";
+		body << "Not found.\n";
+	}
+	string bodyStr(body.str());
+	ostringstream response;
+	response
+			<< "HTTP/1.0 " << status << "\r\n"
+			<< "Content-Type: text/plain; version=0.0.4\r\n"
+			<< "Content-Length: " << bodyStr.size() << "\r\n"
+			<< "Connection: close\r\n\r\n"
+			<< bodyStr;
+	return response.str();
+}
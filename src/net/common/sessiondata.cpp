@@ -187,6 +187,8 @@ SessionData::AuthSetPassword(const std::string &password)
 	if (m_authSession)
 		gsasl_property_set(m_authSession, GSASL_PASSWORD, password.c_str());
 	m_password = password;
+	// Derive the hole card key once per session, not once per hand.
+	m_cipher.Init((const unsigned char *)password.c_str(), (unsigned)password.size());
 }
 
 string
@@ -195,6 +197,12 @@ SessionData::AuthGetPassword() const
 	return m_password;
 }
 
+AES128Context &
+SessionData::AuthGetCipher()
+{
+	return m_cipher;
+}
+
 string
 SessionData::AuthGetNextOutMsg() const
 {
@@ -0,0 +1,158 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+
+#include <net/spectatorstream.h>
+#include <net/senderhelper.h>
+#include <net/netpacket.h>
+#include <net/servermetrics.h>
+
+using namespace std;
+
+
+SpectatorStream::SpectatorStream()
+	: m_firstSeq(0)
+{
+}
+
+SpectatorStream::~SpectatorStream()
+{
+}
+
+void
+SpectatorStream::AddSpectator(boost::shared_ptr<SessionData> session)
+{
+	boost::mutex::scoped_lock lock(m_streamMutex);
+	Cursor &cursor = m_cursorMap[session->GetId()];
+	cursor.session = session;
+	cursor.nextSeq = GetEndSeq();
+}
+
+void
+SpectatorStream::RemoveSpectator(SessionId sessionId)
+{
+	boost::mutex::scoped_lock lock(m_streamMutex);
+	m_cursorMap.erase(sessionId);
+	TrimLog();
+}
+
+void
+SpectatorStream::Clear()
+{
+	boost::mutex::scoped_lock lock(m_streamMutex);
+	m_cursorMap.clear();
+	m_firstSeq += (unsigned)m_log.size();
+	m_log.clear();
+}
+
+void
+SpectatorStream::Append(const NetPacket &packet, SessionId except)
+{
+	boost::mutex::scoped_lock lock(m_streamMutex);
+	if (!m_cursorMap.empty()) {
+		// Serialize only once for all spectators.
+		m_log.push_back(Frame());
+		Frame &frame = m_log.back();
+		packet.GetMsg()->SerializeToString(&frame.data);
+		frame.packetType = ServerMetrics::GetPacketType(*packet.GetMsg());
+		frame.except = except;
+	}
+}
+
+bool
+SpectatorStream::Pump(SenderHelper &sender, SessionList &lostSessions)
+{
+	boost::mutex::scoped_lock lock(m_streamMutex);
+	bool retVal = false;
+	unsigned endSeq = GetEndSeq();
+
+	CursorMap::iterator i = m_cursorMap.begin();
+	CursorMap::iterator end = m_cursorMap.end();
+	while (i != end) {
+		CursorMap::iterator cur = i++;
+		Cursor &cursor = cur->second;
+		boost::shared_ptr<SessionData> session(cursor.session.lock());
+		if (!session || session->GetState() != SessionData::Spectating) {
+			m_cursorMap.erase(cur);
+			continue;
+		}
+		if (cursor.nextSeq < m_firstSeq) {
+			// Frames were dropped before this spectator received them.
+			lostSessions.push_back(session);
+			m_cursorMap.erase(cur);
+			ServerMetrics::AddCounter(METRIC_SPECTATORS_DROPPED);
+			continue;
+		}
+		// Do not let the send queue grow, the spectator lags behind instead.
+		while (cursor.nextSeq < endSeq && sender.GetQueuedBytes(session) < SPECTATOR_STREAM_MAX_QUEUED_BYTES) {
+			SendFrame(sender, session, cursor.nextSeq);
+			cursor.nextSeq++;
+		}
+		if (cursor.nextSeq < endSeq) {
+			retVal = true;
+		}
+	}
+	TrimLog();
+	return retVal;
+}
+
+unsigned
+SpectatorStream::GetNumSpectators() const
+{
+	boost::mutex::scoped_lock lock(m_streamMutex);
+	return (unsigned)m_cursorMap.size();
+}
+
+void
+SpectatorStream::SendFrame(SenderHelper &sender, boost::shared_ptr<SessionData> session, unsigned seq)
+{
+	const Frame &frame = GetFrame(seq);
+	if (frame.except != session->GetId()) {
+		sender.SendEncoded(session, frame.data, frame.packetType);
+	}
+}
+
+void
+SpectatorStream::TrimLog()
+{
+	unsigned minSeq = GetEndSeq();
+	CursorMap::const_iterator i = m_cursorMap.begin();
+	CursorMap::const_iterator end = m_cursorMap.end();
+	while (i != end) {
+		if (i->second.nextSeq < minSeq) {
+			minSeq = i->second.nextSeq;
+		}
+		++i;
+	}
+	while (!m_log.empty() && (m_firstSeq < minSeq || m_log.size() > SPECTATOR_STREAM_MAX_FRAMES)) {
+		m_log.pop_front();
+		m_firstSeq++;
+	}
+}
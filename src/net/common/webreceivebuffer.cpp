@@ -31,6 +31,7 @@
 
 #include <net/sessiondata.h>
 #include <net/webreceivebuffer.h>
+#include <net/servermetrics.h>
 #include <core/loghelper.h>
 
 using namespace std;
@@ -56,6 +57,7 @@ void
 WebReceiveBuffer::HandleMessage(boost::shared_ptr<SessionData> session, const string &msg)
 {
 	boost::shared_ptr<NetPacket> tmpPacket;
+	ServerMetrics::AddCounter(METRIC_BYTES_IN, msg.size());
 	try {
 		tmpPacket = NetPacket::Create(msg.c_str(), msg.size());
 		if (!validator.IsValidMessage(*tmpPacket->GetMsg())) {
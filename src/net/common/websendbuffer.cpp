@@ -33,12 +33,14 @@
 #include <net/websocketdata.h>
 #include <net/netpacket.h>
 #include <net/sessiondata.h>
+#include <net/servermetrics.h>
+#include <boost/chrono.hpp>
 
 using namespace std;
 
 
 WebSendBuffer::WebSendBuffer()
-	: closeAfterSend(false)
+	: closeAfterSend(false), queuedBytes(0)
 {
 }
 
@@ -53,32 +55,116 @@ WebSendBuffer::HandleWrite(boost::shared_ptr<boost::asio::ip::tcp::socket> /*soc
 {
 }
 
+size_t
+WebSendBuffer::GetQueuedBytes() const
+{
+	return queuedBytes;
+}
+
 void
 WebSendBuffer::AsyncSendNextPacket(boost::shared_ptr<SessionData> session)
 {
+	SendPendingMessages(session);
 	if (closeAfterSend) {
 //		boost::system::error_code ec;
-        std::error_code std_ec;
+		std::error_code std_ec;
 		boost::shared_ptr<WebSocketData> webData = session->GetWebData();
-        webData->webSocketServer->close(webData->webHandle, websocketpp::close::status::normal, "PokerTH server closed the connection.", std_ec);
+		webData->webSocketServer->close(webData->webHandle, websocketpp::close::status::normal, "PokerTH server closed the connection.", std_ec);
 	}
 }
 
 void
 WebSendBuffer::InternalStorePacket(boost::shared_ptr<SessionData> session, boost::shared_ptr<NetPacket> packet)
 {
+	std::error_code std_ec;
+	boost::shared_ptr<WebSocketData> webData = session->GetWebData();
+	server::connection_ptr con = webData->webSocketServer->get_con_from_hdl(webData->webHandle, std_ec);
+	if (std_ec) {
+		SetCloseAfterSend();
+		return;
+	}
+
+	// Serialize directly into the message buffer to avoid copying.
 	uint32_t packetSize = packet->GetMsg()->ByteSize();
-	google::protobuf::uint8 *buf = new google::protobuf::uint8[packetSize];
-	packet->GetMsg()->SerializeWithCachedSizesToArray(buf);
+	server::message_ptr msg = con->get_message(websocketpp::frame::opcode::BINARY, packetSize);
+	if (!msg) {
+		SetCloseAfterSend();
+		return;
+	}
+	string &payload = msg->get_raw_payload();
+	payload.resize(packetSize);
+	if (packetSize)
+		packet->GetMsg()->SerializeWithCachedSizesToArray(reinterpret_cast<google::protobuf::uint8 *>(&payload[0]));
+	// Small messages are not worth the deflate overhead.
+	msg->set_compressed(packetSize >= GetWebSocketDeflateConfig().minSize);
+	pendingMessages.push_back(msg);
+}
 
-//	boost::system::error_code ec;
-    std::error_code std_ec;
+void
+WebSendBuffer::InternalStoreEncoded(boost::shared_ptr<SessionData> session, const std::string &msgData)
+{
+	std::error_code std_ec;
 	boost::shared_ptr<WebSocketData> webData = session->GetWebData();
-    webData->webSocketServer->send(webData->webHandle, string((const char *)buf, packetSize), websocketpp::frame::opcode::BINARY, std_ec);
-    if (std_ec) {
+	server::connection_ptr con = webData->webSocketServer->get_con_from_hdl(webData->webHandle, std_ec);
+	if (std_ec) {
 		SetCloseAfterSend();
+		return;
 	}
 
-	delete[] buf;
+	server::message_ptr msg = con->get_message(websocketpp::frame::opcode::BINARY, msgData.size());
+	if (!msg) {
+		SetCloseAfterSend();
+		return;
+	}
+	msg->get_raw_payload() = msgData;
+	msg->set_compressed(msgData.size() >= GetWebSocketDeflateConfig().minSize);
+	pendingMessages.push_back(msg);
 }
 
+void
+WebSendBuffer::SendPendingMessages(boost::shared_ptr<SessionData> session)
+{
+	if (pendingMessages.empty())
+		return;
+
+	boost::shared_ptr<WebSocketData> webData = session->GetWebData();
+	std::error_code std_ec;
+	server::connection_ptr con = webData->webSocketServer->get_con_from_hdl(webData->webHandle, std_ec);
+	WebSocketStatistics tmpStats;
+	if (!std_ec) {
+		// The connection gathers all messages queued before its write handler
+		// runs, so these are written to the socket in a single operation.
+		TakeWebSocketDeflateOutput();
+		boost::chrono::thread_clock::time_point startTime = boost::chrono::thread_clock::now();
+		vector<server::message_ptr>::const_iterator i = pendingMessages.begin();
+		vector<server::message_ptr>::const_iterator end = pendingMessages.end();
+		while (i != end && !std_ec) {
+			size_t payloadSize = (*i)->get_payload().size();
+			std_ec = con->send(*i);
+			size_t compressedSize = TakeWebSocketDeflateOutput();
+			size_t wireSize = compressedSize ? compressedSize : payloadSize;
+			wireSize += wireSize < 126 ? 2 : (wireSize < 65536 ? 4 : 10);
+			tmpStats.messagesOut++;
+			tmpStats.payloadBytesOut += payloadSize;
+			tmpStats.wireBytesOut += wireSize;
+			if (compressedSize)
+				tmpStats.compressedMessagesOut++;
+			++i;
+		}
+		tmpStats.sendCpuMicroSec = boost::chrono::duration_cast<boost::chrono::microseconds>(
+										boost::chrono::thread_clock::now() - startTime).count();
+		queuedBytes = con->get_buffered_amount();
+		ServerMetrics::AddCounter(METRIC_BYTES_OUT, tmpStats.wireBytesOut);
+	}
+	if (std_ec) {
+		SetCloseAfterSend();
+	}
+	pendingMessages.clear();
+
+	boost::mutex::scoped_lock lock(webData->statsMutex);
+	webData->stats.messagesOut += tmpStats.messagesOut;
+	webData->stats.payloadBytesOut += tmpStats.payloadBytesOut;
+	webData->stats.wireBytesOut += tmpStats.wireBytesOut;
+	webData->stats.compressedMessagesOut += tmpStats.compressedMessagesOut;
+	webData->stats.sendCpuMicroSec += tmpStats.sendCpuMicroSec;
+}
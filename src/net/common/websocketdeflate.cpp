@@ -0,0 +1,80 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+
+#include <net/websocketdeflate.h>
+#include <boost/thread.hpp>
+#include <algorithm>
+
+using namespace std;
+
+static boost::mutex s_deflateConfigMutex;
+static WebSocketDeflateConfig s_deflateConfig;
+static boost::thread_specific_ptr<size_t> s_deflateOutput;
+
+
+void
+SetWebSocketDeflateConfig(const WebSocketDeflateConfig &config)
+{
+	boost::mutex::scoped_lock lock(s_deflateConfigMutex);
+	s_deflateConfig = config;
+	s_deflateConfig.windowBits = max(WEBSOCKET_DEFLATE_MIN_WINDOW_BITS, min(WEBSOCKET_DEFLATE_MAX_WINDOW_BITS, config.windowBits));
+	s_deflateConfig.memLevel = max(1, min(MAX_MEM_LEVEL, config.memLevel));
+}
+
+WebSocketDeflateConfig
+GetWebSocketDeflateConfig()
+{
+	boost::mutex::scoped_lock lock(s_deflateConfigMutex);
+	return s_deflateConfig;
+}
+
+void
+AddWebSocketDeflateOutput(size_t bytes)
+{
+	size_t *output = s_deflateOutput.get();
+	if (!output) {
+		output = new size_t(0);
+		s_deflateOutput.reset(output);
+	}
+	*output += bytes;
+}
+
+size_t
+TakeWebSocketDeflateOutput()
+{
+	size_t retVal = 0;
+	size_t *output = s_deflateOutput.get();
+	if (output) {
+		retVal = *output;
+		*output = 0;
+	}
+	return retVal;
+}
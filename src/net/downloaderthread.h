@@ -35,33 +35,42 @@
 
 #include <boost/shared_ptr.hpp>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include <core/thread.h>
 
 #define DOWNLOADER_THREAD_TERMINATE_TIMEOUT		THREAD_WAIT_INFINITE
-class DownloadHelper;
+#define DOWNLOADER_MAX_TRANSFERS				6
+#define DOWNLOADER_MAX_HOST_CONNECTIONS			4
 
+struct DownloaderData;
+
+// Downloads files into memory, several at once using one curl multi handle.
+// Connections are kept alive and reused. Requests for an url which is
+// already queued or running are attached to that download, so every
+// avatar hash is fetched only once.
 class DownloaderThread : public Thread
 {
 public:
 
-	DownloaderThread();
+	// A maxFileSize of 0 means no limit.
+	DownloaderThread(unsigned maxTransfers = DOWNLOADER_MAX_TRANSFERS,
+					 unsigned maxHostConnections = DOWNLOADER_MAX_HOST_CONNECTIONS, size_t maxFileSize = 0);
 	virtual ~DownloaderThread();
 
-	void QueueDownload(unsigned downloadId, const std::string &url, const std::string &filename);
+	void QueueDownload(unsigned downloadId, const std::string &url);
 	bool HasDownloadResult() const;
 	bool GetDownloadResult(unsigned &downloadId, std::vector<unsigned char> &filedata);
 
 protected:
 	struct DownloadData {
 		DownloadData() : id(0) {}
-		DownloadData(unsigned i, const std::string &a, const std::string &f)
-			: id(i), address(a), filename(f) {}
+		DownloadData(unsigned i, const std::string &a)
+			: id(i), address(a) {}
 
 		unsigned id;
 		std::string address;
-		std::string filename;
 	};
 	struct ResultData {
 		ResultData() : id(0) {}
@@ -78,6 +87,13 @@ protected:
 	// Main function of the thread.
 	virtual void Main();
 
+	void InitTransfers();
+	void CleanupTransfers();
+	void AcceptNewDownloads();
+	void StartWaitingDownloads();
+	void ProcessTransfers();
+	void FinishDownload(const std::string &url, bool success);
+
 private:
 
 	DownloadDataQueue m_downloadQueue;
@@ -86,11 +102,10 @@ private:
 	DownloadDoneQueue m_downloadDoneQueue;
 	mutable boost::mutex m_downloadDoneQueueMutex;
 
-	boost::shared_ptr<DownloadHelper> m_downloadHelper;
-	bool m_downloadInProgress;
-
-	boost::shared_ptr<DownloadData> m_curDownloadData;
+	boost::shared_ptr<DownloaderData> m_data;
+	const unsigned m_maxTransfers;
+	const unsigned m_maxHostConnections;
+	const size_t m_maxFileSize;
 };
 
 #endif
-
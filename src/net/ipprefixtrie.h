@@ -0,0 +1,78 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+/* Binary trie for IPv4/IPv6 address ranges (CIDR notation). */
+
+#ifndef _IPPREFIXTRIE_H_
+#define _IPPREFIXTRIE_H_
+
+#include <boost/array.hpp>
+#include <string>
+#include <vector>
+
+#define IP_ADDRESS_NUM_BYTES	16
+#define IP_ADDRESS_NUM_BITS		(IP_ADDRESS_NUM_BYTES * 8)
+
+class IPPrefixTrie
+{
+public:
+	typedef boost::array<unsigned char, IP_ADDRESS_NUM_BYTES> AddressBytes;
+
+	IPPrefixTrie();
+
+	void Clear();
+	bool IsEmpty() const;
+
+	// Add an address range like "10.0.0.0/8" or "2001:db8::/32". A plain
+	// address is added as a single host. Returns false if the range is invalid.
+	bool AddRange(const std::string &range);
+	bool Contains(const std::string &ipAddress) const;
+	bool Contains(const AddressBytes &address) const;
+
+	// IPv4 addresses are stored as IPv4-mapped IPv6 addresses, so both
+	// "1.2.3.4" and "::ffff:1.2.3.4" are parsed to the same bytes.
+	static bool ParseAddress(const std::string &ipAddress, AddressBytes &outAddress, unsigned &outIPv4PrefixOffset);
+	// Canonical text representation, IPv4-mapped addresses are returned as
+	// IPv4. Invalid addresses are returned unchanged.
+	static std::string NormalizeAddress(const std::string &ipAddress);
+
+private:
+	struct Node {
+		Node() : terminal(false) {
+			child[0] = child[1] = 0;
+		}
+		unsigned child[2];
+		bool terminal;
+	};
+
+	std::vector<Node> m_nodes;
+};
+
+#endif
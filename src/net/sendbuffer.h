@@ -36,6 +36,7 @@
 #include <net/websocket_defs.h>
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/thread.hpp>
+#include <string>
 
 class SessionData;
 class NetPacket;
@@ -49,9 +50,14 @@ public:
 
 	virtual void AsyncSendNextPacket(boost::shared_ptr<SessionData> session) = 0;
 	virtual void InternalStorePacket(boost::shared_ptr<SessionData> session, boost::shared_ptr<NetPacket> packet) = 0;
+	// Store a message which was already serialized.
+	virtual void InternalStoreEncoded(boost::shared_ptr<SessionData> session, const std::string &msgData) = 0;
 
 	virtual void HandleWrite(boost::shared_ptr<boost::asio::ip::tcp::socket> socket, const boost::system::error_code &error) = 0;
 
+	// Number of bytes not yet written to the socket.
+	virtual size_t GetQueuedBytes() const = 0;
+
 	mutable boost::mutex dataMutex;
 };
 
@@ -47,6 +47,11 @@ public:
 
 	void Send(boost::shared_ptr<SessionData> session, boost::shared_ptr<NetPacket> packet);
 	void Send(boost::shared_ptr<SessionData> session, const NetPacketList &packetList);
+	// Send a message which was already serialized, e.g. for many receivers.
+	// packetType is from ServerMetrics::GetPacketType().
+	void SendEncoded(boost::shared_ptr<SessionData> session, const std::string &msgData, int packetType);
+
+	size_t GetQueuedBytes(boost::shared_ptr<SessionData> session) const;
 
 	void SetCloseAfterSend(boost::shared_ptr<SessionData> session);
 
@@ -59,6 +59,7 @@ protected:
 	void on_open(websocketpp::connection_hdl hdl);
 	void on_close(websocketpp::connection_hdl hdl);
 	void on_message(websocketpp::connection_hdl hdl, server::message_ptr msg);
+	void LogStatistics(SessionData &session);
 
 private:
 	boost::shared_ptr<boost::asio::io_service> m_ioService;
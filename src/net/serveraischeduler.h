@@ -0,0 +1,90 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+/* Worker threads for the expensive parts of computer player decisions. */
+
+#ifndef _SERVERAISCHEDULER_H_
+#define _SERVERAISCHEDULER_H_
+
+#include <boost/asio.hpp>
+#include <boost/atomic.hpp>
+#include <boost/function.hpp>
+#include <boost/lockfree/queue.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread.hpp>
+#include <vector>
+
+// Jobs are handed to the workers through lock-free queues, one per worker.
+// A worker without jobs steals from the queues of the other workers, and
+// only sleeps if all queues are empty. The result is posted back to the
+// io service of the lobby, so games never see another thread.
+class ServerAiScheduler : private boost::noncopyable
+{
+public:
+	typedef boost::function<void (double)> OddsHandler;
+
+	ServerAiScheduler(boost::shared_ptr<boost::asio::io_service> ioService);
+	virtual ~ServerAiScheduler();
+
+	void Start(unsigned numWorkers);
+	void Stop();
+
+	// Calculates the odds of a computer player, see LocalPlayer::calcOdds.
+	// Without workers, the job is run by the io service itself.
+	void PostOddsJob(int round, const int *holeCards, const int *boardCards, int numPlayers, OddsHandler handler);
+
+protected:
+	struct Job {
+		int round;
+		int holeCards[2];
+		int boardCards[5];
+		int numPlayers;
+		OddsHandler handler;
+	};
+	typedef boost::lockfree::queue<Job *> JobQueue;
+
+	void WorkerMain(unsigned index);
+	Job *NextJob(unsigned index);
+	static void RunJob(Job *job, boost::asio::io_service &ioService);
+
+private:
+	boost::shared_ptr<boost::asio::io_service> m_ioService;
+	std::vector<boost::shared_ptr<JobQueue> > m_queues;
+	boost::thread_group m_workers;
+
+	boost::atomic<unsigned> m_nextQueue;
+	boost::atomic<unsigned> m_numPendingJobs;
+	boost::atomic<unsigned> m_numIdleWorkers;
+	boost::atomic<bool> m_terminate;
+	boost::mutex m_idleMutex;
+	boost::condition_variable m_idleCond;
+};
+
+#endif
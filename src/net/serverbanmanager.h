@@ -34,11 +34,14 @@
 #define _SERVERBANMANAGER_H_
 
 #include <db/dbdefs.h>
+#include <core/multipatternmatcher.h>
+#include <net/ipprefixtrie.h>
 #include <boost/asio.hpp>
 #include <boost/asio/steady_timer.hpp>
 #include <boost/regex.hpp>
 #include <boost/thread.hpp>
 #include <boost/enable_shared_from_this.hpp>
+#include <boost/unordered_set.hpp>
 #include <map>
 #include <list>
 #include <string>
@@ -77,6 +80,15 @@ protected:
 		std::string ipAddress;
 	};
 
+	// Lookup tables derived from the ban lists. A new snapshot is created
+	// whenever the bans change, readers do not need to lock the mutex.
+	struct BanLookup {
+		boost::unordered_set<std::string> playerNames;
+		boost::shared_ptr<boost::regex> playerRegex;
+		boost::unordered_set<std::string> ipAddresses;
+		IPPrefixTrie ipRanges;
+	};
+
 	typedef std::map<unsigned, TimedPlayerBan> RegexMap;
 	typedef std::map<unsigned, TimedIPBan> IPAddressMap;
 	typedef std::list<boost::regex> RegexList;
@@ -84,6 +96,8 @@ protected:
 
 	boost::shared_ptr<boost::asio::steady_timer> InternalRegisterTimedBan(unsigned timerId, unsigned durationHours);
 	void TimerRemoveBan(const boost::system::error_code &ec, unsigned banId, boost::shared_ptr<boost::asio::steady_timer> timer);
+	void InternalUpdateLookup();
+	boost::shared_ptr<const BanLookup> GetLookup() const;
 
 	boost::shared_ptr<boost::asio::io_service> m_ioService;
 
@@ -91,9 +105,11 @@ protected:
 
 private:
 	RegexMap m_banPlayerNameMap;
+	MultiPatternMatcher m_gameNameBadWordMatcher;
 	RegexList m_gameNameBadWordFilter;
 	IPAddressMap m_banIPAddressMap;
 	DBPlayerIdList m_adminPlayers;
+	boost::shared_ptr<const BanLookup> m_lookup;
 	unsigned m_curBanId;
 	mutable boost::mutex m_banMutex;
 };
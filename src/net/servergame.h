@@ -39,11 +39,26 @@
 #include <map>
 
 #include <net/sessionmanager.h>
+#include <net/spectatorstream.h>
 #include <net/serverdelaytime.h>
 #include <db/serverdbcallback.h>
 #include <gui/guiinterface.h>
 #include <gamedata.h>
+#include <engineevent.h>
 
+// Engine events of one engine step, with room for a complete hand start.
+#define SERVER_MAX_ENGINE_EVENTS				64
+
+// Decision of the computer player whose turn it is. The odds are
+// calculated by the ai workers while the action delay runs.
+struct ComputerDecision
+{
+	ComputerDecision() : id(0), oddsPending(false), waitingForOdds(false), odds(-1.0) {}
+	unsigned id;
+	bool oddsPending;
+	bool waitingForOdds;
+	double odds;
+};
 
 class ServerLobbyThread;
 class ServerGameState;
@@ -140,6 +155,7 @@ protected:
 	typedef std::map<unsigned, RankingData> RankingMap;
 
 	void TimerVoteKick(const boost::system::error_code &ec);
+	void TimerSpectatorStream(const boost::system::error_code &ec);
 
 	PlayerDataList InternalStartGame();
 	void InitRankingMap(const PlayerDataList &playerDataList);
@@ -167,6 +183,9 @@ protected:
 	void SessionError(boost::shared_ptr<SessionData> session, int errorCode);
 	void MoveSessionToLobby(boost::shared_ptr<SessionData> session, int reason);
 
+	void AddSpectatorToStream(boost::shared_ptr<SessionData> session);
+	void PumpSpectatorStream();
+
 	void RemoveDisconnectedPlayers();
 	int GetCurNumberOfPlayers() const;
 	void AssignPlayerNumbers(PlayerDataList &playerList);
@@ -179,11 +198,18 @@ protected:
 
 	boost::asio::steady_timer &GetStateTimer1();
 	boost::asio::steady_timer &GetStateTimer2();
+	unsigned GetNumActiveTimers() const;
 
 	const StartData &GetStartData() const;
 	void SetStartData(const StartData &startData);
 
+	boost::shared_ptr<NetPacket> GetGameDataSnapshot() const;
+	const std::string &GetEncodedGameDataSnapshot() const;
+	void SetGameDataSnapshot(boost::shared_ptr<NetPacket> packet);
+
 	GuiInterface &GetGui();
+	EngineEventBuffer &GetEngineEvents();
+	ComputerDecision &GetComputerDecision();
 
 	unsigned GetNextGameNum();
 
@@ -229,7 +255,13 @@ private:
 	const GameData		m_gameData;
 	StartData			m_startData;
 	boost::shared_ptr<Game>	 m_game;
+	EngineEvent			m_engineEventData[SERVER_MAX_ENGINE_EVENTS];
+	EngineEventBuffer	m_engineEvents;
+	ComputerDecision	m_computerDecision;
 	ServerGameState			*m_curState;
+	boost::shared_ptr<NetPacket> m_gameDataSnapshot;
+	std::string			m_encodedGameDataSnapshot;
+	SpectatorStream		m_spectatorStream;
 
 	const u_int32_t		m_id;
 	const std::string	m_name;
@@ -241,6 +273,7 @@ private:
 	boost::asio::steady_timer m_voteKickTimer;
 	boost::asio::steady_timer m_stateTimer1;
 	boost::asio::steady_timer m_stateTimer2;
+	boost::asio::steady_timer m_spectatorTimer;
 	bool				m_isNameReported;
 
 	friend class ServerLobbyThread;
@@ -192,6 +192,10 @@ protected:
 	void EngineLoop(boost::shared_ptr<ServerGame> server);
 	void TimerShowCards(const boost::system::error_code &ec, boost::shared_ptr<ServerGame> server);
 	void TimerComputerAction(const boost::system::error_code &ec, boost::shared_ptr<ServerGame> server);
+	void TimerComputerDeadline(const boost::system::error_code &ec, boost::shared_ptr<ServerGame> server);
+	void StartComputerDecision(boost::shared_ptr<ServerGame> server, boost::shared_ptr<PlayerInterface> player);
+	void ComputerOddsDone(double odds, boost::shared_ptr<ServerGame> server, unsigned decisionId);
+	void PerformComputerAction(boost::shared_ptr<ServerGame> server);
 	void TimerNextHand(const boost::system::error_code &ec, boost::shared_ptr<ServerGame> server);
 	void TimerNextGame(const boost::system::error_code &ec, boost::shared_ptr<ServerGame> server, unsigned winnerPlayerId);
 	int GetDealCardsDelaySec(ServerGame &server);
@@ -202,6 +206,8 @@ protected:
 	static void InitNewSpectators(boost::shared_ptr<ServerGame> server);
 	static void PerformRejoin(boost::shared_ptr<ServerGame> server, boost::shared_ptr<SessionData> session);
 	static void SendGameData(boost::shared_ptr<ServerGame> server, boost::shared_ptr<SessionData> session);
+	static void UpdateGameDataSnapshot(ServerGame &server);
+	static void UpdateGameDataSnapshotId(ServerGame &server, unsigned oldPlayerId, unsigned newPlayerId);
 
 private:
 	static ServerGameStateHand s_state;
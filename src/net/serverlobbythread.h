@@ -57,6 +57,8 @@ class ConfigFile;
 class AvatarManager;
 class ChatCleanerManager;
 class ServerDBInterface;
+class ServerMetricsHelper;
+class ServerAiScheduler;
 struct GameData;
 class Game;
 struct Gsasl;
@@ -114,6 +116,10 @@ public:
 	ChatCleanerManager &GetChatCleaner();
 
 	ServerStats GetStats() const;
+	// Gauges of the lobby for the metrics endpoint, call within the lobby thread.
+	void WriteMetrics(std::ostream &o) const;
+	// Write the trace events of the last seconds to the log dir.
+	bool DumpTrace(unsigned lastSeconds, std::string &outFileName) const;
 	boost::posix_time::ptime GetStartTime() const;
 	ServerMode GetServerMode() const;
 
@@ -121,6 +127,7 @@ public:
 	boost::asio::io_service &GetIOService();
 	boost::shared_ptr<ServerDBInterface> GetDatabase();
 	ServerBanManager &GetBanManager();
+	ServerAiScheduler &GetAiScheduler();
 
 	SessionDataCallback &GetSessionDataCallback();
 
@@ -141,6 +148,7 @@ protected:
 	void InitAuthContext();
 	void ClearAuthContext();
 	void InitChatCleaner();
+	void InitMetrics();
 
 	void HandlePacket(boost::shared_ptr<SessionData> session, boost::shared_ptr<NetPacket> packet);
 	void HandleNetPacketAuthClientRequest(boost::shared_ptr<SessionData> session, const AuthClientRequestMessage &clientRequest);
@@ -257,6 +265,7 @@ private:
 
 	const ServerMode m_mode;
 	std::string m_statisticsFileName;
+	std::string m_logDir;
 	ConfigFile &m_serverConfig;
 	u_int32_t m_curGameId;
 
@@ -271,10 +280,13 @@ private:
 	boost::shared_ptr<ServerBanManager> m_banManager;
 	boost::shared_ptr<ChatCleanerManager> m_chatCleanerManager;
 	boost::shared_ptr<ServerDBInterface> m_database;
+	boost::shared_ptr<ServerMetricsHelper> m_metricsHelper;
+	boost::shared_ptr<ServerAiScheduler> m_aiScheduler;
 
 	boost::asio::steady_timer m_removeGameTimer;
 	boost::asio::steady_timer m_saveStatisticsTimer;
 	boost::asio::steady_timer m_loginLockTimer;
+	boost::asio::steady_timer m_avatarCleanupTimer;
 
 	boost::uuids::random_generator m_sessionIdGenerator;
 
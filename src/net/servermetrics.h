@@ -0,0 +1,112 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+/* Runtime metrics of the server. */
+
+#ifndef _SERVERMETRICS_H_
+#define _SERVERMETRICS_H_
+
+#include <boost/cstdint.hpp>
+#include <boost/chrono.hpp>
+#include <boost/noncopyable.hpp>
+#include <ostream>
+
+class PokerTHMessage;
+
+// Latency histograms are in microseconds, the send queue histogram in bytes.
+#define SERVER_METRICS_NUM_BUCKETS			26
+#define SERVER_METRICS_MAX_MSG_TYPES		64
+
+enum ServerMetricCounter {
+	METRIC_BYTES_IN,
+	METRIC_BYTES_OUT,
+	METRIC_CONNECTIONS_ACCEPTED,
+	METRIC_CONNECTIONS_CLOSED,
+	METRIC_TIMER_CALLBACKS,
+	METRIC_DB_ERRORS,
+	METRIC_SPECTATORS_DROPPED,
+	METRIC_COMPUTER_DEADLINE_MISSES,
+	METRIC_COUNTER_COUNT
+};
+
+enum ServerMetricHistogram {
+	METRIC_HANDLER_USEC,
+	METRIC_ENGINE_STEP_USEC,
+	METRIC_DB_QUERY_USEC,
+	METRIC_SEND_QUEUE_BYTES,
+	METRIC_HISTOGRAM_COUNT
+};
+
+enum ServerMetricMsgCategory {
+	METRIC_MSG_ANNOUNCE,
+	METRIC_MSG_AUTH,
+	METRIC_MSG_LOBBY,
+	METRIC_MSG_GAME_MANAGEMENT,
+	METRIC_MSG_GAME_ENGINE,
+	METRIC_MSG_CATEGORY_COUNT
+};
+
+// Counters and histograms are kept per thread. Each thread only writes
+// its own slots without locking, a scrape sums up the slots of all threads.
+class ServerMetrics
+{
+public:
+	static void AddCounter(ServerMetricCounter counter, boost::uint64_t value = 1);
+	static void AddValue(ServerMetricHistogram histogram, boost::uint64_t value);
+	static void AddPacketIn(const PokerTHMessage &msg);
+	static void AddPacketOut(const PokerTHMessage &msg);
+	// For packets which are sent pre-serialized, the type is taken
+	// from the message once. Returns -1 if the type is not counted.
+	static int GetPacketType(const PokerTHMessage &msg);
+	static void AddPacketOut(int packetType);
+
+	// Prometheus text exposition format.
+	static void WriteText(std::ostream &o);
+};
+
+// Adds the lifetime of the object in microseconds to a histogram.
+class ServerMetricsTimer : private boost::noncopyable
+{
+public:
+	ServerMetricsTimer(ServerMetricHistogram histogram)
+		: m_histogram(histogram), m_startTime(boost::chrono::steady_clock::now()) {}
+
+	~ServerMetricsTimer()
+	{
+		ServerMetrics::AddValue(m_histogram, boost::chrono::duration_cast<boost::chrono::microseconds>(
+									boost::chrono::steady_clock::now() - m_startTime).count());
+	}
+
+private:
+	ServerMetricHistogram m_histogram;
+	boost::chrono::steady_clock::time_point m_startTime;
+};
+
+#endif
@@ -0,0 +1,77 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+/* Plain HTTP endpoint to scrape the server metrics. */
+
+#ifndef _SERVERMETRICSHELPER_H_
+#define _SERVERMETRICSHELPER_H_
+
+#include <boost/asio.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <string>
+
+class ServerLobbyThread;
+
+class ServerMetricsHelper : public boost::enable_shared_from_this<ServerMetricsHelper>
+{
+public:
+	ServerMetricsHelper(boost::shared_ptr<boost::asio::io_service> ioService, boost::shared_ptr<ServerLobbyThread> lobbyThread);
+	virtual ~ServerMetricsHelper();
+
+	// Listen on the given address, usually localhost.
+	bool Listen(const std::string &address, unsigned port);
+	void Close();
+
+protected:
+	struct Request {
+		Request(boost::asio::io_service &ioService)
+			: socket(ioService), timer(ioService), requestBuf(SERVER_METRICS_MAX_REQUEST_SIZE) {}
+		enum { SERVER_METRICS_MAX_REQUEST_SIZE = 4096 };
+		boost::asio::ip::tcp::socket socket;
+		boost::asio::deadline_timer timer;
+		boost::asio::streambuf requestBuf;
+		std::string response;
+	};
+
+	void StartAccept();
+	void HandleAccept(boost::shared_ptr<Request> request, const boost::system::error_code &ec);
+	void HandleRead(boost::shared_ptr<Request> request, const boost::system::error_code &ec);
+	void HandleWrite(boost::shared_ptr<Request> request, const boost::system::error_code &ec);
+	void HandleTimeout(boost::shared_ptr<Request> request, const boost::system::error_code &ec);
+
+	std::string CreateResponse(const std::string &requestLine);
+
+private:
+	boost::shared_ptr<boost::asio::io_service> m_ioService;
+	boost::asio::ip::tcp::acceptor m_acceptor;
+	boost::shared_ptr<ServerLobbyThread> m_lobbyThread;
+};
+
+#endif
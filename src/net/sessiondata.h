@@ -41,6 +41,7 @@ typedef unsigned SessionId;
 #include <boost/enable_shared_from_this.hpp>
 #include <string>
 
+#include <core/crypthelper.h>
 #include <net/socket_helper.h>
 #include <net/sessiondatacallback.h>
 
@@ -83,6 +84,7 @@ public:
 	std::string AuthGetUser() const;
 	void AuthSetPassword(const std::string &password);
 	std::string AuthGetPassword() const;
+	AES128Context &AuthGetCipher();
 	std::string AuthGetNextOutMsg() const;
 	int AuthGetCurStepNum() const;
 
@@ -157,6 +159,7 @@ private:
 	int								m_curAuthStep;
 	std::string						m_nextGsaslMsg;
 	std::string						m_password;
+	AES128Context					m_cipher;
 	boost::shared_ptr<PlayerData>	m_playerData;
 
 	mutable boost::mutex			m_dataMutex;
@@ -0,0 +1,114 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+/* Shared event stream for the spectators of a game. */
+
+#ifndef _SPECTATORSTREAM_H_
+#define _SPECTATORSTREAM_H_
+
+#include <boost/thread.hpp>
+#include <deque>
+#include <list>
+#include <map>
+#include <string>
+
+#include <net/sessiondata.h>
+
+// Number of frames kept in the log. Spectators falling further behind are removed.
+#define SPECTATOR_STREAM_MAX_FRAMES			1024
+// Frames are held back in the log while the send queue of a spectator is larger.
+#define SPECTATOR_STREAM_MAX_QUEUED_BYTES	16384
+
+class NetPacket;
+class SenderHelper;
+
+// Each packet for the spectators is serialized once and appended to a log.
+// Every spectator has a read position in the log and gets the frames passed
+// as long as its send queue is small. The client cannot resync the table in
+// the middle of a game, so no frames are skipped. A spectator which falls
+// out of the log is removed from the game instead.
+class SpectatorStream
+{
+public:
+	typedef std::list<boost::shared_ptr<SessionData> > SessionList;
+
+	SpectatorStream();
+	~SpectatorStream();
+
+	void AddSpectator(boost::shared_ptr<SessionData> session);
+	void RemoveSpectator(SessionId sessionId);
+	void Clear();
+
+	void Append(const NetPacket &packet, SessionId except = INVALID_SESSION);
+
+	// Pass pending frames to the spectators. Returns whether frames are still pending.
+	// Spectators which can no longer be kept in sync are returned in lostSessions.
+	bool Pump(SenderHelper &sender, SessionList &lostSessions);
+
+	unsigned GetNumSpectators() const;
+
+protected:
+	struct Frame {
+		Frame() : packetType(-1), except(INVALID_SESSION) {}
+		std::string data;
+		int packetType;
+		SessionId except;
+	};
+
+	struct Cursor {
+		Cursor() : nextSeq(0) {}
+		boost::weak_ptr<SessionData> session;
+		unsigned nextSeq;
+	};
+
+	typedef std::deque<Frame> FrameLog;
+	typedef std::map<SessionId, Cursor> CursorMap;
+
+	void SendFrame(SenderHelper &sender, boost::shared_ptr<SessionData> session, unsigned seq);
+	void TrimLog();
+
+	const Frame &GetFrame(unsigned seq) const
+	{
+		return m_log[seq - m_firstSeq];
+	}
+
+	unsigned GetEndSeq() const
+	{
+		return m_firstSeq + (unsigned)m_log.size();
+	}
+
+private:
+	FrameLog m_log;
+	unsigned m_firstSeq;
+	CursorMap m_cursorMap;
+	mutable boost::mutex m_streamMutex;
+};
+
+#endif
@@ -35,6 +35,7 @@
 
 #include <net/sendbuffer.h>
 #include <cstdlib>
+#include <vector>
 
 class WebSendBuffer : public SendBuffer
 {
@@ -45,11 +46,21 @@ public:
 
 	virtual void AsyncSendNextPacket(boost::shared_ptr<SessionData> session);
 	virtual void InternalStorePacket(boost::shared_ptr<SessionData> session, boost::shared_ptr<NetPacket> packet);
+	virtual void InternalStoreEncoded(boost::shared_ptr<SessionData> session, const std::string &msgData);
 
 	virtual void HandleWrite(boost::shared_ptr<boost::asio::ip::tcp::socket> socket, const boost::system::error_code &error);
 
+	virtual size_t GetQueuedBytes() const;
+
+protected:
+	void SendPendingMessages(boost::shared_ptr<SessionData> session);
+
 private:
 	bool closeAfterSend;
+	// Bytes buffered by the connection after the last send.
+	size_t queuedBytes;
+	// Messages stored during one handler turn, sent together.
+	std::vector<server::message_ptr> pendingMessages;
 };
 
 #endif
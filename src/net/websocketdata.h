@@ -34,11 +34,28 @@
 #define _WEBSOCKETDATA_H_
 
 #include <net/websocket_defs.h>
+#include <boost/thread.hpp>
 
 
+struct WebSocketStatistics {
+	WebSocketStatistics()
+		: messagesOut(0), payloadBytesOut(0), wireBytesOut(0), compressedMessagesOut(0),
+		  sendCpuMicroSec(0), messagesIn(0), bytesIn(0) {}
+	boost::uint64_t messagesOut;
+	boost::uint64_t payloadBytesOut;
+	boost::uint64_t wireBytesOut;
+	boost::uint64_t compressedMessagesOut;
+	boost::uint64_t sendCpuMicroSec;
+	boost::uint64_t messagesIn;
+	boost::uint64_t bytesIn;
+};
+
 struct WebSocketData {
 	boost::shared_ptr<server> webSocketServer;
 	websocketpp::connection_hdl webHandle;
+
+	mutable boost::mutex statsMutex;
+	WebSocketStatistics stats;
 };
 
 #endif
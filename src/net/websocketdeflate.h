@@ -0,0 +1,253 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+/* Server side permessage-deflate (RFC 7692) for the websocket transport. */
+
+#ifndef _WEBSOCKETDEFLATE_H_
+#define _WEBSOCKETDEFLATE_H_
+
+#include <websocketpp/http/constants.hpp>
+#include <websocketpp/extensions/extension.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/noncopyable.hpp>
+#include <zlib.h>
+#include <string>
+
+#define WEBSOCKET_DEFLATE_MIN_WINDOW_BITS	9
+#define WEBSOCKET_DEFLATE_MAX_WINDOW_BITS	15
+#define WEBSOCKET_DEFLATE_BUFFER_SIZE		4096
+
+struct WebSocketDeflateConfig {
+	WebSocketDeflateConfig()
+		: enabled(false), windowBits(WEBSOCKET_DEFLATE_MAX_WINDOW_BITS), memLevel(8), minSize(0) {}
+	bool enabled;
+	int windowBits;
+	int memLevel;
+	unsigned minSize;
+};
+
+// Process wide settings, applied to connections negotiated afterwards.
+void SetWebSocketDeflateConfig(const WebSocketDeflateConfig &config);
+WebSocketDeflateConfig GetWebSocketDeflateConfig();
+
+// Number of compressed bytes produced by the calling thread since the last call.
+void AddWebSocketDeflateOutput(std::size_t bytes);
+std::size_t TakeWebSocketDeflateOutput();
+
+template <typename config>
+class WebSocketDeflate : private boost::noncopyable
+{
+	typedef std::pair<websocketpp::lib::error_code, std::string> err_str_pair;
+
+public:
+	WebSocketDeflate()
+		: m_enabled(false), m_serverNoContextTakeover(false), m_windowBits(WEBSOCKET_DEFLATE_MAX_WINDOW_BITS),
+		  m_clientWindowBits(WEBSOCKET_DEFLATE_MAX_WINDOW_BITS), m_deflateInit(false), m_inflateInit(false)
+	{
+		m_config = GetWebSocketDeflateConfig();
+	}
+
+	~WebSocketDeflate()
+	{
+		if (m_deflateInit) {
+			deflateEnd(&m_deflateState);
+		}
+		if (m_inflateInit) {
+			inflateEnd(&m_inflateState);
+		}
+	}
+
+	bool is_implemented() const {
+		return m_config.enabled;
+	}
+
+	bool is_enabled() const {
+		return m_enabled;
+	}
+
+	err_str_pair negotiate(websocketpp::http::attribute_list const &offer) {
+		err_str_pair retVal;
+		bool serverNoContextTakeover = false;
+		bool clientNoContextTakeover = false;
+		bool serverMaxWindowBits = false;
+		bool clientMaxWindowBits = false;
+		int windowBits = m_config.windowBits;
+		int clientWindowBits = WEBSOCKET_DEFLATE_MAX_WINDOW_BITS;
+
+		// Only the first acceptable offer is used.
+		if (m_enabled)
+			retVal.first = MakeError();
+
+		websocketpp::http::attribute_list::const_iterator i = offer.begin();
+		websocketpp::http::attribute_list::const_iterator end = offer.end();
+		while (i != end && !retVal.first) {
+			if (i->first == "server_no_context_takeover" && i->second.empty()) {
+				serverNoContextTakeover = true;
+			} else if (i->first == "client_no_context_takeover" && i->second.empty()) {
+				clientNoContextTakeover = true;
+			} else if (i->first == "server_max_window_bits") {
+				// zlib cannot produce 8 bit windows, decline such an offer.
+				int bits = ParseWindowBits(i->second);
+				serverMaxWindowBits = true;
+				if (bits < WEBSOCKET_DEFLATE_MIN_WINDOW_BITS)
+					retVal.first = MakeError();
+				else if (bits < windowBits)
+					windowBits = bits;
+			} else if (i->first == "client_max_window_bits") {
+				// The client window can only be limited if the client offered it.
+				clientWindowBits = m_config.windowBits;
+				if (!i->second.empty()) {
+					int bits = ParseWindowBits(i->second);
+					if (bits < 0)
+						retVal.first = MakeError();
+					else if (bits < clientWindowBits)
+						clientWindowBits = bits;
+				}
+				clientMaxWindowBits = true;
+			} else {
+				retVal.first = MakeError();
+			}
+			++i;
+		}
+
+		if (!retVal.first) {
+			m_serverNoContextTakeover = serverNoContextTakeover;
+			m_windowBits = windowBits;
+			m_clientWindowBits = clientWindowBits;
+			if (InitStreams()) {
+				m_enabled = true;
+				retVal.second = "permessage-deflate";
+				if (m_serverNoContextTakeover)
+					retVal.second += "; server_no_context_takeover";
+				if (clientNoContextTakeover)
+					retVal.second += "; client_no_context_takeover";
+				// A smaller window needs no announcement, the client inflates any size.
+				if (serverMaxWindowBits)
+					retVal.second += "; server_max_window_bits=" + boost::lexical_cast<std::string>(m_windowBits);
+				if (clientMaxWindowBits)
+					retVal.second += "; client_max_window_bits=" + boost::lexical_cast<std::string>(m_clientWindowBits);
+			} else {
+				retVal.first = MakeError();
+			}
+		}
+		return retVal;
+	}
+
+	// Compresses one complete message. The trailing empty block which is
+	// produced by the sync flush is removed as required by RFC 7692.
+	websocketpp::lib::error_code compress(std::string const &in, std::string &out) {
+		if (!m_enabled)
+			return MakeError();
+
+		std::size_t startSize = out.size();
+		m_deflateState.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(in.data()));
+		m_deflateState.avail_in = static_cast<uInt>(in.size());
+		do {
+			m_deflateState.next_out = m_buffer;
+			m_deflateState.avail_out = WEBSOCKET_DEFLATE_BUFFER_SIZE;
+			if (deflate(&m_deflateState, Z_SYNC_FLUSH) == Z_STREAM_ERROR)
+				return MakeError();
+			out.append(reinterpret_cast<char *>(m_buffer), WEBSOCKET_DEFLATE_BUFFER_SIZE - m_deflateState.avail_out);
+		} while (m_deflateState.avail_out == 0);
+
+		if (out.size() - startSize >= 4)
+			out.resize(out.size() - 4);
+		if (m_serverNoContextTakeover)
+			deflateReset(&m_deflateState);
+		AddWebSocketDeflateOutput(out.size() - startSize);
+		return websocketpp::lib::error_code();
+	}
+
+	websocketpp::lib::error_code decompress(uint8_t const *buf, size_t len, std::string &out) {
+		if (!m_enabled)
+			return MakeError();
+
+		m_inflateState.next_in = const_cast<Bytef *>(buf);
+		m_inflateState.avail_in = static_cast<uInt>(len);
+		int ret;
+		do {
+			m_inflateState.next_out = m_buffer;
+			m_inflateState.avail_out = WEBSOCKET_DEFLATE_BUFFER_SIZE;
+			ret = inflate(&m_inflateState, Z_SYNC_FLUSH);
+			if (ret == Z_STREAM_END)
+				inflateReset(&m_inflateState); // Client finished its stream, a new one may follow.
+			else if (ret != Z_OK && ret != Z_BUF_ERROR)
+				return MakeError();
+			out.append(reinterpret_cast<char *>(m_buffer), WEBSOCKET_DEFLATE_BUFFER_SIZE - m_inflateState.avail_out);
+		} while (ret != Z_BUF_ERROR && (m_inflateState.avail_out == 0 || m_inflateState.avail_in > 0));
+		return websocketpp::lib::error_code();
+	}
+
+protected:
+	static websocketpp::lib::error_code MakeError() {
+		return websocketpp::extensions::error::make_error_code(websocketpp::extensions::error::general);
+	}
+
+	static int ParseWindowBits(const std::string &value) {
+		int retVal = -1;
+		try {
+			retVal = boost::lexical_cast<int>(value);
+		} catch (const boost::bad_lexical_cast &) {
+		}
+		if (retVal < 8 || retVal > WEBSOCKET_DEFLATE_MAX_WINDOW_BITS)
+			retVal = -1;
+		return retVal;
+	}
+
+	bool InitStreams() {
+		m_deflateState.zalloc = Z_NULL;
+		m_deflateState.zfree = Z_NULL;
+		m_deflateState.opaque = Z_NULL;
+		// Negative window bits select a raw deflate stream without header.
+		m_deflateInit = deflateInit2(&m_deflateState, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+									 -m_windowBits, m_config.memLevel, Z_DEFAULT_STRATEGY) == Z_OK;
+		m_inflateState.zalloc = Z_NULL;
+		m_inflateState.zfree = Z_NULL;
+		m_inflateState.opaque = Z_NULL;
+		m_inflateState.next_in = Z_NULL;
+		m_inflateState.avail_in = 0;
+		m_inflateInit = inflateInit2(&m_inflateState, -m_clientWindowBits) == Z_OK;
+		return m_deflateInit && m_inflateInit;
+	}
+
+private:
+	WebSocketDeflateConfig m_config;
+	bool m_enabled;
+	bool m_serverNoContextTakeover;
+	int m_windowBits;
+	int m_clientWindowBits;
+	bool m_deflateInit;
+	bool m_inflateInit;
+	z_stream m_deflateState;
+	z_stream m_inflateState;
+	Bytef m_buffer[WEBSOCKET_DEFLATE_BUFFER_SIZE];
+};
+
+#endif
@@ -306,6 +306,8 @@ int main( int argc, char **argv )
 	a.setActivationWindow(&mainWin, true);
 #endif
 	int retVal = a.exec();
+	// The config is written in the background, make sure pending changes reach the disk.
+	myConfig->flushBuffer();
 	curl_global_cleanup();
 	socket_cleanup();
 	return retVal;
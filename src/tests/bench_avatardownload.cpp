@@ -0,0 +1,217 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+/* Runs the avatar downloader against a local keep-alive HTTP stand-in. */
+
+#include <tests/benchmark.h>
+#include <net/downloaderthread.h>
+#include <core/avatarmanager.h>
+#include <boost/asio.hpp>
+#include <boost/bind.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread.hpp>
+#include <curl/curl.h>
+#include <cstdlib>
+#include <sstream>
+
+using namespace std;
+using boost::asio::ip::tcp;
+
+#define BENCH_NUM_AVATARS		200
+#define BENCH_NUM_DUPLICATES	3
+#define BENCH_AVATAR_SIZE		8192
+#define BENCH_LATENCY_MSEC		20
+#define BENCH_TIMEOUT_MSEC		60000
+
+// Answers every GET with a fixed payload after a short delay, as a remote
+// avatar server would. Connections stay open for further requests.
+class HttpStandInSession : public boost::enable_shared_from_this<HttpStandInSession>
+{
+public:
+	HttpStandInSession(boost::asio::io_service &ioService, const string &payload)
+		: m_socket(ioService), m_timer(ioService), m_payload(payload) {}
+
+	tcp::socket &GetSocket() {
+		return m_socket;
+	}
+
+	void Start() {
+		boost::asio::async_read_until(m_socket, m_request, "\r\n\r\n",
+									  boost::bind(&HttpStandInSession::HandleRequest, shared_from_this(), boost::asio::placeholders::error));
+	}
+
+protected:
+	void HandleRequest(const boost::system::error_code &ec) {
+		if (!ec) {
+			// Only the header is sent by curl, drop it.
+			m_request.consume(m_request.size());
+			m_timer.expires_from_now(boost::posix_time::milliseconds(BENCH_LATENCY_MSEC));
+			m_timer.async_wait(boost::bind(&HttpStandInSession::SendResponse, shared_from_this(), boost::asio::placeholders::error));
+		}
+	}
+
+	void SendResponse(const boost::system::error_code &ec) {
+		if (!ec) {
+			ostringstream header;
+			header << "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: "
+				   << m_payload.size() << "\r\n\r\n";
+			m_response = header.str() + m_payload;
+			boost::asio::async_write(m_socket, boost::asio::buffer(m_response),
+									 boost::bind(&HttpStandInSession::HandleWrite, shared_from_this(), boost::asio::placeholders::error));
+		}
+	}
+
+	void HandleWrite(const boost::system::error_code &ec) {
+		if (!ec)
+			Start();
+	}
+
+private:
+	tcp::socket m_socket;
+	boost::asio::deadline_timer m_timer;
+	boost::asio::streambuf m_request;
+	const string &m_payload;
+	string m_response;
+};
+
+class HttpStandIn
+{
+public:
+	HttpStandIn(boost::asio::io_service &ioService)
+		: m_ioService(ioService), m_acceptor(ioService, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)),
+		  m_payload(BENCH_AVATAR_SIZE, 'x'), m_numConnections(0) {
+		StartAccept();
+	}
+
+	unsigned short GetPort() const {
+		return m_acceptor.local_endpoint().port();
+	}
+
+	unsigned GetNumConnections() const {
+		return m_numConnections;
+	}
+
+protected:
+	void StartAccept() {
+		boost::shared_ptr<HttpStandInSession> session(new HttpStandInSession(m_ioService, m_payload));
+		m_acceptor.async_accept(session->GetSocket(),
+								boost::bind(&HttpStandIn::HandleAccept, this, session, boost::asio::placeholders::error));
+	}
+
+	void HandleAccept(boost::shared_ptr<HttpStandInSession> session, const boost::system::error_code &ec) {
+		if (!ec) {
+			m_numConnections++;
+			session->Start();
+			StartAccept();
+		}
+	}
+
+private:
+	boost::asio::io_service &m_ioService;
+	tcp::acceptor m_acceptor;
+	string m_payload;
+	unsigned m_numConnections;
+};
+
+// Requests every avatar several times, as happens when a player is in
+// several games, and waits for all results.
+static bool
+RunDownloads(unsigned short port, unsigned numAvatars, unsigned maxTransfers, double &elapsedMsec)
+{
+	boost::shared_ptr<DownloaderThread> downloader(
+		new DownloaderThread(maxTransfers, DOWNLOADER_MAX_HOST_CONNECTIONS, MAX_AVATAR_FILE_SIZE));
+	downloader->Run();
+
+	const string baseUrl("http://127.0.0.1:" + boost::lexical_cast<string>(port) + "/");
+	unsigned numRequests = 0;
+	BenchTimer timer;
+	for (unsigned i = 0; i < numAvatars; i++) {
+		for (unsigned j = 0; j < BENCH_NUM_DUPLICATES; j++)
+			downloader->QueueDownload(numRequests++, baseUrl + boost::lexical_cast<string>(i) + ".png");
+	}
+
+	unsigned numResults = 0;
+	bool sizeOk = true;
+	while (numResults < numRequests && timer.ElapsedMsec() < BENCH_TIMEOUT_MSEC) {
+		unsigned id;
+		vector<unsigned char> data;
+		if (downloader->GetDownloadResult(id, data)) {
+			sizeOk = sizeOk && data.size() == BENCH_AVATAR_SIZE;
+			numResults++;
+		} else {
+			Thread::Msleep(1);
+		}
+	}
+	elapsedMsec = timer.ElapsedMsec();
+
+	downloader->SignalTermination();
+	downloader->Join(DOWNLOADER_THREAD_TERMINATE_TIMEOUT);
+
+	if (numResults != numRequests || !sizeOk) {
+		cerr << "Downloads incomplete: " << numResults << " of " << numRequests << endl;
+		return false;
+	}
+	return true;
+}
+
+int
+BenchAvatarDownload(int argc, char *argv[])
+{
+	unsigned numAvatars = argc > 0 ? static_cast<unsigned>(atoi(argv[0])) : BENCH_NUM_AVATARS;
+	int retVal = 0;
+
+	curl_global_init(CURL_GLOBAL_NOTHING);
+	boost::asio::io_service ioService;
+	HttpStandIn server(ioService);
+	boost::thread serverThread(boost::bind(&boost::asio::io_service::run, &ioService));
+
+	double serialMsec = 0;
+	if (RunDownloads(server.GetPort(), numAvatars, 1, serialMsec)) {
+		BenchReport("single transfer", numAvatars, serialMsec);
+	} else {
+		retVal = 1;
+	}
+	unsigned serialConnections = server.GetNumConnections();
+
+	double parallelMsec = 0;
+	if (RunDownloads(server.GetPort(), numAvatars, DOWNLOADER_MAX_TRANSFERS, parallelMsec)) {
+		BenchReport("parallel transfers", numAvatars, parallelMsec);
+	} else {
+		retVal = 1;
+	}
+	cout << "connections: " << serialConnections << " single, "
+		 << server.GetNumConnections() - serialConnections << " parallel" << endl;
+
+	ioService.stop();
+	serverThread.join();
+	curl_global_cleanup();
+	return retVal;
+}
@@ -0,0 +1,115 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+/* Compares per hand key derivation with cached cipher contexts for hole card encryption. */
+
+#include <tests/benchmark.h>
+#include <core/crypthelper.h>
+#include <boost/shared_ptr.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+#define BENCH_NUM_HANDS			20000
+#define BENCH_NUM_SEATS			10
+#define BENCH_GAME_ID			4711
+#define BENCH_PLAIN_BUF_SIZE	64
+
+int
+BenchHandStart(int argc, char *argv[])
+{
+	unsigned numHands = argc > 0 ? static_cast<unsigned>(atoi(argv[0])) : BENCH_NUM_HANDS;
+
+	vector<string> passwordList;
+	vector<boost::shared_ptr<AES128Context> > contextList;
+	BenchTimer loginTimer;
+	for (unsigned seat = 0; seat < BENCH_NUM_SEATS; seat++) {
+		ostringstream pw;
+		pw << "password" << seat;
+		passwordList.push_back(pw.str());
+		boost::shared_ptr<AES128Context> context(new AES128Context);
+		context->Init((const unsigned char *)passwordList[seat].c_str(), (unsigned)passwordList[seat].size());
+		contextList.push_back(context);
+	}
+	cout << "Derived " << BENCH_NUM_SEATS << " session keys in " << loginTimer.ElapsedMsec() << " ms" << endl;
+
+	// Previous implementation: derive the key and format the data for every seat and hand.
+	unsigned long long legacySum = 0;
+	BenchTimer legacyTimer;
+	for (unsigned hand = 0; hand < numHands; hand++) {
+		for (unsigned seat = 0; seat < BENCH_NUM_SEATS; seat++) {
+			ostringstream cardDataStream;
+			vector<unsigned char> tmpCipher;
+			cardDataStream
+					<< seat + 1 << " "
+					<< BENCH_GAME_ID << " "
+					<< hand << " "
+					<< (hand + seat) % 52 << " "
+					<< (hand + seat + 13) % 52;
+			if (!CryptHelper::AES128Encrypt((const unsigned char *)passwordList[seat].c_str(),
+											(unsigned)passwordList[seat].size(),
+											cardDataStream.str(),
+											tmpCipher)) {
+				cerr << "Encryption failed." << endl;
+				return 1;
+			}
+			legacySum += tmpCipher[0];
+		}
+	}
+	BenchReport("per hand key derivation (10 seats)", numHands, legacyTimer.ElapsedMsec());
+
+	// Batched pass with cached contexts and fixed size buffers.
+	unsigned long long cachedSum = 0;
+	BenchTimer cachedTimer;
+	for (unsigned hand = 0; hand < numHands; hand++) {
+		unsigned char cipher[BENCH_NUM_SEATS][BENCH_PLAIN_BUF_SIZE];
+		for (unsigned seat = 0; seat < BENCH_NUM_SEATS; seat++) {
+			char plainData[BENCH_PLAIN_BUF_SIZE];
+			int plainSize = snprintf(plainData, sizeof(plainData), "%u %u %d %d %d",
+									 seat + 1, BENCH_GAME_ID, hand, (hand + seat) % 52, (hand + seat + 13) % 52);
+			if (!contextList[seat]->Encrypt((const unsigned char *)plainData, plainSize, cipher[seat], sizeof(cipher[seat]))) {
+				cerr << "Encryption failed." << endl;
+				return 1;
+			}
+		}
+		for (unsigned seat = 0; seat < BENCH_NUM_SEATS; seat++)
+			cachedSum += cipher[seat][0];
+	}
+	BenchReport("cached cipher contexts (10 seats)", numHands, cachedTimer.ElapsedMsec());
+
+	if (legacySum != cachedSum) {
+		cerr << "Result mismatch: " << legacySum << " != " << cachedSum << endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,113 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+/* Compares the chat cleaner word search with the previous per-word scan. */
+
+#include <tests/benchmark.h>
+#include <core/multipatternmatcher.h>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+
+#define BENCH_NUM_WORDS		10000
+#define BENCH_NUM_MESSAGES	20000
+#define BENCH_MESSAGE_WORDS	12
+
+static string
+randomWord(boost::random::mt19937 &gen, unsigned minLen, unsigned maxLen)
+{
+	boost::random::uniform_int_distribution<> lenDist(minLen, maxLen);
+	boost::random::uniform_int_distribution<> charDist('a', 'z');
+	string word;
+	int len = lenDist(gen);
+	for (int i = 0; i < len; i++)
+		word += static_cast<char>(charDist(gen));
+	return word;
+}
+
+int
+BenchPatternMatcher(int argc, char *argv[])
+{
+	unsigned numWords = argc > 0 ? static_cast<unsigned>(atoi(argv[0])) : BENCH_NUM_WORDS;
+	boost::random::mt19937 gen(42);
+
+	vector<string> wordList;
+	for (unsigned i = 0; i < numWords; i++)
+		wordList.push_back(randomWord(gen, 4, 9));
+
+	// Chat lines of short words, every tenth line contains a listed word.
+	vector<string> messageList;
+	boost::random::uniform_int_distribution<> wordDist(0, numWords - 1);
+	for (unsigned i = 0; i < BENCH_NUM_MESSAGES; i++) {
+		string msg;
+		for (unsigned j = 0; j < BENCH_MESSAGE_WORDS; j++)
+			msg += randomWord(gen, 1, 5) + " ";
+		if (i % 10 == 0)
+			msg += wordList[wordDist(gen)];
+		messageList.push_back(msg);
+	}
+
+	BenchTimer buildTimer;
+	MultiPatternMatcher matcher;
+	for (unsigned i = 0; i < numWords; i++)
+		matcher.AddPattern(wordList[i]);
+	matcher.Build();
+	cout << "Built matcher for " << numWords << " words in " << buildTimer.ElapsedMsec() << " ms" << endl;
+
+	unsigned naiveHits = 0;
+	BenchTimer naiveTimer;
+	for (unsigned i = 0; i < BENCH_NUM_MESSAGES; i++) {
+		for (unsigned j = 0; j < numWords; j++) {
+			if (messageList[i].find(wordList[j]) != string::npos)
+				naiveHits++;
+		}
+	}
+	BenchReport("per-word scan", BENCH_NUM_MESSAGES, naiveTimer.ElapsedMsec());
+
+	unsigned matcherHits = 0;
+	vector<char> hits;
+	BenchTimer matcherTimer;
+	for (unsigned i = 0; i < BENCH_NUM_MESSAGES; i++) {
+		matcher.FindAll(messageList[i], hits);
+		for (unsigned j = 0; j < numWords; j++)
+			matcherHits += hits[j];
+	}
+	BenchReport("aho-corasick", BENCH_NUM_MESSAGES, matcherTimer.ElapsedMsec());
+
+	if (naiveHits != matcherHits) {
+		cerr << "Result mismatch: " << naiveHits << " != " << matcherHits << endl;
+		return 1;
+	}
+	cout << "Found " << matcherHits << " word hits" << endl;
+	return 0;
+}
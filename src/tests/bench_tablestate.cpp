@@ -0,0 +1,239 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+/* Compares the list based pot distribution with the flat table state of the local engine. */
+
+#include <tests/benchmark.h>
+#include <engine/local_engine/localenginefactory.h>
+#include <engine/boardinterface.h>
+#include <engine/playerinterface.h>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+
+#define BENCH_NUM_HANDS		200000
+#define BENCH_START_CASH	5000
+
+// Previous implementation: walk the seat list with virtual getters.
+static void
+LegacyCollectPot(PlayerList seatsList, int &pot)
+{
+	PlayerListIterator it;
+	for (it = seatsList->begin(); it != seatsList->end(); ++it) {
+		pot += (*it)->getMySet();
+		(*it)->setMySetNull();
+	}
+}
+
+static void
+LegacyDistributePot(PlayerList seatsList, int &pot, unsigned dealerPosition)
+{
+	size_t i, j, k, l;
+	PlayerListIterator it;
+	PlayerListConstIterator it_c;
+
+	vector<unsigned> playerSets;
+	for (it = seatsList->begin(); it != seatsList->end(); ++it) {
+		if ((*it)->getMyActiveStatus())
+			playerSets.push_back((*it)->getMyRoundStartCash() - (*it)->getMyCash());
+		else
+			playerSets.push_back(0);
+		(*it)->setLastMoneyWon(0);
+	}
+	vector<unsigned> playerSetsSort = playerSets;
+	sort(playerSetsSort.begin(), playerSetsSort.end());
+
+	vector<unsigned> potLevel;
+	int potCarryOver = 0;
+	for (i = 0; i < playerSetsSort.size(); i++) {
+		int highestCardsValue = 0;
+		if (playerSetsSort[i] > 0) {
+			potLevel.push_back(playerSetsSort[i]);
+			potLevel.push_back((playerSetsSort.size() - i) * potLevel[0] + potCarryOver);
+			for (it_c = seatsList->begin(), j = 0; it_c != seatsList->end(); ++it_c, j++) {
+				if ((*it_c)->getMyActiveStatus() && (*it_c)->getMyCardsValueInt() > highestCardsValue && (*it_c)->getMyAction() != PLAYER_ACTION_FOLD && playerSets[j] >= potLevel[0])
+					highestCardsValue = (*it_c)->getMyCardsValueInt();
+			}
+			for (it_c = seatsList->begin(), j = 0; it_c != seatsList->end(); ++it_c, j++) {
+				if ((*it_c)->getMyActiveStatus() && highestCardsValue == (*it_c)->getMyCardsValueInt() && (*it_c)->getMyAction() != PLAYER_ACTION_FOLD && playerSets[j] >= potLevel[0])
+					potLevel.push_back((*it_c)->getMyUniqueID());
+			}
+			size_t winnerCount = potLevel.size() - 2;
+			bool finalPot = false;
+			for (j = 2; j < potLevel.size() && !finalPot; j++) {
+				for (it = seatsList->begin(), k = 0; it != seatsList->end(); ++it, k++) {
+					if ((*it)->getMyUniqueID() == potLevel[j] && potLevel[0] == playerSets[k]) {
+						finalPot = true;
+						break;
+					}
+				}
+			}
+			if (finalPot && winnerCount > 0) {
+				size_t mod = potLevel[1] % winnerCount;
+				if (mod == 0) {
+					for (j = 2; j < potLevel.size(); j++) {
+						for (it = seatsList->begin(); it != seatsList->end(); ++it) {
+							if ((*it)->getMyUniqueID() == potLevel[j])
+								break;
+						}
+						(*it)->setMyCash((*it)->getMyCash() + potLevel[1] / winnerCount);
+						(*it)->setLastMoneyWon((*it)->getLastMoneyWon() + potLevel[1] / winnerCount);
+					}
+				} else {
+					for (it = seatsList->begin(); it != seatsList->end(); ++it) {
+						if ((*it)->getMyUniqueID() == dealerPosition)
+							break;
+					}
+					if (it == seatsList->end())
+						it = seatsList->begin();
+					for (j = 0; j < winnerCount; j++) {
+						bool winnerHit = false;
+						for (k = 0; k < MAX_NUMBER_OF_PLAYERS && !winnerHit; k++) {
+							++it;
+							if (it == seatsList->end())
+								it = seatsList->begin();
+							for (l = 2; l < potLevel.size(); l++) {
+								if ((*it)->getMyActiveStatus() && (*it)->getMyUniqueID() == potLevel[l])
+									winnerHit = true;
+							}
+						}
+						if (winnerHit) {
+							int share = (int)(potLevel[1] / winnerCount) + (j < mod ? 1 : 0);
+							(*it)->setMyCash((*it)->getMyCash() + share);
+							(*it)->setLastMoneyWon((*it)->getLastMoneyWon() + share);
+						}
+					}
+				}
+				potCarryOver = 0;
+				pot -= potLevel[1];
+			} else {
+				potCarryOver = potLevel[1];
+			}
+			for (j = 0; j < playerSets.size(); j++) {
+				if (playerSets[j] > 0)
+					playerSets[j] -= potLevel[0];
+			}
+			playerSetsSort = playerSets;
+			sort(playerSetsSort.begin(), playerSetsSort.end());
+			potLevel.clear();
+		}
+	}
+}
+
+static PlayerList
+CreateTable(boost::shared_ptr<EngineFactory> factory)
+{
+	PlayerList seatsList(new std::list<boost::shared_ptr<PlayerInterface> >);
+	for (int i = 0; i < MAX_NUMBER_OF_PLAYERS; i++)
+		seatsList->push_back(factory->createPlayer(i, i + 1, PLAYER_TYPE_COMPUTER, "", "", BENCH_START_CASH, true, false, 0));
+	return seatsList;
+}
+
+// Bets of random size and random hand values. Only players below the highest
+// set may fold. If a player lost everything, the table starts over.
+static void
+DealRandomSets(PlayerList seatsList, boost::random::mt19937 &gen)
+{
+	boost::random::uniform_int_distribution<> percentDist(0, 100);
+	boost::random::uniform_int_distribution<> valueDist(1, 10000);
+	PlayerListIterator it;
+	for (it = seatsList->begin(); it != seatsList->end(); ++it) {
+		if ((*it)->getMyCash() == 0)
+			break;
+	}
+	if (it != seatsList->end()) {
+		for (it = seatsList->begin(); it != seatsList->end(); ++it)
+			(*it)->setMyCash(BENCH_START_CASH);
+	}
+	int highestSet = 0;
+	for (it = seatsList->begin(); it != seatsList->end(); ++it) {
+		(*it)->setMyRoundStartCash((*it)->getMyCash());
+		(*it)->setMyCardsValueInt(valueDist(gen));
+		(*it)->setMySet((*it)->getMyCash() * percentDist(gen) / 100);
+		highestSet = max(highestSet, (*it)->getMySet());
+	}
+	for (it = seatsList->begin(); it != seatsList->end(); ++it) {
+		if ((*it)->getMyCash() == 0)
+			(*it)->setMyAction(PLAYER_ACTION_ALLIN);
+		else if ((*it)->getMySet() < highestSet && percentDist(gen) < 30)
+			(*it)->setMyAction(PLAYER_ACTION_FOLD);
+		else
+			(*it)->setMyAction(PLAYER_ACTION_CALL);
+	}
+}
+
+int
+BenchTableState(int argc, char *argv[])
+{
+	unsigned numHands = argc > 0 ? static_cast<unsigned>(atoi(argv[0])) : BENCH_NUM_HANDS;
+
+	boost::shared_ptr<EngineFactory> legacyFactory(new LocalEngineFactory(NULL));
+	PlayerList legacySeats(CreateTable(legacyFactory));
+	boost::random::mt19937 legacyGen(42);
+	int legacyPot = 0;
+	BenchTimer legacyTimer;
+	for (unsigned hand = 0; hand < numHands; hand++) {
+		DealRandomSets(legacySeats, legacyGen);
+		LegacyCollectPot(legacySeats, legacyPot);
+		LegacyDistributePot(legacySeats, legacyPot, hand % MAX_NUMBER_OF_PLAYERS + 1);
+	}
+	BenchReport("player list pot distribution (10 seats)", numHands, legacyTimer.ElapsedMsec());
+
+	boost::shared_ptr<EngineFactory> factory(new LocalEngineFactory(NULL));
+	PlayerList seats(CreateTable(factory));
+	boost::shared_ptr<BoardInterface> board(factory->createBoard());
+	board->setPlayerLists(seats, seats, seats);
+	boost::random::mt19937 gen(42);
+	BenchTimer flatTimer;
+	for (unsigned hand = 0; hand < numHands; hand++) {
+		DealRandomSets(seats, gen);
+		board->collectSets();
+		board->collectPot();
+		board->distributePot(hand % MAX_NUMBER_OF_PLAYERS + 1);
+	}
+	BenchReport("flat table state pot distribution (10 seats)", numHands, flatTimer.ElapsedMsec());
+
+	PlayerListConstIterator legacy_i = legacySeats->begin();
+	PlayerListConstIterator flat_i = seats->begin();
+	while (legacy_i != legacySeats->end()) {
+		if ((*legacy_i)->getMyCash() != (*flat_i)->getMyCash()) {
+			cerr << "Result mismatch for seat " << (*legacy_i)->getMyID() << ": "
+				 << (*legacy_i)->getMyCash() << " != " << (*flat_i)->getMyCash() << endl;
+			return 1;
+		}
+		++legacy_i;
+		++flat_i;
+	}
+	return 0;
+}
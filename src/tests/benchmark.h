@@ -0,0 +1,66 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+/* Micro benchmarks for performance critical code paths. */
+
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#include <boost/chrono.hpp>
+#include <iostream>
+#include <string>
+
+// Measures wall clock time in milliseconds.
+class BenchTimer
+{
+public:
+	BenchTimer() : m_start(boost::chrono::steady_clock::now()) {}
+
+	double ElapsedMsec() const {
+		return boost::chrono::duration<double, boost::milli>(boost::chrono::steady_clock::now() - m_start).count();
+	}
+
+private:
+	boost::chrono::steady_clock::time_point m_start;
+};
+
+inline void
+BenchReport(const std::string &name, unsigned numOperations, double elapsedMsec)
+{
+	std::cout << name << ": " << numOperations << " operations in " << elapsedMsec << " ms ("
+			  << (elapsedMsec > 0 ? numOperations * 1000.0 / elapsedMsec : 0) << "/s)" << std::endl;
+}
+
+int BenchPatternMatcher(int argc, char *argv[]);
+int BenchHandStart(int argc, char *argv[]);
+int BenchTableState(int argc, char *argv[]);
+int BenchAvatarDownload(int argc, char *argv[]);
+
+#endif
@@ -0,0 +1,739 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+
+#include <tests/loadclient.h>
+#include <net/netpacket.h>
+#include <boost/bind.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <gsasl.h>
+#include <sstream>
+
+using namespace std;
+using boost::asio::ip::tcp;
+
+#define LOAD_MAX_MESSAGE_SIZE		65536
+#define LOAD_RETRY_DELAY_MSEC		2000
+#define LOAD_GAME_SMALL_BLIND		50
+#define LOAD_GAME_START_MONEY		2000
+
+
+LoadClient::LoadClient(boost::asio::io_service &ioService, const LoadConfig &config, LoadStatistics &stats, unsigned clientNum)
+	: m_ioService(ioService), m_strand(ioService), m_socket(ioService), m_actionTimer(ioService),
+	  m_chatTimer(ioService), m_retryTimer(ioService), m_config(config), m_stats(stats), m_clientNum(clientNum),
+	  m_authSession(NULL), m_state(STATE_INIT), m_playerId(0), m_gameId(0), m_requestId(0), m_gameRound(0),
+	  m_handNum(0), m_highestSet(0), m_myBet(0), m_gameState(netStatePreflop), m_chatCounter(0), m_loggedIn(false)
+{
+	ostringstream name;
+	switch (config.loginType) {
+	case LOAD_LOGIN_GUEST :
+		name << "Guest";
+		break;
+	case LOAD_LOGIN_SCRAM :
+		name << "test";
+		break;
+	default :
+		name << "load";
+		break;
+	}
+	name << config.firstId + clientNum;
+	m_name = name.str();
+
+	for (int i = 0; i < LOAD_OP_COUNT; i++)
+		m_opPending[i] = false;
+}
+
+LoadClient::~LoadClient()
+{
+	if (m_authSession)
+		gsasl_finish(m_authSession);
+}
+
+void
+LoadClient::Start()
+{
+	m_state = STATE_CONNECTING;
+	BeginOperation(LOAD_OP_CONNECT);
+	m_socket.async_connect(m_config.serverEndpoint,
+						   m_strand.wrap(boost::bind(&LoadClient::HandleConnect, shared_from_this(), boost::asio::placeholders::error)));
+}
+
+void
+LoadClient::Stop()
+{
+	m_strand.post(boost::bind(&LoadClient::Close, shared_from_this()));
+}
+
+void
+LoadClient::HandleConnect(const boost::system::error_code &ec)
+{
+	if (m_state != STATE_CONNECTING)
+		return;
+	if (ec) {
+		Fail(LOAD_OP_CONNECT);
+		Close();
+	} else {
+		EndOperation(LOAD_OP_CONNECT);
+		m_stats.AdjustGauge(LOAD_GAUGE_CONNECTED, 1);
+		m_state = STATE_AUTH;
+		boost::system::error_code optionEc;
+		m_socket.set_option(tcp::no_delay(true), optionEc);
+		BeginOperation(LOAD_OP_LOGIN);
+		boost::asio::async_read(m_socket, boost::asio::buffer(m_recvHeader),
+								m_strand.wrap(boost::bind(&LoadClient::HandleReadHeader, shared_from_this(), boost::asio::placeholders::error)));
+	}
+}
+
+void
+LoadClient::HandleReadHeader(const boost::system::error_code &ec)
+{
+	if (m_state == STATE_STOPPED)
+		return;
+	size_t size = ((size_t)(unsigned char)m_recvHeader[0] << 24) | ((size_t)(unsigned char)m_recvHeader[1] << 16)
+				  | ((size_t)(unsigned char)m_recvHeader[2] << 8) | (size_t)(unsigned char)m_recvHeader[3];
+	if (ec || size == 0 || size > LOAD_MAX_MESSAGE_SIZE) {
+		if (m_opPending[LOAD_OP_LOGIN])
+			Fail(LOAD_OP_LOGIN);
+		Close();
+	} else {
+		m_recvBody.resize(size);
+		boost::asio::async_read(m_socket, boost::asio::buffer(&m_recvBody[0], size),
+								m_strand.wrap(boost::bind(&LoadClient::HandleReadBody, shared_from_this(), boost::asio::placeholders::error)));
+	}
+}
+
+void
+LoadClient::HandleReadBody(const boost::system::error_code &ec)
+{
+	if (m_state == STATE_STOPPED)
+		return;
+	PokerTHMessage msg;
+	if (ec || !msg.ParseFromString(m_recvBody)) {
+		if (m_opPending[LOAD_OP_LOGIN])
+			Fail(LOAD_OP_LOGIN);
+		Close();
+	} else {
+		m_stats.AddIncoming(m_recvBody.size() + NET_HEADER_SIZE);
+		HandleMessage(msg);
+		if (m_state != STATE_STOPPED) {
+			boost::asio::async_read(m_socket, boost::asio::buffer(m_recvHeader),
+									m_strand.wrap(boost::bind(&LoadClient::HandleReadHeader, shared_from_this(), boost::asio::placeholders::error)));
+		}
+	}
+}
+
+void
+LoadClient::HandleWrite(const boost::system::error_code &ec, size_t /*bytesTransferred*/)
+{
+	if (m_state == STATE_STOPPED)
+		return;
+	if (ec) {
+		Close();
+	} else {
+		m_sendQueue.pop_front();
+		if (!m_sendQueue.empty()) {
+			boost::asio::async_write(m_socket, boost::asio::buffer(m_sendQueue.front()),
+									 m_strand.wrap(boost::bind(&LoadClient::HandleWrite, shared_from_this(),
+											 boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred)));
+		}
+	}
+}
+
+void
+LoadClient::HandleActionTimer(const boost::system::error_code &ec)
+{
+	if (!ec && m_state == STATE_GAME) {
+		SendAction(m_myBet < m_highestSet ? netActionCall : netActionCheck);
+	}
+}
+
+void
+LoadClient::HandleChatTimer(const boost::system::error_code &ec)
+{
+	if (!ec && m_state != STATE_STOPPED) {
+		if (m_state == STATE_LOBBY || m_state == STATE_GAME)
+			SendChat();
+		ScheduleChat();
+	}
+}
+
+void
+LoadClient::HandleRetryTimer(const boost::system::error_code &ec)
+{
+	if (!ec && m_state == STATE_LOBBY) {
+		if (IsGameCreator())
+			CreateGame();
+		else
+			TryJoinGame();
+	}
+}
+
+void
+LoadClient::HandleMessage(const PokerTHMessage &msg)
+{
+	switch (msg.messagetype()) {
+	case PokerTHMessage::Type_AnnounceMessage :
+		if (msg.has_announcemessage())
+			HandleAnnounce(msg.announcemessage());
+		break;
+	case PokerTHMessage::Type_AuthMessage :
+		if (msg.has_authmessage())
+			HandleAuth(msg.authmessage());
+		break;
+	case PokerTHMessage::Type_LobbyMessage :
+		if (msg.has_lobbymessage())
+			HandleLobby(msg.lobbymessage());
+		break;
+	case PokerTHMessage::Type_GameMessage :
+		if (msg.has_gamemessage()) {
+			const GameMessage &game = msg.gamemessage();
+			if (game.messagetype() == GameMessage::Type_GameManagementMessage && game.has_gamemanagementmessage())
+				HandleGameManagement(game.gameid(), game.gamemanagementmessage());
+			else if (game.messagetype() == GameMessage::Type_GameEngineMessage && game.has_gameenginemessage())
+				HandleGameEngine(game.gameenginemessage());
+		}
+		break;
+	}
+}
+
+void
+LoadClient::HandleAnnounce(const AnnounceMessage &/*announce*/)
+{
+	if (m_state == STATE_AUTH)
+		Login();
+}
+
+void
+LoadClient::HandleAuth(const AuthMessage &auth)
+{
+	if (auth.messagetype() == AuthMessage::Type_AuthServerChallengeMessage && auth.has_authserverchallengemessage() && m_authSession) {
+		const string &challenge = auth.authserverchallengemessage().serverchallenge();
+		char *tmpOut;
+		size_t tmpOutSize;
+		if (gsasl_step(m_authSession, challenge.c_str(), challenge.size(), &tmpOut, &tmpOutSize) == GSASL_NEEDS_MORE) {
+			PokerTHMessage msg;
+			msg.set_messagetype(PokerTHMessage::Type_AuthMessage);
+			AuthMessage *netAuth = msg.mutable_authmessage();
+			netAuth->set_messagetype(AuthMessage::Type_AuthClientResponseMessage);
+			netAuth->mutable_authclientresponsemessage()->set_clientresponse(string(tmpOut, tmpOutSize));
+			gsasl_free(tmpOut);
+			SendPacket(msg);
+		} else {
+			Fail(LOAD_OP_LOGIN);
+			Close();
+		}
+	} else if (auth.messagetype() == AuthMessage::Type_ErrorMessage) {
+		Fail(LOAD_OP_LOGIN);
+		Close();
+	}
+}
+
+void
+LoadClient::HandleLobby(const LobbyMessage &lobby)
+{
+	switch (lobby.messagetype()) {
+	case LobbyMessage::Type_InitDoneMessage :
+		if (m_state == STATE_AUTH && lobby.has_initdonemessage()) {
+			m_playerId = lobby.initdonemessage().yourplayerid();
+			m_loggedIn = true;
+			EndOperation(LOAD_OP_LOGIN);
+			m_stats.AdjustGauge(LOAD_GAUGE_LOGGED_IN, 1);
+			ScheduleChat();
+			EnterLobby();
+		}
+		break;
+	case LobbyMessage::Type_GameListNewMessage :
+		if (lobby.has_gamelistnewmessage()) {
+			const GameListNewMessage &newGame = lobby.gamelistnewmessage();
+			if (newGame.gamemode() == netGameCreated
+					&& boost::algorithm::starts_with(newGame.gameinfo().gamename(), GetGameNamePrefix())) {
+				m_groupGames.insert(newGame.gameid());
+				TryJoinGame();
+			}
+		}
+		break;
+	case LobbyMessage::Type_GameListUpdateMessage :
+		if (lobby.has_gamelistupdatemessage() && lobby.gamelistupdatemessage().gamemode() != netGameCreated)
+			m_groupGames.erase(lobby.gamelistupdatemessage().gameid());
+		break;
+	case LobbyMessage::Type_SubscriptionReplyMessage :
+		EndOperation(LOAD_OP_SUBSCRIBE);
+		break;
+	case LobbyMessage::Type_CreateGameFailedMessage :
+		if (m_state == STATE_JOINING) {
+			Fail(LOAD_OP_CREATE_GAME);
+			m_state = STATE_LOBBY;
+			m_gameRound++;
+			m_retryTimer.expires_from_now(boost::posix_time::milliseconds(LOAD_RETRY_DELAY_MSEC));
+			m_retryTimer.async_wait(m_strand.wrap(boost::bind(&LoadClient::HandleRetryTimer, shared_from_this(), boost::asio::placeholders::error)));
+		}
+		break;
+	case LobbyMessage::Type_JoinGameAckMessage :
+		if (m_state == STATE_JOINING && lobby.has_joingameackmessage()) {
+			EndOperation(IsGameCreator() ? LOAD_OP_CREATE_GAME : LOAD_OP_JOIN_GAME);
+			EnterGame(lobby.joingameackmessage().gameid());
+		}
+		break;
+	case LobbyMessage::Type_JoinGameFailedMessage :
+		if (m_state == STATE_JOINING && lobby.has_joingamefailedmessage()) {
+			Fail(LOAD_OP_JOIN_GAME);
+			m_groupGames.erase(lobby.joingamefailedmessage().gameid());
+			m_state = STATE_LOBBY;
+			m_retryTimer.expires_from_now(boost::posix_time::milliseconds(LOAD_RETRY_DELAY_MSEC));
+			m_retryTimer.async_wait(m_strand.wrap(boost::bind(&LoadClient::HandleRetryTimer, shared_from_this(), boost::asio::placeholders::error)));
+		}
+		break;
+	case LobbyMessage::Type_ChatMessage :
+		if (lobby.has_chatmessage())
+			HandleChat(lobby.chatmessage());
+		break;
+	case LobbyMessage::Type_ChatRejectMessage :
+		Fail(LOAD_OP_CHAT);
+		break;
+	case LobbyMessage::Type_TimeoutWarningMessage : {
+		PokerTHMessage msg;
+		msg.set_messagetype(PokerTHMessage::Type_LobbyMessage);
+		LobbyMessage *netLobby = msg.mutable_lobbymessage();
+		netLobby->set_messagetype(LobbyMessage::Type_ResetTimeoutMessage);
+		netLobby->mutable_resettimeoutmessage();
+		SendPacket(msg);
+	}
+	break;
+	case LobbyMessage::Type_ErrorMessage :
+		if (m_opPending[LOAD_OP_LOGIN])
+			Fail(LOAD_OP_LOGIN);
+		Close();
+		break;
+	default :
+		break;
+	}
+}
+
+void
+LoadClient::HandleGameManagement(unsigned gameId, const GameManagementMessage &management)
+{
+	if (m_state != STATE_GAME || gameId != m_gameId)
+		return;
+
+	PokerTHMessage msg;
+	msg.set_messagetype(PokerTHMessage::Type_GameMessage);
+	GameMessage *netGame = msg.mutable_gamemessage();
+	netGame->set_messagetype(GameMessage::Type_GameManagementMessage);
+	netGame->set_gameid(m_gameId);
+	GameManagementMessage *netManage = netGame->mutable_gamemanagementmessage();
+
+	switch (management.messagetype()) {
+	case GameManagementMessage::Type_StartEventMessage :
+		netManage->set_messagetype(GameManagementMessage::Type_StartEventAckMessage);
+		netManage->mutable_starteventackmessage();
+		SendPacket(msg);
+		break;
+	case GameManagementMessage::Type_GameStartInitialMessage :
+	case GameManagementMessage::Type_GameStartRejoinMessage :
+		m_handNum = 0;
+		break;
+	case GameManagementMessage::Type_EndOfGameMessage :
+		netManage->set_messagetype(GameManagementMessage::Type_LeaveGameRequestMessage);
+		netManage->mutable_leavegamerequestmessage();
+		SendPacket(msg);
+		break;
+	case GameManagementMessage::Type_RemovedFromGameMessage :
+		LeaveGame();
+		break;
+	case GameManagementMessage::Type_PlayerIdChangedMessage :
+		if (management.has_playeridchangedmessage() && management.playeridchangedmessage().oldplayerid() == m_playerId)
+			m_playerId = management.playeridchangedmessage().newplayerid();
+		break;
+	case GameManagementMessage::Type_ChatMessage :
+		if (management.has_chatmessage())
+			HandleChat(management.chatmessage());
+		break;
+	case GameManagementMessage::Type_ChatRejectMessage :
+		Fail(LOAD_OP_CHAT);
+		break;
+	case GameManagementMessage::Type_TimeoutWarningMessage :
+		netManage->set_messagetype(GameManagementMessage::Type_ResetTimeoutMessage);
+		netManage->mutable_resettimeoutmessage();
+		SendPacket(msg);
+		break;
+	case GameManagementMessage::Type_ErrorMessage :
+		Close();
+		break;
+	default :
+		break;
+	}
+}
+
+void
+LoadClient::HandleGameEngine(const GameEngineMessage &engine)
+{
+	if (m_state != STATE_GAME)
+		return;
+
+	switch (engine.messagetype()) {
+	case GameEngineMessage::Type_HandStartMessage :
+		m_handNum++;
+		m_highestSet = 0;
+		m_myBet = 0;
+		break;
+	case GameEngineMessage::Type_PlayersTurnMessage :
+		if (engine.has_playersturnmessage()) {
+			m_gameState = engine.playersturnmessage().gamestate();
+			if (engine.playersturnmessage().playerid() == m_playerId) {
+				m_actionTimer.expires_from_now(boost::posix_time::milliseconds(m_config.actionDelayMsec));
+				m_actionTimer.async_wait(m_strand.wrap(boost::bind(&LoadClient::HandleActionTimer, shared_from_this(), boost::asio::placeholders::error)));
+			}
+		}
+		break;
+	case GameEngineMessage::Type_PlayersActionDoneMessage :
+		if (engine.has_playersactiondonemessage()) {
+			const PlayersActionDoneMessage &actionDone = engine.playersactiondonemessage();
+			m_highestSet = actionDone.highestset();
+			if (actionDone.playerid() == m_playerId) {
+				m_myBet = actionDone.totalplayerbet();
+				EndOperation(LOAD_OP_ACTION);
+			}
+		}
+		break;
+	case GameEngineMessage::Type_DealFlopCardsMessage :
+	case GameEngineMessage::Type_DealTurnCardMessage :
+	case GameEngineMessage::Type_DealRiverCardMessage :
+		m_highestSet = 0;
+		m_myBet = 0;
+		break;
+	case GameEngineMessage::Type_YourActionRejectedMessage :
+		Fail(LOAD_OP_ACTION);
+		if (engine.has_youractionrejectedmessage() && engine.youractionrejectedmessage().youraction() != netActionFold)
+			SendAction(netActionFold);
+		break;
+	default :
+		break;
+	}
+}
+
+void
+LoadClient::HandleChat(const ChatMessage &chat)
+{
+	if (m_opPending[LOAD_OP_CHAT] && chat.has_playerid() && chat.playerid() == m_playerId && chat.chattext() == m_pendingChat)
+		EndOperation(LOAD_OP_CHAT);
+}
+
+void
+LoadClient::Login()
+{
+	PokerTHMessage msg;
+	msg.set_messagetype(PokerTHMessage::Type_AuthMessage);
+	AuthMessage *netAuth = msg.mutable_authmessage();
+	netAuth->set_messagetype(AuthMessage::Type_AuthClientRequestMessage);
+	AuthClientRequestMessage *netRequest = netAuth->mutable_authclientrequestmessage();
+	netRequest->mutable_requestedversion()->set_majorversion(NET_VERSION_MAJOR);
+	netRequest->mutable_requestedversion()->set_minorversion(NET_VERSION_MINOR);
+	netRequest->set_buildid(0);
+
+	switch (m_config.loginType) {
+	case LOAD_LOGIN_GUEST :
+		netRequest->set_login(AuthClientRequestMessage::guestLogin);
+		netRequest->set_nickname(m_name);
+		break;
+	case LOAD_LOGIN_UNAUTHENTICATED :
+		netRequest->set_login(AuthClientRequestMessage::unauthenticatedLogin);
+		netRequest->set_nickname(m_name);
+		break;
+	case LOAD_LOGIN_SCRAM : {
+		char *tmpOut;
+		size_t tmpOutSize;
+		if (gsasl_client_start(m_config.authContext, "SCRAM-SHA-1", &m_authSession) != GSASL_OK) {
+			Fail(LOAD_OP_LOGIN);
+			Close();
+			return;
+		}
+		// The test accounts use the user name as password.
+		gsasl_property_set(m_authSession, GSASL_AUTHID, m_name.c_str());
+		gsasl_property_set(m_authSession, GSASL_PASSWORD, m_name.c_str());
+		if (gsasl_step(m_authSession, NULL, 0, &tmpOut, &tmpOutSize) != GSASL_NEEDS_MORE) {
+			Fail(LOAD_OP_LOGIN);
+			Close();
+			return;
+		}
+		netRequest->set_login(AuthClientRequestMessage::authenticatedLogin);
+		netRequest->set_clientuserdata(string(tmpOut, tmpOutSize));
+		gsasl_free(tmpOut);
+	}
+	break;
+	}
+	SendPacket(msg);
+}
+
+void
+LoadClient::EnterLobby()
+{
+	m_state = STATE_LOBBY;
+	if (m_config.playersPerGame) {
+		if (IsGameCreator())
+			CreateGame();
+		else
+			TryJoinGame();
+	}
+}
+
+void
+LoadClient::EnterGame(unsigned gameId)
+{
+	m_state = STATE_GAME;
+	m_gameId = gameId;
+	m_handNum = 0;
+	m_stats.AdjustGauge(LOAD_GAUGE_IN_GAME, 1);
+	// Like the regular client, do not receive lobby updates while playing.
+	Subscribe(false);
+}
+
+void
+LoadClient::LeaveGame()
+{
+	m_actionTimer.cancel();
+	m_stats.AdjustGauge(LOAD_GAUGE_IN_GAME, -1);
+	m_groupGames.erase(m_gameId);
+	m_gameId = 0;
+	m_gameRound++;
+	m_opPending[LOAD_OP_ACTION] = false;
+	// The resubscription also delivers the current game list.
+	m_state = STATE_LOBBY;
+	Subscribe(true);
+	EnterLobby();
+}
+
+void
+LoadClient::TryJoinGame()
+{
+	if (m_state == STATE_LOBBY && m_config.playersPerGame && !IsGameCreator() && !m_groupGames.empty()) {
+		// Join the most recently created game of the group.
+		unsigned gameId = *m_groupGames.rbegin();
+		m_state = STATE_JOINING;
+		BeginOperation(LOAD_OP_JOIN_GAME);
+
+		PokerTHMessage msg;
+		msg.set_messagetype(PokerTHMessage::Type_LobbyMessage);
+		LobbyMessage *netLobby = msg.mutable_lobbymessage();
+		netLobby->set_messagetype(LobbyMessage::Type_JoinGameMessage);
+		netLobby->mutable_joingamemessage()->set_gameid(gameId);
+		SendPacket(msg);
+	}
+}
+
+void
+LoadClient::CreateGame()
+{
+	m_state = STATE_JOINING;
+	BeginOperation(LOAD_OP_CREATE_GAME);
+
+	ostringstream gameName;
+	gameName << GetGameNamePrefix() << m_gameRound;
+
+	PokerTHMessage msg;
+	msg.set_messagetype(PokerTHMessage::Type_LobbyMessage);
+	LobbyMessage *netLobby = msg.mutable_lobbymessage();
+	netLobby->set_messagetype(LobbyMessage::Type_CreateGameMessage);
+	CreateGameMessage *netCreate = netLobby->mutable_creategamemessage();
+	netCreate->set_requestid(++m_requestId);
+	NetGameInfo *gameInfo = netCreate->mutable_gameinfo();
+	gameInfo->set_gamename(gameName.str());
+	gameInfo->set_netgametype(NetGameInfo::normalGame);
+	gameInfo->set_maxnumplayers(m_config.playersPerGame);
+	gameInfo->set_raiseintervalmode(NetGameInfo::raiseOnHandNum);
+	gameInfo->set_raiseeveryhands(5);
+	gameInfo->set_endraisemode(NetGameInfo::doubleBlinds);
+	gameInfo->set_proposedguispeed(11);
+	gameInfo->set_delaybetweenhands(5);
+	gameInfo->set_playeractiontimeout(20);
+	gameInfo->set_firstsmallblind(LOAD_GAME_SMALL_BLIND);
+	gameInfo->set_startmoney(LOAD_GAME_START_MONEY);
+	SendPacket(msg);
+}
+
+void
+LoadClient::Subscribe(bool subscribe)
+{
+	BeginOperation(LOAD_OP_SUBSCRIBE);
+
+	PokerTHMessage msg;
+	msg.set_messagetype(PokerTHMessage::Type_LobbyMessage);
+	LobbyMessage *netLobby = msg.mutable_lobbymessage();
+	netLobby->set_messagetype(LobbyMessage::Type_SubscriptionRequestMessage);
+	SubscriptionRequestMessage *netSubscription = netLobby->mutable_subscriptionrequestmessage();
+	netSubscription->set_requestid(++m_requestId);
+	netSubscription->set_subscriptionaction(
+		subscribe ? SubscriptionRequestMessage::resubscribeGameList : SubscriptionRequestMessage::unsubscribeGameList);
+	SendPacket(msg);
+}
+
+void
+LoadClient::SendChat()
+{
+	// Guests are not allowed to chat.
+	if (m_config.loginType == LOAD_LOGIN_GUEST)
+		return;
+	// No echo for the previous chat message, count it as lost.
+	if (m_opPending[LOAD_OP_CHAT])
+		Fail(LOAD_OP_CHAT);
+
+	ostringstream text;
+	text << "load test message " << ++m_chatCounter;
+	m_pendingChat = text.str();
+	BeginOperation(LOAD_OP_CHAT);
+
+	PokerTHMessage msg;
+	if (m_state == STATE_GAME) {
+		msg.set_messagetype(PokerTHMessage::Type_GameMessage);
+		GameMessage *netGame = msg.mutable_gamemessage();
+		netGame->set_messagetype(GameMessage::Type_GameManagementMessage);
+		netGame->set_gameid(m_gameId);
+		GameManagementMessage *netManage = netGame->mutable_gamemanagementmessage();
+		netManage->set_messagetype(GameManagementMessage::Type_ChatRequestMessage);
+		netManage->mutable_chatrequestmessage()->set_chattext(m_pendingChat);
+	} else {
+		msg.set_messagetype(PokerTHMessage::Type_LobbyMessage);
+		LobbyMessage *netLobby = msg.mutable_lobbymessage();
+		netLobby->set_messagetype(LobbyMessage::Type_ChatRequestMessage);
+		netLobby->mutable_chatrequestmessage()->set_chattext(m_pendingChat);
+	}
+	SendPacket(msg);
+}
+
+void
+LoadClient::SendAction(NetPlayerAction action)
+{
+	BeginOperation(LOAD_OP_ACTION);
+
+	PokerTHMessage msg;
+	msg.set_messagetype(PokerTHMessage::Type_GameMessage);
+	GameMessage *netGame = msg.mutable_gamemessage();
+	netGame->set_messagetype(GameMessage::Type_GameEngineMessage);
+	netGame->set_gameid(m_gameId);
+	GameEngineMessage *netEngine = netGame->mutable_gameenginemessage();
+	netEngine->set_messagetype(GameEngineMessage::Type_MyActionRequestMessage);
+	MyActionRequestMessage *netAction = netEngine->mutable_myactionrequestmessage();
+	netAction->set_handnum(m_handNum);
+	netAction->set_gamestate(m_gameState);
+	netAction->set_myaction(action);
+	netAction->set_myrelativebet(0);
+	SendPacket(msg);
+}
+
+void
+LoadClient::ScheduleChat()
+{
+	if (m_config.chatIntervalSec) {
+		unsigned intervalMsec = m_config.chatIntervalSec * 1000;
+		// Spread the first message of the clients over one interval.
+		unsigned delayMsec = m_chatCounter ? intervalMsec : (m_clientNum * 7919) % intervalMsec;
+		m_chatTimer.expires_from_now(boost::posix_time::milliseconds(delayMsec));
+		m_chatTimer.async_wait(m_strand.wrap(boost::bind(&LoadClient::HandleChatTimer, shared_from_this(), boost::asio::placeholders::error)));
+	}
+}
+
+void
+LoadClient::SendPacket(const PokerTHMessage &msg)
+{
+	if (m_state == STATE_STOPPED)
+		return;
+	size_t size = msg.ByteSize();
+	m_sendQueue.push_back(string(size + NET_HEADER_SIZE, '\0'));
+	string &buf = m_sendQueue.back();
+	buf[0] = (char)((size >> 24) & 0xff);
+	buf[1] = (char)((size >> 16) & 0xff);
+	buf[2] = (char)((size >> 8) & 0xff);
+	buf[3] = (char)(size & 0xff);
+	msg.SerializeWithCachedSizesToArray(reinterpret_cast<google::protobuf::uint8 *>(&buf[NET_HEADER_SIZE]));
+	m_stats.AddOutgoing(buf.size());
+
+	if (m_sendQueue.size() == 1) {
+		boost::asio::async_write(m_socket, boost::asio::buffer(m_sendQueue.front()),
+								 m_strand.wrap(boost::bind(&LoadClient::HandleWrite, shared_from_this(),
+										 boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred)));
+	}
+}
+
+void
+LoadClient::BeginOperation(LoadOperation op)
+{
+	m_opStartTime[op] = boost::chrono::steady_clock::now();
+	m_opPending[op] = true;
+}
+
+void
+LoadClient::EndOperation(LoadOperation op)
+{
+	if (m_opPending[op]) {
+		m_stats.AddLatency(op, boost::chrono::steady_clock::now() - m_opStartTime[op]);
+		m_opPending[op] = false;
+	}
+}
+
+void
+LoadClient::Fail(LoadOperation op)
+{
+	m_opPending[op] = false;
+	m_stats.AddError(op);
+}
+
+void
+LoadClient::Close()
+{
+	if (m_state == STATE_STOPPED)
+		return;
+	if (m_state != STATE_INIT && m_state != STATE_CONNECTING)
+		m_stats.AdjustGauge(LOAD_GAUGE_CONNECTED, -1);
+	if (m_loggedIn)
+		m_stats.AdjustGauge(LOAD_GAUGE_LOGGED_IN, -1);
+	if (m_state == STATE_GAME)
+		m_stats.AdjustGauge(LOAD_GAUGE_IN_GAME, -1);
+	m_state = STATE_STOPPED;
+	m_loggedIn = false;
+
+	m_actionTimer.cancel();
+	m_chatTimer.cancel();
+	m_retryTimer.cancel();
+	boost::system::error_code ec;
+	m_socket.close(ec);
+}
+
+string
+LoadClient::GetGameNamePrefix() const
+{
+	ostringstream prefix;
+	prefix << "_load" << m_config.runId << "_" << (m_clientNum / max(m_config.playersPerGame, 1u)) << "_";
+	return prefix.str();
+}
+
+bool
+LoadClient::IsGameCreator() const
+{
+	return m_config.playersPerGame && (m_clientNum % m_config.playersPerGame) == 0;
+}
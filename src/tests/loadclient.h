@@ -0,0 +1,164 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+/* Simulated client of the load generator. */
+
+#ifndef _LOADCLIENT_H_
+#define _LOADCLIENT_H_
+
+#include <tests/loadstatistics.h>
+#include <third_party/protobuf/pokerth.pb.h>
+#include <boost/asio.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/array.hpp>
+#include <deque>
+#include <set>
+#include <string>
+
+struct Gsasl;
+struct Gsasl_session;
+
+enum LoadLoginType {
+	LOAD_LOGIN_GUEST,
+	LOAD_LOGIN_UNAUTHENTICATED,
+	LOAD_LOGIN_SCRAM
+};
+
+struct LoadConfig {
+	LoadConfig()
+		: loginType(LOAD_LOGIN_UNAUTHENTICATED), authContext(NULL), firstId(1), playersPerGame(10),
+		  actionDelayMsec(500), chatIntervalSec(60) {}
+	boost::asio::ip::tcp::endpoint serverEndpoint;
+	LoadLoginType loginType;
+	Gsasl *authContext;
+	unsigned firstId;
+	// Clients are grouped into games of this size, 0 keeps them in the lobby.
+	unsigned playersPerGame;
+	unsigned actionDelayMsec;
+	unsigned chatIntervalSec;
+	std::string runId;
+};
+
+class LoadClient : public boost::enable_shared_from_this<LoadClient>
+{
+public:
+	LoadClient(boost::asio::io_service &ioService, const LoadConfig &config, LoadStatistics &stats, unsigned clientNum);
+	~LoadClient();
+
+	void Start();
+	void Stop();
+
+protected:
+	enum State {
+		STATE_INIT,
+		STATE_CONNECTING,
+		STATE_AUTH,
+		STATE_LOBBY,
+		STATE_JOINING,
+		STATE_GAME,
+		STATE_STOPPED
+	};
+	typedef boost::chrono::steady_clock::time_point TimePoint;
+
+	void HandleConnect(const boost::system::error_code &ec);
+	void HandleReadHeader(const boost::system::error_code &ec);
+	void HandleReadBody(const boost::system::error_code &ec);
+	void HandleWrite(const boost::system::error_code &ec, std::size_t bytesTransferred);
+	void HandleActionTimer(const boost::system::error_code &ec);
+	void HandleChatTimer(const boost::system::error_code &ec);
+	void HandleRetryTimer(const boost::system::error_code &ec);
+
+	void HandleMessage(const PokerTHMessage &msg);
+	void HandleAnnounce(const AnnounceMessage &announce);
+	void HandleAuth(const AuthMessage &auth);
+	void HandleLobby(const LobbyMessage &lobby);
+	void HandleGameManagement(unsigned gameId, const GameManagementMessage &management);
+	void HandleGameEngine(const GameEngineMessage &engine);
+	void HandleChat(const ChatMessage &chat);
+
+	void Login();
+	void EnterLobby();
+	void EnterGame(unsigned gameId);
+	void LeaveGame();
+	void TryJoinGame();
+	void CreateGame();
+	void Subscribe(bool subscribe);
+	void SendChat();
+	void SendAction(NetPlayerAction action);
+	void ScheduleChat();
+
+	void SendPacket(const PokerTHMessage &msg);
+	void BeginOperation(LoadOperation op);
+	void EndOperation(LoadOperation op);
+	void Fail(LoadOperation op);
+	void Close();
+
+	std::string GetGameNamePrefix() const;
+	bool IsGameCreator() const;
+
+private:
+	boost::asio::io_service &m_ioService;
+	boost::asio::io_service::strand m_strand;
+	boost::asio::ip::tcp::socket m_socket;
+	boost::asio::deadline_timer m_actionTimer;
+	boost::asio::deadline_timer m_chatTimer;
+	boost::asio::deadline_timer m_retryTimer;
+	const LoadConfig &m_config;
+	LoadStatistics &m_stats;
+	const unsigned m_clientNum;
+	std::string m_name;
+	Gsasl_session *m_authSession;
+
+	State m_state;
+	unsigned m_playerId;
+	unsigned m_gameId;
+	unsigned m_requestId;
+	unsigned m_gameRound;
+	unsigned m_handNum;
+	unsigned m_highestSet;
+	unsigned m_myBet;
+	NetGameState m_gameState;
+	unsigned m_chatCounter;
+	std::string m_pendingChat;
+	bool m_loggedIn;
+
+	// Ids of the open games of this client's group.
+	std::set<unsigned> m_groupGames;
+
+	TimePoint m_opStartTime[LOAD_OP_COUNT];
+	bool m_opPending[LOAD_OP_COUNT];
+
+	boost::array<char, 4> m_recvHeader;
+	std::string m_recvBody;
+	std::deque<std::string> m_sendQueue;
+};
+
+#endif
@@ -0,0 +1,263 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+
+#include <tests/loadstatistics.h>
+#include <iomanip>
+
+using namespace std;
+
+#define LOAD_HISTOGRAM_SUB_BITS		3
+#define LOAD_HISTOGRAM_SUB_BUCKETS	(1 << LOAD_HISTOGRAM_SUB_BITS)
+#define LOAD_HISTOGRAM_BUCKETS		((64 - LOAD_HISTOGRAM_SUB_BITS + 1) * LOAD_HISTOGRAM_SUB_BUCKETS)
+
+static const char *s_operationNames[LOAD_OP_COUNT] = {
+	"connect", "login", "subscribe", "create", "join", "action", "chat"
+};
+
+
+LoadHistogram::LoadHistogram()
+	: m_buckets(LOAD_HISTOGRAM_BUCKETS, 0), m_count(0), m_max(0)
+{
+}
+
+void
+LoadHistogram::Add(boost::uint64_t value)
+{
+	m_buckets[GetBucket(value)]++;
+	m_count++;
+	if (value > m_max)
+		m_max = value;
+}
+
+void
+LoadHistogram::Merge(const LoadHistogram &other)
+{
+	for (unsigned i = 0; i < LOAD_HISTOGRAM_BUCKETS; i++)
+		m_buckets[i] += other.m_buckets[i];
+	m_count += other.m_count;
+	if (other.m_max > m_max)
+		m_max = other.m_max;
+}
+
+void
+LoadHistogram::Clear()
+{
+	fill(m_buckets.begin(), m_buckets.end(), 0);
+	m_count = 0;
+	m_max = 0;
+}
+
+boost::uint64_t
+LoadHistogram::GetPercentile(double percent) const
+{
+	boost::uint64_t retVal = 0;
+	if (m_count) {
+		boost::uint64_t rank = static_cast<boost::uint64_t>(percent / 100.0 * m_count + 0.5);
+		if (rank < 1)
+			rank = 1;
+		boost::uint64_t sum = 0;
+		unsigned i = 0;
+		while (i < LOAD_HISTOGRAM_BUCKETS && sum < rank) {
+			sum += m_buckets[i];
+			++i;
+		}
+		retVal = min(GetBucketUpperValue(i - 1), m_max);
+	}
+	return retVal;
+}
+
+unsigned
+LoadHistogram::GetBucket(boost::uint64_t value)
+{
+	unsigned retVal;
+	if (value < LOAD_HISTOGRAM_SUB_BUCKETS) {
+		retVal = static_cast<unsigned>(value);
+	} else {
+		unsigned exponent = 0;
+		boost::uint64_t tmpValue = value;
+		while (tmpValue >>= 1)
+			exponent++;
+		unsigned shift = exponent - LOAD_HISTOGRAM_SUB_BITS;
+		retVal = (shift + 1) * LOAD_HISTOGRAM_SUB_BUCKETS
+				 + static_cast<unsigned>((value >> shift) & (LOAD_HISTOGRAM_SUB_BUCKETS - 1));
+	}
+	return retVal;
+}
+
+boost::uint64_t
+LoadHistogram::GetBucketUpperValue(unsigned bucket)
+{
+	boost::uint64_t retVal;
+	if (bucket < LOAD_HISTOGRAM_SUB_BUCKETS) {
+		retVal = bucket;
+	} else {
+		unsigned shift = bucket / LOAD_HISTOGRAM_SUB_BUCKETS - 1;
+		boost::uint64_t lower = static_cast<boost::uint64_t>(LOAD_HISTOGRAM_SUB_BUCKETS + bucket % LOAD_HISTOGRAM_SUB_BUCKETS) << shift;
+		retVal = lower + ((boost::uint64_t)1 << shift) - 1;
+	}
+	return retVal;
+}
+
+LoadStatistics::LoadStatistics()
+	: m_startTime(boost::chrono::steady_clock::now())
+{
+	m_intervalStartTime = m_startTime;
+	for (int i = 0; i < LOAD_GAUGE_COUNT; i++)
+		m_gauges[i] = 0;
+}
+
+void
+LoadStatistics::AddLatency(LoadOperation op, boost::chrono::steady_clock::duration latency)
+{
+	boost::uint64_t usec = static_cast<boost::uint64_t>(boost::chrono::duration_cast<boost::chrono::microseconds>(latency).count());
+	boost::mutex::scoped_lock lock(m_mutex);
+	m_operations[op].interval.Add(usec);
+}
+
+void
+LoadStatistics::AddError(LoadOperation op)
+{
+	boost::mutex::scoped_lock lock(m_mutex);
+	m_operations[op].intervalErrors++;
+}
+
+void
+LoadStatistics::AddIncoming(size_t bytes)
+{
+	boost::mutex::scoped_lock lock(m_mutex);
+	m_intervalTraffic.msgIn++;
+	m_intervalTraffic.bytesIn += bytes;
+}
+
+void
+LoadStatistics::AddOutgoing(size_t bytes)
+{
+	boost::mutex::scoped_lock lock(m_mutex);
+	m_intervalTraffic.msgOut++;
+	m_intervalTraffic.bytesOut += bytes;
+}
+
+void
+LoadStatistics::AdjustGauge(LoadGauge gauge, int delta)
+{
+	boost::mutex::scoped_lock lock(m_mutex);
+	m_gauges[gauge] += delta;
+}
+
+void
+LoadStatistics::PrintIntervalReport(ostream &o)
+{
+	OperationData tmpOperations[LOAD_OP_COUNT];
+	TrafficData tmpTraffic;
+	int tmpGauges[LOAD_GAUGE_COUNT];
+	boost::chrono::steady_clock::time_point now = boost::chrono::steady_clock::now();
+	double seconds;
+	double elapsed;
+	{
+		// Move the interval data to the totals, print without holding the lock.
+		boost::mutex::scoped_lock lock(m_mutex);
+		for (int i = 0; i < LOAD_OP_COUNT; i++) {
+			tmpOperations[i].interval = m_operations[i].interval;
+			tmpOperations[i].intervalErrors = m_operations[i].intervalErrors;
+			m_operations[i].total.Merge(m_operations[i].interval);
+			m_operations[i].totalErrors += m_operations[i].intervalErrors;
+			m_operations[i].interval.Clear();
+			m_operations[i].intervalErrors = 0;
+		}
+		tmpTraffic = m_intervalTraffic;
+		m_totalTraffic.msgIn += m_intervalTraffic.msgIn;
+		m_totalTraffic.msgOut += m_intervalTraffic.msgOut;
+		m_totalTraffic.bytesIn += m_intervalTraffic.bytesIn;
+		m_totalTraffic.bytesOut += m_intervalTraffic.bytesOut;
+		m_intervalTraffic = TrafficData();
+		for (int i = 0; i < LOAD_GAUGE_COUNT; i++)
+			tmpGauges[i] = m_gauges[i];
+		seconds = boost::chrono::duration<double>(now - m_intervalStartTime).count();
+		elapsed = boost::chrono::duration<double>(now - m_startTime).count();
+		m_intervalStartTime = now;
+	}
+
+	o << fixed << setprecision(1) << "[" << elapsed << "s] clients connected " << tmpGauges[LOAD_GAUGE_CONNECTED]
+	  << ", logged in " << tmpGauges[LOAD_GAUGE_LOGGED_IN] << ", in game " << tmpGauges[LOAD_GAUGE_IN_GAME] << endl;
+	PrintTraffic(o, tmpTraffic, seconds);
+	PrintOperations(o, tmpOperations, false, seconds);
+}
+
+void
+LoadStatistics::PrintFinalReport(ostream &o)
+{
+	PrintIntervalReport(o);
+
+	OperationData tmpOperations[LOAD_OP_COUNT];
+	TrafficData tmpTraffic;
+	double seconds;
+	{
+		boost::mutex::scoped_lock lock(m_mutex);
+		for (int i = 0; i < LOAD_OP_COUNT; i++)
+			tmpOperations[i] = m_operations[i];
+		tmpTraffic = m_totalTraffic;
+		seconds = boost::chrono::duration<double>(m_intervalStartTime - m_startTime).count();
+	}
+	o << "=== Total (" << fixed << setprecision(1) << seconds << "s)" << endl;
+	PrintTraffic(o, tmpTraffic, seconds);
+	PrintOperations(o, tmpOperations, true, seconds);
+}
+
+void
+LoadStatistics::PrintOperations(ostream &o, const OperationData *data, bool total, double seconds)
+{
+	o << "  " << left << setw(10) << "operation" << right << setw(9) << "count" << setw(9) << "per sec"
+	  << setw(9) << "errors" << setw(8) << "err %" << setw(10) << "p50 ms" << setw(10) << "p90 ms"
+	  << setw(10) << "p99 ms" << setw(10) << "max ms" << endl;
+	for (int i = 0; i < LOAD_OP_COUNT; i++) {
+		const LoadHistogram &histogram = total ? data[i].total : data[i].interval;
+		boost::uint64_t errors = total ? data[i].totalErrors : data[i].intervalErrors;
+		boost::uint64_t attempts = histogram.GetCount() + errors;
+		if (attempts) {
+			o << "  " << left << setw(10) << s_operationNames[i] << right << setw(9) << histogram.GetCount()
+			  << setw(9) << setprecision(1) << (seconds > 0 ? histogram.GetCount() / seconds : 0.0)
+			  << setw(9) << errors << setw(8) << setprecision(2) << errors * 100.0 / attempts
+			  << setw(10) << setprecision(2) << histogram.GetPercentile(50) / 1000.0
+			  << setw(10) << histogram.GetPercentile(90) / 1000.0
+			  << setw(10) << histogram.GetPercentile(99) / 1000.0
+			  << setw(10) << histogram.GetMax() / 1000.0 << endl;
+		}
+	}
+}
+
+void
+LoadStatistics::PrintTraffic(ostream &o, const TrafficData &traffic, double seconds)
+{
+	if (seconds <= 0)
+		seconds = 1;
+	o << fixed << setprecision(1) << "  messages in " << traffic.msgIn / seconds << "/s (" << traffic.bytesIn / seconds / 1024 << " KB/s)"
+	  << ", out " << traffic.msgOut / seconds << "/s (" << traffic.bytesOut / seconds / 1024 << " KB/s)" << endl;
+}
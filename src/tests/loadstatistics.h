@@ -0,0 +1,132 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+/* Latency and throughput statistics of the load generator. */
+
+#ifndef _LOADSTATISTICS_H_
+#define _LOADSTATISTICS_H_
+
+#include <boost/chrono.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread.hpp>
+#include <ostream>
+#include <vector>
+
+enum LoadOperation {
+	LOAD_OP_CONNECT = 0,
+	LOAD_OP_LOGIN,
+	LOAD_OP_SUBSCRIBE,
+	LOAD_OP_CREATE_GAME,
+	LOAD_OP_JOIN_GAME,
+	LOAD_OP_ACTION,
+	LOAD_OP_CHAT,
+	LOAD_OP_COUNT
+};
+
+enum LoadGauge {
+	LOAD_GAUGE_CONNECTED = 0,
+	LOAD_GAUGE_LOGGED_IN,
+	LOAD_GAUGE_IN_GAME,
+	LOAD_GAUGE_COUNT
+};
+
+// Log-linear histogram of microsecond values, 8 buckets per power of two.
+class LoadHistogram
+{
+public:
+	LoadHistogram();
+
+	void Add(boost::uint64_t value);
+	void Merge(const LoadHistogram &other);
+	void Clear();
+
+	boost::uint64_t GetCount() const {
+		return m_count;
+	}
+	boost::uint64_t GetMax() const {
+		return m_max;
+	}
+	boost::uint64_t GetPercentile(double percent) const;
+
+protected:
+	static unsigned GetBucket(boost::uint64_t value);
+	static boost::uint64_t GetBucketUpperValue(unsigned bucket);
+
+private:
+	std::vector<boost::uint64_t> m_buckets;
+	boost::uint64_t m_count;
+	boost::uint64_t m_max;
+};
+
+class LoadStatistics
+{
+public:
+	LoadStatistics();
+
+	void AddLatency(LoadOperation op, boost::chrono::steady_clock::duration latency);
+	void AddError(LoadOperation op);
+	void AddIncoming(std::size_t bytes);
+	void AddOutgoing(std::size_t bytes);
+	void AdjustGauge(LoadGauge gauge, int delta);
+
+	// Prints the data of the last interval and starts a new one.
+	void PrintIntervalReport(std::ostream &o);
+	void PrintFinalReport(std::ostream &o);
+
+protected:
+	struct OperationData {
+		OperationData() : intervalErrors(0), totalErrors(0) {}
+		LoadHistogram interval;
+		LoadHistogram total;
+		boost::uint64_t intervalErrors;
+		boost::uint64_t totalErrors;
+	};
+	struct TrafficData {
+		TrafficData() : msgIn(0), msgOut(0), bytesIn(0), bytesOut(0) {}
+		boost::uint64_t msgIn;
+		boost::uint64_t msgOut;
+		boost::uint64_t bytesIn;
+		boost::uint64_t bytesOut;
+	};
+
+	static void PrintOperations(std::ostream &o, const OperationData *data, bool total, double seconds);
+	static void PrintTraffic(std::ostream &o, const TrafficData &traffic, double seconds);
+
+private:
+	mutable boost::mutex m_mutex;
+	OperationData m_operations[LOAD_OP_COUNT];
+	TrafficData m_intervalTraffic;
+	TrafficData m_totalTraffic;
+	int m_gauges[LOAD_GAUGE_COUNT];
+	boost::chrono::steady_clock::time_point m_startTime;
+	boost::chrono::steady_clock::time_point m_intervalStartTime;
+};
+
+#endif
@@ -0,0 +1,69 @@
+/*****************************************************************************
+ * PokerTH - The open source texas holdem engine                             *
+ * Copyright (C) 2006-2012 Felix Hammer, Florian Thauer, Lothar May          *
+ *                                                                           *
+ * This program is free software: you can redistribute it and/or modify      *
+ * it under the terms of the GNU Affero General Public License as            *
+ * published by the Free Software Foundation, either version 3 of the        *
+ * License, or (at your option) any later version.                           *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU Affero General Public License for more details.                       *
+ *                                                                           *
+ * You should have received a copy of the GNU Affero General Public License  *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *                                                                           *
+ *                                                                           *
+ * Additional permission under GNU AGPL version 3 section 7                  *
+ *                                                                           *
+ * If you modify this program, or any covered work, by linking or            *
+ * combining it with the OpenSSL project's OpenSSL library (or a             *
+ * modified version of that library), containing parts covered by the        *
+ * terms of the OpenSSL or SSLeay licenses, the authors of PokerTH           *
+ * (Felix Hammer, Florian Thauer, Lothar May) grant you additional           *
+ * permission to convey the resulting work.                                  *
+ * Corresponding Source for a non-source form of such a combination          *
+ * shall include the source code for the parts of OpenSSL used as well       *
+ * as that of the covered work.                                              *
+ *****************************************************************************/
+
+#include <tests/benchmark.h>
+#include <cstring>
+
+using namespace std;
+
+struct BenchInfo {
+	const char *name;
+	int (*run)(int argc, char *argv[]);
+};
+
+static const BenchInfo benchList[] = {
+	{ "patternmatcher", &BenchPatternMatcher },
+	{ "handstart", &BenchHandStart },
+	{ "tablestate", &BenchTableState },
+	{ "avatardownload", &BenchAvatarDownload },
+};
+
+int
+main(int argc, char *argv[])
+{
+	int retVal = 0;
+	bool found = false;
+	for (unsigned i = 0; i < sizeof(benchList) / sizeof(benchList[0]); i++) {
+		if (argc < 2 || strcmp(argv[1], benchList[i].name) == 0) {
+			cout << "*** " << benchList[i].name << endl;
+			retVal |= benchList[i].run(argc > 2 ? argc - 2 : 0, argc > 2 ? argv + 2 : argv + argc);
+			found = true;
+		}
+	}
+	if (!found) {
+		cerr << "Usage: " << argv[0] << " [benchmark] [options]" << endl << "Benchmarks:";
+		for (unsigned i = 0; i < sizeof(benchList) / sizeof(benchList[0]); i++)
+			cerr << " " << benchList[i].name;
+		cerr << endl;
+		retVal = 1;
+	}
+	return retVal;
+}
@@ -391,6 +391,11 @@ public:
                             m_msg_manager->get_message(op,m_bytes_needed),
                             frame::get_masking_key(m_basic_header,m_extended_header)
                         );
+
+                        // Only the first frame of a message carries RSV1,
+                        // remember it for the continuation frames.
+                        m_data_msg.msg_ptr->set_compressed(
+                            frame::get_rsv1(m_basic_header));
                     } else {
                         // Fetch the underlying payload buffer from the data message we
                         // are writing into.
@@ -440,6 +445,18 @@ public:
                         }
                     }
 
+                    // The sender strips the trailing empty block of the
+                    // deflate stream (RFC 7692, 7.2.2), put it back.
+                    if (m_current_msg == &m_data_msg
+                        && m_permessage_deflate.is_enabled()
+                        && m_data_msg.msg_ptr->get_compressed())
+                    {
+                        uint8_t const trailer[4] = {0x00, 0x00, 0xff, 0xff};
+                        ec = m_permessage_deflate.decompress(trailer,4,
+                            m_data_msg.msg_ptr->get_raw_payload());
+                        if (ec) {break;}
+                    }
+
                     m_state = READY;
                 } else {
                     this->reset_headers();
@@ -551,18 +568,9 @@ public:
                           && in->get_compressed();
         bool fin = in->get_fin();
 
-        // generate header
-        frame::basic_header h(op,i.size(),fin,masked,compressed);
-
         if (masked) {
             // Generate masking key.
             key.i = m_rng();
-
-            frame::extended_header e(i.size(),key.i);
-            out->set_header(frame::prepare_header(h,e));
-        } else {
-            frame::extended_header e(i.size());
-            out->set_header(frame::prepare_header(h,e));
         }
 
         // prepare payload
@@ -588,6 +596,17 @@ public:
             }
         }
 
+        // generate header, the payload size is only known after compression
+        frame::basic_header h(op,o.size(),fin,masked,compressed);
+
+        if (masked) {
+            frame::extended_header e(o.size(),key.i);
+            out->set_header(frame::prepare_header(h,e));
+        } else {
+            frame::extended_header e(o.size());
+            out->set_header(frame::prepare_header(h,e));
+        }
+
         out->set_prepared(true);
         out->set_opcode(op);
 
@@ -730,10 +749,17 @@ protected:
 
         // decompress message if needed.
         if (m_permessage_deflate.is_enabled()
-            && frame::get_rsv1(m_basic_header))
+            && m_current_msg->msg_ptr->get_compressed())
         {
             // Decompress current buffer into the message buffer
-            m_permessage_deflate.decompress(buf,len,out);
+            ec = m_permessage_deflate.decompress(buf,len,out);
+            if (ec) {
+                return 0;
+            }
+            if (out.size() > base::m_max_message_size) {
+                ec = make_error_code(error::message_too_big);
+                return 0;
+            }
 
             // get the length of the newly uncompressed output
             offset = out.size() - offset;